@@ -23,6 +23,8 @@
 #define C32_ASM_H
 
 #include "c32_types.h"
+#include "c32_opcodes.h"
+#include "c32_vm.h"
 
 /**
  * @defgroup assembler CRISP-32 Assembler
@@ -36,13 +38,18 @@
  * **Assembly Process:**
  * - Pass 1: Collect label definitions and calculate addresses
  * - Pass 2: Generate machine code with resolved symbols
+ * - Or a single pass that records forward references as fixups and
+ *   patches them at the end (every instruction is 8 bytes, so a label's
+ *   address never depends on code after it)
  *
  * **Supported Features:**
  * - Labels and forward references
  * - All CRISP-32 instruction mnemonics
  * - Register names (R0-R31) and ABI names (zero, at, v0, etc.)
- * - Immediate values (decimal, hexadecimal)
+ * - Immediate values (decimal, hexadecimal), %hi(label) and %lo(label)
  * - Comments (# or ; to end of line)
+ * - .text, .bss, .space and .global for relocatable objects (c32_obj.h)
+ * - An optional peephole optimizer for single-pass images (c32_asm_set_optimize())
  *
  * @{
  */
@@ -53,7 +60,7 @@
  * @{
  */
 
-/** @brief Maximum number of symbols in symbol table */
+/** @brief Maximum number of symbols in the builtin symbol table (no arena) */
 #define MAX_SYMBOLS     1024
 
 /** @brief Maximum length of input line */
@@ -62,9 +69,21 @@
 /** @brief Maximum length of label name */
 #define MAX_LABEL_LEN   64
 
-/** @brief Maximum output binary size (64KB) */
+/** @brief Size of the builtin output buffer (64KB; the image limit without a write callback) */
 #define MAX_OUTPUT_SIZE (64 * 1024)
 
+/** @brief Number of forward references held in the builtin fixup table (no arena) */
+#define MAX_FIXUPS      1024
+
+/** @brief Value of c32_asm_state_t::pass for single-pass assembly */
+#define C32_ASM_ONE_PASS 0
+
+/** @brief Default load address assumed for absolute addresses (J/JAL, symbol maps) */
+#define C32_ASM_LOAD_ADDR 0x1000
+
+/** @brief Work memory the optimizer needs for an image of image_size bytes */
+#define C32_ASM_OPT_WORK_SIZE(image_size) (((image_size) / 8 + 1) * 13 + 4)
+
 /** @} */ /* end of asm_constants */
 
 /**
@@ -87,6 +106,20 @@ typedef struct {
     uint32_t immediate;     /**< 32-bit immediate value or offset */
 } c32_instruction_t;
 
+/** @brief Symbol sections (see c32_obj.h) */
+#define C32_SECTION_UNDEF 0     /**< Imported from another object */
+#define C32_SECTION_TEXT  1     /**< Code */
+#define C32_SECTION_BSS   2     /**< Zero-initialized data, size only */
+
+/**
+ * @brief Instruction table entry (one per C32_INSTRUCTIONS entry)
+ */
+typedef struct {
+    const char *mnemonic;       /**< Upper-case mnemonic */
+    uint8_t opcode;             /**< Opcode byte */
+    uint8_t format;             /**< Operand format (c32_format_t) */
+} c32_op_info_t;
+
 /**
  * @brief Symbol table entry
  *
@@ -94,25 +127,99 @@ typedef struct {
  * during the first pass and used to calculate addresses in the second pass.
  */
 typedef struct {
-    char name[MAX_LABEL_LEN];   /**< Symbol name (label) */
+    const char *name;           /**< Symbol name (label), interned in the symbol store */
     uint32_t address;           /**< Resolved address */
+    uint32_t hash;              /**< Hash of name */
     int defined;                /**< 1 if defined, 0 if forward reference */
+    uint8_t section;            /**< Section of a defined symbol (C32_SECTION_TEXT or _BSS) */
+    uint8_t global;             /**< 1 if exported with .global */
 } c32_symbol_t;
 
+/** @brief Fixup kinds */
+#define C32_FIXUP_BRANCH 0  /**< PC-relative branch offset */
+#define C32_FIXUP_JUMP   1  /**< Absolute J/JAL target */
+#define C32_FIXUP_HI16   2  /**< %hi(label): upper 16 bits of the absolute address (LUI) */
+#define C32_FIXUP_LO16   3  /**< %lo(label): lower 16 bits of the absolute address (ORI) */
+
+/**
+ * @brief Forward reference awaiting its label (single-pass mode)
+ */
+typedef struct {
+    uint32_t address;           /**< Address of the referring instruction */
+    int symbol;                 /**< Index of the (undefined) symbol */
+    int kind;                   /**< C32_FIXUP_BRANCH or C32_FIXUP_JUMP */
+} c32_fixup_t;
+
+/**
+ * @brief Output callback for streamed images
+ *
+ * Receives the image in chunks as the output buffer fills, and at the end
+ * of a single pass the 4-byte immediates patched by fixups whose
+ * instructions were already written. Chunks arrive in order; patches may
+ * go back to any offset written earlier.
+ *
+ * @param ctx Context pointer given to c32_asm_set_output()
+ * @param offset Image offset of data
+ * @param data Bytes to write
+ * @param size Number of bytes
+ * @return 0 on success, -1 on error
+ */
+typedef int (*c32_asm_write_t)(void *ctx, uint32_t offset, const uint8_t *data, uint32_t size);
+
 /**
  * @brief Assembler state
  *
  * Complete state for the two-pass assembler including symbol table,
  * output buffer, and current assembly context.
+ *
+ * In single-pass mode (pass == C32_ASM_ONE_PASS) each line is read once:
+ * a branch or jump to a label not yet defined emits a zero immediate and
+ * records a fixup, and c32_asm_finish() patches every fixup once all
+ * labels are known. Fixups are kept like symbols: MAX_FIXUPS in the
+ * builtin table, or growing from the arena.
+ *
+ * Symbols are kept in insertion order in symbols[] and found through an
+ * open-addressing hash index of at least twice as many slots. By default
+ * the table lives in the builtin arrays and holds MAX_SYMBOLS symbols;
+ * after c32_asm_set_arena() the entries, index and interned names are
+ * carved from the caller's arena and the table doubles as it fills.
  */
 typedef struct {
-    c32_symbol_t symbols[MAX_SYMBOLS];  /**< Symbol table */
+    c32_symbol_t *symbols;              /**< Symbol table, in definition order */
     int num_symbols;                    /**< Number of symbols defined */
+    int max_symbols;                    /**< Capacity of symbols */
+    int32_t *symbol_index;              /**< Hash slots: symbol index or -1 */
+    uint32_t index_mask;                /**< Number of hash slots minus one */
+    uint8_t *arena;                     /**< Caller arena, or NULL for the builtin table */
+    uint32_t arena_size;                /**< Size of arena in bytes */
+    uint32_t arena_used;                /**< Bytes of arena handed out */
+    uint32_t names_used;                /**< Bytes of builtin_names handed out */
+    c32_symbol_t builtin_symbols[MAX_SYMBOLS];      /**< Builtin symbol entries */
+    int32_t builtin_index[2 * MAX_SYMBOLS];         /**< Builtin hash slots */
+    char builtin_names[MAX_SYMBOLS * MAX_LABEL_LEN]; /**< Builtin name storage */
+    c32_fixup_t *fixups;                /**< Pending forward references */
+    int num_fixups;                     /**< Number of pending fixups */
+    int max_fixups;                     /**< Capacity of fixups */
+    c32_fixup_t builtin_fixups[MAX_FIXUPS];         /**< Builtin fixup table */
     uint32_t current_address;           /**< Current assembly address */
-    uint8_t output[MAX_OUTPUT_SIZE];    /**< Output binary buffer */
-    uint32_t output_size;               /**< Size of generated code in bytes */
-    int pass;                           /**< Current pass (1 or 2) */
+    uint8_t *output;                    /**< Output binary buffer */
+    uint32_t output_capacity;           /**< Size of output in bytes */
+    uint32_t output_size;               /**< Bytes of generated code held in output */
+    uint32_t output_flushed;            /**< Bytes already passed to output_write */
+    c32_asm_write_t output_write;       /**< Output callback, or NULL to keep the image in output */
+    void *output_ctx;                   /**< Context pointer passed to output_write */
+    uint8_t builtin_output[MAX_OUTPUT_SIZE];        /**< Default output buffer */
+    uint32_t load_address;              /**< Address the image is loaded at (J/JAL targets) */
+    int object;                         /**< 1 to assemble a relocatable object (see c32_obj.h) */
+    int section;                        /**< Current section (C32_SECTION_TEXT or _BSS) */
+    uint32_t bss_size;                  /**< Bytes reserved in .bss (object mode) */
+    int optimize;                       /**< 1 if c32_asm_finish() runs the optimizer first */
+    uint8_t *opt_work;                  /**< Optimizer work memory */
+    uint32_t opt_work_size;             /**< Size of opt_work in bytes */
+    uint32_t opt_removed;               /**< Instructions removed by the optimizer */
+    int pass;                           /**< Current pass (1 or 2, or C32_ASM_ONE_PASS) */
     int errors;                         /**< Number of assembly errors */
+    int error_line;                     /**< First failing line of c32_asm_assemble_buffer(), or 0 */
 } c32_asm_state_t;
 
 /** @} */ /* end of asm_types */
@@ -133,11 +240,118 @@ typedef struct {
  */
 void c32_asm_init(c32_asm_state_t *state);
 
+/**
+ * @brief Grow the symbol and fixup tables from a caller-supplied arena
+ *
+ * Call after c32_asm_init() and before the first symbol is added. The
+ * tables then have no fixed limit: entries, hash slots, interned names
+ * and fixups are allocated from arena, and c32_asm_add_symbol() returns
+ * -3 only once the arena is exhausted. Space freed by growing the table is not
+ * reused, so allow about (40 + average name length) bytes per symbol on
+ * 64-bit hosts. The arena must outlive the assembler state.
+ *
+ * @param state Pointer to assembler state (no symbols yet)
+ * @param arena Arena memory
+ * @param size Size of arena in bytes
+ * @return 0 on success, -1 if symbols were already added or arena is NULL
+ */
+int c32_asm_set_arena(c32_asm_state_t *state, void *arena, uint32_t size);
+
+/**
+ * @brief Replace the output buffer and optionally stream the image
+ *
+ * Without a callback the whole image is kept in buffer and may not exceed
+ * capacity. With one, the buffer is passed to write each time it fills,
+ * so the image size is unlimited; c32_asm_finish() writes the remainder.
+ * Call after c32_asm_init() and before assembling.
+ *
+ * @param state Pointer to assembler state
+ * @param buffer Output buffer (a multiple of 8 bytes), or NULL for the builtin one
+ * @param capacity Size of buffer in bytes (ignored for the builtin buffer)
+ * @param write Output callback, or NULL
+ * @param ctx Context pointer passed to write
+ * @return 0 on success, -1 if capacity is below one instruction
+ */
+int c32_asm_set_output(c32_asm_state_t *state, uint8_t *buffer, uint32_t capacity,
+                       c32_asm_write_t write, void *ctx);
+
+/**
+ * @brief Enable the peephole optimizer for single-pass assembly
+ *
+ * Every label reference then becomes a fixup, and c32_asm_finish() runs
+ * c32_asm_optimize() before patching them. The whole image must stay in
+ * the output buffer, so with a callback it may not exceed the buffer's
+ * capacity. work needs C32_ASM_OPT_WORK_SIZE() of the image size.
+ *
+ * @param state Pointer to assembler state
+ * @param work Work memory, or NULL to disable the optimizer
+ * @param size Size of work in bytes
+ * @return 0 on success, -1 if state is NULL
+ */
+int c32_asm_set_optimize(c32_asm_state_t *state, void *work, uint32_t size);
+
+/**
+ * @brief Run the peephole optimizer over the buffered image
+ *
+ * Called by c32_asm_finish() when the optimizer is enabled; fixups are
+ * still pending. Repeats until nothing changes:
+ * - removes NOPs, instructions that only write R0, register moves to
+ *   themselves, branches that are never taken and branches or jumps to
+ *   the next instruction
+ * - folds LUI rt, hi followed by ORI/ADDI/ADDIU rt, rt, lo (numbers, or
+ *   %hi/%lo of one label) into a single ORI/ADDIU rt, R0
+ * - points branches and jumps to an unconditional jump at that jump's
+ *   label instead
+ *
+ * Labels, fixups and numeric branch offsets are moved with the code, and
+ * opt_removed counts the instructions removed. Code addresses must come
+ * from labels: the optimizer cannot see addresses computed at run time
+ * (GETPC, a return address plus an offset, jump tables of numbers).
+ *
+ * @param state Pointer to assembler state after a single pass
+ * @return 0 on success, -1 if the optimizer is not enabled, part of the
+ *         image was already streamed, work is too small or a numeric
+ *         branch leaves the image
+ */
+int c32_asm_optimize(c32_asm_state_t *state);
+
+/**
+ * @brief Start a pass
+ *
+ * Sets the pass (1, 2 or C32_ASM_ONE_PASS) and rewinds the address and
+ * the output. Symbols are kept, so pass 2 sees the labels of pass 1.
+ *
+ * @param state Pointer to assembler state
+ * @param pass Pass to start
+ */
+void c32_asm_begin_pass(c32_asm_state_t *state, int pass);
+
+/**
+ * @brief Finish the pass that generated code
+ *
+ * In single-pass mode, runs the optimizer if it is enabled and patches every fixup with its label's address
+ * (in the buffer, or through the output callback if already written).
+ * Then passes any buffered output to the callback.
+ *
+ * @param state Pointer to assembler state after pass 2 or a single pass
+ * @return 0 on success, -1 if a referenced label was never defined, the
+ *         optimizer failed or the output callback failed
+ */
+int c32_asm_finish(c32_asm_state_t *state);
+
+/**
+ * @brief Size of the generated image in bytes
+ *
+ * @param state Pointer to assembler state
+ * @return Bytes of code generated so far, streamed or buffered
+ */
+uint32_t c32_asm_image_size(const c32_asm_state_t *state);
+
 /**
  * @brief Assemble a source file
  *
  * Performs two-pass assembly on the input file and writes the
- * resulting binary to the output file.
+ * resulting binary to the output file, streaming the output buffer.
  *
  * **Pass 1:** Scans the file to collect label definitions and
  * calculate instruction addresses.
@@ -151,6 +365,78 @@ void c32_asm_init(c32_asm_state_t *state);
  */
 int c32_asm_assemble_file(c32_asm_state_t *state, const char *input_file, const char *output_file);
 
+/**
+ * @brief Assemble a source file in a single pass
+ *
+ * Reads the input once, records forward references as fixups and
+ * patches them once the whole file is read. The output buffer is
+ * streamed to the output file as it fills, so the image size is not
+ * limited by the buffer. Produces the same image as
+ * c32_asm_assemble_file(), but a reference to a label that is never
+ * defined is an error.
+ *
+ * @param state Pointer to assembler state
+ * @param input_file Path to assembly source file (.asm)
+ * @param output_file Path to output binary file (.bin)
+ * @return 0 on success, -1 on error
+ */
+int c32_asm_assemble_file_one_pass(c32_asm_state_t *state, const char *input_file,
+                                   const char *output_file);
+
+/**
+ * @brief Assemble source text in memory into a caller buffer
+ *
+ * Single-pass assembly of length bytes of source (lines separated by
+ * '\n' or "\r\n"; no terminator needed) straight into output, with no
+ * file I/O. Call c32_asm_init() first, and c32_asm_set_arena() for large
+ * sources; afterwards the state's symbol table holds every label
+ * (c32_asm_find_symbol(), state->symbols) and c32_asm_image_size() gives
+ * the number of bytes written. J/JAL targets use state->load_address.
+ *
+ * @param state Pointer to initialized assembler state
+ * @param source Source text
+ * @param length Length of source in bytes
+ * @param output Buffer receiving the machine code
+ * @param capacity Size of output in bytes
+ * @return 0 on success; -1 if a line failed (state->error_line has the
+ *         first, state->errors the count), the image does not fit, or a
+ *         referenced label is undefined
+ */
+int c32_asm_assemble_buffer(c32_asm_state_t *state, const char *source, uint32_t length,
+                            uint8_t *output, uint32_t capacity);
+
+/**
+ * @brief Assemble source text directly into guest memory
+ *
+ * Sets state->load_address to load_addr, assembles with
+ * c32_asm_assemble_buffer() into vm->memory at that physical address,
+ * and reports the written range with c32_vm_host_write() so that cached
+ * or translated code there is dropped. The VM's PC is not changed.
+ *
+ * @param state Pointer to initialized assembler state
+ * @param vm VM whose memory receives the code
+ * @param load_addr Physical load address
+ * @param source Source text
+ * @param length Length of source in bytes
+ * @return 0 on success, -1 on error (as c32_asm_assemble_buffer(), or
+ *         load_addr outside memory); guest memory may be partly written
+ */
+int c32_asm_assemble_to_vm(c32_asm_state_t *state, c32_vm_t *vm, uint32_t load_addr,
+                           const char *source, uint32_t length);
+
+/**
+ * @brief Write the symbol table as a text symbol map
+ *
+ * One line per defined label, sorted by address: the absolute address
+ * (label offset + load address, the address J/JAL use) in hex and
+ * the label name. Lines starting with '#' are comments.
+ *
+ * @param state Pointer to assembler state after a successful assembly
+ * @param map_file Path to output map file
+ * @return 0 on success, -1 on error
+ */
+int c32_asm_write_map(const c32_asm_state_t *state, const char *map_file);
+
 /**
  * @brief Assemble a single line
  *
@@ -177,19 +463,22 @@ int c32_asm_assemble_line(c32_asm_state_t *state, const char *line, int line_num
  * @brief Add symbol to symbol table
  *
  * Adds a new symbol (label) to the symbol table with the specified address.
- * If the symbol already exists, returns an error.
+ * If the symbol already exists, returns an error. The name is copied, so
+ * the caller's string need not outlive the call.
  *
  * @param state Pointer to assembler state
  * @param name Symbol name (label)
  * @param address Address associated with symbol
- * @return Symbol index on success, -1 on error (duplicate or table full)
+ * @return Symbol index on success, -1 for a missing, empty or too long
+ *         name, -2 for a duplicate, -3 if the table (or arena) is full
  */
 int c32_asm_add_symbol(c32_asm_state_t *state, const char *name, uint32_t address);
 
 /**
  * @brief Find symbol in symbol table
  *
- * Searches the symbol table for a symbol with the given name.
+ * Looks up a symbol by name through the hash index; the cost does not
+ * depend on the number of symbols.
  *
  * @param state Pointer to assembler state
  * @param name Symbol name to search for
@@ -197,6 +486,29 @@ int c32_asm_add_symbol(c32_asm_state_t *state, const char *name, uint32_t addres
  */
 int c32_asm_find_symbol(c32_asm_state_t *state, const char *name);
 
+/**
+ * @brief Find a symbol, entering it as undefined if it is new
+ *
+ * Used for forward references in single-pass mode. A later
+ * c32_asm_add_symbol() of the same name defines the entry.
+ *
+ * @param state Pointer to assembler state
+ * @param name Symbol name
+ * @return Symbol index, -1 for a bad name, -3 if the table is full
+ */
+int c32_asm_reference_symbol(c32_asm_state_t *state, const char *name);
+
+/**
+ * @brief Record a forward reference to patch in c32_asm_finish()
+ *
+ * @param state Pointer to assembler state
+ * @param symbol Index of the referenced symbol
+ * @param address Address of the referring instruction
+ * @param kind C32_FIXUP_BRANCH or C32_FIXUP_JUMP
+ * @return 0 on success, -1 if the fixup table (or arena) is full
+ */
+int c32_asm_add_fixup(c32_asm_state_t *state, int symbol, uint32_t address, int kind);
+
 /** @} */ /* end of asm_symbols */
 
 /**
@@ -221,6 +533,20 @@ int c32_asm_find_symbol(c32_asm_state_t *state, const char *name);
  */
 void c32_encode_instruction(uint8_t *output, const c32_instruction_t *inst);
 
+/**
+ * @brief Look up an instruction by mnemonic
+ *
+ * Hashes the mnemonic into a constant slot table that c32ophash generates
+ * from C32_INSTRUCTIONS, with a seed chosen so every mnemonic has a slot of
+ * its own, then confirms the one candidate with a single comparison.
+ * Nothing is built at run time, so lookups are safe from any thread.
+ * Mnemonics are case-sensitive (upper case).
+ *
+ * @param mnemonic Mnemonic to look up
+ * @return Table entry, or NULL for an unknown mnemonic
+ */
+const c32_op_info_t *c32_asm_lookup_op(const char *mnemonic);
+
 /** @} */ /* end of asm_encoding */
 
 /**
@@ -0,0 +1,132 @@
+/**
+ * @file c32_checkpoint.h
+ * @brief CRISP-32 Incremental Checkpoints
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef C32_CHECKPOINT_H
+#define C32_CHECKPOINT_H
+
+#include "c32_vm.h"
+
+/**
+ * @defgroup checkpoint Incremental Checkpoints
+ * @brief Portable VM checkpoints holding only the pages written since the last one
+ *
+ * A full checkpoint holds every page of guest memory; an incremental one
+ * holds the pages set in the VM's dirty map (see vm_dirty), so its cost
+ * follows the guest's write rate rather than its memory size. Loading a
+ * full checkpoint and then each later incremental one in order rebuilds
+ * the VM as it was at the last. Every checkpoint also carries the
+ * complete architectural state, so the same stream drives pre-copy live
+ * migration: send a full checkpoint and incremental ones while the guest
+ * keeps running, then stop it and send a final, small one.
+ *
+ * Stream format (all fields little-endian, independent of the host): a
+ * C32_CHECKPOINT_HEADER_SIZE byte header (magic "C32CHKPT", format
+ * version, guest memory size, flags), C32_CHECKPOINT_STATE_SIZE bytes of
+ * architectural state (registers, PC, running flag, privilege and paging
+ * state, interrupt state and shadow register banks, timer), then page records (a page number
+ * followed by the page; the last page of memory may be short) ended by
+ * C32_CHECKPOINT_END. Caches and host attachments are not saved.
+ *
+ * Bytes move through caller-supplied callbacks (a file, a socket, or a
+ * memory buffer). Freestanding: no libc.
+ * @{
+ */
+
+/** @brief Stream magic (first 8 bytes) */
+#define C32_CHECKPOINT_MAGIC "C32CHKPT"
+
+/** @brief Stream format version */
+#define C32_CHECKPOINT_VERSION 2
+
+/** @brief Size of the stream header in bytes */
+#define C32_CHECKPOINT_HEADER_SIZE 20
+
+/** @brief Size of the architectural state record in bytes (55 words, 33 per shadow bank) */
+#define C32_CHECKPOINT_STATE_SIZE (4 * (55 + 33 * C32_SHADOW_BANKS))
+
+/** @brief Header flag: the checkpoint holds every page */
+#define C32_CHECKPOINT_FULL 1
+
+/** @brief Page number that ends the page records */
+#define C32_CHECKPOINT_END 0xFFFFFFFFUL
+
+/**
+ * @brief Output callback
+ *
+ * @param ctx Context pointer given to c32_checkpoint_save()
+ * @param data Bytes to write
+ * @param size Number of bytes
+ * @return 0 if all bytes were written, -1 on error
+ */
+typedef int (*c32_checkpoint_write_t)(void *ctx, const uint8_t *data, uint32_t size);
+
+/**
+ * @brief Input callback
+ *
+ * @param ctx Context pointer given to c32_checkpoint_load()
+ * @param data Receives the bytes
+ * @param size Number of bytes
+ * @return 0 if all bytes were read, -1 on error or end of input
+ */
+typedef int (*c32_checkpoint_read_t)(void *ctx, uint8_t *data, uint32_t size);
+
+/**
+ * @brief Write a checkpoint and clear the dirty map
+ *
+ * Call between run slices. A full checkpoint needs no dirty map; an
+ * incremental one needs the map attached since the previous checkpoint.
+ * If the output fails, every page is marked dirty so that the next
+ * incremental checkpoint resends everything.
+ *
+ * @param vm Pointer to VM structure
+ * @param full 1 for a full checkpoint, 0 for the dirty pages only
+ * @param write Output callback
+ * @param ctx Context pointer passed to write
+ * @param pages If non-NULL, receives the number of pages written
+ * @return 0 on success, -1 on output error or if an incremental
+ *         checkpoint is requested without a dirty map
+ */
+int c32_checkpoint_save(c32_vm_t *vm, int full, c32_checkpoint_write_t write, void *ctx,
+                        uint32_t *pages);
+
+/**
+ * @brief Apply a checkpoint to a VM
+ *
+ * vm must have been set up with c32_vm_init() over memory of the size
+ * the checkpoint was taken with; its host attachments are kept, and the
+ * loaded pages are reported through c32_vm_host_write(). The state is
+ * applied only once the whole stream has been read, but a stream that
+ * fails part way leaves guest memory partly updated: load a full
+ * checkpoint before using the VM.
+ *
+ * @param vm Pointer to VM structure
+ * @param read Input callback
+ * @param ctx Context pointer passed to read
+ * @param pages If non-NULL, receives the number of pages loaded
+ * @return 0 on success, -1 on input error, bad header, memory size
+ *         mismatch or page number outside memory
+ */
+int c32_checkpoint_load(c32_vm_t *vm, c32_checkpoint_read_t read, void *ctx,
+                        uint32_t *pages);
+
+/** @} */ /* end of checkpoint */
+
+#endif /* C32_CHECKPOINT_H */
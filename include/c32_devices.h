@@ -0,0 +1,198 @@
+/**
+ * @file c32_devices.h
+ * @brief CRISP-32 Host Console and Block Devices (POSIX hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef C32_DEVICES_H
+#define C32_DEVICES_H
+
+#include "c32_vm.h"
+
+/**
+ * @defgroup devices Host Devices
+ * @brief Console and block device models for the MMIO bus
+ *
+ * Both devices are serviced inside the guest's load or store: console
+ * output goes to a host file descriptor and a block transfer completes
+ * before the store to the command register retires, so a guest doing
+ * I/O never stops the VM or round-trips through the host's run loop.
+ * Each device fills in a c32_device_t for c32_vm_set_devices(). All
+ * registers are 32 bits wide at word-aligned offsets.
+ *
+ * This module is hosted (POSIX file descriptors) and not part of the
+ * freestanding core.
+ * @{
+ */
+
+/** @brief Physical base crisp32 maps the console at */
+#define C32_CONSOLE_BASE 0xF0000000UL
+
+/** @brief Physical base crisp32 maps the block device at */
+#define C32_BLOCKDEV_BASE 0xF0001000UL
+
+/** @brief Console register: write sends a byte, read returns the next input byte */
+#define C32_CONSOLE_DATA 0x00
+
+/** @brief Console register: bit 0 = input available without blocking */
+#define C32_CONSOLE_STATUS 0x04
+
+/** @brief Console register window size */
+#define C32_CONSOLE_SIZE 0x08
+
+/** @brief Console DATA value at end of input */
+#define C32_CONSOLE_EOF 0xFFFFFFFFUL
+
+/** @brief Console output bytes buffered before a host write */
+#define C32_CONSOLE_BUFFER 256
+
+/** @brief Block device register: first sector of the transfer */
+#define C32_BLOCKDEV_SECTOR 0x00
+
+/** @brief Block device register: guest physical address of the buffer */
+#define C32_BLOCKDEV_BUFFER 0x04
+
+/** @brief Block device register: number of sectors to transfer */
+#define C32_BLOCKDEV_COUNT 0x08
+
+/** @brief Block device register: writing a command runs the transfer */
+#define C32_BLOCKDEV_COMMAND 0x0C
+
+/** @brief Block device register: result of the last command */
+#define C32_BLOCKDEV_STATUS 0x10
+
+/** @brief Block device register: disk size in sectors (read-only) */
+#define C32_BLOCKDEV_CAPACITY 0x14
+
+/** @brief Block device register window size */
+#define C32_BLOCKDEV_SIZE 0x18
+
+/** @brief Block device sector size in bytes */
+#define C32_BLOCKDEV_SECTOR_SIZE 512
+
+/** @brief Command: copy sectors from the disk into guest memory */
+#define C32_BLOCKDEV_CMD_READ 1
+
+/** @brief Command: copy guest memory to sectors on the disk */
+#define C32_BLOCKDEV_CMD_WRITE 2
+
+/** @brief Status: last command completed */
+#define C32_BLOCKDEV_OK 0
+
+/** @brief Status: bad command, range outside the disk or RAM, or host error */
+#define C32_BLOCKDEV_ERROR 1
+
+/**
+ * @brief Console state
+ */
+typedef struct {
+    /** Host descriptor read for input */
+    int in_fd;
+
+    /** Host descriptor written for output */
+    int out_fd;
+
+    /** Bytes waiting in out */
+    uint32_t used;
+
+    /** Output buffer, written on newline, when full, and on flush */
+    uint8_t out[C32_CONSOLE_BUFFER];
+} c32_console_t;
+
+/**
+ * @brief Block device state
+ */
+typedef struct {
+    /** Host descriptor of the disk image (-1 = closed) */
+    int fd;
+
+    /** 1 if the image was opened for writing */
+    int writable;
+
+    /** Disk size in whole sectors */
+    uint32_t capacity;
+
+    /** SECTOR register */
+    uint32_t sector;
+
+    /** BUFFER register */
+    uint32_t buffer;
+
+    /** COUNT register */
+    uint32_t count;
+
+    /** STATUS register */
+    uint32_t status;
+} c32_blockdev_t;
+
+/**
+ * @brief Initialize a console
+ *
+ * @param con Console state
+ * @param in_fd Host descriptor for input
+ * @param out_fd Host descriptor for output
+ */
+void c32_console_init(c32_console_t *con, int in_fd, int out_fd);
+
+/**
+ * @brief Write buffered console output to the host
+ *
+ * @param con Console state
+ */
+void c32_console_flush(c32_console_t *con);
+
+/**
+ * @brief Describe a console as an MMIO device
+ *
+ * @param dev Device entry to fill in
+ * @param base Physical base address
+ * @param con Console state
+ */
+void c32_console_device(c32_device_t *dev, uint32_t base, c32_console_t *con);
+
+/**
+ * @brief Open a disk image
+ *
+ * The capacity is the image size rounded down to whole sectors.
+ *
+ * @param blk Block device state
+ * @param filename Disk image
+ * @param writable 1 to allow C32_BLOCKDEV_CMD_WRITE
+ * @return 0 on success, -1 on host error
+ */
+int c32_blockdev_open(c32_blockdev_t *blk, const char *filename, int writable);
+
+/**
+ * @brief Close a disk image
+ *
+ * @param blk Block device state
+ */
+void c32_blockdev_close(c32_blockdev_t *blk);
+
+/**
+ * @brief Describe a block device as an MMIO device
+ *
+ * @param dev Device entry to fill in
+ * @param base Physical base address
+ * @param blk Block device state
+ */
+void c32_blockdev_device(c32_device_t *dev, uint32_t base, c32_blockdev_t *blk);
+
+/** @} */ /* end of devices */
+
+#endif /* C32_DEVICES_H */
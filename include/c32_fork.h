@@ -0,0 +1,108 @@
+/**
+ * @file c32_fork.h
+ * @brief CRISP-32 Copy-on-Write VM Fork API (POSIX hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef C32_FORK_H
+#define C32_FORK_H
+
+#include "c32_vm.h"
+
+/**
+ * @defgroup fork Copy-on-Write Fork
+ * @brief Cheap VM clones that share unmodified guest memory
+ *
+ * A fork base is a snapshot whose memory image lives in an unlinked
+ * temporary file mapped read-only. Each clone maps the same file
+ * privately, so the host kernel shares every page until the clone writes
+ * it and then copies just that page. With 4KB host pages the copy unit is
+ * the guest's own page size. Resetting a clone remaps the file over its
+ * memory, discarding the private pages, which makes starting the next
+ * job on the same clone cost microseconds regardless of guest size.
+ *
+ * This module is hosted (mmap, temporary files) and not part of the
+ * freestanding core. A base is read-only after c32_fork_base_init(), so
+ * clones may be created from several threads at once.
+ * @{
+ */
+
+/**
+ * @brief Shared, read-only parent of copy-on-write clones
+ */
+typedef struct {
+    /** Snapshot; snap.image is the read-only shared mapping */
+    c32_snapshot_t snap;
+
+    /** Descriptor of the unlinked file holding the image */
+    int fd;
+
+    /** Mapping size (guest memory size rounded up to host pages) */
+    unsigned long map_size;
+} c32_fork_base_t;
+
+/**
+ * @brief Snapshot a VM into a fork base
+ *
+ * @param base Fork base to initialize
+ * @param vm VM to capture
+ * @return 0 on success, -1 on host error
+ */
+int c32_fork_base_init(c32_fork_base_t *base, const c32_vm_t *vm);
+
+/**
+ * @brief Release a fork base
+ *
+ * Clones that still exist keep their mappings and stay valid.
+ *
+ * @param base Fork base
+ */
+void c32_fork_base_destroy(c32_fork_base_t *base);
+
+/**
+ * @brief Create a copy-on-write clone
+ *
+ * vm must have been set up with c32_vm_init() (its memory may be NULL);
+ * host attachments such as the decoded instruction cache are kept.
+ *
+ * @param base Fork base
+ * @param vm VM to turn into a clone
+ * @return 0 on success, -1 on host error
+ */
+int c32_fork_clone(const c32_fork_base_t *base, c32_vm_t *vm);
+
+/**
+ * @brief Return a clone to the base state, dropping its private pages
+ *
+ * @param base Fork base the clone was created from
+ * @param vm Clone
+ * @return 0 on success, -1 on host error
+ */
+int c32_fork_reset(const c32_fork_base_t *base, c32_vm_t *vm);
+
+/**
+ * @brief Unmap a clone's memory
+ *
+ * @param base Fork base the clone was created from
+ * @param vm Clone (left halted with no memory)
+ */
+void c32_fork_release(const c32_fork_base_t *base, c32_vm_t *vm);
+
+/** @} */ /* end of fork */
+
+#endif /* C32_FORK_H */
@@ -0,0 +1,85 @@
+/**
+ * @file c32_hostmem.h
+ * @brief CRISP-32 Host Guest-Memory Allocation (POSIX hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef C32_HOSTMEM_H
+#define C32_HOSTMEM_H
+
+#include "c32_vm.h"
+
+/**
+ * @defgroup hostmem Sparse Guest Memory
+ * @brief Reserve large guest memories and map program images into them
+ *
+ * Guest memory is reserved as anonymous host address space without
+ * committing it: the host kernel supplies a zeroed page the first time
+ * the guest (or the host) touches it, so a 1GB guest that uses a few
+ * megabytes costs a few megabytes. Program images are mapped privately
+ * from their file when the load address is host-page aligned, so a large
+ * image is paged in on demand instead of being read up front, and guest
+ * writes to it never reach the file.
+ *
+ * The VM core sees an ordinary memory/memory_size pair and its bounds
+ * checks are unchanged. This module is hosted (mmap) and not part of the
+ * freestanding core.
+ * @{
+ */
+
+/** @brief Largest supported guest memory (2GB, keeps address + size in range) */
+#define C32_HOSTMEM_MAX_SIZE 0x80000000UL
+
+/**
+ * @brief Reserve zero-filled guest memory
+ *
+ * @param size Guest memory size in bytes (1 to C32_HOSTMEM_MAX_SIZE)
+ * @return Base of the reservation, or NULL on host error
+ */
+uint8_t *c32_hostmem_reserve(uint32_t size);
+
+/**
+ * @brief Release memory from c32_hostmem_reserve()
+ *
+ * Also releases any image mapped into it.
+ *
+ * @param memory Base of the reservation
+ * @param size Size passed to c32_hostmem_reserve()
+ */
+void c32_hostmem_release(uint8_t *memory, uint32_t size);
+
+/**
+ * @brief Load a program image file into reserved guest memory
+ *
+ * Maps the file copy-on-write at memory + load_addr if that address is
+ * host-page aligned; otherwise reads it. Images longer than the space
+ * above load_addr are truncated.
+ *
+ * @param memory Base of the reservation
+ * @param memory_size Guest memory size
+ * @param load_addr Guest physical address of the first image byte
+ * @param filename Image file
+ * @param loaded Receives the number of image bytes placed in memory
+ * @return 1 if mapped, 0 if read, -1 on host error or bad load address
+ */
+int c32_hostmem_load_image(uint8_t *memory, uint32_t memory_size, uint32_t load_addr,
+                           const char *filename, uint32_t *loaded);
+
+/** @} */ /* end of hostmem */
+
+#endif /* C32_HOSTMEM_H */
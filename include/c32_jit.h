@@ -0,0 +1,197 @@
+/**
+ * @file c32_jit.h
+ * @brief CRISP-32 Dynamic Binary Translator (JIT) API
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef C32_JIT_H
+#define C32_JIT_H
+
+#include "c32_vm.h"
+
+/**
+ * @defgroup jit Dynamic Binary Translator
+ * @brief Optional hosted engine that compiles guest basic blocks
+ *
+ * The JIT is a separate, hosted module layered on top of the freestanding
+ * core: it needs executable memory from the host OS and is only built by
+ * the `jit` make targets. Guest basic blocks are translated to host code
+ * and chained directly to each other; anything the translator does not
+ * handle (system, interrupt, privileged and MMU instructions, paged user
+ * mode, pending interrupts) is executed by the interpreter through
+ * c32_vm_run_for(), so exit reasons and interrupt timing match the
+ * interpreter exactly at block boundaries.
+ *
+ * Code generators exist for x86-64 and AArch64 hosts. On other hosts
+ * c32_jit_init() fails and callers fall back to the interpreter.
+ * @{
+ */
+
+/** @brief Size of the executable code buffer in bytes */
+#define C32_JIT_CODE_SIZE (4 * 1024 * 1024)
+
+/** @brief Maximum number of translated blocks between flushes */
+#define C32_JIT_MAX_BLOCKS 16384
+
+/** @brief Entries in the guest PC to block lookup table (power of two) */
+#define C32_JIT_MAP_ENTRIES 16384
+
+/** @brief Maximum number of patchable chain exits between flushes */
+#define C32_JIT_MAX_SLOTS 32768
+
+/** @brief Maximum guest instructions per block */
+#define C32_JIT_MAX_BLOCK_INSNS 64
+
+/** @brief log2 of the self-modifying code detection granule in bytes */
+#define C32_JIT_WATCH_SHIFT 8
+
+/**
+ * @brief Translated block descriptor
+ */
+typedef struct {
+    /** Guest physical address of the first instruction */
+    uint32_t pc;
+
+    /** Guest physical address just past the last instruction */
+    uint32_t end;
+
+    /** Host entry point, or NULL if the first instruction is interpreted */
+    uint8_t *code;
+} c32_jit_block_t;
+
+/**
+ * @brief Patchable direct jump from one block to another
+ */
+typedef struct {
+    /** Address of the jump (its rel32 field on x86-64, the B on AArch64) */
+    uint8_t *site;
+
+    /** Guest physical address the jump leads to */
+    uint32_t target;
+} c32_jit_slot_t;
+
+/**
+ * @brief JIT state
+ *
+ * Large; hosts normally give it static storage. Bound to one VM and its
+ * guest memory by c32_jit_init().
+ */
+typedef struct {
+    /** VM being translated */
+    c32_vm_t *vm;
+
+    /** Executable code buffer (mapped by c32_jit_init) */
+    uint8_t *code;
+
+    /** Bytes of code buffer in use */
+    uint32_t code_used;
+
+    /** Bytes of code buffer taken by the shared entry/exit stubs */
+    uint32_t code_base;
+
+    /** Shared exit stub all blocks return through */
+    uint8_t *exit_stub;
+
+    /** Self-modifying code watch map, one byte per granule */
+    uint8_t *watch;
+
+    /** Number of granules in watch map */
+    uint32_t watch_size;
+
+    /** 1 if the translated stores mark the VM's dirty map */
+    int dirty;
+
+    /** Translated blocks */
+    c32_jit_block_t blocks[C32_JIT_MAX_BLOCKS];
+
+    /** Number of entries used in blocks */
+    uint32_t num_blocks;
+
+    /** Guest PC lookup: block index + 1, or 0 if empty */
+    uint32_t map[C32_JIT_MAP_ENTRIES];
+
+    /** Chain exits */
+    c32_jit_slot_t slots[C32_JIT_MAX_SLOTS];
+
+    /** Number of entries used in slots */
+    uint32_t num_slots;
+
+    /** Statistics: blocks translated since init */
+    uint32_t stat_blocks;
+
+    /** Statistics: chain exits patched since init */
+    uint32_t stat_chains;
+
+    /** Statistics: full flushes since init */
+    uint32_t stat_flushes;
+} c32_jit_t;
+
+/**
+ * @brief Attach a JIT to a VM
+ *
+ * Maps the code buffer and watch map, registers the watch map with the
+ * VM, and detaches the VM's decoded instruction cache (translated stores
+ * do not maintain it).
+ *
+ * @param jit Pointer to JIT state
+ * @param vm Pointer to initialized VM
+ * @return 0 on success, -1 if the host has no code generator or no
+ *         executable memory is available
+ */
+int c32_jit_init(c32_jit_t *jit, c32_vm_t *vm);
+
+/**
+ * @brief Release the JIT's host resources and detach it from the VM
+ *
+ * @param jit Pointer to JIT state
+ */
+void c32_jit_destroy(c32_jit_t *jit);
+
+/**
+ * @brief Run VM for at most budget instructions using translated code
+ *
+ * Same contract as c32_vm_run_for().
+ *
+ * @param jit Pointer to JIT state
+ * @param budget Maximum number of instructions to execute
+ * @param executed If non-NULL, receives the number of instructions retired
+ * @return Why execution stopped
+ */
+c32_exit_reason_t c32_jit_run_for(c32_jit_t *jit, uint32_t budget, uint32_t *executed);
+
+/**
+ * @brief Discard translations overlapping a physical range
+ *
+ * Must be called after the host modifies guest code directly.
+ *
+ * @param jit Pointer to JIT state
+ * @param phys_addr Physical start address of modified range
+ * @param size Size of modified range in bytes
+ */
+void c32_jit_invalidate(c32_jit_t *jit, uint32_t phys_addr, uint32_t size);
+
+/**
+ * @brief Discard all translations
+ *
+ * @param jit Pointer to JIT state
+ */
+void c32_jit_flush(c32_jit_t *jit);
+
+/** @} */ /* end of jit */
+
+#endif /* C32_JIT_H */
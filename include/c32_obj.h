@@ -0,0 +1,146 @@
+/**
+ * @file c32_obj.h
+ * @brief CRISP-32 Relocatable Objects and Linker
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef C32_OBJ_H
+#define C32_OBJ_H
+
+#include "c32_asm.h"
+
+/**
+ * @defgroup object Relocatable Objects
+ * @brief Separate compilation: object files and the linker
+ *
+ * `c32asm -c` writes a relocatable object instead of a flat image: the
+ * .text section (code, assembled at offset 0), the size of the .bss
+ * section (which takes no space in the file), a symbol table and a
+ * relocation table. Every label is in the symbol table; `.global` makes
+ * it visible to other objects, and a label that is referenced but not
+ * defined is imported. Branches within .text are resolved by the
+ * assembler; J/JAL targets, %hi()/%lo() operands (for LUI/ORI pairs) and
+ * branches to other objects become relocations.
+ *
+ * c32_link() places the .text sections of its inputs one after another,
+ * then their .bss sections, resolves the relocations and produces a flat
+ * image of the .text sections only. It defines `__bss_start` and
+ * `__bss_end`, so a guest that cannot rely on zeroed memory can clear
+ * .bss itself.
+ *
+ * Object format (all fields little-endian 32-bit words): a
+ * C32_OBJ_HEADER_SIZE byte header (magic "C32OBJ\0\0", version,
+ * .text size, .bss size, symbol count, relocation count, string table
+ * size), the .text bytes, symbol entries (name offset, value, section,
+ * binding), relocation entries (.text offset of the instruction, type,
+ * symbol index) and the string table of NUL-terminated names.
+ *
+ * Freestanding: no libc. The linker uses an assembler state's symbol
+ * table for the global symbols, so after linking it holds the link map.
+ * @{
+ */
+
+/** @brief Object magic (first 8 bytes) */
+#define C32_OBJ_MAGIC "C32OBJ\0\0"
+
+/** @brief Object format version */
+#define C32_OBJ_VERSION 1
+
+/** @brief Size of the object header in bytes */
+#define C32_OBJ_HEADER_SIZE 32
+
+/** @brief Size of a symbol entry in bytes */
+#define C32_OBJ_SYMBOL_SIZE 16
+
+/** @brief Size of a relocation entry in bytes */
+#define C32_OBJ_RELOC_SIZE 12
+
+/** @brief Symbol bindings */
+#define C32_BIND_LOCAL  0       /**< Visible in its own object only */
+#define C32_BIND_GLOBAL 1       /**< Exported (or imported, if undefined) */
+
+/**
+ * @brief Relocation types (same values as the fixup kinds)
+ *
+ * S is the symbol's absolute address and P the instruction's.
+ */
+#define C32_RELOC_BRANCH C32_FIXUP_BRANCH   /**< imm = S - (P + 8) */
+#define C32_RELOC_JUMP   C32_FIXUP_JUMP     /**< imm = S */
+#define C32_RELOC_HI16   C32_FIXUP_HI16     /**< imm = S >> 16 */
+#define C32_RELOC_LO16   C32_FIXUP_LO16     /**< imm = S & 0xFFFF */
+
+/** @brief Link error codes (c32_link_result_t::error) */
+#define C32_LINK_OK          0  /**< Success */
+#define C32_LINK_BAD_OBJECT  1  /**< Malformed or truncated object */
+#define C32_LINK_DUPLICATE   2  /**< Global symbol defined twice */
+#define C32_LINK_UNDEFINED   3  /**< Imported symbol defined nowhere */
+#define C32_LINK_NO_SPACE    4  /**< Image or symbol table does not fit */
+
+/**
+ * @brief Linker input: one object file in memory
+ */
+typedef struct {
+    const uint8_t *data;        /**< Object bytes */
+    uint32_t size;              /**< Size of data in bytes */
+} c32_link_input_t;
+
+/**
+ * @brief Linker output summary
+ */
+typedef struct {
+    uint32_t text_size;         /**< Bytes of image written */
+    uint32_t bss_start;         /**< Offset of .bss from the load address */
+    uint32_t bss_size;          /**< Bytes of .bss after the image */
+    int error;                  /**< C32_LINK_OK or an error code */
+    int error_object;           /**< Index of the failing input, or -1 */
+    const char *error_symbol;   /**< Symbol behind a DUPLICATE/UNDEFINED error, or NULL */
+} c32_link_result_t;
+
+/**
+ * @brief Write the assembled module as a relocatable object
+ *
+ * Call after assembling in object mode (state->object set before the
+ * single pass) and c32_asm_finish(). The .text bytes must still be in
+ * the output buffer (no output callback).
+ *
+ * @param state Pointer to assembler state
+ * @param write Output callback (offsets increase; see c32_asm_write_t)
+ * @param ctx Context pointer passed to write
+ * @return 0 on success, -1 if not in object mode, the code was streamed
+ *         or the callback failed
+ */
+int c32_asm_write_object(const c32_asm_state_t *state, c32_asm_write_t write, void *ctx);
+
+/**
+ * @brief Link objects into a flat image
+ *
+ * @param globals Initialized assembler state receiving the global symbols
+ *        (addresses relative to its load_address, which is the image's)
+ * @param inputs Objects, in link order
+ * @param count Number of objects
+ * @param output Buffer receiving the image
+ * @param capacity Size of output in bytes
+ * @param result Receives sizes, or the error and where it happened
+ * @return 0 on success, -1 on error
+ */
+int c32_link(c32_asm_state_t *globals, const c32_link_input_t *inputs, int count,
+             uint8_t *output, uint32_t capacity, c32_link_result_t *result);
+
+/** @} */ /* end of object */
+
+#endif /* C32_OBJ_H */
@@ -197,6 +197,15 @@
 /** @brief Store byte (mem[rs+offset] = rt[7:0]) */
 #define OP_SB           0x5A
 
+/** @brief Copy rt bytes from [rs] to [rd], advancing rd and rs and counting rt down */
+#define OP_MEMCPY       0x5C
+
+/** @brief Fill rt bytes at [rd] with rs[7:0], advancing rd and counting rt down */
+#define OP_MEMSET       0x5D
+
+/** @brief Compare rt bytes at [rd] and [rs], stopping at the first difference */
+#define OP_MEMCMP       0x5E
+
 /** @} */ /* end of opcode_memory */
 
 /**
@@ -297,6 +306,9 @@
 /** @brief Set page table base register (rd=base, rt=num_pages, privileged) */
 #define OP_SET_PTBR     0xF9
 
+/** @brief Program the instruction-count timer (period = rs, interrupt = imm, privileged) */
+#define OP_SET_TIMER    0xFA
+
 /** @brief Enter user mode (drop to user privilege, privileged) */
 #define OP_ENTER_USER   0xFB
 
@@ -305,6 +317,64 @@
 
 /** @} */ /* end of opcode_privilege */
 
+/**
+ * @defgroup opcode_table Instruction Table
+ * @brief One entry per instruction: mnemonic, opcode and operand format
+ *
+ * C32_INSTRUCTIONS(X) expands X(name, format) for every instruction, where
+ * OP_##name is the opcode and #name the mnemonic. The assembler's mnemonic
+ * lookup and operand encoder and c32trace's disassembler are generated from
+ * this list, so a new instruction needs its OP_ define above and one entry
+ * here.
+ * @{
+ */
+
+/** @brief Operand formats (assembly syntax shown for each) */
+typedef enum {
+    C32_FMT_NONE,       /**< SYSCALL */
+    C32_FMT_R,          /**< ADD rd, rs, rt */
+    C32_FMT_I,          /**< ADDI rt, rs, imm */
+    C32_FMT_LOGIC,      /**< ORI rt, rs, imm (disassembled in hex) */
+    C32_FMT_LUI,        /**< LUI rt, imm */
+    C32_FMT_SHIFT,      /**< SLL rd, rt, shamt */
+    C32_FMT_MEM,        /**< LW rt, rs, offset */
+    C32_FMT_BULK,       /**< MEMCPY rd, rs, rt (three distinct registers) */
+    C32_FMT_BRANCH2,    /**< BEQ rs, rt, target */
+    C32_FMT_BRANCH1,    /**< BLEZ rs, target */
+    C32_FMT_JUMP,       /**< J target */
+    C32_FMT_RS,         /**< JR rs */
+    C32_FMT_RD_RS,      /**< JALR rd, rs */
+    C32_FMT_RD,         /**< GETPC rd */
+    C32_FMT_RD_RT,      /**< SET_PTBR rd, rt */
+    C32_FMT_RS_IMM,     /**< SET_TIMER rs, imm */
+    C32_FMT_IMM         /**< RAISE imm */
+} c32_format_t;
+
+/** @brief Expand X(name, format) for every instruction */
+#define C32_INSTRUCTIONS(X) \
+    X(NOP, NONE) \
+    X(ADD, R) X(ADDU, R) X(SUB, R) X(SUBU, R) \
+    X(ADDI, I) X(ADDIU, I) \
+    X(MUL, R) X(MULH, R) X(MULHU, R) \
+    X(DIV, R) X(DIVU, R) X(REM, R) X(REMU, R) \
+    X(AND, R) X(OR, R) X(XOR, R) X(NOR, R) \
+    X(ANDI, LOGIC) X(ORI, LOGIC) X(XORI, LOGIC) X(LUI, LUI) \
+    X(SLL, SHIFT) X(SRL, SHIFT) X(SRA, SHIFT) \
+    X(SLLV, R) X(SRLV, R) X(SRAV, R) \
+    X(SLT, R) X(SLTU, R) X(SLTI, I) X(SLTIU, I) \
+    X(LW, MEM) X(LH, MEM) X(LHU, MEM) X(LB, MEM) X(LBU, MEM) \
+    X(SW, MEM) X(SH, MEM) X(SB, MEM) \
+    X(MEMCPY, BULK) X(MEMSET, BULK) X(MEMCMP, BULK) \
+    X(BEQ, BRANCH2) X(BNE, BRANCH2) \
+    X(BLEZ, BRANCH1) X(BGTZ, BRANCH1) X(BLTZ, BRANCH1) X(BGEZ, BRANCH1) \
+    X(J, JUMP) X(JAL, JUMP) X(JR, RS) X(JALR, RD_RS) \
+    X(SYSCALL, NONE) X(BREAK, NONE) \
+    X(EI, NONE) X(DI, NONE) X(IRET, NONE) X(RAISE, IMM) X(GETPC, RD) \
+    X(ENABLE_PAGING, NONE) X(DISABLE_PAGING, NONE) X(SET_PTBR, RD_RT) \
+    X(SET_TIMER, RS_IMM) X(ENTER_USER, NONE) X(GETMODE, RD)
+
+/** @} */ /* end of opcode_table */
+
 /** @} */ /* end of opcodes */
 
 #endif /* C32_OPCODES_H */
@@ -32,8 +32,9 @@
  * Provides a comprehensive testing framework for validating VM execution:
  * - Test case definitions with embedded programs
  * - Assertion macros for checking VM state
- * - Test runner with pass/fail reporting
+ * - Test runner with pass/fail reporting, wall time and step counts
  * - Test suite organization
+ * - Parallel runs across worker threads and repeated runs for timing
  * @{
  */
 
@@ -49,6 +50,15 @@
 /** @brief Default maximum execution steps (prevents infinite loops) */
 #define C32_TEST_DEFAULT_MAX_STEPS 1000
 
+/** @brief Decoded instruction cache entries used while running a test */
+#define C32_TEST_ICACHE_ENTRIES 256
+
+/** @brief VM memory per worker when c32_test_options_t::memory_size is 0 */
+#define C32_TEST_MEMORY_SIZE 65536
+
+/** @brief Upper bound on worker threads */
+#define C32_TEST_MAX_WORKERS 256
+
 /**
  * @brief Test result status codes
  */
@@ -93,6 +103,7 @@ typedef struct {
     uint32_t load_addr;         /**< Address to load program (default: 0x1000) */
     uint32_t max_steps;         /**< Maximum execution steps (default: 1000) */
     c32_test_fn_t test_fn;      /**< Test validation function */
+    int expect_fault;           /**< Nonzero if the program must stop on a fault */
 } c32_test_case_t;
 
 /**
@@ -105,8 +116,36 @@ typedef struct {
     int passed;     /**< Number of tests passed */
     int failed;     /**< Number of tests failed */
     int errors;     /**< Number of tests with errors */
+    double seconds; /**< Wall time of the whole suite */
 } c32_test_results_t;
 
+/**
+ * @brief Suite run options
+ *
+ * Test cases are handed to workers one at a time, so a validation
+ * function never runs concurrently with itself (its static data is safe)
+ * but may run alongside any other; with repeat, a validation must reset
+ * any static data it keeps. Every worker has its own VM memory,
+ * instruction cache and (with C32_USE_JIT) translator.
+ */
+typedef struct {
+    int workers;            /**< Worker threads (0 = online CPUs, 1 = calling thread) */
+    uint32_t repeat;        /**< Runs per test case, for timing (0 = 1) */
+    uint32_t memory_size;   /**< VM memory per worker (0 = C32_TEST_MEMORY_SIZE) */
+} c32_test_options_t;
+
+/**
+ * @brief Outcome and timing of one test case
+ */
+typedef struct {
+    c32_test_status_t status;           /**< Status of the last run */
+    uint32_t runs;                      /**< Runs made (stops at the first non-pass) */
+    uint32_t steps;                     /**< Instructions the program executed (last run) */
+    double seconds;                     /**< Wall time of all runs */
+    double min_seconds;                 /**< Wall time of the fastest run */
+    char failure_msg[C32_TEST_MAX_MSG]; /**< Assertion message, or empty */
+} c32_test_report_t;
+
 /* ========================================================================
  * Assertion Macros
  * ======================================================================== */
@@ -274,6 +313,25 @@ void c32_run_test_suite(const c32_test_case_t *tests,
                         int test_count,
                         c32_test_results_t *results);
 
+/**
+ * @brief Run a suite of test cases with options
+ *
+ * Like c32_run_test_suite(), but can spread the cases over worker threads
+ * and run each case several times. Reports are printed in suite order
+ * once all cases have run (as each finishes with a single worker), so
+ * output never interleaves. Requires a hosted POSIX environment.
+ *
+ * @param tests Array of test cases
+ * @param test_count Number of test cases in array
+ * @param options Run options, or NULL for one run on the calling thread
+ * @param results Pointer to results structure to populate
+ * @return 0 on success, -1 if worker memory could not be allocated
+ */
+int c32_run_test_suite_opts(const c32_test_case_t *tests,
+                            int test_count,
+                            const c32_test_options_t *options,
+                            c32_test_results_t *results);
+
 /**
  * @brief Initialize test results structure
  *
@@ -0,0 +1,99 @@
+/**
+ * @file c32_trace_writer.h
+ * @brief CRISP-32 Streaming Trace Writer (POSIX hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef C32_TRACE_WRITER_H
+#define C32_TRACE_WRITER_H
+
+#include "c32_vm.h"
+
+/**
+ * @defgroup trace_writer Streaming Trace Writer
+ * @brief Drains an execution trace ring to a file on a background thread
+ *
+ * The VM thread calls c32_trace_writer_drain() between run slices. It
+ * only copies pending records into the current chunk buffer; a full
+ * chunk is handed to a writer thread, which writes it while the VM keeps
+ * running and fills the other buffer. The VM thread waits only if it
+ * fills a chunk before the previous one is on disk.
+ *
+ * File format (all fields little-endian): a 16-byte header holding the
+ * magic "C32TRACE", the format version and the record size, followed by
+ * fixed-size records: pc, the opcode, rs, rt and rd bytes, imm, and the
+ * effective load/store address. bin/c32trace prints a file as
+ * disassembly.
+ *
+ * This module is hosted (stdio, POSIX threads) and not part of the
+ * freestanding core.
+ * @{
+ */
+
+/** @brief File magic (first 8 bytes) */
+#define C32_TRACE_MAGIC "C32TRACE"
+
+/** @brief File format version */
+#define C32_TRACE_VERSION 1
+
+/** @brief Size of the file header in bytes */
+#define C32_TRACE_HEADER_SIZE 16
+
+/** @brief Size of one record in the file in bytes */
+#define C32_TRACE_RECORD_SIZE 16
+
+/** @brief Default chunk size in records (1MB per buffer) */
+#define C32_TRACE_DEFAULT_CHUNK 65536
+
+/**
+ * @brief Streaming trace writer (opaque)
+ */
+typedef struct c32_trace_writer c32_trace_writer_t;
+
+/**
+ * @brief Create a trace file and start its writer thread
+ *
+ * @param filename Output path
+ * @param chunk_records Records per chunk buffer (0 selects the default)
+ * @return Writer, or NULL on host error
+ */
+c32_trace_writer_t *c32_trace_writer_open(const char *filename, uint32_t chunk_records);
+
+/**
+ * @brief Move every pending record from a ring into the writer
+ *
+ * @param writer Writer
+ * @param trace Ring to drain
+ * @return 0 on success, -1 if a write has failed
+ */
+int c32_trace_writer_drain(c32_trace_writer_t *writer, c32_trace_t *trace);
+
+/**
+ * @brief Drain a ring one last time, finish the file and free the writer
+ *
+ * @param writer Writer
+ * @param trace Ring to drain, or NULL
+ * @param records If non-NULL, receives the number of records written
+ * @return 0 on success, -1 if any write failed
+ */
+int c32_trace_writer_close(c32_trace_writer_t *writer, c32_trace_t *trace,
+                           unsigned long *records);
+
+/** @} */ /* end of trace_writer */
+
+#endif /* C32_TRACE_WRITER_H */
@@ -34,13 +34,389 @@
  * @{
  */
 
+/**
+ * @brief Tag marking an empty decoded-instruction cache entry
+ *
+ * The last entry of a cache uses C32_ICACHE_INVALID - 8 instead, so that
+ * no PC, 0xFFFFFFFF included, matches an empty entry.
+ */
+#define C32_ICACHE_INVALID 0xFFFFFFFF
+
+/**
+ * @brief Decoded instruction cache entry
+ *
+ * Holds one pre-split instruction keyed by its physical PC so that
+ * repeated execution skips the fetch and field extraction.
+ */
+typedef struct {
+    /** Physical PC of the cached instruction (C32_ICACHE_INVALID if empty) */
+    uint32_t tag;
+
+    /** 32-bit immediate value */
+    uint32_t imm;
+
+    /** Raw opcode byte */
+    uint8_t opcode;
+
+    /** Source register 1 */
+    uint8_t rs;
+
+    /** Source register 2 or target for immediates */
+    uint8_t rt;
+
+    /** Destination register */
+    uint8_t rd;
+
+    /** Dispatch handler index (the opcode for plain instructions) */
+    uint8_t handler;
+} c32_icache_entry_t;
+
+/**
+ * @brief Instruction pairs fused into one handler by the decoded cache
+ *
+ * Used as indices into c32_vm_t::fusion_hits.
+ */
+typedef enum {
+    /** LUI rX; ORI rY, rX, imm (32-bit constant) */
+    C32_FUSE_LUI_ORI = 0,
+
+    /** SLT rX, ...; BEQ on rX */
+    C32_FUSE_SLT_BEQ = 1,
+
+    /** SLT rX, ...; BNE on rX */
+    C32_FUSE_SLT_BNE = 2,
+
+    /** SLTU rX, ...; BEQ on rX */
+    C32_FUSE_SLTU_BEQ = 3,
+
+    /** SLTU rX, ...; BNE on rX */
+    C32_FUSE_SLTU_BNE = 4,
+
+    /** ADDI/ADDIU rX, ...; BEQ on rX (loop counter) */
+    C32_FUSE_ADDI_BEQ = 5,
+
+    /** ADDI/ADDIU rX, ...; BNE on rX (loop counter) */
+    C32_FUSE_ADDI_BNE = 6,
+
+    /** Number of fusion kinds */
+    C32_FUSE_COUNT = 7
+} c32_fusion_t;
+
+/**
+ * @brief Page fault causes, in the order translation checks them
+ *
+ * Used as indices into c32_stats_t::page_faults.
+ */
+typedef enum {
+    /** Virtual page number (or directory index) beyond num_pages */
+    C32_PF_BOUNDS = 0,
+
+    /** Page table or directory entry lies outside guest memory */
+    C32_PF_TABLE = 1,
+
+    /** Valid bit clear (in the PTE or a non-leaf directory entry) */
+    C32_PF_INVALID = 2,
+
+    /** User bit clear */
+    C32_PF_USER = 3,
+
+    /** Store to a page without the W bit */
+    C32_PF_WRITE = 4,
+
+    /** Fetch from a page without the X bit */
+    C32_PF_EXEC = 5,
+
+    /** Number of page fault causes */
+    C32_PF_COUNT = 6
+} c32_fault_cause_t;
+
+/**
+ * @brief Execution counters
+ *
+ * Maintained by the interpreter when the core is built with
+ * C32_ENABLE_STATS (`make STATS=1`); without it the increments compile
+ * to nothing and c32_vm_t has no counters. Counters are 32 bits and wrap,
+ * except the retired instruction count which carries into a high word.
+ */
+typedef struct {
+    /** Instructions retired (low 32 bits) */
+    uint32_t instructions;
+
+    /** Instructions retired (high 32 bits) */
+    uint32_t instructions_hi;
+
+    /** Instructions executed per opcode */
+    uint32_t opcodes[256];
+
+    /** Instructions decoded from guest memory (decoded cache misses) */
+    uint32_t decodes;
+
+    /** Data loads executed (LW, LH, LHU, LB, LBU) */
+    uint32_t loads;
+
+    /** Data stores executed (SW, SH, SB) */
+    uint32_t stores;
+
+    /** Conditional branches taken */
+    uint32_t branches_taken;
+
+    /** Conditional branches not taken */
+    uint32_t branches_not_taken;
+
+    /** Page table walks (software TLB misses in paged user mode) */
+    uint32_t translations;
+
+    /** Page faults raised, indexed by c32_fault_cause_t */
+    uint32_t page_faults[C32_PF_COUNT];
+
+    /** Interrupts dispatched to a guest handler */
+    uint32_t interrupts;
+
+    /** IRET instructions completed in kernel mode */
+    uint32_t irets;
+
+    /** Interrupt entries that saved R0-R31 to guest memory (not a shadow bank) */
+    uint32_t spills;
+} c32_stats_t;
+
+/**
+ * @brief PC profile: sample and call histograms over a range of code
+ *
+ * Bucket i covers PCs base + (i << shift) up to the next bucket; a shift
+ * of 3 gives one bucket per instruction. Buffers are caller-supplied.
+ */
+typedef struct {
+    /** PC sample counters, num_buckets entries */
+    uint32_t *samples;
+
+    /** JAL/JALR target counters, num_buckets entries (NULL = not counted) */
+    uint32_t *calls;
+
+    /** Number of buckets in each histogram */
+    uint32_t num_buckets;
+
+    /** PC of the start of bucket 0 */
+    uint32_t base;
+
+    /** log2 of the bucket size in bytes */
+    uint8_t shift;
+
+    /** Samples recorded in the histogram */
+    uint32_t total;
+
+    /** Samples and calls that fell outside the histogram */
+    uint32_t dropped;
+} c32_profile_t;
+
+/**
+ * @brief One execution trace record (16 bytes)
+ *
+ * Written when an instruction is fetched, before it executes, so the
+ * instruction that faults is the last record in the ring.
+ */
+typedef struct {
+    /** Virtual address of the instruction */
+    uint32_t pc;
+
+    /** Opcode byte */
+    uint8_t opcode;
+
+    /** Source register field */
+    uint8_t rs;
+
+    /** Target register field */
+    uint8_t rt;
+
+    /** Destination register field */
+    uint8_t rd;
+
+    /** Immediate field */
+    uint32_t imm;
+
+    /** Effective virtual address of a load or store, 0 otherwise */
+    uint32_t addr;
+} c32_trace_record_t;
+
+/**
+ * @brief Execution trace ring over a caller-supplied record buffer
+ *
+ * head and tail count records since c32_trace_init() and wrap at 2^32;
+ * records head - tail are waiting to be drained. When the ring is full the
+ * oldest record is overwritten, so an undrained ring always holds the
+ * last num_records instructions.
+ */
+typedef struct {
+    /** Record storage, mask + 1 entries */
+    c32_trace_record_t *records;
+
+    /** Record index mask (entry count - 1) */
+    uint32_t mask;
+
+    /** Records written */
+    uint32_t head;
+
+    /** Records drained or overwritten */
+    uint32_t tail;
+
+    /** Records overwritten before they were drained */
+    uint32_t lost;
+} c32_trace_t;
+
+/** @brief Number of entries in each software TLB (power of two) */
+#define C32_TLB_ENTRIES 64
+
+/** @brief Number of entries in the superpage TLB (power of two) */
+#define C32_STLB_ENTRIES 16
+
+/** @brief Tag value marking an unused TLB entry */
+#define C32_TLB_INVALID 0xFFFFFFFF
+
+/** @brief PTBR bit 0: the table is a two-level page directory */
+#define C32_PTBR_TWO_LEVEL 0x1
+
+/** @brief Directory entry bit 4: the entry maps a 4 MB superpage */
+#define C32_PDE_SUPER 0x10
+
+/**
+ * @brief Software TLB entry
+ *
+ * Caches one page table entry that passed the valid and user checks.
+ * Permission bits are kept so that a hit can be refused (and the full
+ * walk re-run to raise the fault) without touching guest memory.
+ */
+typedef struct {
+    /** Virtual page number, or C32_TLB_INVALID */
+    uint32_t vpn;
+
+    /** Page table entry as read from guest memory */
+    uint32_t pte;
+
+    /** Physical address the entry was read from (two-level tables only) */
+    uint32_t source;
+} c32_tlb_entry_t;
+
+/** @brief Number of shadow register banks held in c32_vm_t */
+#define C32_SHADOW_BANKS 4
+
+/** @brief Flag in word 1 of an IVT entry: always save registers to guest memory */
+#define C32_IVT_SPILL 0x1
+
+/**
+ * @brief Shadow register bank (see c32_vm_set_shadow_banks())
+ *
+ * Holds the interrupted context while its handler runs, instead of the
+ * 128-byte frame on the guest stack.
+ */
+typedef struct {
+    /** R0-R31 of the interrupted context */
+    uint32_t regs[32];
+
+    /** PC to return to (saved_pc of this level) */
+    uint32_t pc;
+} c32_shadow_bank_t;
+
+/**
+ * @brief Reason a bounded run stopped
+ *
+ * Returned by c32_vm_run_for(). Every reason except C32_EXIT_BUDGET
+ * leaves the VM halted (running = 0) or faulted; the host decides
+ * whether to service the event and resume.
+ */
+typedef enum {
+    C32_EXIT_HALTED = 0,    /**< VM was not running on entry */
+    C32_EXIT_BUDGET = 1,    /**< Instruction budget used up, VM still running */
+    C32_EXIT_SYSCALL = 2,   /**< Unhandled SYSCALL executed (interrupt 4 raised) */
+    C32_EXIT_BREAK = 3,     /**< BREAK executed (interrupt 5 raised) */
+    C32_EXIT_FAULT = 4,     /**< Fetch fault, bad PC, or failed interrupt dispatch */
+    C32_EXIT_ILLEGAL = 5    /**< Illegal opcode (interrupt 1 raised) */
+} c32_exit_reason_t;
+
+/** @brief Number of argument registers passed to a syscall handler (R5-R10) */
+#define C32_SYSCALL_ARGS 6
+
+/** @brief R4 value that makes SYSCALL run a table of requests */
+#define C32_SYSCALL_BATCH 0xFFFF
+
+/** @brief Size of one request in a guest syscall batch table */
+#define C32_SYSCALL_REQUEST_SIZE 32
+
+/**
+ * @brief One system call as seen by a host syscall handler
+ *
+ * For a plain SYSCALL, number is R4, args are R5-R10 and result is
+ * written back to R2. In a batch each request is 8 little-endian words
+ * in guest memory in the same order: number, six arguments, result.
+ */
+typedef struct {
+    /** Syscall number */
+    uint32_t number;
+
+    /** Arguments */
+    uint32_t args[C32_SYSCALL_ARGS];
+
+    /** Result written back to the guest (preset to 0) */
+    uint32_t result;
+} c32_syscall_t;
+
+/**
+ * @brief Host syscall handler return values
+ */
+typedef enum {
+    C32_SYSCALL_DONE = 0,   /**< Call serviced, the guest continues */
+    C32_SYSCALL_HALT = 1    /**< Stop as an unhandled SYSCALL would */
+} c32_syscall_status_t;
+
+struct c32_vm;
+
+/**
+ * @brief Host syscall handler
+ *
+ * Called inline by the engine. The handler may read and write registers
+ * and guest memory through vm; a handler that writes guest memory that
+ * may hold code must call c32_vm_host_write() for it.
+ *
+ * @param vm VM executing the SYSCALL
+ * @param call Decoded call; set call->result
+ * @param ctx Context pointer given to c32_vm_set_syscall_handler()
+ * @return C32_SYSCALL_DONE or C32_SYSCALL_HALT
+ */
+typedef c32_syscall_status_t (*c32_syscall_handler_t)(struct c32_vm *vm, c32_syscall_t *call,
+                                                      void *ctx);
+
+/**
+ * @brief Memory-mapped device
+ *
+ * Covers the physical range [base, base + size), which must lie above
+ * guest RAM. Loads and stores of width bytes (1, 2 or 4) that fall
+ * entirely inside the range call read or write inline from the engine
+ * with offset = physical address - base. A NULL read returns 0 and a
+ * NULL write drops the store.
+ */
+typedef struct {
+    /** Physical base address (at or above memory_size) */
+    uint32_t base;
+
+    /** Size of the register window in bytes */
+    uint32_t size;
+
+    /** Load handler; the engine truncates and extends the result to width */
+    uint32_t (*read)(struct c32_vm *vm, void *ctx, uint32_t offset, uint32_t width);
+
+    /** Store handler; value holds the low width bytes of the register */
+    void (*write)(struct c32_vm *vm, void *ctx, uint32_t offset, uint32_t width,
+                  uint32_t value);
+
+    /** Context pointer passed to read and write */
+    void *ctx;
+} c32_device_t;
+
 /**
  * @brief VM State Structure
  *
  * Complete virtual machine state including registers, memory,
  * privilege level, paging, and interrupt subsystem.
  */
-typedef struct {
+typedef struct c32_vm {
     /** General purpose registers R0-R31 (R0 is hardwired to zero) */
     uint32_t regs[32];
 
@@ -62,26 +438,115 @@ typedef struct {
     /** Paging enabled flag: 1 = virtual addressing on, 0 = physical only */
     uint8_t paging_enabled;
 
-    /** Physical address of page table in guest memory */
+    /** Physical address of page table in guest memory, plus C32_PTBR_TWO_LEVEL */
     uint32_t page_table_base;
 
-    /** Number of virtual pages managed by MMU */
+    /** Number of virtual pages (two-level: directory entries) managed by MMU */
     uint32_t num_pages;
 
+    /** Decoded instruction cache (caller-supplied, NULL = disabled) */
+    c32_icache_entry_t *icache;
+
+    /** Decoded instruction cache index mask (entry count - 1) */
+    uint32_t icache_mask;
+
+    /** Fused pairs executed, indexed by c32_fusion_t */
+    uint32_t fusion_hits[C32_FUSE_COUNT];
+
+    /** PC profile receiving call counts (caller-supplied, NULL = off) */
+    c32_profile_t *profile;
+
+    /** Execution trace ring (caller-supplied, NULL = off) */
+    c32_trace_t *trace;
+
+    /** Host syscall handler (NULL = SYSCALL halts the VM) */
+    c32_syscall_handler_t syscall_handler;
+
+    /** Context pointer passed to syscall_handler */
+    void *syscall_ctx;
+
+    /** Memory-mapped devices above RAM (caller-supplied, NULL = none) */
+    const c32_device_t *devices;
+
+    /** Number of entries in devices */
+    uint32_t num_devices;
+
+#ifdef C32_ENABLE_STATS
+    /** Execution counters (read with c32_vm_get_stats) */
+    c32_stats_t stats;
+#endif
+
+    /** Instruction fetch TLB (direct-mapped by virtual page number) */
+    c32_tlb_entry_t itlb[C32_TLB_ENTRIES];
+
+    /** Data access TLB (direct-mapped by virtual page number) */
+    c32_tlb_entry_t dtlb[C32_TLB_ENTRIES];
+
+    /** Superpage TLB holding directory entries (direct-mapped by vaddr >> 22) */
+    c32_tlb_entry_t stlb[C32_STLB_ENTRIES];
+
+    /** Lowest physical address a cached two-level entry was read from */
+    uint32_t tlb_source_low;
+
+    /** End of the physical range cached two-level entries were read from */
+    uint32_t tlb_source_high;
+
+    /** Write watch map, one byte per granule (caller-supplied, NULL = off) */
+    uint8_t *watch_map;
+
+    /** Number of granules covered by watch_map */
+    uint32_t watch_size;
+
+    /** log2 of the watch granule size in bytes */
+    uint8_t watch_shift;
+
+    /** Set to 1 when a guest store hits a non-zero watch map byte */
+    uint8_t watch_hit;
+
+    /** Dirty page bitmap, bit n%32 of word n/32 per page (caller-supplied, NULL = off) */
+    uint32_t *dirty_map;
+
     /** Interrupt subsystem state */
     struct {
         /** Global interrupt enable flag */
         uint8_t enabled;
 
-        /** Pending interrupt bitmap (256 bits = 32 bytes) */
-        uint8_t pending[32];
+        /** Pending interrupt bitmap (256 bits = 8 words, bit n%32 of word n/32) */
+        uint32_t pending[8];
+
+        /** Summary of pending: bit w set iff pending[w] is non-zero */
+        uint32_t pending_summary;
 
         /** Saved PC when interrupt fires */
         uint32_t saved_pc;
 
         /** Address in guest memory where R0-R31 are saved */
         uint32_t saved_regs_addr;
+
+        /** Shadow banks in use for interrupt entry (0 = always save to memory) */
+        uint32_t shadow_count;
+
+        /** Banks holding interrupted contexts (innermost is shadow[shadow_depth - 1]) */
+        uint32_t shadow_depth;
+
+        /** Memory frames nested inside the banked ones, returned from first */
+        uint32_t shadow_spilled;
+
+        /** Shadow register banks */
+        c32_shadow_bank_t shadow[C32_SHADOW_BANKS];
     } interrupts;
+
+    /** Instruction-count timer (see c32_vm_set_timer) */
+    struct {
+        /** Instructions left until the timer expires (0 = stopped) */
+        uint32_t count;
+
+        /** Value count is reloaded with on expiry */
+        uint32_t period;
+
+        /** Interrupt raised on expiry */
+        uint8_t irq;
+    } timer;
 } c32_vm_t;
 
 /**
@@ -133,8 +598,492 @@ int c32_vm_step(c32_vm_t *vm);
  */
 void c32_vm_run(c32_vm_t *vm);
 
+/**
+ * @brief Run VM for at most budget instructions
+ *
+ * Executes up to budget instructions in one inner loop and reports why
+ * it stopped. Does not set the running flag; returns C32_EXIT_HALTED
+ * without executing anything if the VM is halted.
+ *
+ * @param vm Pointer to VM structure
+ * @param budget Maximum number of instructions to execute
+ * @param executed If non-NULL, receives the number of instructions retired
+ * @return Exit reason
+ */
+c32_exit_reason_t c32_vm_run_for(c32_vm_t *vm, uint32_t budget,
+                                 uint32_t *executed);
+
 /** @} */ /* end of vm_lifecycle */
 
+/**
+ * @defgroup vm_icache Decoded Instruction Cache
+ * @brief Optional cache of pre-decoded instructions
+ *
+ * The cache memory is supplied by the caller, the same way guest memory
+ * is, so the core stays free of dynamic allocation. Guest stores through
+ * SW/SH/SB invalidate overlapping entries automatically; hosts that write
+ * guest memory directly must call c32_vm_icache_invalidate().
+ *
+ * When an entry is filled, common instruction pairs (see c32_fusion_t)
+ * are fused: the first entry is given a handler that executes both
+ * instructions with one dispatch, reading the second from the next
+ * entry. Pairs are never fused across a 4KB page boundary. Instructions
+ * without side effects whose destination is R0 are decoded as NOP.
+ * @{
+ */
+
+/**
+ * @brief Attach a decoded instruction cache
+ *
+ * The entry count is rounded down to a power of two. All entries are
+ * flushed. Passing NULL or fewer than two entries disables the cache.
+ *
+ * @param vm Pointer to VM structure
+ * @param entries Caller-supplied entry buffer
+ * @param num_entries Number of entries in buffer
+ */
+void c32_vm_set_icache(c32_vm_t *vm, c32_icache_entry_t *entries, uint32_t num_entries);
+
+/**
+ * @brief Flush the entire decoded instruction cache
+ *
+ * @param vm Pointer to VM structure
+ */
+void c32_vm_icache_flush(c32_vm_t *vm);
+
+/**
+ * @brief Invalidate cached instructions overlapping a physical range
+ *
+ * Must be called after the host modifies guest code behind the VM's back,
+ * for example after loading a new program image.
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical start address of modified range
+ * @param size Size of modified range in bytes
+ */
+void c32_vm_icache_invalidate(c32_vm_t *vm, uint32_t phys_addr, uint32_t size);
+
+/** @} */ /* end of vm_icache */
+
+/**
+ * @defgroup vm_tlb Software TLB
+ * @brief Cache of page table entries used by address translation
+ *
+ * The VM flushes both TLBs on SET_PTBR, ENABLE_PAGING, DISABLE_PAGING
+ * and ENTER_USER, and drops the affected entries when a guest store
+ * writes the page table. Hosts that edit page tables in guest memory
+ * directly must call c32_vm_tlb_flush().
+ * @{
+ */
+
+/**
+ * @brief Flush the instruction, data and superpage TLBs
+ *
+ * @param vm Pointer to VM structure
+ */
+void c32_vm_tlb_flush(c32_vm_t *vm);
+
+/** @} */ /* end of vm_tlb */
+
+/**
+ * @defgroup vm_watch Write Watch
+ * @brief Notification of guest stores into host-selected memory
+ *
+ * Lets an external translator (such as the JIT) learn that the guest
+ * wrote memory it has cached in another form. The host marks granules
+ * by writing non-zero bytes into the map; the VM only ever sets
+ * watch_hit and never clears it.
+ * @{
+ */
+
+/**
+ * @brief Attach a write watch map
+ *
+ * Byte i of the map covers physical addresses
+ * [i << shift, (i + 1) << shift). Clears watch_hit.
+ *
+ * @param vm Pointer to VM structure
+ * @param map Caller-supplied map (NULL disables watching)
+ * @param size Number of bytes in map
+ * @param shift log2 of the granule size in bytes
+ */
+void c32_vm_set_write_watch(c32_vm_t *vm, uint8_t *map, uint32_t size, uint8_t shift);
+
+/** @} */ /* end of vm_watch */
+
+/**
+ * @defgroup vm_dirty Dirty Page Tracking
+ * @brief Which 4KB physical pages were written since the last collection
+ *
+ * Every write into guest RAM sets its page's bit: guest stores (in the
+ * interpreter and in translated code), the register save area stored on
+ * interrupt entry, c32_set_interrupt_handler() and c32_vm_host_write().
+ * Restoring a snapshot marks every page. An incremental checkpoint (see
+ * c32_checkpoint.h) then costs time in proportion to the pages written,
+ * not to the size of guest memory. Hosts that write guest memory without
+ * c32_vm_host_write() must mark the pages themselves.
+ * @{
+ */
+
+/** @brief log2 of the tracked page size */
+#define C32_DIRTY_PAGE_SHIFT 12
+
+/** @brief Tracked page size in bytes */
+#define C32_DIRTY_PAGE_SIZE (1UL << C32_DIRTY_PAGE_SHIFT)
+
+/** @brief Pages covering memory_size bytes of guest memory */
+#define C32_DIRTY_PAGES(memory_size) \
+    (((uint32_t)(memory_size) >> C32_DIRTY_PAGE_SHIFT) + \
+     (((uint32_t)(memory_size) & (C32_DIRTY_PAGE_SIZE - 1)) != 0))
+
+/** @brief Bitmap words needed to track memory_size bytes of guest memory */
+#define C32_DIRTY_MAP_WORDS(memory_size) ((C32_DIRTY_PAGES(memory_size) + 31) >> 5)
+
+/**
+ * @brief Attach a dirty page bitmap (NULL detaches)
+ *
+ * The bitmap is cleared, so the first collection reports the pages
+ * written after this call.
+ *
+ * @param vm Pointer to VM structure
+ * @param map Caller-supplied bitmap, or NULL
+ * @param num_words Number of words in map
+ * @return 0 on success, -1 if map is smaller than
+ *         C32_DIRTY_MAP_WORDS(vm->memory_size) (nothing is attached)
+ */
+int c32_vm_set_dirty_map(c32_vm_t *vm, uint32_t *map, uint32_t num_words);
+
+/**
+ * @brief Copy the dirty bitmap out and clear it
+ *
+ * Nothing can run between the copy and the clear, so every write lands
+ * either in this collection or in the next one.
+ *
+ * @param vm Pointer to VM structure (with a dirty map attached)
+ * @param out Receives C32_DIRTY_MAP_WORDS(vm->memory_size) words, or NULL
+ *            to discard them
+ * @return Number of dirty pages
+ */
+uint32_t c32_vm_dirty_collect(c32_vm_t *vm, uint32_t *out);
+
+/**
+ * @brief Mark the pages covering a physical range as dirty
+ *
+ * @param vm Pointer to VM structure (with a dirty map attached)
+ * @param phys_addr Physical start address
+ * @param size Size of the range in bytes
+ */
+void c32_vm_dirty_mark(c32_vm_t *vm, uint32_t phys_addr, uint32_t size);
+
+/** @} */ /* end of vm_dirty */
+
+/**
+ * @defgroup vm_snapshot Snapshots
+ * @brief Capture a VM once and start many instances from it
+ *
+ * A snapshot holds the complete architectural state (registers, PC,
+ * privilege and paging state, TLBs, interrupt state) and a copy of guest
+ * memory in a caller-supplied image buffer. Restoring keeps the target's
+ * own host attachments (decoded instruction cache, write watch, dirty map,
+ * profile, trace, syscall handler, devices) and flushes its cache. Hosts
+ * that can share the image between instances (for example with
+ * copy-on-write page mappings) place the image in the new instance's
+ * memory themselves and call c32_vm_restore_state().
+ * @{
+ */
+
+/**
+ * @brief Saved VM state plus guest memory image
+ */
+typedef struct {
+    /** VM state at snapshot time (state.memory points at image) */
+    c32_vm_t state;
+
+    /** Copy of guest memory (state.memory_size bytes, caller-supplied) */
+    uint8_t *image;
+} c32_snapshot_t;
+
+/**
+ * @brief Capture VM state and guest memory
+ *
+ * @param vm Pointer to VM structure
+ * @param snap Snapshot to fill
+ * @param image Buffer receiving a copy of guest memory
+ * @param image_size Size of image buffer in bytes
+ * @return 0 on success, -1 if image is smaller than guest memory
+ */
+int c32_vm_snapshot(const c32_vm_t *vm, c32_snapshot_t *snap,
+                    uint8_t *image, uint32_t image_size);
+
+/**
+ * @brief Restore VM state and copy the snapshot image into guest memory
+ *
+ * @param vm Pointer to initialized VM structure
+ * @param snap Snapshot to restore
+ * @param memory Guest memory buffer (at least state.memory_size bytes)
+ */
+void c32_vm_restore(c32_vm_t *vm, const c32_snapshot_t *snap, uint8_t *memory);
+
+/**
+ * @brief Restore VM state over memory that already holds the image
+ *
+ * @param vm Pointer to initialized VM structure
+ * @param snap Snapshot to restore
+ * @param memory Guest memory whose contents equal snap->image
+ */
+void c32_vm_restore_state(c32_vm_t *vm, const c32_snapshot_t *snap, uint8_t *memory);
+
+/** @} */ /* end of vm_snapshot */
+
+/**
+ * @defgroup vm_stats Execution Counters
+ * @brief Read and clear the counters kept when built with C32_ENABLE_STATS
+ *
+ * Counters are updated by the interpreter. Code run by the dynamic
+ * binary translator only adds to the retired instruction count.
+ * @{
+ */
+
+/**
+ * @brief Copy the VM's counters
+ *
+ * @param vm Pointer to VM structure
+ * @param stats Receives the counters (zeroed if counters are compiled out)
+ * @return 0 on success, -1 if the core was built without C32_ENABLE_STATS
+ */
+int c32_vm_get_stats(const c32_vm_t *vm, c32_stats_t *stats);
+
+/**
+ * @brief Clear the VM's counters
+ *
+ * Also done by c32_vm_init().
+ *
+ * @param vm Pointer to VM structure
+ */
+void c32_vm_reset_stats(c32_vm_t *vm);
+
+/** @} */ /* end of vm_stats */
+
+/**
+ * @defgroup vm_profile PC Profiling
+ * @brief Sampled PC histogram and call counts for finding hot code
+ *
+ * Sampling costs nothing inside the engine: the host runs the VM in
+ * slices of N instructions with c32_vm_run_for() and records the PC
+ * after each slice with c32_profile_sample(). Call counts come from the
+ * engine itself, which bumps the target's bucket on every JAL and JALR
+ * while a profile is attached with c32_vm_set_profile(); when no
+ * profile is attached this is one pointer test per call instruction.
+ * @{
+ */
+
+/**
+ * @brief Initialize a profile over caller-supplied histograms
+ *
+ * Clears both histograms and the totals.
+ *
+ * @param prof Profile to initialize
+ * @param samples Sample counters (num_buckets entries)
+ * @param calls Call counters (num_buckets entries), or NULL
+ * @param num_buckets Number of buckets
+ * @param base PC of the start of bucket 0
+ * @param shift log2 of the bucket size in bytes
+ */
+void c32_profile_init(c32_profile_t *prof, uint32_t *samples, uint32_t *calls,
+                      uint32_t num_buckets, uint32_t base, uint8_t shift);
+
+/**
+ * @brief Record one PC sample
+ *
+ * @param prof Profile
+ * @param pc Sampled program counter
+ */
+void c32_profile_sample(c32_profile_t *prof, uint32_t pc);
+
+/**
+ * @brief Attach a profile to receive call counts (NULL detaches)
+ *
+ * Attach before running translated code: the dynamic binary translator
+ * leaves JAL and JALR to the interpreter only while a profile with call
+ * counters is attached when a block is translated.
+ *
+ * @param vm Pointer to VM structure
+ * @param prof Profile, or NULL
+ */
+void c32_vm_set_profile(c32_vm_t *vm, c32_profile_t *prof);
+
+/** @} */ /* end of vm_profile */
+
+/**
+ * @defgroup vm_trace Execution Trace
+ * @brief Binary record of every executed instruction in a ring buffer
+ *
+ * While a ring is attached with c32_vm_set_trace(), the engine writes one
+ * c32_trace_record_t per instruction it fetches; when none is attached
+ * this is one pointer test per instruction. The host drains the ring
+ * between c32_vm_run_for() slices with c32_trace_peek() and
+ * c32_trace_consume(), or leaves it alone and reads the last
+ * instructions before a fault after the run. Translated code is not
+ * traced: the dynamic binary translator runs everything on the
+ * interpreter while a ring is attached.
+ * @{
+ */
+
+/**
+ * @brief Initialize a trace ring over a caller-supplied record buffer
+ *
+ * @param trace Ring to initialize
+ * @param records Record storage
+ * @param num_records Number of records (must be a power of two)
+ * @return 0 on success, -1 if num_records is not a power of two
+ */
+int c32_trace_init(c32_trace_t *trace, c32_trace_record_t *records, uint32_t num_records);
+
+/**
+ * @brief Get the oldest undrained records
+ *
+ * Returns the records from tail up to head or to the end of the buffer,
+ * whichever comes first; call again after c32_trace_consume() to get the
+ * rest after a wrap.
+ *
+ * @param trace Ring
+ * @param chunk Receives a pointer to the first undrained record
+ * @return Number of contiguous records at *chunk (0 if the ring is empty)
+ */
+uint32_t c32_trace_peek(const c32_trace_t *trace, const c32_trace_record_t **chunk);
+
+/**
+ * @brief Mark records returned by c32_trace_peek() as drained
+ *
+ * @param trace Ring
+ * @param count Number of records to drop from the tail
+ */
+void c32_trace_consume(c32_trace_t *trace, uint32_t count);
+
+/**
+ * @brief Attach a trace ring (NULL detaches)
+ *
+ * @param vm Pointer to VM structure
+ * @param trace Ring, or NULL
+ */
+void c32_vm_set_trace(c32_vm_t *vm, c32_trace_t *trace);
+
+/** @} */ /* end of vm_trace */
+
+/**
+ * @defgroup vm_syscall Host System Calls
+ * @brief Service guest SYSCALLs inline without stopping the VM
+ *
+ * Without a handler, SYSCALL raises interrupt 4 and halts the VM with
+ * C32_EXIT_SYSCALL, and the host must restart it. With a handler
+ * attached, SYSCALL calls it from inside the engine and execution
+ * continues with the next instruction unless it returns
+ * C32_SYSCALL_HALT.
+ *
+ * A guest can post many requests per trap: SYSCALL with R4 =
+ * C32_SYSCALL_BATCH, R5 = address of a table of
+ * C32_SYSCALL_REQUEST_SIZE-byte requests (aligned to that size) and R6 =
+ * request count runs the handler once per request and stores each result
+ * in its request. R2 then holds the number of requests completed; it is
+ * less than R6 if a handler halted or the table ran outside memory (a
+ * page fault is raised in that case in paged user mode).
+ * @{
+ */
+
+/**
+ * @brief Attach a host syscall handler (NULL restores halting)
+ *
+ * @param vm Pointer to VM structure
+ * @param handler Handler, or NULL
+ * @param ctx Context pointer passed to every call
+ */
+void c32_vm_set_syscall_handler(c32_vm_t *vm, c32_syscall_handler_t handler, void *ctx);
+
+/** @} */ /* end of vm_syscall */
+
+/**
+ * @defgroup vm_devices Memory-Mapped Devices
+ * @brief Route loads and stores above RAM to host device callbacks
+ *
+ * Devices sit above the top of guest RAM, so the engine only looks for
+ * one after an access has already failed the RAM bounds check: ordinary
+ * loads and stores pay nothing. Accesses outside RAM that hit no device
+ * behave as before (loads leave the register unchanged, stores are
+ * dropped). In paged user mode, a page table entry whose frame lies in
+ * a device window maps that device into the address space.
+ * @{
+ */
+
+/**
+ * @brief Attach a device table (NULL or count 0 detaches)
+ *
+ * The table is not copied and must outlive the attachment. Devices are
+ * searched in table order.
+ *
+ * @param vm Pointer to VM structure
+ * @param devices Device table, or NULL
+ * @param count Number of entries in devices
+ * @return 0 on success, -1 if a device is empty, overlaps RAM or reaches
+ *         0xFFFFFFFF (the fault marker of address translation; the
+ *         previous table stays attached)
+ */
+int c32_vm_set_devices(c32_vm_t *vm, const c32_device_t *devices, uint32_t count);
+
+/**
+ * @brief Account for a host write into guest memory
+ *
+ * Devices that DMA into RAM (and syscall handlers that write it) call
+ * this after writing so the decoded instruction cache, the TLBs and the
+ * write watch map see the change exactly as for a guest store.
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical start address of the written range
+ * @param size Size of the written range in bytes
+ */
+void c32_vm_host_write(c32_vm_t *vm, uint32_t phys_addr, uint32_t size);
+
+/** @} */ /* end of vm_devices */
+
+/**
+ * @defgroup vm_timer Instruction-Count Timer
+ * @brief Periodic interrupt counted in retired instructions
+ *
+ * The timer counts retired instructions, not host time, so a guest
+ * scheduler preempts at the same points on every run and every host.
+ * The engine does not test it per instruction: each run slice is cut
+ * short at the expiry point, and the timer is charged once when the
+ * slice ends. Kernel code programs it with SET_TIMER; the host with
+ * c32_vm_set_timer(). Timer state is part of a snapshot.
+ * @{
+ */
+
+/**
+ * @brief Program the timer
+ *
+ * Equivalent to a kernel-mode SET_TIMER. The timer raises irq after
+ * every period retired instructions until it is stopped; the
+ * instruction that expires it retires before the interrupt is taken.
+ *
+ * @param vm Pointer to VM structure
+ * @param period Instructions between interrupts (0 stops the timer)
+ * @param irq Interrupt raised on expiry
+ */
+void c32_vm_set_timer(c32_vm_t *vm, uint32_t period, uint8_t irq);
+
+/**
+ * @brief Charge the timer for instructions retired outside the interpreter
+ *
+ * For execution engines (such as the JIT) that retire guest instructions
+ * without going through c32_vm_run_for(). They must not run past
+ * vm->timer.count instructions at a time while the timer is running.
+ *
+ * @param vm Pointer to VM structure
+ * @param count Instructions retired
+ */
+void c32_vm_timer_elapse(c32_vm_t *vm, uint32_t count);
+
+/** @} */ /* end of vm_timer */
+
 /**
  * @defgroup vm_interrupts Interrupt Management
  * @brief Interrupt control and handling
@@ -153,6 +1102,17 @@ void c32_vm_run(c32_vm_t *vm);
  */
 void c32_raise_interrupt(c32_vm_t *vm, uint8_t int_num);
 
+/**
+ * @brief Clear a pending interrupt
+ *
+ * Withdraws an interrupt raised but not yet dispatched, such as the one
+ * BREAK leaves pending for a debugger that resumes the guest itself.
+ *
+ * @param vm Pointer to VM structure
+ * @param int_num Interrupt number (0-255)
+ */
+void c32_clear_interrupt(c32_vm_t *vm, uint8_t int_num);
+
 /**
  * @brief Set interrupt handler address
  *
@@ -166,6 +1126,28 @@ void c32_raise_interrupt(c32_vm_t *vm, uint8_t int_num);
  */
 void c32_set_interrupt_handler(c32_vm_t *vm, uint8_t int_num, uint32_t handler_addr);
 
+/**
+ * @brief Enter interrupts through shadow register banks
+ *
+ * With count banks, interrupt entry copies R0-R31 and the return PC into
+ * the next free bank instead of the 128-byte frame at R29 - 128, and R29
+ * is left alone; IRET switches the bank back. Registers are saved to
+ * guest memory as before only when all banks are in use (nesting deeper
+ * than count), inside a handler that was itself entered that way, or
+ * when word 1 of the vector's IVT entry has C32_IVT_SPILL set. Handlers
+ * that read or rewrite the saved frame (a scheduler switching tasks, a
+ * syscall returning a value through it) need C32_IVT_SPILL.
+ *
+ * The banks are part of c32_vm_t, so snapshots, checkpoints and forks
+ * include them.
+ *
+ * @param vm Pointer to VM structure
+ * @param count Banks to use (0 restores the memory frame for every entry)
+ * @return 0 on success, -1 if count exceeds C32_SHADOW_BANKS or a banked
+ *         handler is running
+ */
+int c32_vm_set_shadow_banks(c32_vm_t *vm, uint32_t count);
+
 /** @} */ /* end of vm_interrupts */
 
 /**
@@ -0,0 +1,228 @@
+/**
+ * @file c32_vring.h
+ * @brief CRISP-32 Shared-Memory Request Rings
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef C32_VRING_H
+#define C32_VRING_H
+
+#include "c32_vm.h"
+
+/**
+ * @defgroup vring Request Rings
+ * @brief Virtio-style split rings in guest memory, serviced in place
+ *
+ * A ring is three guest-physical structures, little-endian, laid out as
+ * in a virtio split virtqueue:
+ * - descriptor table: num entries of {u64 addr, u32 len, u16 flags,
+ *   u16 next}, 16-byte aligned (addr must be below 4GB)
+ * - available ring: {u16 flags, u16 idx, u16 ring[num]}, 2-byte aligned,
+ *   written by the guest
+ * - used ring: {u16 flags, u16 idx, {u32 id, u32 len} ring[num]},
+ *   4-byte aligned, written by the host
+ *
+ * The guest publishes chains of descriptors in the available ring and,
+ * after as many as it likes, writes the doorbell device's NOTIFY
+ * register once. The host's service callback pops each chain, works
+ * directly on the buffers in guest memory (c32_vring_pop() returns
+ * pointers into vm->memory, nothing is copied), pushes completions to
+ * the used ring and raises the ring's interrupt with c32_vring_notify().
+ *
+ * Everything runs on the VM's thread inside the doorbell store; a host
+ * that hands buffers to other threads must push completions and notify
+ * from the VM's thread. Freestanding: no libc.
+ * @{
+ */
+
+/** @brief Descriptor flag: the chain continues at next */
+#define C32_VRING_DESC_F_NEXT 1
+
+/** @brief Descriptor flag: buffer is written by the host */
+#define C32_VRING_DESC_F_WRITE 2
+
+/** @brief Available ring flag: guest does not want completion interrupts */
+#define C32_VRING_AVAIL_F_NO_INTERRUPT 1
+
+/** @brief Largest ring size */
+#define C32_VRING_MAX_SIZE 32768
+
+/** @brief Doorbell register: ring size (power of two) */
+#define C32_VRING_NUM 0x00
+
+/** @brief Doorbell register: descriptor table address */
+#define C32_VRING_DESC 0x04
+
+/** @brief Doorbell register: available ring address */
+#define C32_VRING_AVAIL 0x08
+
+/** @brief Doorbell register: used ring address */
+#define C32_VRING_USED 0x0C
+
+/** @brief Doorbell register: write 1 to start the ring, 0 to reset; reads 1 while running */
+#define C32_VRING_READY 0x10
+
+/** @brief Doorbell register: any write runs the service callback */
+#define C32_VRING_NOTIFY 0x14
+
+/** @brief Doorbell register window size */
+#define C32_VRING_SIZE 0x18
+
+struct c32_vring;
+
+/**
+ * @brief Host callback run by a NOTIFY write
+ *
+ * @param vm VM that wrote the doorbell
+ * @param ring Ring to service
+ * @param ctx Context pointer given to c32_vring_init()
+ */
+typedef void (*c32_vring_service_t)(c32_vm_t *vm, struct c32_vring *ring, void *ctx);
+
+/**
+ * @brief One buffer of a popped chain
+ */
+typedef struct {
+    /** Buffer contents in place in guest memory */
+    uint8_t *data;
+
+    /** Guest physical address */
+    uint32_t addr;
+
+    /** Length in bytes */
+    uint32_t len;
+
+    /** 1 if the host may write the buffer (C32_VRING_DESC_F_WRITE) */
+    int writable;
+} c32_vring_buf_t;
+
+/**
+ * @brief Host-side ring state
+ */
+typedef struct c32_vring {
+    /** Ring size in entries (0 until configured) */
+    uint32_t num;
+
+    /** Descriptor table address */
+    uint32_t desc;
+
+    /** Available ring address */
+    uint32_t avail;
+
+    /** Used ring address */
+    uint32_t used;
+
+    /** 1 once the layout has been checked against guest memory */
+    int ready;
+
+    /** Next available ring entry to pop */
+    uint16_t last_avail;
+
+    /** Host copy of the used ring index */
+    uint16_t used_idx;
+
+    /** Interrupt raised by c32_vring_notify() */
+    uint8_t irq;
+
+    /** Doorbell callback */
+    c32_vring_service_t service;
+
+    /** Context pointer passed to service */
+    void *ctx;
+} c32_vring_t;
+
+/**
+ * @brief Initialize an unconfigured ring
+ *
+ * @param ring Ring state
+ * @param irq Interrupt raised on completion
+ * @param service Doorbell callback
+ * @param ctx Context pointer passed to service
+ */
+void c32_vring_init(c32_vring_t *ring, uint8_t irq, c32_vring_service_t service, void *ctx);
+
+/**
+ * @brief Check a ring layout against guest memory and start the ring
+ *
+ * Clears both ring indices. The doorbell device calls this when the
+ * guest writes 1 to READY; a host may call it directly instead.
+ *
+ * @param ring Ring state
+ * @param vm VM whose memory holds the ring
+ * @param num Ring size (power of two, 1 to C32_VRING_MAX_SIZE)
+ * @param desc Descriptor table address (16-byte aligned)
+ * @param avail Available ring address (2-byte aligned)
+ * @param used Used ring address (4-byte aligned)
+ * @return 0 on success, -1 if the layout is invalid or outside RAM
+ */
+int c32_vring_setup(c32_vring_t *ring, const c32_vm_t *vm, uint32_t num,
+                    uint32_t desc, uint32_t avail, uint32_t used);
+
+/**
+ * @brief Pop the next available chain
+ *
+ * A malformed chain (bad index, loop, unknown flag, buffer outside RAM,
+ * more than max_bufs buffers, or a 64-bit address) stops the ring: it
+ * must be reset and set up again before it is serviced.
+ *
+ * @param ring Ring state (ready)
+ * @param vm VM whose memory holds the ring
+ * @param head Receives the chain's head descriptor, for c32_vring_push()
+ * @param bufs Receives the chain's buffers in order
+ * @param max_bufs Capacity of bufs
+ * @param num_bufs Receives the number of buffers in the chain
+ * @return 1 if a chain was popped, 0 if none is available, -1 if malformed
+ */
+int c32_vring_pop(c32_vring_t *ring, c32_vm_t *vm, uint16_t *head, c32_vring_buf_t *bufs,
+                  uint32_t max_bufs, uint32_t *num_bufs);
+
+/**
+ * @brief Complete a chain by posting it to the used ring
+ *
+ * Only the used ring is reported through c32_vm_host_write(); a host
+ * that writes buffers which may later hold guest code reports them itself.
+ *
+ * @param ring Ring state (ready)
+ * @param vm VM whose memory holds the ring
+ * @param head Head descriptor returned by c32_vring_pop()
+ * @param written Bytes the host wrote into the chain's writable buffers
+ */
+void c32_vring_push(c32_vring_t *ring, c32_vm_t *vm, uint16_t head, uint32_t written);
+
+/**
+ * @brief Raise the ring's interrupt unless the guest suppressed it
+ *
+ * Call once after a batch of c32_vring_push() calls.
+ *
+ * @param ring Ring state (ready)
+ * @param vm VM whose memory holds the ring
+ */
+void c32_vring_notify(c32_vring_t *ring, c32_vm_t *vm);
+
+/**
+ * @brief Describe a ring's doorbell and configuration registers as an MMIO device
+ *
+ * @param dev Device entry to fill in
+ * @param base Physical base address
+ * @param ring Ring state
+ */
+void c32_vring_device(c32_device_t *dev, uint32_t base, c32_vring_t *ring);
+
+/** @} */ /* end of vring */
+
+#endif /* C32_VRING_H */
@@ -5,6 +5,52 @@
 #include "c32_asm.h"
 #include "c32_vm.h"
 #include "c32_string.h"
+#include "c32_ophash.h"
+
+/* Instruction table, generated from the list in c32_opcodes.h */
+static const c32_op_info_t op_table[] = {
+#define C32_OP_ENTRY(name, format) { #name, OP_##name, C32_FMT_##format },
+    C32_INSTRUCTIONS(C32_OP_ENTRY)
+#undef C32_OP_ENTRY
+};
+
+/* Position of every instruction in op_table */
+enum {
+#define C32_OP_INDEX(name, format) OP_INDEX_##name,
+    C32_INSTRUCTIONS(C32_OP_INDEX)
+#undef C32_OP_INDEX
+    OP_INDEX_END
+};
+
+/* The generated hash table must describe this instruction list */
+typedef char op_hash_matches_table[C32_OPHASH_COUNT == OP_INDEX_END ? 1 : -1];
+
+/* Look up an instruction by mnemonic (no mutable state: safe from any thread) */
+const c32_op_info_t *c32_asm_lookup_op(const char *mnemonic) {
+    uint32_t hash = C32_OPHASH_SEED;
+    size_t len = 0;
+    unsigned int slot;
+
+    if (!mnemonic) {
+        return NULL;
+    }
+
+    /* Hash at most C32_OPHASH_MAX_LEN characters; longer is never a match */
+    while (mnemonic[len]) {
+        if (len == C32_OPHASH_MAX_LEN) {
+            return NULL;
+        }
+        hash = C32_OPHASH_STEP(hash, mnemonic[len]);
+        len++;
+    }
+
+    /* Each mnemonic owns its slot, so one comparison settles the lookup */
+    slot = op_hash_slots[C32_OPHASH_SLOT(hash)];
+    if (slot == 0 || c32_strcmp(mnemonic, op_table[slot - 1].mnemonic) != 0) {
+        return NULL;
+    }
+    return &op_table[slot - 1];
+}
 
 /* Encode a CRISP-32 instruction to 8 bytes (little-endian) */
 void c32_encode_instruction(uint8_t *output, const c32_instruction_t *inst) {
@@ -0,0 +1,75 @@
+/*
+ * CRISP-32 Symbol Map Writer
+ * Shared by the assembler and the linker
+ *
+ * Note: This file uses stdio for file I/O (not freestanding)
+ */
+
+#include "c32_asm.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Symbol table being sorted by write_map's comparator */
+static const c32_symbol_t *map_symbols;
+
+/* Order symbols by address, then by definition order */
+static int compare_symbols(const void *a, const void *b) {
+    int i = *(const int *)a;
+    int j = *(const int *)b;
+
+    if (map_symbols[i].address != map_symbols[j].address) {
+        return map_symbols[i].address < map_symbols[j].address ? -1 : 1;
+    }
+    return i < j ? -1 : (i > j);
+}
+
+/* Write the symbol map */
+int c32_asm_write_map(const c32_asm_state_t *state, const char *map_file) {
+    int *order;
+    FILE *output;
+    int count = 0;
+    int i;
+
+    if (!state || !map_file) {
+        return -1;
+    }
+
+    /* Defined symbols sorted by address (stable for equal addresses) */
+    order = (int *)malloc((state->num_symbols > 0 ? (size_t)state->num_symbols : 1) *
+                          sizeof(int));
+    if (!order) {
+        fprintf(stderr, "Error: Out of memory writing map file '%s'\n", map_file);
+        return -1;
+    }
+    for (i = 0; i < state->num_symbols; i++) {
+        if (state->symbols[i].defined) {
+            order[count++] = i;
+        }
+    }
+    map_symbols = state->symbols;
+    qsort(order, (size_t)count, sizeof(int), compare_symbols);
+
+    output = fopen(map_file, "w");
+    if (!output) {
+        fprintf(stderr, "Error: Cannot create map file '%s'\n", map_file);
+        free(order);
+        return -1;
+    }
+
+    fprintf(output, "# CRISP-32 symbol map (load address 0x%08lx)\n",
+            (unsigned long)state->load_address);
+    for (i = 0; i < count; i++) {
+        const c32_symbol_t *sym = &state->symbols[order[i]];
+        fprintf(output, "0x%08lx %s\n",
+                (unsigned long)(sym->address + state->load_address), sym->name);
+    }
+    free(order);
+
+    if (fclose(output) != 0) {
+        fprintf(stderr, "Error: Failed to write map file '%s'\n", map_file);
+        return -1;
+    }
+
+    return 0;
+}
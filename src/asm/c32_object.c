@@ -0,0 +1,319 @@
+/*
+ * CRISP-32 Relocatable Objects and Linker
+ *
+ * Freestanding: objects are written through a callback and linked from
+ * memory.
+ */
+
+#include "c32_obj.h"
+#include "c32_string.h"
+#include "c32_vm.h"
+
+/* Header word offsets (after the 8-byte magic) */
+#define HDR_VERSION 8
+#define HDR_TEXT    12
+#define HDR_BSS     16
+#define HDR_NSYMS   20
+#define HDR_NRELOCS 24
+#define HDR_STRTAB  28
+
+/* Alignment of each object's .bss in the linked layout */
+#define BSS_ALIGN 8
+
+/* Write through the callback, advancing the offset */
+static int put(c32_asm_write_t write, void *ctx, uint32_t *offset, const uint8_t *data,
+               uint32_t size) {
+    if (size && write(ctx, *offset, data, size) != 0) {
+        return -1;
+    }
+    *offset += size;
+    return 0;
+}
+
+/* Write the assembled module as a relocatable object */
+int c32_asm_write_object(const c32_asm_state_t *state, c32_asm_write_t write, void *ctx) {
+    uint8_t buf[C32_OBJ_HEADER_SIZE];
+    uint32_t offset = 0, strtab = 0;
+    int i;
+
+    if (!state || !write || !state->object || state->output_flushed != 0) {
+        return -1;
+    }
+    for (i = 0; i < state->num_symbols; i++) {
+        strtab += (uint32_t)c32_strlen(state->symbols[i].name) + 1;
+    }
+
+    c32_memcpy(buf, C32_OBJ_MAGIC, 8);
+    c32_write_word(buf + HDR_VERSION, C32_OBJ_VERSION);
+    c32_write_word(buf + HDR_TEXT, state->output_size);
+    c32_write_word(buf + HDR_BSS, state->bss_size);
+    c32_write_word(buf + HDR_NSYMS, (uint32_t)state->num_symbols);
+    c32_write_word(buf + HDR_NRELOCS, (uint32_t)state->num_fixups);
+    c32_write_word(buf + HDR_STRTAB, strtab);
+    if (put(write, ctx, &offset, buf, C32_OBJ_HEADER_SIZE) != 0 ||
+        put(write, ctx, &offset, state->output, state->output_size) != 0) {
+        return -1;
+    }
+
+    /* Symbols in table order, so relocations can use symbol indices */
+    strtab = 0;
+    for (i = 0; i < state->num_symbols; i++) {
+        const c32_symbol_t *sym = &state->symbols[i];
+
+        c32_write_word(buf, strtab);
+        c32_write_word(buf + 4, sym->defined ? sym->address : 0);
+        c32_write_word(buf + 8, sym->defined ? sym->section : C32_SECTION_UNDEF);
+        c32_write_word(buf + 12, sym->global || !sym->defined ? C32_BIND_GLOBAL : C32_BIND_LOCAL);
+        if (put(write, ctx, &offset, buf, C32_OBJ_SYMBOL_SIZE) != 0) {
+            return -1;
+        }
+        strtab += (uint32_t)c32_strlen(sym->name) + 1;
+    }
+
+    /* Fixups left after c32_asm_finish() are the relocations */
+    for (i = 0; i < state->num_fixups; i++) {
+        c32_write_word(buf, state->fixups[i].address);
+        c32_write_word(buf + 4, (uint32_t)state->fixups[i].kind);
+        c32_write_word(buf + 8, (uint32_t)state->fixups[i].symbol);
+        if (put(write, ctx, &offset, buf, C32_OBJ_RELOC_SIZE) != 0) {
+            return -1;
+        }
+    }
+
+    for (i = 0; i < state->num_symbols; i++) {
+        const char *name = state->symbols[i].name;
+
+        if (put(write, ctx, &offset, (const uint8_t *)name,
+                (uint32_t)c32_strlen(name) + 1) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* Parsed view of one object */
+typedef struct {
+    const uint8_t *text;
+    const uint8_t *symbols;
+    const uint8_t *relocs;
+    const char *strtab;
+    uint32_t text_size;
+    uint32_t bss_size;
+    uint32_t num_symbols;
+    uint32_t num_relocs;
+    uint32_t strtab_size;
+} object_t;
+
+/* Check an object's header and tables */
+static int parse_object(const c32_link_input_t *in, object_t *obj) {
+    uint32_t size;
+
+    if (!in->data || in->size < C32_OBJ_HEADER_SIZE ||
+        c32_memcmp(in->data, C32_OBJ_MAGIC, 8) != 0 ||
+        c32_read_word(in->data + HDR_VERSION) != C32_OBJ_VERSION) {
+        return -1;
+    }
+    obj->text_size = c32_read_word(in->data + HDR_TEXT);
+    obj->bss_size = c32_read_word(in->data + HDR_BSS);
+    obj->num_symbols = c32_read_word(in->data + HDR_NSYMS);
+    obj->num_relocs = c32_read_word(in->data + HDR_NRELOCS);
+    obj->strtab_size = c32_read_word(in->data + HDR_STRTAB);
+
+    /* Sizes are checked one at a time so that the sum cannot wrap */
+    size = in->size - C32_OBJ_HEADER_SIZE;
+    if ((obj->text_size & 7) != 0 || obj->text_size > size) {
+        return -1;
+    }
+    size -= obj->text_size;
+    if (obj->num_symbols > size / C32_OBJ_SYMBOL_SIZE) {
+        return -1;
+    }
+    size -= obj->num_symbols * C32_OBJ_SYMBOL_SIZE;
+    if (obj->num_relocs > size / C32_OBJ_RELOC_SIZE) {
+        return -1;
+    }
+    size -= obj->num_relocs * C32_OBJ_RELOC_SIZE;
+    if (obj->strtab_size != size || obj->bss_size > 0xFFFFFFFFUL - BSS_ALIGN) {
+        return -1;
+    }
+
+    obj->text = in->data + C32_OBJ_HEADER_SIZE;
+    obj->symbols = obj->text + obj->text_size;
+    obj->relocs = obj->symbols + obj->num_symbols * C32_OBJ_SYMBOL_SIZE;
+    obj->strtab = (const char *)(obj->relocs + obj->num_relocs * C32_OBJ_RELOC_SIZE);
+    return 0;
+}
+
+/* Name of symbol i, or NULL if it is not a terminated string in the table */
+static const char *symbol_name(const object_t *obj, uint32_t i) {
+    uint32_t off = c32_read_word(obj->symbols + i * C32_OBJ_SYMBOL_SIZE);
+    uint32_t end;
+
+    for (end = off; end < obj->strtab_size; end++) {
+        if (obj->strtab[end] == '\0') {
+            return end > off ? obj->strtab + off : NULL;
+        }
+    }
+    return NULL;
+}
+
+/* Image offset of symbol i, or -1 with the error set */
+static int symbol_address(c32_asm_state_t *globals, const object_t *obj, uint32_t i,
+                          uint32_t text_base, uint32_t bss_base, uint32_t *address,
+                          c32_link_result_t *result) {
+    const uint8_t *entry = obj->symbols + i * C32_OBJ_SYMBOL_SIZE;
+    uint32_t value = c32_read_word(entry + 4);
+    uint32_t section = c32_read_word(entry + 8);
+    const char *name = symbol_name(obj, i);
+    int idx;
+
+    if (!name) {
+        result->error = C32_LINK_BAD_OBJECT;
+        return -1;
+    }
+
+    switch (section) {
+        case C32_SECTION_TEXT:
+            if (value > obj->text_size) {
+                break;
+            }
+            *address = text_base + value;
+            return 0;
+        case C32_SECTION_BSS:
+            if (value > obj->bss_size) {
+                break;
+            }
+            *address = bss_base + value;
+            return 0;
+        case C32_SECTION_UNDEF:
+            idx = c32_asm_find_symbol(globals, name);
+            if (idx < 0 || !globals->symbols[idx].defined) {
+                result->error = C32_LINK_UNDEFINED;
+                result->error_symbol = name;
+                return -1;
+            }
+            *address = globals->symbols[idx].address;
+            return 0;
+        default:
+            break;
+    }
+    result->error = C32_LINK_BAD_OBJECT;
+    return -1;
+}
+
+/* Enter a global definition, or fail with the error set */
+static int define_global(c32_asm_state_t *globals, const char *name, uint32_t address,
+                         int section, c32_link_result_t *result) {
+    int idx = c32_asm_add_symbol(globals, name, address);
+
+    if (idx < 0) {
+        result->error = idx == -2 ? C32_LINK_DUPLICATE :
+                        idx == -3 ? C32_LINK_NO_SPACE : C32_LINK_BAD_OBJECT;
+        result->error_symbol = name;
+        return -1;
+    }
+    globals->symbols[idx].section = (uint8_t)section;
+    globals->symbols[idx].global = 1;
+    return 0;
+}
+
+/* Link objects into a flat image */
+int c32_link(c32_asm_state_t *globals, const c32_link_input_t *inputs, int count,
+             uint8_t *output, uint32_t capacity, c32_link_result_t *result) {
+    object_t obj;
+    uint32_t text_base, bss_base, i, address, value;
+    int n;
+
+    result->text_size = 0;
+    result->bss_start = 0;
+    result->bss_size = 0;
+    result->error = C32_LINK_OK;
+    result->error_object = -1;
+    result->error_symbol = NULL;
+
+    /* Lay out .text: every image byte comes from some object's .text */
+    for (n = 0; n < count; n++) {
+        result->error_object = n;
+        if (parse_object(&inputs[n], &obj) != 0) {
+            result->error = C32_LINK_BAD_OBJECT;
+            return -1;
+        }
+        if (obj.text_size > capacity - result->text_size) {
+            result->error = C32_LINK_NO_SPACE;
+            return -1;
+        }
+        result->text_size += obj.text_size;
+    }
+    result->bss_start = result->text_size;
+
+    /* Enter the global definitions at their final offsets */
+    text_base = 0;
+    bss_base = result->bss_start;
+    for (n = 0; n < count; n++) {
+        result->error_object = n;
+        parse_object(&inputs[n], &obj);
+        for (i = 0; i < obj.num_symbols; i++) {
+            const uint8_t *entry = obj.symbols + i * C32_OBJ_SYMBOL_SIZE;
+            uint32_t section = c32_read_word(entry + 8);
+
+            if (c32_read_word(entry + 12) != C32_BIND_GLOBAL || section == C32_SECTION_UNDEF) {
+                continue;
+            }
+            if (symbol_address(globals, &obj, i, text_base, bss_base, &address, result) != 0 ||
+                define_global(globals, symbol_name(&obj, i), address, (int)section,
+                              result) != 0) {
+                return -1;
+            }
+        }
+        text_base += obj.text_size;
+        bss_base += (obj.bss_size + BSS_ALIGN - 1) & ~(uint32_t)(BSS_ALIGN - 1);
+    }
+    result->bss_size = bss_base - result->bss_start;
+
+    result->error_object = -1;
+    if (define_global(globals, "__bss_start", result->bss_start, C32_SECTION_BSS, result) != 0 ||
+        define_global(globals, "__bss_end", bss_base, C32_SECTION_BSS, result) != 0) {
+        return -1;
+    }
+
+    /* Copy each .text and apply its relocations */
+    text_base = 0;
+    bss_base = result->bss_start;
+    for (n = 0; n < count; n++) {
+        result->error_object = n;
+        parse_object(&inputs[n], &obj);
+        c32_memcpy(output + text_base, obj.text, obj.text_size);
+
+        for (i = 0; i < obj.num_relocs; i++) {
+            const uint8_t *entry = obj.relocs + i * C32_OBJ_RELOC_SIZE;
+            uint32_t offset = c32_read_word(entry);
+            uint32_t type = c32_read_word(entry + 4);
+            uint32_t symbol = c32_read_word(entry + 8);
+            uint32_t absolute;
+
+            if (offset > obj.text_size - 8 || obj.text_size < 8 || (offset & 7) != 0 ||
+                type > C32_RELOC_LO16 || symbol >= obj.num_symbols) {
+                result->error = C32_LINK_BAD_OBJECT;
+                return -1;
+            }
+            if (symbol_address(globals, &obj, symbol, text_base, bss_base, &address,
+                               result) != 0) {
+                return -1;
+            }
+
+            absolute = address + globals->load_address;
+            switch (type) {
+                case C32_RELOC_BRANCH: value = address - (text_base + offset + 8); break;
+                case C32_RELOC_HI16: value = absolute >> 16; break;
+                case C32_RELOC_LO16: value = absolute & 0xFFFF; break;
+                default: value = absolute; break;
+            }
+            c32_write_word(output + text_base + offset + 4, value);
+        }
+        text_base += obj.text_size;
+        bss_base += (obj.bss_size + BSS_ALIGN - 1) & ~(uint32_t)(BSS_ALIGN - 1);
+    }
+
+    result->error_object = -1;
+    return 0;
+}
@@ -0,0 +1,45 @@
+/*
+ * Mnemonic hash table, generated by c32ophash from C32_INSTRUCTIONS
+ * Do not edit: run 'make' after changing c32_opcodes.h
+ */
+
+#ifndef C32_OPHASH_H
+#define C32_OPHASH_H
+
+/* Number of instructions the table was built for */
+#define C32_OPHASH_COUNT 66
+
+/* Length of the longest mnemonic */
+#define C32_OPHASH_MAX_LEN 14
+
+/* FNV-1a starting value that places every mnemonic in its own slot */
+#define C32_OPHASH_SEED 0x00000B68UL
+
+/* Fold one character into the 32-bit hash h */
+#define C32_OPHASH_STEP(h, c) \
+    ((((h) ^ (unsigned char)(c)) * 16777619UL) & 0xFFFFFFFFUL)
+
+/* Slot index of a finished hash */
+#define C32_OPHASH_SLOT(h) ((h) >> 24)
+
+/* Instruction table index + 1 for every slot (0 = empty) */
+static const unsigned char op_hash_slots[256] = {
+    0, 0, 13, 0, 0, 0, 0, 26, 0, 0, 0, 0, 0, 3, 0, 0,
+    0, 6, 0, 0, 60, 10, 0, 8, 12, 44, 0, 0, 0, 0, 0, 0,
+    0, 0, 50, 0, 0, 49, 0, 0, 0, 0, 0, 0, 0, 46, 0, 0,
+    0, 0, 0, 48, 0, 0, 0, 0, 11, 0, 0, 0, 0, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 66, 0, 64, 0, 0, 0, 55, 0,
+    24, 0, 5, 25, 30, 0, 0, 0, 31, 0, 0, 58, 29, 0, 0, 0,
+    0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 32, 57, 45, 62, 65,
+    0, 0, 0, 0, 23, 52, 0, 0, 0, 0, 0, 0, 4, 0, 0, 0,
+    0, 0, 61, 0, 0, 42, 0, 0, 0, 0, 0, 0, 0, 9, 0, 0,
+    56, 0, 0, 0, 0, 0, 63, 0, 0, 41, 0, 0, 0, 0, 43, 40,
+    0, 0, 28, 0, 27, 39, 0, 0, 0, 0, 0, 34, 0, 19, 51, 18,
+    0, 1, 38, 0, 0, 36, 0, 16, 0, 0, 0, 21, 0, 0, 0, 0,
+    0, 17, 33, 0, 0, 0, 0, 0, 59, 0, 0, 0, 0, 0, 0, 0,
+    0, 2, 0, 0, 0, 15, 0, 0, 0, 0, 0, 0, 0, 0, 0, 35,
+    0, 0, 0, 37, 0, 0, 0, 22, 14, 0, 53, 0, 0, 7, 54, 47,
+    0, 20, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
+};
+
+#endif /* C32_OPHASH_H */
@@ -0,0 +1,379 @@
+/*
+ * CRISP-32 Peephole Optimizer
+ *
+ * Runs over the buffered image of a single pass, before fixups are
+ * patched. Every label reference is still a fixup, so instructions can be
+ * removed and the labels, fixups and numeric branch targets moved down
+ * after them. Rounds repeat until nothing changes: removing one
+ * instruction can turn a branch into a branch to the next instruction.
+ */
+
+#include "c32_asm.h"
+#include "c32_string.h"
+
+/* Limits on rounds and on jump chains followed while threading */
+#define MAX_ROUNDS 16
+#define MAX_HOPS   8
+
+/* Per-instruction flags */
+#define FLAG_LABEL   1      /* Some label or numeric branch lands here */
+#define FLAG_REMOVED 2
+
+/* Optimizer view of the image */
+typedef struct {
+    c32_asm_state_t *state;
+    uint8_t *code;
+    uint32_t count;         /* Instructions */
+    int32_t *fix;           /* Fixup index per instruction, or -1 */
+    uint32_t *dest;         /* Numeric in-image target + 1, or 0 */
+    uint32_t *map;          /* New index per old index (count + 1 entries) */
+    uint8_t *flags;
+} opt_t;
+
+/* Field accessors (instruction format: [opcode][rs][rt][rd][imm32]) */
+#define OPCODE(o, i) ((o)->code[(i) * 8])
+#define RS(o, i)     ((o)->code[(i) * 8 + 1])
+#define RT(o, i)     ((o)->code[(i) * 8 + 2])
+#define RD(o, i)     ((o)->code[(i) * 8 + 3])
+#define IMM(o, i)    c32_read_word((o)->code + (i) * 8 + 4)
+
+/* Conditional branches (PC-relative offset) */
+static int is_branch(uint8_t op) {
+    return op == OP_BEQ || op == OP_BNE || op == OP_BLEZ || op == OP_BGTZ ||
+           op == OP_BLTZ || op == OP_BGEZ;
+}
+
+/* Instructions whose only effect is writing their destination register */
+static int is_pure(const opt_t *o, uint32_t i, uint8_t *dest) {
+    switch (OPCODE(o, i)) {
+        case OP_ADD: case OP_ADDU: case OP_SUB: case OP_SUBU:
+        case OP_AND: case OP_OR: case OP_XOR: case OP_NOR:
+        case OP_SLL: case OP_SRL: case OP_SRA:
+        case OP_SLLV: case OP_SRLV: case OP_SRAV:
+        case OP_SLT: case OP_SLTU:
+        case OP_MUL: case OP_MULH: case OP_MULHU:
+        case OP_DIV: case OP_DIVU: case OP_REM: case OP_REMU:
+            *dest = RD(o, i);
+            return 1;
+        case OP_ADDI: case OP_ADDIU:
+        case OP_ANDI: case OP_ORI: case OP_XORI: case OP_LUI:
+        case OP_SLTI: case OP_SLTIU:
+            *dest = RT(o, i);
+            return 1;
+        default:
+            return 0;
+    }
+}
+
+/* NOPs, writes to R0 and moves of a register to itself */
+static int is_dead(const opt_t *o, uint32_t i) {
+    uint8_t op = OPCODE(o, i), rd;
+
+    if (op == OP_NOP) {
+        return 1;
+    }
+    if (!is_pure(o, i, &rd)) {
+        return 0;
+    }
+    if (rd == 0) {
+        return 1;                       /* The VM discards these too */
+    }
+    switch (op) {
+        case OP_ADD: case OP_ADDU: case OP_OR: case OP_XOR:
+            return (RS(o, i) == rd && RT(o, i) == 0) || (RT(o, i) == rd && RS(o, i) == 0);
+        case OP_SUB: case OP_SUBU:
+            return RS(o, i) == rd && RT(o, i) == 0;
+        case OP_SLL: case OP_SRL: case OP_SRA:
+            return RT(o, i) == rd && (IMM(o, i) & 0x1F) == 0;
+        case OP_ADDI: case OP_ADDIU: case OP_ORI: case OP_XORI:
+            return RS(o, i) == rd && o->fix[i] < 0 && IMM(o, i) == 0;
+        default:
+            return 0;
+    }
+}
+
+/* Branches that are always taken (jumps) and never taken (dead) */
+static int is_always(const opt_t *o, uint32_t i) {
+    uint8_t op = OPCODE(o, i);
+
+    return op == OP_J || (op == OP_BEQ && RS(o, i) == RT(o, i)) ||
+           ((op == OP_BLEZ || op == OP_BGEZ) && RS(o, i) == 0);
+}
+
+static int is_never(const opt_t *o, uint32_t i) {
+    uint8_t op = OPCODE(o, i);
+
+    return (op == OP_BNE && RS(o, i) == RT(o, i)) ||
+           ((op == OP_BGTZ || op == OP_BLTZ) && RS(o, i) == 0);
+}
+
+/* In-image control transfer target of a labelled branch or jump */
+static int symbol_target(const opt_t *o, uint32_t i, uint32_t *target) {
+    const c32_fixup_t *fixup;
+    const c32_symbol_t *sym;
+
+    if (o->fix[i] < 0) {
+        return 0;
+    }
+    fixup = &o->state->fixups[o->fix[i]];
+    sym = &o->state->symbols[fixup->symbol];
+    if ((fixup->kind != C32_FIXUP_BRANCH && fixup->kind != C32_FIXUP_JUMP) ||
+        !sym->defined || sym->section != C32_SECTION_TEXT) {
+        return 0;
+    }
+    *target = sym->address / 8;
+    return 1;
+}
+
+/* Control transfer target, labelled or numeric */
+static int target_of(const opt_t *o, uint32_t i, uint32_t *target) {
+    if (o->dest[i]) {
+        *target = o->dest[i] - 1;
+        return 1;
+    }
+    return symbol_target(o, i, target);
+}
+
+/* Record numeric branch and jump targets; -1 if one cannot be moved */
+static int find_numeric_targets(opt_t *o) {
+    uint32_t load = o->state->load_address;
+    uint32_t i;
+
+    for (i = 0; i < o->count; i++) {
+        uint8_t op = OPCODE(o, i);
+        uint32_t imm = IMM(o, i);
+
+        o->dest[i] = 0;
+        if (o->fix[i] >= 0) {
+            continue;
+        }
+        if (is_branch(op)) {
+            /* Offsets are relative, so the target must be in the image */
+            int32_t off = (int32_t)imm;
+            int32_t t = (int32_t)i + 1 + off / 8;
+
+            if ((off & 7) != 0 || t < 0 || (uint32_t)t > o->count) {
+                return -1;
+            }
+            o->dest[i] = (uint32_t)t + 1;
+        } else if ((op == OP_J || op == OP_JAL) && imm >= load &&
+                   imm - load <= o->count * 8 && ((imm - load) & 7) == 0) {
+            /* Absolute targets outside the image need no change */
+            o->dest[i] = (imm - load) / 8 + 1;
+        }
+    }
+    return 0;
+}
+
+/* Mark every instruction that something can branch to */
+static void mark_labels(opt_t *o) {
+    const c32_asm_state_t *state = o->state;
+    uint32_t i;
+    int s;
+
+    for (i = 0; i <= o->count; i++) {
+        o->flags[i] = 0;
+    }
+    for (s = 0; s < state->num_symbols; s++) {
+        if (state->symbols[s].defined && state->symbols[s].section == C32_SECTION_TEXT &&
+            state->symbols[s].address / 8 <= o->count) {
+            o->flags[state->symbols[s].address / 8] |= FLAG_LABEL;
+        }
+    }
+    for (i = 0; i < o->count; i++) {
+        if (o->dest[i]) {
+            o->flags[o->dest[i] - 1] |= FLAG_LABEL;
+        }
+    }
+}
+
+/* Fold LUI rt, hi + ORI/ADDI(U) rt, rt, lo into one instruction */
+static int fold_constant(opt_t *o, uint32_t i) {
+    uint32_t j = i + 1;
+    uint8_t op, rt = RT(o, i);
+
+    if (j >= o->count || (o->flags[j] & FLAG_LABEL) || rt == 0) {
+        return 0;
+    }
+    op = OPCODE(o, j);
+    if ((op != OP_ORI && op != OP_ADDI && op != OP_ADDIU) || RS(o, j) != rt || RT(o, j) != rt) {
+        return 0;
+    }
+
+    if (o->fix[i] < 0 && o->fix[j] < 0) {
+        uint32_t hi = IMM(o, i) << 16;
+
+        c32_write_word(o->code + j * 8 + 4, op == OP_ORI ? hi | IMM(o, j) : hi + IMM(o, j));
+    } else if (o->fix[i] >= 0 && o->fix[j] >= 0) {
+        c32_fixup_t *hi = &o->state->fixups[o->fix[i]];
+        c32_fixup_t *lo = &o->state->fixups[o->fix[j]];
+
+        /* %hi(x) + %lo(x) is x itself: an absolute reference */
+        if (hi->kind != C32_FIXUP_HI16 || lo->kind != C32_FIXUP_LO16 ||
+            hi->symbol != lo->symbol) {
+            return 0;
+        }
+        lo->kind = C32_FIXUP_JUMP;
+    } else {
+        return 0;
+    }
+
+    OPCODE(o, j) = op == OP_ORI ? OP_ORI : OP_ADDIU;
+    RS(o, j) = 0;
+    o->flags[i] |= FLAG_REMOVED;
+    return 1;
+}
+
+/* Point a jump at the end of its chain of unconditional jumps */
+static int thread_jump(opt_t *o, uint32_t i) {
+    uint32_t target, next;
+    int symbol = -1;
+    int hops;
+
+    if (!symbol_target(o, i, &target)) {
+        return 0;
+    }
+    for (hops = 0; target < o->count && !(o->flags[target] & FLAG_REMOVED) &&
+                   is_always(o, target) && symbol_target(o, target, &next); hops++) {
+        if (hops == MAX_HOPS || next == target) {
+            return 0;                   /* Loop or too long */
+        }
+        symbol = o->state->fixups[o->fix[target]].symbol;
+        target = next;
+    }
+    if (symbol < 0 || symbol == o->state->fixups[o->fix[i]].symbol) {
+        return 0;
+    }
+    o->state->fixups[o->fix[i]].symbol = symbol;
+    return 1;
+}
+
+/* Drop removed instructions and move everything after them down */
+static void compact(opt_t *o) {
+    c32_asm_state_t *state = o->state;
+    uint32_t i, k = 0;
+    int f, kept = 0;
+
+    for (i = 0; i < o->count; i++) {
+        o->map[i] = k;
+        if (!(o->flags[i] & FLAG_REMOVED)) {
+            k++;
+        }
+    }
+    o->map[o->count] = k;
+
+    for (i = 0; i < o->count; i++) {
+        uint32_t to = o->map[i];
+
+        if (o->flags[i] & FLAG_REMOVED) {
+            continue;
+        }
+        if (to != i) {
+            c32_memcpy(o->code + to * 8, o->code + i * 8, 8);
+        }
+        o->dest[to] = o->dest[i] ? o->map[o->dest[i] - 1] + 1 : 0;
+    }
+
+    for (f = 0; f < state->num_fixups; f++) {
+        c32_fixup_t fixup = state->fixups[f];
+
+        if (!(o->flags[fixup.address / 8] & FLAG_REMOVED)) {
+            fixup.address = o->map[fixup.address / 8] * 8;
+            state->fixups[kept++] = fixup;
+        }
+    }
+    state->num_fixups = kept;
+
+    for (f = 0; f < state->num_symbols; f++) {
+        c32_symbol_t *sym = &state->symbols[f];
+
+        if (sym->defined && sym->section == C32_SECTION_TEXT && sym->address / 8 <= o->count) {
+            sym->address = o->map[sym->address / 8] * 8;
+        }
+    }
+
+    state->opt_removed += o->count - k;
+    o->count = k;
+    state->output_size = k * 8;
+    state->current_address = k * 8;
+}
+
+/* Run the peephole optimizer over the buffered image */
+int c32_asm_optimize(c32_asm_state_t *state) {
+    opt_t o;
+    uint32_t i, n, pad;
+    int round;
+
+    if (!state->optimize || state->pass != C32_ASM_ONE_PASS || state->output_flushed != 0) {
+        return -1;
+    }
+    n = state->output_size / 8;
+
+    pad = (uint32_t)(-(size_t)state->opt_work & 3);
+    if (state->opt_work_size < pad || state->opt_work_size - pad < C32_ASM_OPT_WORK_SIZE(n * 8) - 4) {
+        return -1;
+    }
+    o.state = state;
+    o.code = state->output;
+    o.count = n;
+    o.fix = (int32_t *)(void *)(state->opt_work + pad);
+    o.dest = (uint32_t *)(o.fix + n + 1);
+    o.map = o.dest + n + 1;
+    o.flags = (uint8_t *)(o.map + n + 1);
+
+    for (i = 0; i < n; i++) {
+        o.fix[i] = -1;
+    }
+    for (round = 0; round < state->num_fixups; round++) {
+        o.fix[state->fixups[round].address / 8] = round;
+    }
+    if (find_numeric_targets(&o) != 0) {
+        return -1;
+    }
+
+    for (round = 0; round < MAX_ROUNDS; round++) {
+        int removed = 0, threaded = 0;
+
+        mark_labels(&o);
+        for (i = 0; i < o.count; i++) {
+            uint8_t op = OPCODE(&o, i);
+            uint32_t target;
+
+            if (o.flags[i] & FLAG_REMOVED) {
+                continue;
+            }
+            if (is_dead(&o, i) || is_never(&o, i) ||
+                ((is_branch(op) || op == OP_J) && target_of(&o, i, &target) && target == i + 1)) {
+                o.flags[i] |= FLAG_REMOVED;
+                removed = 1;
+            } else if (op == OP_LUI) {
+                removed |= fold_constant(&o, i);
+            } else if (is_branch(op) || op == OP_J || op == OP_JAL) {
+                threaded |= thread_jump(&o, i);
+            }
+        }
+        if (removed) {
+            compact(&o);
+            for (i = 0; i < o.count; i++) {
+                o.fix[i] = -1;
+            }
+            for (i = 0; i < (uint32_t)state->num_fixups; i++) {
+                o.fix[state->fixups[i].address / 8] = (int32_t)i;
+            }
+        }
+        if (!removed && !threaded) {
+            break;
+        }
+    }
+
+    /* Numeric targets are encoded directly; labelled ones by c32_asm_finish() */
+    for (i = 0; i < o.count; i++) {
+        if (o.dest[i]) {
+            uint32_t target = o.dest[i] - 1;
+
+            c32_write_word(o.code + i * 8 + 4, is_branch(OPCODE(&o, i)) ?
+                           (target - (i + 1)) * 8 : state->load_address + target * 8);
+        }
+    }
+    return 0;
+}
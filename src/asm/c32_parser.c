@@ -5,6 +5,7 @@
 #include "c32_asm.h"
 #include "c32_opcodes.h"
 #include "c32_string.h"
+#include "c32_vm.h"
 
 /* Helper: skip whitespace */
 static const char* skip_whitespace(const char *str) {
@@ -54,93 +55,318 @@ static int parse_immediate(const char *str, int32_t *result) {
     return 0;
 }
 
-/* Parse instruction opcode and return opcode byte */
-static int parse_opcode(const char *mnemonic) {
-    /* Arithmetic */
-    if (c32_strcmp(mnemonic, "ADD") == 0) return OP_ADD;
-    if (c32_strcmp(mnemonic, "ADDU") == 0) return OP_ADDU;
-    if (c32_strcmp(mnemonic, "SUB") == 0) return OP_SUB;
-    if (c32_strcmp(mnemonic, "SUBU") == 0) return OP_SUBU;
-    if (c32_strcmp(mnemonic, "ADDI") == 0) return OP_ADDI;
-    if (c32_strcmp(mnemonic, "ADDIU") == 0) return OP_ADDIU;
-
-    /* Logical */
-    if (c32_strcmp(mnemonic, "AND") == 0) return OP_AND;
-    if (c32_strcmp(mnemonic, "OR") == 0) return OP_OR;
-    if (c32_strcmp(mnemonic, "XOR") == 0) return OP_XOR;
-    if (c32_strcmp(mnemonic, "NOR") == 0) return OP_NOR;
-    if (c32_strcmp(mnemonic, "ANDI") == 0) return OP_ANDI;
-    if (c32_strcmp(mnemonic, "ORI") == 0) return OP_ORI;
-    if (c32_strcmp(mnemonic, "XORI") == 0) return OP_XORI;
-    if (c32_strcmp(mnemonic, "LUI") == 0) return OP_LUI;
-
-    /* Shifts */
-    if (c32_strcmp(mnemonic, "SLL") == 0) return OP_SLL;
-    if (c32_strcmp(mnemonic, "SRL") == 0) return OP_SRL;
-    if (c32_strcmp(mnemonic, "SRA") == 0) return OP_SRA;
-    if (c32_strcmp(mnemonic, "SLLV") == 0) return OP_SLLV;
-    if (c32_strcmp(mnemonic, "SRLV") == 0) return OP_SRLV;
-    if (c32_strcmp(mnemonic, "SRAV") == 0) return OP_SRAV;
-
-    /* Comparison */
-    if (c32_strcmp(mnemonic, "SLT") == 0) return OP_SLT;
-    if (c32_strcmp(mnemonic, "SLTU") == 0) return OP_SLTU;
-    if (c32_strcmp(mnemonic, "SLTI") == 0) return OP_SLTI;
-    if (c32_strcmp(mnemonic, "SLTIU") == 0) return OP_SLTIU;
-
-    /* Multiply/Divide */
-    if (c32_strcmp(mnemonic, "MUL") == 0) return OP_MUL;
-    if (c32_strcmp(mnemonic, "MULH") == 0) return OP_MULH;
-    if (c32_strcmp(mnemonic, "MULHU") == 0) return OP_MULHU;
-    if (c32_strcmp(mnemonic, "DIV") == 0) return OP_DIV;
-    if (c32_strcmp(mnemonic, "DIVU") == 0) return OP_DIVU;
-    if (c32_strcmp(mnemonic, "REM") == 0) return OP_REM;
-    if (c32_strcmp(mnemonic, "REMU") == 0) return OP_REMU;
-
-    /* Load/Store */
-    if (c32_strcmp(mnemonic, "LW") == 0) return OP_LW;
-    if (c32_strcmp(mnemonic, "LH") == 0) return OP_LH;
-    if (c32_strcmp(mnemonic, "LHU") == 0) return OP_LHU;
-    if (c32_strcmp(mnemonic, "LB") == 0) return OP_LB;
-    if (c32_strcmp(mnemonic, "LBU") == 0) return OP_LBU;
-    if (c32_strcmp(mnemonic, "SW") == 0) return OP_SW;
-    if (c32_strcmp(mnemonic, "SH") == 0) return OP_SH;
-    if (c32_strcmp(mnemonic, "SB") == 0) return OP_SB;
-
-    /* Branches */
-    if (c32_strcmp(mnemonic, "BEQ") == 0) return OP_BEQ;
-    if (c32_strcmp(mnemonic, "BNE") == 0) return OP_BNE;
-    if (c32_strcmp(mnemonic, "BLEZ") == 0) return OP_BLEZ;
-    if (c32_strcmp(mnemonic, "BGTZ") == 0) return OP_BGTZ;
-    if (c32_strcmp(mnemonic, "BLTZ") == 0) return OP_BLTZ;
-    if (c32_strcmp(mnemonic, "BGEZ") == 0) return OP_BGEZ;
-
-    /* Jumps */
-    if (c32_strcmp(mnemonic, "J") == 0) return OP_J;
-    if (c32_strcmp(mnemonic, "JAL") == 0) return OP_JAL;
-    if (c32_strcmp(mnemonic, "JR") == 0) return OP_JR;
-    if (c32_strcmp(mnemonic, "JALR") == 0) return OP_JALR;
-
-    /* System */
-    if (c32_strcmp(mnemonic, "SYSCALL") == 0) return OP_SYSCALL;
-    if (c32_strcmp(mnemonic, "BREAK") == 0) return OP_BREAK;
-    if (c32_strcmp(mnemonic, "NOP") == 0) return OP_NOP;
-
-    /* Interrupt */
-    if (c32_strcmp(mnemonic, "EI") == 0) return OP_EI;
-    if (c32_strcmp(mnemonic, "DI") == 0) return OP_DI;
-    if (c32_strcmp(mnemonic, "IRET") == 0) return OP_IRET;
-    if (c32_strcmp(mnemonic, "RAISE") == 0) return OP_RAISE;
-    if (c32_strcmp(mnemonic, "GETPC") == 0) return OP_GETPC;
-
-    /* MMU */
-    if (c32_strcmp(mnemonic, "ENABLE_PAGING") == 0) return OP_ENABLE_PAGING;
-    if (c32_strcmp(mnemonic, "DISABLE_PAGING") == 0) return OP_DISABLE_PAGING;
-    if (c32_strcmp(mnemonic, "SET_PTBR") == 0) return OP_SET_PTBR;
-    if (c32_strcmp(mnemonic, "ENTER_USER") == 0) return OP_ENTER_USER;
-    if (c32_strcmp(mnemonic, "GETMODE") == 0) return OP_GETMODE;
-
-    return -1; /* Unknown instruction */
+/* Helper: does a target operand name a label rather than a number */
+static int is_label(const char *token) {
+    return !((*token >= '0' && *token <= '9') || *token == '-' || *token == '+');
+}
+
+/* Helper: immediate for a reference of the given kind to an address */
+static uint32_t reference_value(const c32_asm_state_t *state, int kind, uint32_t address,
+                                uint32_t inst_address) {
+    uint32_t absolute = address + state->load_address;
+
+    switch (kind) {
+        case C32_FIXUP_BRANCH: return address - (inst_address + 8);
+        case C32_FIXUP_HI16: return absolute >> 16;
+        case C32_FIXUP_LO16: return absolute & 0xFFFF;
+        default: return absolute;
+    }
+}
+
+/* Resolve a label or number operand; forward labels (all labels in an object or when optimizing) become fixups */
+static int resolve_target(c32_asm_state_t *state, const char *token, int kind,
+                          uint32_t *value) {
+    int32_t imm;
+    int idx = c32_asm_find_symbol(state, token);
+
+    if (idx >= 0 && state->symbols[idx].defined && !state->object &&
+        !(state->optimize && state->pass == C32_ASM_ONE_PASS)) {
+        /* Label - offset for branches, load address added for absolute addresses */
+        *value = reference_value(state, kind, state->symbols[idx].address,
+                                 state->current_address);
+        return 0;
+    }
+
+    if (state->pass == C32_ASM_ONE_PASS && is_label(token)) {
+        idx = c32_asm_reference_symbol(state, token);
+        if (idx < 0 || c32_asm_add_fixup(state, idx, state->current_address, kind) < 0) {
+            return -1;
+        }
+        *value = 0;
+        return 0;
+    }
+
+    parse_immediate(token, &imm);
+    if (kind == C32_FIXUP_BRANCH) {
+        *value = (uint32_t)imm;
+    } else {
+        *value = reference_value(state, kind, (uint32_t)imm, state->current_address);
+    }
+    return 0;
+}
+
+/* Parse an immediate that may be %hi(label) or %lo(label) */
+static int parse_operand(c32_asm_state_t *state, const char *token, uint32_t *value) {
+    char inner[MAX_LABEL_LEN];
+    size_t len = c32_strlen(token);
+    int32_t imm;
+    int kind;
+
+    if (len > 5 && token[0] == '%' && token[3] == '(' && token[len - 1] == ')') {
+        if (token[1] == 'h' && token[2] == 'i') {
+            kind = C32_FIXUP_HI16;
+        } else if (token[1] == 'l' && token[2] == 'o') {
+            kind = C32_FIXUP_LO16;
+        } else {
+            return -1;
+        }
+        c32_memcpy(inner, token + 4, len - 5);
+        inner[len - 5] = '\0';
+        if (!is_label(inner)) {
+            /* %hi/%lo of a number: no load address */
+            parse_immediate(inner, &imm);
+            *value = kind == C32_FIXUP_HI16 ? (uint32_t)imm >> 16 : (uint32_t)imm & 0xFFFF;
+            return 0;
+        }
+        return resolve_target(state, inner, kind, value);
+    }
+
+    parse_immediate(token, &imm);
+    *value = (uint32_t)imm;
+    return 0;
+}
+
+/* Handle an assembler directive */
+static int assemble_directive(c32_asm_state_t *state, char tokens[][MAX_LABEL_LEN],
+                              int token_count) {
+    int32_t imm;
+    int idx;
+
+    if (c32_strcmp(tokens[0], ".text") == 0) {
+        state->section = C32_SECTION_TEXT;
+        return 0;
+    }
+    if (c32_strcmp(tokens[0], ".bss") == 0) {
+        if (!state->object) {
+            return -1; /* Flat images have no .bss */
+        }
+        state->section = C32_SECTION_BSS;
+        return 0;
+    }
+    if (c32_strcmp(tokens[0], ".space") == 0) {
+        /* .space bytes: reserve .bss */
+        if (token_count < 2 || state->section != C32_SECTION_BSS) {
+            return -1;
+        }
+        parse_immediate(tokens[1], &imm);
+        if (imm < 0) {
+            return -1;
+        }
+        state->bss_size += (uint32_t)imm;
+        return 0;
+    }
+    if (c32_strcmp(tokens[0], ".global") == 0) {
+        /* .global label: export from an object (no effect on flat images) */
+        if (token_count < 2) {
+            return -1;
+        }
+        if (state->pass == 2) {
+            return 0;
+        }
+        idx = c32_asm_reference_symbol(state, tokens[1]);
+        if (idx < 0) {
+            return -1;
+        }
+        state->symbols[idx].global = 1;
+        return 0;
+    }
+    return -1; /* Unknown directive */
+}
+
+/* Helper: pass the buffered output to the callback */
+static int flush_output(c32_asm_state_t *state) {
+    if (state->output_size == 0) {
+        return 0;
+    }
+    if (state->output_write(state->output_ctx, state->output_flushed, state->output,
+                            state->output_size) != 0) {
+        return -1;
+    }
+    state->output_flushed += state->output_size;
+    state->output_size = 0;
+    return 0;
+}
+
+/* Helper: append one encoded instruction to the output */
+static int emit_instruction(c32_asm_state_t *state, const c32_instruction_t *inst) {
+    if (state->output_size + 8 > state->output_capacity) {
+        if (!state->output_write || flush_output(state) != 0) {
+            return -1;
+        }
+    }
+    c32_encode_instruction(state->output + state->output_size, inst);
+    state->output_size += 8;
+    return 0;
+}
+
+/* Replace the output buffer and optionally stream the image */
+int c32_asm_set_output(c32_asm_state_t *state, uint8_t *buffer, uint32_t capacity,
+                       c32_asm_write_t write, void *ctx) {
+    if (!buffer) {
+        buffer = state->builtin_output;
+        capacity = MAX_OUTPUT_SIZE;
+    }
+    if (capacity < 8) {
+        return -1;
+    }
+
+    state->output = buffer;
+    state->output_capacity = capacity & ~(uint32_t)7;
+    state->output_size = 0;
+    state->output_flushed = 0;
+    state->output_write = write;
+    state->output_ctx = ctx;
+    return 0;
+}
+
+/* Start a pass */
+void c32_asm_begin_pass(c32_asm_state_t *state, int pass) {
+    state->pass = pass;
+    state->current_address = 0;
+    state->output_size = 0;
+    state->output_flushed = 0;
+    state->num_fixups = 0;
+    state->section = C32_SECTION_TEXT;
+    state->bss_size = 0;
+    state->opt_removed = 0;
+}
+
+/* Enable or disable the optimizer */
+int c32_asm_set_optimize(c32_asm_state_t *state, void *work, uint32_t size) {
+    if (!state) {
+        return -1;
+    }
+    state->optimize = work != NULL;
+    state->opt_work = (uint8_t *)work;
+    state->opt_work_size = work ? size : 0;
+    return 0;
+}
+
+/* Patch fixups and flush the output */
+int c32_asm_finish(c32_asm_state_t *state) {
+    int i, kept = 0;
+
+    if (state->optimize && state->pass == C32_ASM_ONE_PASS && c32_asm_optimize(state) < 0) {
+        return -1;
+    }
+
+    for (i = 0; i < state->num_fixups; i++) {
+        const c32_fixup_t *fixup = &state->fixups[i];
+        const c32_symbol_t *sym = &state->symbols[fixup->symbol];
+        uint32_t offset = fixup->address + 4;
+        uint32_t value;
+        uint8_t word[4];
+
+        if (state->object) {
+            /* Only branches within .text are final; the rest are relocations */
+            if (fixup->kind != C32_FIXUP_BRANCH || !sym->defined ||
+                sym->section != C32_SECTION_TEXT) {
+                state->fixups[kept++] = *fixup;
+                continue;
+            }
+        } else if (!sym->defined) {
+            return -1;
+        }
+        value = reference_value(state, fixup->kind, sym->address, fixup->address);
+
+        /* Patch in place unless the instruction was already streamed */
+        if (offset >= state->output_flushed) {
+            c32_write_word(state->output + (offset - state->output_flushed), value);
+        } else {
+            c32_write_word(word, value);
+            if (state->output_write(state->output_ctx, offset, word, 4) != 0) {
+                return -1;
+            }
+        }
+    }
+    state->num_fixups = kept;
+
+    if (state->output_write) {
+        return flush_output(state);
+    }
+    return 0;
+}
+
+/* Assemble source text into a caller buffer */
+int c32_asm_assemble_buffer(c32_asm_state_t *state, const char *source, uint32_t length,
+                            uint8_t *output, uint32_t capacity) {
+    char line[MAX_LINE_LEN];
+    uint32_t pos = 0;
+    int line_num = 0;
+
+    if (!state || (!source && length) ||
+        c32_asm_set_output(state, output, capacity, NULL, NULL) < 0) {
+        return -1;
+    }
+    c32_asm_begin_pass(state, C32_ASM_ONE_PASS);
+    state->error_line = 0;
+
+    while (pos < length) {
+        uint32_t len = 0;
+        int status = 0;
+
+        line_num++;
+        while (pos < length && source[pos] != '\n') {
+            if (len < MAX_LINE_LEN - 1) {
+                line[len] = source[pos];
+            } else {
+                status = -1; /* Line too long */
+            }
+            len++;
+            pos++;
+        }
+        pos++; /* Skip the newline */
+        if (len > 0 && len < MAX_LINE_LEN && line[len - 1] == '\r') {
+            len--;
+        }
+        line[len < MAX_LINE_LEN ? len : MAX_LINE_LEN - 1] = '\0';
+
+        if (status < 0 || c32_asm_assemble_line(state, line, line_num) < 0) {
+            if (!state->error_line) {
+                state->error_line = line_num;
+            }
+            state->errors++;
+        }
+    }
+
+    if (state->errors > 0) {
+        return -1;
+    }
+    return c32_asm_finish(state);
+}
+
+/* Assemble source text directly into guest memory */
+int c32_asm_assemble_to_vm(c32_asm_state_t *state, c32_vm_t *vm, uint32_t load_addr,
+                           const char *source, uint32_t length) {
+    int status;
+
+    if (!state || !vm || load_addr >= vm->memory_size) {
+        return -1;
+    }
+
+    state->load_address = load_addr;
+    status = c32_asm_assemble_buffer(state, source, length, vm->memory + load_addr,
+                                     vm->memory_size - load_addr);
+    /* Include code the optimizer moved down: it was written before */
+    if (c32_asm_image_size(state) + state->opt_removed * 8 > 0) {
+        c32_vm_host_write(vm, load_addr, c32_asm_image_size(state) + state->opt_removed * 8);
+    }
+    return status;
+}
+
+/* Size of the generated image */
+uint32_t c32_asm_image_size(const c32_asm_state_t *state) {
+    return state->output_flushed + state->output_size;
 }
 
 /* Tokenize a line into tokens separated by whitespace and commas */
@@ -183,9 +409,8 @@ int c32_asm_assemble_line(c32_asm_state_t *state, const char *line, int line_num
     char tokens[8][MAX_LABEL_LEN];
     int token_count;
     c32_instruction_t inst;
-    int opcode;
+    const c32_op_info_t *op;
     int32_t imm;
-    int idx;
 
     (void)line_num; /* Unused for now */
 
@@ -215,9 +440,14 @@ int c32_asm_assemble_line(c32_asm_state_t *state, const char *line, int line_num
             c32_memcpy(label, line, len);
             label[len] = '\0';
 
-            /* Add label to symbol table in pass 1 */
-            if (state->pass == 1) {
-                c32_asm_add_symbol(state, label, state->current_address);
+            /* Add label to symbol table in pass 1 (or the single pass) */
+            if (state->pass == 1 || state->pass == C32_ASM_ONE_PASS) {
+                int idx = c32_asm_add_symbol(state, label,
+                                             state->section == C32_SECTION_BSS ?
+                                             state->bss_size : state->current_address);
+                if (idx >= 0) {
+                    state->symbols[idx].section = (uint8_t)state->section;
+                }
             }
 
             /* Skip past label for rest of parsing */
@@ -235,126 +465,113 @@ int c32_asm_assemble_line(c32_asm_state_t *state, const char *line, int line_num
         return 0;
     }
 
+    /* Directives start with '.' */
+    if (tokens[0][0] == '.') {
+        return assemble_directive(state, tokens, token_count);
+    }
+    if (state->section != C32_SECTION_TEXT) {
+        return -1; /* Instructions belong in .text */
+    }
+
     /* Get opcode */
-    opcode = parse_opcode(tokens[0]);
-    if (opcode < 0) {
+    op = c32_asm_lookup_op(tokens[0]);
+    if (!op) {
         return -1; /* Unknown instruction */
     }
 
     /* Initialize instruction */
     c32_memset(&inst, 0, sizeof(inst));
-    inst.opcode = (uint8_t)opcode;
-
-    /* Parse operands based on instruction type */
-    /* R-type: ADD rd, rs, rt */
-    if (opcode == OP_ADD || opcode == OP_ADDU || opcode == OP_SUB || opcode == OP_SUBU ||
-        opcode == OP_AND || opcode == OP_OR || opcode == OP_XOR || opcode == OP_NOR ||
-        opcode == OP_SLT || opcode == OP_SLTU ||
-        opcode == OP_MUL || opcode == OP_MULH || opcode == OP_MULHU ||
-        opcode == OP_DIV || opcode == OP_DIVU || opcode == OP_REM || opcode == OP_REMU ||
-        opcode == OP_SLLV || opcode == OP_SRLV || opcode == OP_SRAV) {
-        if (token_count < 4) return -1;
-        inst.rd = (uint8_t)c32_parse_register(tokens[1]);
-        inst.rs = (uint8_t)c32_parse_register(tokens[2]);
-        inst.rt = (uint8_t)c32_parse_register(tokens[3]);
-        inst.immediate = 0;
-    }
-    /* I-type: ADDI rt, rs, imm */
-    else if (opcode == OP_ADDI || opcode == OP_ADDIU ||
-             opcode == OP_ANDI || opcode == OP_ORI || opcode == OP_XORI ||
-             opcode == OP_SLTI || opcode == OP_SLTIU) {
-        if (token_count < 4) return -1;
-        inst.rt = (uint8_t)c32_parse_register(tokens[1]);
-        inst.rs = (uint8_t)c32_parse_register(tokens[2]);
-        parse_immediate(tokens[3], &imm);
-        inst.immediate = (uint32_t)imm;
-    }
-    /* LUI rt, imm */
-    else if (opcode == OP_LUI) {
-        if (token_count < 3) return -1;
-        inst.rt = (uint8_t)c32_parse_register(tokens[1]);
-        parse_immediate(tokens[2], &imm);
-        inst.immediate = (uint32_t)imm;
-    }
-    /* Shift immediate: SLL rd, rt, shamt */
-    else if (opcode == OP_SLL || opcode == OP_SRL || opcode == OP_SRA) {
-        if (token_count < 4) return -1;
-        inst.rd = (uint8_t)c32_parse_register(tokens[1]);
-        inst.rt = (uint8_t)c32_parse_register(tokens[2]);
-        parse_immediate(tokens[3], &imm);
-        inst.immediate = (uint32_t)imm;
-    }
-    /* Branch: BEQ rs, rt, offset */
-    else if (opcode == OP_BEQ || opcode == OP_BNE) {
-        if (token_count < 4) return -1;
-        inst.rs = (uint8_t)c32_parse_register(tokens[1]);
-        inst.rt = (uint8_t)c32_parse_register(tokens[2]);
-        /* Check if label or immediate */
-        idx = c32_asm_find_symbol(state, tokens[3]);
-        if (idx >= 0) {
-            /* Label - calculate offset */
-            inst.immediate = state->symbols[idx].address - (state->current_address + 8);
-        } else {
+    inst.opcode = op->opcode;
+
+    /* Parse operands based on the instruction's format */
+    switch (op->format) {
+        case C32_FMT_R:         /* ADD rd, rs, rt */
+            if (token_count < 4) return -1;
+            inst.rd = (uint8_t)c32_parse_register(tokens[1]);
+            inst.rs = (uint8_t)c32_parse_register(tokens[2]);
+            inst.rt = (uint8_t)c32_parse_register(tokens[3]);
+            break;
+        case C32_FMT_BULK:      /* MEMCPY dst, src, len or MEMSET dst, value, len */
+            if (token_count < 4) return -1;
+            inst.rd = (uint8_t)c32_parse_register(tokens[1]);
+            inst.rs = (uint8_t)c32_parse_register(tokens[2]);
+            inst.rt = (uint8_t)c32_parse_register(tokens[3]);
+            /* The VM updates the registers as it goes, so they must not alias */
+            if (inst.rd == inst.rs || inst.rd == inst.rt || inst.rs == inst.rt) return -1;
+            break;
+        case C32_FMT_I:         /* ADDI rt, rs, imm */
+        case C32_FMT_LOGIC:     /* ORI rt, rs, imm or ORI rt, rs, %lo(label) */
+        case C32_FMT_MEM:       /* LW rt, rs, offset or SW rt, rs, offset */
+            if (token_count < 4) return -1;
+            inst.rt = (uint8_t)c32_parse_register(tokens[1]);
+            inst.rs = (uint8_t)c32_parse_register(tokens[2]);
+            if (parse_operand(state, tokens[3], &inst.immediate) < 0) return -1;
+            break;
+        case C32_FMT_LUI:       /* LUI rt, imm or LUI rt, %hi(label) */
+            if (token_count < 3) return -1;
+            inst.rt = (uint8_t)c32_parse_register(tokens[1]);
+            if (parse_operand(state, tokens[2], &inst.immediate) < 0) return -1;
+            break;
+        case C32_FMT_SHIFT:     /* SLL rd, rt, shamt */
+            if (token_count < 4) return -1;
+            inst.rd = (uint8_t)c32_parse_register(tokens[1]);
+            inst.rt = (uint8_t)c32_parse_register(tokens[2]);
             parse_immediate(tokens[3], &imm);
             inst.immediate = (uint32_t)imm;
-        }
-    }
-    /* Branch single register: BLEZ rs, offset */
-    else if (opcode == OP_BLEZ || opcode == OP_BGTZ || opcode == OP_BLTZ || opcode == OP_BGEZ) {
-        if (token_count < 3) return -1;
-        inst.rs = (uint8_t)c32_parse_register(tokens[1]);
-        idx = c32_asm_find_symbol(state, tokens[2]);
-        if (idx >= 0) {
-            inst.immediate = state->symbols[idx].address - (state->current_address + 8);
-        } else {
+            break;
+        case C32_FMT_BRANCH2:   /* BEQ rs, rt, offset */
+            if (token_count < 4) return -1;
+            inst.rs = (uint8_t)c32_parse_register(tokens[1]);
+            inst.rt = (uint8_t)c32_parse_register(tokens[2]);
+            if (resolve_target(state, tokens[3], C32_FIXUP_BRANCH, &inst.immediate) < 0) return -1;
+            break;
+        case C32_FMT_BRANCH1:   /* BLEZ rs, offset */
+            if (token_count < 3) return -1;
+            inst.rs = (uint8_t)c32_parse_register(tokens[1]);
+            if (resolve_target(state, tokens[2], C32_FIXUP_BRANCH, &inst.immediate) < 0) return -1;
+            break;
+        case C32_FMT_JUMP:      /* J target or JAL target */
+            if (token_count < 2) return -1;
+            if (resolve_target(state, tokens[1], C32_FIXUP_JUMP, &inst.immediate) < 0) return -1;
+            break;
+        case C32_FMT_RS:        /* JR rs */
+            if (token_count < 2) return -1;
+            inst.rs = (uint8_t)c32_parse_register(tokens[1]);
+            break;
+        case C32_FMT_RD_RS:     /* JALR rd, rs */
+            if (token_count < 3) return -1;
+            inst.rd = (uint8_t)c32_parse_register(tokens[1]);
+            inst.rs = (uint8_t)c32_parse_register(tokens[2]);
+            break;
+        case C32_FMT_RD:        /* GETPC rd or GETMODE rd */
+            if (token_count < 2) return -1;
+            inst.rd = (uint8_t)c32_parse_register(tokens[1]);
+            break;
+        case C32_FMT_RD_RT:     /* SET_PTBR base, num_pages */
+            if (token_count < 3) return -1;
+            inst.rd = (uint8_t)c32_parse_register(tokens[1]);
+            inst.rt = (uint8_t)c32_parse_register(tokens[2]);
+            break;
+        case C32_FMT_RS_IMM:    /* SET_TIMER period, int_num */
+            if (token_count < 3) return -1;
+            inst.rs = (uint8_t)c32_parse_register(tokens[1]);
             parse_immediate(tokens[2], &imm);
             inst.immediate = (uint32_t)imm;
-        }
-    }
-    /* Jump: J target or JAL target */
-    else if (opcode == OP_J || opcode == OP_JAL) {
-        if (token_count < 2) return -1;
-        idx = c32_asm_find_symbol(state, tokens[1]);
-        if (idx >= 0) {
-            /* Add default load address (0x1000) to make addresses absolute */
-            inst.immediate = state->symbols[idx].address + 0x1000;
-        } else {
+            break;
+        case C32_FMT_IMM:       /* RAISE int_num */
+            if (token_count < 2) return -1;
             parse_immediate(tokens[1], &imm);
-            inst.immediate = (uint32_t)imm + 0x1000;
-        }
+            inst.immediate = (uint32_t)imm;
+            break;
+        default:                /* No operands: NOP, EI, DI, IRET, SYSCALL, BREAK, etc. */
+            break;
     }
-    /* JR rs or JALR rd, rs */
-    else if (opcode == OP_JR) {
-        if (token_count < 2) return -1;
-        inst.rs = (uint8_t)c32_parse_register(tokens[1]);
-    }
-    else if (opcode == OP_JALR) {
-        if (token_count < 3) return -1;
-        inst.rd = (uint8_t)c32_parse_register(tokens[1]);
-        inst.rs = (uint8_t)c32_parse_register(tokens[2]);
-    }
-    /* Load/Store: LW rt, rs, offset or SW rt, rs, offset */
-    else if (opcode == OP_LW || opcode == OP_LH || opcode == OP_LHU ||
-             opcode == OP_LB || opcode == OP_LBU ||
-             opcode == OP_SW || opcode == OP_SH || opcode == OP_SB) {
-        if (token_count < 4) return -1;
-        inst.rt = (uint8_t)c32_parse_register(tokens[1]);
-        inst.rs = (uint8_t)c32_parse_register(tokens[2]);
-        parse_immediate(tokens[3], &imm);
-        inst.immediate = (uint32_t)imm;
-    }
-    /* No operands: NOP, EI, DI, IRET, SYSCALL, BREAK, etc. */
-    else {
-        /* Already initialized to zeros */
-    }
-
-    /* Encode instruction in pass 2 */
-    if (state->pass == 2) {
-        if (state->output_size + 8 > MAX_OUTPUT_SIZE) {
+
+    /* Encode instruction in pass 2 (or the single pass) */
+    if (state->pass == 2 || state->pass == C32_ASM_ONE_PASS) {
+        if (emit_instruction(state, &inst) < 0) {
             return -1;
         }
-        c32_encode_instruction(state->output + state->output_size, &inst);
-        state->output_size += 8;
     }
 
     /* Advance address */
@@ -1,10 +1,159 @@
 /*
  * CRISP-32 Symbol Table Management
+ *
+ * Open-addressing hash table (linear probing) over interned names. The
+ * index always has at least twice as many slots as the table has entries,
+ * so probes stay short and an empty slot always ends a search.
  */
 
 #include "c32_asm.h"
 #include "c32_string.h"
 
+/* Capacity of the first table carved from an arena */
+#define ARENA_MIN_SYMBOLS 64
+
+/* Alignment of entry and index arrays in the arena */
+#define ARENA_ALIGN 8
+
+/* FNV-1a hash of a symbol name */
+static uint32_t hash_name(const char *name) {
+    uint32_t h = 2166136261UL;
+
+    while (*name) {
+        h ^= (uint8_t)*name++;
+        h *= 16777619UL;
+    }
+    return h;
+}
+
+/* Take size bytes from the caller arena, or NULL if it is exhausted */
+static void *arena_alloc(c32_asm_state_t *state, uint32_t size, uint32_t align) {
+    uint32_t start = (state->arena_used + align - 1) & ~(align - 1);
+
+    if (start > state->arena_size || size > state->arena_size - start) {
+        return NULL;
+    }
+    state->arena_used = start + size;
+    return state->arena + start;
+}
+
+/* Copy a name into the symbol store */
+static const char *intern_name(c32_asm_state_t *state, const char *name, size_t len) {
+    char *copy;
+
+    if (state->arena) {
+        copy = (char *)arena_alloc(state, (uint32_t)len + 1, 1);
+    } else if (len + 1 <= sizeof(state->builtin_names) - state->names_used) {
+        copy = state->builtin_names + state->names_used;
+        state->names_used += (uint32_t)len + 1;
+    } else {
+        copy = NULL;
+    }
+    if (copy) {
+        c32_memcpy(copy, name, len + 1);
+    }
+    return copy;
+}
+
+/* Enter symbol idx into the hash index */
+static void index_insert(c32_asm_state_t *state, int idx) {
+    uint32_t slot = state->symbols[idx].hash & state->index_mask;
+
+    while (state->symbol_index[slot] >= 0) {
+        slot = (slot + 1) & state->index_mask;
+    }
+    state->symbol_index[slot] = idx;
+}
+
+/* Double the arena-backed table; the old arrays are left behind */
+static int grow_table(c32_asm_state_t *state) {
+    c32_symbol_t *symbols;
+    int32_t *index;
+    uint32_t max, slots, i;
+
+    max = state->max_symbols ? 2 * (uint32_t)state->max_symbols : ARENA_MIN_SYMBOLS;
+    slots = 2 * max;
+    if (max > 0x3FFFFFFUL) {
+        return -1;
+    }
+
+    symbols = (c32_symbol_t *)arena_alloc(state, max * (uint32_t)sizeof(c32_symbol_t),
+                                          ARENA_ALIGN);
+    if (!symbols) {
+        return -1;
+    }
+    index = (int32_t *)arena_alloc(state, slots * (uint32_t)sizeof(int32_t), ARENA_ALIGN);
+    if (!index) {
+        return -1;
+    }
+
+    if (state->num_symbols > 0) {
+        c32_memcpy(symbols, state->symbols, (size_t)state->num_symbols * sizeof(c32_symbol_t));
+    }
+    for (i = 0; i < slots; i++) {
+        index[i] = -1;
+    }
+
+    state->symbols = symbols;
+    state->max_symbols = (int)max;
+    state->symbol_index = index;
+    state->index_mask = slots - 1;
+    for (i = 0; i < (uint32_t)state->num_symbols; i++) {
+        index_insert(state, (int)i);
+    }
+    return 0;
+}
+
+/* Double the arena-backed fixup table */
+static int grow_fixups(c32_asm_state_t *state) {
+    c32_fixup_t *fixups;
+    uint32_t max;
+
+    max = state->max_fixups ? 2 * (uint32_t)state->max_fixups : ARENA_MIN_SYMBOLS;
+    if (max > 0x3FFFFFFUL) {
+        return -1;
+    }
+    fixups = (c32_fixup_t *)arena_alloc(state, max * (uint32_t)sizeof(c32_fixup_t),
+                                        ARENA_ALIGN);
+    if (!fixups) {
+        return -1;
+    }
+    if (state->num_fixups > 0) {
+        c32_memcpy(fixups, state->fixups, (size_t)state->num_fixups * sizeof(c32_fixup_t));
+    }
+    state->fixups = fixups;
+    state->max_fixups = (int)max;
+    return 0;
+}
+
+/* Append a symbol known not to be in the table */
+static int new_symbol(c32_asm_state_t *state, const char *name, size_t name_len,
+                      uint32_t address, int defined) {
+    const char *copy;
+    int idx;
+
+    if (state->num_symbols >= state->max_symbols &&
+        (!state->arena || grow_table(state) != 0)) {
+        return -3; /* Symbol table full */
+    }
+    copy = intern_name(state, name, name_len);
+    if (!copy) {
+        return -3;
+    }
+
+    idx = state->num_symbols;
+    state->symbols[idx].name = copy;
+    state->symbols[idx].address = address;
+    state->symbols[idx].hash = hash_name(name);
+    state->symbols[idx].defined = defined;
+    state->symbols[idx].section = (uint8_t)(defined ? C32_SECTION_TEXT : C32_SECTION_UNDEF);
+    state->symbols[idx].global = 0;
+    state->num_symbols++;
+    index_insert(state, idx);
+
+    return idx;
+}
+
 /* Initialize assembler state */
 void c32_asm_init(c32_asm_state_t *state) {
     int i;
@@ -12,18 +161,63 @@ void c32_asm_init(c32_asm_state_t *state) {
     state->num_symbols = 0;
     state->current_address = 0;
     state->output_size = 0;
+    state->load_address = C32_ASM_LOAD_ADDR;
+    state->object = 0;
+    state->section = C32_SECTION_TEXT;
+    state->bss_size = 0;
+    state->optimize = 0;
+    state->opt_work = NULL;
+    state->opt_work_size = 0;
+    state->opt_removed = 0;
     state->pass = 1;
     state->errors = 0;
+    state->error_line = 0;
+
+    /* Builtin symbol table until an arena is given */
+    state->symbols = state->builtin_symbols;
+    state->max_symbols = MAX_SYMBOLS;
+    state->symbol_index = state->builtin_index;
+    state->index_mask = 2 * MAX_SYMBOLS - 1;
+    state->arena = NULL;
+    state->arena_size = 0;
+    state->arena_used = 0;
+    state->names_used = 0;
+    for (i = 0; i < 2 * MAX_SYMBOLS; i++) {
+        state->builtin_index[i] = -1;
+    }
+    state->fixups = state->builtin_fixups;
+    state->num_fixups = 0;
+    state->max_fixups = MAX_FIXUPS;
+
+    /* Builtin output buffer, image kept in memory */
+    state->output = state->builtin_output;
+    state->output_capacity = MAX_OUTPUT_SIZE;
+    state->output_flushed = 0;
+    state->output_write = NULL;
+    state->output_ctx = NULL;
+}
+
+/* Move the (empty) symbol table into a caller arena */
+int c32_asm_set_arena(c32_asm_state_t *state, void *arena, uint32_t size) {
+    uint32_t pad;
 
-    /* Clear symbol table */
-    for (i = 0; i < MAX_SYMBOLS; i++) {
-        state->symbols[i].name[0] = '\0';
-        state->symbols[i].address = 0;
-        state->symbols[i].defined = 0;
+    if (!state || !arena || state->num_symbols > 0) {
+        return -1;
     }
 
-    /* Clear output buffer */
-    c32_memset(state->output, 0, MAX_OUTPUT_SIZE);
+    /* Align the base so that arena offsets can be aligned directly */
+    pad = (uint32_t)(-(size_t)arena & (ARENA_ALIGN - 1));
+    state->arena = (uint8_t *)arena + (pad < size ? pad : size);
+    state->arena_size = pad < size ? size - pad : 0;
+    state->arena_used = 0;
+    state->symbols = NULL;
+    state->max_symbols = 0;
+    state->symbol_index = NULL;
+    state->index_mask = 0;
+    state->fixups = NULL;
+    state->num_fixups = 0;
+    state->max_fixups = 0;
+    return 0;
 }
 
 /* Add a symbol to the symbol table */
@@ -54,32 +248,62 @@ int c32_asm_add_symbol(c32_asm_state_t *state, const char *name, uint32_t addres
     }
 
     /* Add new symbol */
-    if (state->num_symbols >= MAX_SYMBOLS) {
-        return -3; /* Symbol table full */
-    }
-
-    idx = state->num_symbols;
-    c32_strcpy(state->symbols[idx].name, name);
-    state->symbols[idx].address = address;
-    state->symbols[idx].defined = 1;
-    state->num_symbols++;
-
-    return idx;
+    return new_symbol(state, name, name_len, address, 1);
 }
 
 /* Find a symbol in the symbol table */
 int c32_asm_find_symbol(c32_asm_state_t *state, const char *name) {
-    int i;
+    uint32_t hash, slot;
+    int32_t idx;
 
-    if (!state || !name) {
+    if (!state || !name || !state->symbol_index) {
         return -1;
     }
 
-    for (i = 0; i < state->num_symbols; i++) {
-        if (c32_strcmp(state->symbols[i].name, name) == 0) {
-            return i;
+    hash = hash_name(name);
+    for (slot = hash & state->index_mask; (idx = state->symbol_index[slot]) >= 0;
+         slot = (slot + 1) & state->index_mask) {
+        if (state->symbols[idx].hash == hash && c32_strcmp(state->symbols[idx].name, name) == 0) {
+            return idx;
         }
     }
 
     return -1;
 }
+
+/* Find a symbol, entering it as undefined if it is new */
+int c32_asm_reference_symbol(c32_asm_state_t *state, const char *name) {
+    int idx;
+    size_t name_len;
+
+    if (!state || !name) {
+        return -1;
+    }
+
+    name_len = c32_strlen(name);
+    if (name_len == 0 || name_len >= MAX_LABEL_LEN) {
+        return -1;
+    }
+
+    idx = c32_asm_find_symbol(state, name);
+    if (idx >= 0) {
+        return idx;
+    }
+    return new_symbol(state, name, name_len, 0, 0);
+}
+
+/* Record a forward reference */
+int c32_asm_add_fixup(c32_asm_state_t *state, int symbol, uint32_t address, int kind) {
+    c32_fixup_t *fixup;
+
+    if (state->num_fixups >= state->max_fixups &&
+        (!state->arena || grow_fixups(state) != 0)) {
+        return -1;
+    }
+
+    fixup = &state->fixups[state->num_fixups++];
+    fixup->address = address;
+    fixup->symbol = symbol;
+    fixup->kind = kind;
+    return 0;
+}
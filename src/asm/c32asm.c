@@ -1,39 +1,81 @@
 /*
  * CRISP-32 Assembler - Main Program
- * Two-pass assembler
+ * Single-pass assembler with fixups (two-pass with -2, objects with -c,
+ * peephole optimizer with -O)
  *
  * Note: This tool uses stdio for file I/O (not freestanding)
  */
 
 #include "c32_asm.h"
+#include "c32_obj.h"
 #include "c32_string.h"
 
 /* We need file I/O, so include stdio */
 #include <stdio.h>
+#include <stdlib.h>
 
-/* Assemble a file */
-int c32_asm_assemble_file(c32_asm_state_t *state, const char *input_file, const char *output_file) {
-    FILE *input;
-    FILE *output;
-    char line[MAX_LINE_LEN];
-    int line_num;
+/* Symbol arena for the command line tool (about 300000 typical labels) */
+#define C32ASM_ARENA_SIZE (16UL * 1024 * 1024)
 
-    if (!state || !input_file || !output_file) {
+/* Output buffer for the command line tool; larger single-pass images spill to host memory */
+#define C32ASM_OUTPUT_SIZE (4UL * 1024 * 1024)
+
+/* Single-pass image kept in memory, so each fixup is a store rather than a seek and write */
+typedef struct {
+    uint8_t *data;
+    uint32_t size;
+    uint32_t capacity;
+} image_t;
+
+/* Output callback: write (or patch) the image file at offset */
+static int file_write(void *ctx, uint32_t offset, const uint8_t *data, uint32_t size) {
+    FILE *output = (FILE *)ctx;
+
+    if (fseek(output, (long)offset, SEEK_SET) != 0 ||
+        fwrite(data, 1, size, output) != size) {
         return -1;
     }
+    return 0;
+}
 
-    /* Pass 1: Collect labels and calculate addresses */
-    state->pass = 1;
-    state->current_address = 0;
-    state->output_size = 0;
+/* Output callback: copy (or patch) the in-memory image, growing it as needed */
+static int image_write(void *ctx, uint32_t offset, const uint8_t *data, uint32_t size) {
+    image_t *image = (image_t *)ctx;
+    uint32_t end = offset + size;
 
-    input = fopen(input_file, "r");
-    if (!input) {
-        fprintf(stderr, "Error: Cannot open input file '%s'\n", input_file);
+    if (end < offset) {
         return -1;
     }
+    if (end > image->capacity) {
+        uint32_t capacity = image->capacity ? image->capacity : (uint32_t)C32ASM_OUTPUT_SIZE;
+        uint8_t *grown;
+
+        while (capacity < end) {
+            if (capacity > 0x7FFFFFFFUL) {
+                capacity = 0xFFFFFFFFUL;
+                break;
+            }
+            capacity *= 2;
+        }
+        grown = (uint8_t *)realloc(image->data, capacity);
+        if (!grown) {
+            return -1;
+        }
+        image->data = grown;
+        image->capacity = capacity;
+    }
+    c32_memcpy(image->data + offset, data, size);
+    if (end > image->size) {
+        image->size = end;
+    }
+    return 0;
+}
+
+/* Run one pass over an open source file */
+static void assemble_stream(c32_asm_state_t *state, FILE *input, const char *name) {
+    char line[MAX_LINE_LEN];
+    int line_num = 0;
 
-    line_num = 0;
     while (fgets(line, MAX_LINE_LEN, input)) {
         size_t len;
         line_num++;
@@ -48,11 +90,83 @@ int c32_asm_assemble_file(c32_asm_state_t *state, const char *input_file, const
         }
 
         if (c32_asm_assemble_line(state, line, line_num) < 0) {
-            fprintf(stderr, "Error: Pass 1, line %d: %s\n", line_num, line);
+            fprintf(stderr, "Error: %s, line %d: %s\n", name, line_num, line);
             state->errors++;
         }
     }
+}
 
+/* Open the image file and stream the output buffer into it (or into image) */
+static FILE *open_output(c32_asm_state_t *state, const char *output_file, image_t *image) {
+    FILE *output = fopen(output_file, "wb");
+
+    if (!output) {
+        fprintf(stderr, "Error: Cannot create output file '%s'\n", output_file);
+        return NULL;
+    }
+    if (image) {
+        c32_asm_set_output(state, state->output, state->output_capacity, image_write, image);
+    } else {
+        c32_asm_set_output(state, state->output, state->output_capacity, file_write, output);
+    }
+    return output;
+}
+
+/* Patch fixups, write the rest of the image and close it */
+static int close_output(c32_asm_state_t *state, FILE *output, const char *output_file,
+                        image_t *image) {
+    int i;
+    int undefined = 0;
+    int status;
+
+    /* The optimizer moves code, so none of it may be in the file yet */
+    if (state->optimize && state->output_flushed != 0) {
+        fprintf(stderr, "Error: Image too large for -O (limit %lu bytes)\n",
+                (unsigned long)C32ASM_OUTPUT_SIZE);
+        fclose(output);
+        remove(output_file);
+        return -1;
+    }
+    status = c32_asm_finish(state);
+    if (status == 0 && image && image->size != 0 &&
+        fwrite(image->data, 1, image->size, output) != image->size) {
+        status = -1;
+    }
+
+    for (i = 0; status < 0 && i < state->num_symbols; i++) {
+        if (!state->symbols[i].defined) {
+            fprintf(stderr, "Error: Undefined label '%s'\n", state->symbols[i].name);
+            undefined++;
+        }
+    }
+    if (fclose(output) != 0 || status < 0) {
+        if (!undefined) {
+            fprintf(stderr, "Error: Failed to write output\n");
+        }
+        remove(output_file);
+        return -1;
+    }
+    return 0;
+}
+
+/* Assemble a file */
+int c32_asm_assemble_file(c32_asm_state_t *state, const char *input_file, const char *output_file) {
+    FILE *input;
+    FILE *output;
+
+    if (!state || !input_file || !output_file) {
+        return -1;
+    }
+
+    /* Pass 1: Collect labels and calculate addresses */
+    c32_asm_begin_pass(state, 1);
+
+    input = fopen(input_file, "r");
+    if (!input) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", input_file);
+        return -1;
+    }
+    assemble_stream(state, input, "Pass 1");
     fclose(input);
 
     if (state->errors > 0) {
@@ -60,92 +174,210 @@ int c32_asm_assemble_file(c32_asm_state_t *state, const char *input_file, const
         return -1;
     }
 
-    /* Pass 2: Generate code */
-    state->pass = 2;
-    state->current_address = 0;
-    state->output_size = 0;
-
+    /* Pass 2: Generate code, streamed to the output file */
     input = fopen(input_file, "r");
     if (!input) {
         fprintf(stderr, "Error: Cannot reopen input file '%s'\n", input_file);
         return -1;
     }
+    output = open_output(state, output_file, NULL);
+    if (!output) {
+        fclose(input);
+        return -1;
+    }
+    c32_asm_begin_pass(state, 2);
+    assemble_stream(state, input, "Pass 2");
+    fclose(input);
 
-    line_num = 0;
-    while (fgets(line, MAX_LINE_LEN, input)) {
-        size_t len;
-        line_num++;
+    if (state->errors > 0) {
+        fprintf(stderr, "Pass 2 failed with %d errors\n", state->errors);
+        fclose(output);
+        remove(output_file);
+        return -1;
+    }
 
-        /* Strip newline */
-        len = c32_strlen(line);
-        if (len > 0 && line[len-1] == '\n') {
-            line[len-1] = '\0';
-        }
-        if (len > 1 && line[len-2] == '\r') {
-            line[len-2] = '\0';
-        }
+    return close_output(state, output, output_file, NULL);
+}
 
-        if (c32_asm_assemble_line(state, line, line_num) < 0) {
-            fprintf(stderr, "Error: Pass 2, line %d: %s\n", line_num, line);
-            state->errors++;
-        }
+/* Assemble a file in a single pass, patching forward references at the end */
+int c32_asm_assemble_file_one_pass(c32_asm_state_t *state, const char *input_file,
+                                   const char *output_file) {
+    FILE *input;
+    FILE *output;
+    image_t image = { NULL, 0, 0 };
+    int status;
+
+    if (!state || !input_file || !output_file) {
+        return -1;
     }
 
+    input = fopen(input_file, "r");
+    if (!input) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", input_file);
+        return -1;
+    }
+    output = open_output(state, output_file, &image);
+    if (!output) {
+        fclose(input);
+        return -1;
+    }
+
+    c32_asm_begin_pass(state, C32_ASM_ONE_PASS);
+    assemble_stream(state, input, "Line pass");
     fclose(input);
 
     if (state->errors > 0) {
-        fprintf(stderr, "Pass 2 failed with %d errors\n", state->errors);
+        fprintf(stderr, "Assembly failed with %d errors\n", state->errors);
+        fclose(output);
+        remove(output_file);
+        free(image.data);
         return -1;
     }
 
-    /* Write output file */
+    status = close_output(state, output, output_file, &image);
+    free(image.data);
+    return status;
+}
+
+/* Assemble a file into a relocatable object */
+static int assemble_object(c32_asm_state_t *state, const char *input_file,
+                           const char *output_file) {
+    FILE *input;
+    FILE *output;
+    int status;
+
+    input = fopen(input_file, "r");
+    if (!input) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", input_file);
+        return -1;
+    }
+
+    /* The code stays in the buffer: relocations are written after it */
+    state->object = 1;
+    c32_asm_begin_pass(state, C32_ASM_ONE_PASS);
+    assemble_stream(state, input, "Line pass");
+    fclose(input);
+
+    if (state->errors > 0) {
+        fprintf(stderr, "Assembly failed with %d errors\n", state->errors);
+        return -1;
+    }
     output = fopen(output_file, "wb");
     if (!output) {
         fprintf(stderr, "Error: Cannot create output file '%s'\n", output_file);
         return -1;
     }
-
-    if (fwrite(state->output, 1, state->output_size, output) != state->output_size) {
+    status = c32_asm_finish(state);
+    if (status == 0) {
+        status = c32_asm_write_object(state, file_write, output);
+    }
+    if (fclose(output) != 0 || status < 0) {
         fprintf(stderr, "Error: Failed to write output\n");
-        fclose(output);
+        remove(output_file);
         return -1;
     }
-
-    fclose(output);
-
     return 0;
 }
 
 int main(int argc, char **argv) {
     c32_asm_state_t state;
+    void *arena;
+    void *work = NULL;
+    uint8_t *buffer;
     const char *input_file;
     const char *output_file;
+    const char *map_file = NULL;
+    int two_pass = 0;
+    int object = 0;
+    int optimize = 0;
+    int argi = 1;
+    int status;
 
-    if (argc != 3) {
-        fprintf(stderr, "Usage: %s <input.asm> <output.bin>\n", argv[0]);
-        fprintf(stderr, "\nCRISP-32 Assembler - Two-pass assembler for CRISP-32 ISA\n");
+    while (argi < argc && argv[argi][0] == '-') {
+        if (c32_strcmp(argv[argi], "-m") == 0 && argi + 1 < argc) {
+            map_file = argv[argi + 1];
+            argi += 2;
+        } else if (c32_strcmp(argv[argi], "-2") == 0) {
+            two_pass = 1;
+            argi++;
+        } else if (c32_strcmp(argv[argi], "-c") == 0) {
+            object = 1;
+            argi++;
+        } else if (c32_strcmp(argv[argi], "-O") == 0) {
+            optimize = 1;
+            argi++;
+        } else {
+            break;
+        }
+    }
+
+    if (argc - argi != 2 || (object && (two_pass || map_file)) || (optimize && two_pass)) {
+        fprintf(stderr, "Usage: %s [-2 | -O] [-m <output.map>] <input.asm> <output.bin>\n", argv[0]);
+        fprintf(stderr, "       %s -c [-O] <input.asm> <output.o32>\n", argv[0]);
+        fprintf(stderr, "\nCRISP-32 Assembler for CRISP-32 ISA\n");
         fprintf(stderr, "Converts assembly language to binary machine code.\n");
+        fprintf(stderr, "  -2               Read the source twice instead of patching forward references\n");
+        fprintf(stderr, "  -m <output.map>  Also write a symbol map (address and label per line)\n");
+        fprintf(stderr, "  -c               Write a relocatable object for c32ld\n");
+        fprintf(stderr, "  -O               Remove redundant instructions (images up to %lu bytes)\n",
+                (unsigned long)C32ASM_OUTPUT_SIZE);
         return 1;
     }
 
-    input_file = argv[1];
-    output_file = argv[2];
+    input_file = argv[argi];
+    output_file = argv[argi + 1];
 
     /* Initialize assembler */
     c32_asm_init(&state);
+    arena = malloc(C32ASM_ARENA_SIZE);
+    buffer = (uint8_t *)malloc(C32ASM_OUTPUT_SIZE);
+    if (!arena || c32_asm_set_arena(&state, arena, (uint32_t)C32ASM_ARENA_SIZE) < 0 ||
+        !buffer || c32_asm_set_output(&state, buffer, (uint32_t)C32ASM_OUTPUT_SIZE, NULL, NULL) < 0) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+    if (optimize) {
+        work = malloc(C32_ASM_OPT_WORK_SIZE(C32ASM_OUTPUT_SIZE));
+        if (!work || c32_asm_set_optimize(&state, work,
+                                          (uint32_t)C32_ASM_OPT_WORK_SIZE(C32ASM_OUTPUT_SIZE)) < 0) {
+            fprintf(stderr, "Error: Out of memory\n");
+            return 1;
+        }
+    }
 
     /* Assemble the file */
-    if (c32_asm_assemble_file(&state, input_file, output_file) < 0) {
+    if (object) {
+        status = assemble_object(&state, input_file, output_file);
+    } else if (two_pass) {
+        status = c32_asm_assemble_file(&state, input_file, output_file);
+    } else {
+        status = c32_asm_assemble_file_one_pass(&state, input_file, output_file);
+    }
+    if (status < 0) {
         fprintf(stderr, "Assembly failed.\n");
         return 1;
     }
 
+    if (map_file && c32_asm_write_map(&state, map_file) < 0) {
+        return 1;
+    }
+
     printf("Assembly successful:\n");
     printf("  Input:   %s\n", input_file);
     printf("  Output:  %s\n", output_file);
     printf("  Size:    %u bytes (%u instructions)\n",
-           state.output_size, state.output_size / 8);
+           c32_asm_image_size(&state), c32_asm_image_size(&state) / 8);
+    if (optimize) {
+        printf("  Removed: %u instructions\n", state.opt_removed);
+    }
+    if (object) {
+        printf("  BSS:     %u bytes\n", state.bss_size);
+        printf("  Relocs:  %d\n", state.num_fixups);
+    }
     printf("  Symbols: %d\n", state.num_symbols);
+    if (map_file) {
+        printf("  Map:     %s\n", map_file);
+    }
 
     return 0;
 }
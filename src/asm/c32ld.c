@@ -0,0 +1,152 @@
+/*
+ * CRISP-32 Linker - Main Program
+ * Combines c32asm -c objects into a flat image
+ *
+ * Note: This tool uses stdio for file I/O (not freestanding)
+ */
+
+#include "c32_obj.h"
+#include "c32_string.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Symbol arena for the global symbols (as c32asm) */
+#define C32LD_ARENA_SIZE (16UL * 1024 * 1024)
+
+/* Read a whole file into a malloc'd buffer */
+static uint8_t *read_file(const char *path, uint32_t *size) {
+    FILE *input = fopen(path, "rb");
+    uint8_t *data;
+    long length;
+
+    if (!input) {
+        fprintf(stderr, "Error: Cannot open input file '%s'\n", path);
+        return NULL;
+    }
+    if (fseek(input, 0, SEEK_END) != 0 || (length = ftell(input)) < 0 ||
+        fseek(input, 0, SEEK_SET) != 0) {
+        fprintf(stderr, "Error: Cannot read input file '%s'\n", path);
+        fclose(input);
+        return NULL;
+    }
+
+    data = (uint8_t *)malloc(length > 0 ? (size_t)length : 1);
+    if (!data || fread(data, 1, (size_t)length, input) != (size_t)length) {
+        fprintf(stderr, "Error: Cannot read input file '%s'\n", path);
+        free(data);
+        fclose(input);
+        return NULL;
+    }
+    fclose(input);
+    *size = (uint32_t)length;
+    return data;
+}
+
+/* Describe a link failure */
+static void report(const c32_link_result_t *result, char **inputs) {
+    const char *where = result->error_object >= 0 ? inputs[result->error_object] : "link";
+
+    switch (result->error) {
+        case C32_LINK_BAD_OBJECT:
+            fprintf(stderr, "Error: %s: Not a valid CRISP-32 object\n", where);
+            break;
+        case C32_LINK_DUPLICATE:
+            fprintf(stderr, "Error: %s: Duplicate definition of '%s'\n", where,
+                    result->error_symbol);
+            break;
+        case C32_LINK_UNDEFINED:
+            fprintf(stderr, "Error: %s: Undefined label '%s'\n", where, result->error_symbol);
+            break;
+        default:
+            fprintf(stderr, "Error: %s: Image or symbol table too large\n", where);
+            break;
+    }
+}
+
+int main(int argc, char **argv) {
+    c32_asm_state_t globals;
+    c32_link_input_t *inputs;
+    c32_link_result_t result;
+    uint8_t *image;
+    void *arena;
+    uint32_t capacity = 0;
+    const char *output_file;
+    const char *map_file = NULL;
+    FILE *output;
+    int argi = 1;
+    int count, i;
+
+    if (argi + 1 < argc && c32_strcmp(argv[argi], "-m") == 0) {
+        map_file = argv[argi + 1];
+        argi += 2;
+    }
+
+    if (argc - argi < 2) {
+        fprintf(stderr, "Usage: %s [-m <output.map>] <output.bin> <input.o32>...\n", argv[0]);
+        fprintf(stderr, "\nCRISP-32 Linker\n");
+        fprintf(stderr, "Combines objects from c32asm -c into a flat image at 0x%08lx.\n",
+                (unsigned long)C32_ASM_LOAD_ADDR);
+        fprintf(stderr, "Each object's .text follows the previous one; .bss follows the image.\n");
+        fprintf(stderr, "  -m <output.map>  Also write a symbol map of the global labels\n");
+        return 1;
+    }
+
+    output_file = argv[argi++];
+    count = argc - argi;
+    inputs = (c32_link_input_t *)malloc((size_t)count * sizeof(c32_link_input_t));
+    if (!inputs) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        inputs[i].data = read_file(argv[argi + i], &inputs[i].size);
+        if (!inputs[i].data) {
+            return 1;
+        }
+        capacity += inputs[i].size;
+    }
+
+    /* The image is no larger than the objects that make it up */
+    c32_asm_init(&globals);
+    arena = malloc(C32LD_ARENA_SIZE);
+    image = (uint8_t *)malloc(capacity > 0 ? capacity : 1);
+    if (!arena || c32_asm_set_arena(&globals, arena, (uint32_t)C32LD_ARENA_SIZE) < 0 || !image) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+
+    if (c32_link(&globals, inputs, count, image, capacity, &result) < 0) {
+        report(&result, argv + argi);
+        fprintf(stderr, "Link failed.\n");
+        return 1;
+    }
+
+    output = fopen(output_file, "wb");
+    if (!output) {
+        fprintf(stderr, "Error: Cannot create output file '%s'\n", output_file);
+        return 1;
+    }
+    if (fwrite(image, 1, result.text_size, output) != result.text_size || fclose(output) != 0) {
+        fprintf(stderr, "Error: Failed to write output\n");
+        remove(output_file);
+        return 1;
+    }
+
+    if (map_file && c32_asm_write_map(&globals, map_file) < 0) {
+        return 1;
+    }
+
+    printf("Link successful:\n");
+    printf("  Objects: %d\n", count);
+    printf("  Output:  %s\n", output_file);
+    printf("  Size:    %u bytes (%u instructions)\n", result.text_size, result.text_size / 8);
+    printf("  BSS:     %u bytes at 0x%08lx\n", result.bss_size,
+           (unsigned long)(result.bss_start + C32_ASM_LOAD_ADDR));
+    printf("  Globals: %d\n", globals.num_symbols);
+    if (map_file) {
+        printf("  Map:     %s\n", map_file);
+    }
+
+    return 0;
+}
@@ -0,0 +1,276 @@
+/**
+ * @file bench.c
+ * @brief CRISP-32 Guest Benchmark Suite
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_vm.h"
+#include "c32_string.h"
+#ifdef C32_USE_JIT
+#include "c32_jit.h"
+#endif
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Include generated kernel headers */
+#include "kernels/bench_alu.h"
+#include "kernels/bench_string.h"
+#include "kernels/bench_bulk.h"
+#include "kernels/bench_list.h"
+#include "kernels/bench_sort.h"
+#include "kernels/bench_muldiv.h"
+#include "kernels/bench_paging.h"
+#include "kernels/bench_superpage.h"
+#include "kernels/bench_interrupt.h"
+
+/**
+ * @defgroup vm_bench Benchmark Suite
+ * @brief Long-running guest kernels timed on the host
+ *
+ * Each kernel runs from a clean VM until it halts with SYSCALL and must
+ * leave its known checksum in R2, so a benchmark run is also a
+ * correctness check. Results are printed as CSV, one line per kernel,
+ * for comparison between builds and releases.
+ * @{
+ */
+
+/** @brief Guest memory size (1MB, 256 pages) */
+#define BENCH_MEMORY_SIZE (1024 * 1024)
+
+/** @brief Kernel load address */
+#define BENCH_LOAD_ADDR 0x1000
+
+/** @brief Instruction budget per kernel run */
+#define BENCH_MAX_STEPS 200000000
+
+/** @brief Decoded instruction cache size (entries) */
+#define BENCH_ICACHE_ENTRIES 4096
+
+/** @brief Default number of timed runs per kernel (best is reported) */
+#define BENCH_DEFAULT_RUNS 3
+
+/**
+ * @brief Benchmark kernel descriptor
+ */
+typedef struct {
+    const char *name;           /**< Kernel name (CSV key) */
+    const uint8_t *program;     /**< Pointer to program binary */
+    uint32_t program_size;      /**< Size of program in bytes */
+    uint32_t expected;          /**< Expected R2 at SYSCALL */
+    uint32_t shadow_banks;      /**< Shadow register banks for interrupt entry */
+} bench_kernel_t;
+
+/**
+ * @brief Benchmark kernels
+ *
+ * Expected values were computed independently of the VM from the
+ * algorithms described at the top of each kernel.
+ */
+static const bench_kernel_t bench_kernels[] = {
+    { "alu",       test_bench_alu,       test_bench_alu_size,       0xFFFFF5F7, 0 },
+    { "string",    test_bench_string,    test_bench_string_size,    0x00321E6F, 0 },
+    { "bulk",      test_bench_bulk,      test_bench_bulk_size,      0x00321E6F, 0 },
+    { "list",      test_bench_list,      test_bench_list_size,      0x1FE70000, 0 },
+    { "sort",      test_bench_sort,      test_bench_sort_size,      0xBEAF351C, 0 },
+    { "muldiv",    test_bench_muldiv,    test_bench_muldiv_size,    0x3A122074, 0 },
+    { "paging",    test_bench_paging,    test_bench_paging_size,    0x355A3400, 0 },
+    { "superpage", test_bench_superpage, test_bench_superpage_size, 0x355A3400, 0 },
+    { "interrupt", test_bench_interrupt, test_bench_interrupt_size, 0x000F4240, 0 },
+    { "interrupt_banked", test_bench_interrupt, test_bench_interrupt_size, 0x000F4240, 1 }
+};
+
+/** @brief Guest memory */
+static uint8_t bench_memory[BENCH_MEMORY_SIZE];
+
+/** @brief Decoded instruction cache buffer */
+static c32_icache_entry_t bench_icache[BENCH_ICACHE_ENTRIES];
+
+#ifdef C32_USE_JIT
+/** @brief Dynamic binary translator state */
+static c32_jit_t bench_jit;
+#endif
+
+/**
+ * @brief Name of the execution engine this binary was built for
+ */
+#if defined(C32_USE_JIT)
+#define BENCH_ENGINE "jit"
+#else
+#define BENCH_ENGINE "interpreter"
+#endif
+
+/**
+ * @brief Current monotonic time in seconds
+ *
+ * @return Seconds since an arbitrary epoch
+ */
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/**
+ * @brief Run a kernel once from a clean VM
+ *
+ * @param kernel Kernel to run
+ * @param vm VM to use
+ * @param steps Receives the number of instructions retired
+ * @param seconds Receives the wall time of the run
+ * @return Why execution stopped
+ */
+static c32_exit_reason_t run_kernel(const bench_kernel_t *kernel, c32_vm_t *vm,
+                                    uint32_t *steps, double *seconds) {
+    c32_exit_reason_t reason;
+    double start;
+
+    c32_memset(bench_memory, 0, sizeof(bench_memory));
+    c32_vm_init(vm, bench_memory, sizeof(bench_memory));
+    c32_vm_set_icache(vm, bench_icache, BENCH_ICACHE_ENTRIES);
+    c32_vm_set_shadow_banks(vm, kernel->shadow_banks);
+    c32_memcpy(bench_memory + BENCH_LOAD_ADDR, kernel->program, kernel->program_size);
+    vm->pc = BENCH_LOAD_ADDR;
+    vm->running = 1;
+
+    start = now_seconds();
+#ifdef C32_USE_JIT
+    if (c32_jit_init(&bench_jit, vm) == 0) {
+        reason = c32_jit_run_for(&bench_jit, BENCH_MAX_STEPS, steps);
+        *seconds = now_seconds() - start;
+        c32_jit_destroy(&bench_jit);
+        return reason;
+    }
+#endif
+    reason = c32_vm_run_for(vm, BENCH_MAX_STEPS, steps);
+    *seconds = now_seconds() - start;
+    return reason;
+}
+
+/**
+ * @brief Print usage information
+ *
+ * @param program_name Name of the program
+ */
+static void print_usage(const char *program_name) {
+    printf("CRISP-32 Benchmark Suite\n");
+    printf("Usage: %s [-r runs] [kernel...]\n\n", program_name);
+    printf("Options:\n");
+    printf("  -r runs        Timed runs per kernel, best is reported (default: %d)\n",
+           BENCH_DEFAULT_RUNS);
+    printf("  kernel         Only run the named kernels\n\n");
+    printf("Output is CSV: kernel,instructions,seconds,mips,result,status\n");
+}
+
+/**
+ * @brief Check whether a kernel was selected on the command line
+ *
+ * @param name Kernel name
+ * @param names Selected names
+ * @param count Number of selected names (0 selects every kernel)
+ * @return 1 if selected, 0 otherwise
+ */
+static int kernel_selected(const char *name, char **names, int count) {
+    int i;
+
+    if (count == 0) {
+        return 1;
+    }
+    for (i = 0; i < count; i++) {
+        if (strcmp(names[i], name) == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/**
+ * @brief Main entry point for the benchmark suite
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return 0 if every kernel produced its expected result, 1 otherwise
+ */
+int main(int argc, char **argv) {
+    c32_vm_t vm;
+    int runs = BENCH_DEFAULT_RUNS;
+    int argi = 1;
+    int status = 0;
+    size_t i;
+
+    if (argi + 1 < argc && strcmp(argv[argi], "-r") == 0) {
+        runs = atoi(argv[argi + 1]);
+        argi += 2;
+    }
+    if (runs < 1 || (argi < argc && argv[argi][0] == '-')) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    printf("# CRISP-32 benchmarks: engine=%s runs=%d\n", BENCH_ENGINE, runs);
+    printf("kernel,instructions,seconds,mips,result,status\n");
+
+    for (i = 0; i < sizeof(bench_kernels) / sizeof(bench_kernels[0]); i++) {
+        const bench_kernel_t *kernel = &bench_kernels[i];
+        c32_exit_reason_t reason = C32_EXIT_HALTED;
+        uint32_t steps = 0;
+        double best = 0.0;
+        const char *verdict;
+        int run;
+
+        if (!kernel_selected(kernel->name, argv + argi, argc - argi)) {
+            continue;
+        }
+
+        for (run = 0; run < runs; run++) {
+            double seconds;
+
+            reason = run_kernel(kernel, &vm, &steps, &seconds);
+            if (run == 0 || seconds < best) {
+                best = seconds;
+            }
+        }
+        if (best <= 0.0) {
+            best = 1e-9;
+        }
+
+        if (reason == C32_EXIT_SYSCALL && vm.regs[2] == kernel->expected) {
+            verdict = "ok";
+        } else if (reason == C32_EXIT_BUDGET) {
+            verdict = "budget";
+        } else if (reason == C32_EXIT_SYSCALL) {
+            verdict = "wrong";
+        } else {
+            verdict = "fault";
+        }
+        if (verdict[0] != 'o') {
+            status = 1;
+        }
+
+        printf("%s,%lu,%.6f,%.1f,0x%08lx,%s\n", kernel->name, (unsigned long)steps,
+               best, (double)steps / best / 1e6, (unsigned long)vm.regs[2], verdict);
+        fflush(stdout);
+    }
+
+    return status;
+}
+
+/** @} */ /* end of vm_bench */
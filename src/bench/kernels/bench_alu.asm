@@ -0,0 +1,23 @@
+# Benchmark: ALU loop
+# 2,000,000 iterations of 11 register-only operations plus loop control.
+# Expected result: R2 = checksum (see bench.c)
+
+start:
+    ADDI R1, R0, 2000000    # Iterations
+    ADDI R2, R0, 0x1234     # Accumulator
+    ADDI R3, R0, 0x5678     # Mixer
+loop:
+    ADD R2, R2, R3
+    XOR R3, R3, R2
+    SLL R4, R2, 3
+    SRL R5, R3, 5
+    OR R4, R4, R5
+    AND R5, R4, R3
+    SUB R2, R2, R5
+    XORI R3, R3, 0x5A5A
+    ADDI R3, R3, 7
+    NOR R6, R2, R3
+    ADDU R2, R2, R6
+    ADDI R1, R1, -1
+    BNE R1, R0, loop
+    SYSCALL                 # Halt
@@ -0,0 +1,25 @@
+/*
+ * Auto-generated from bench_alu.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_bench_alu_H
+#define TEST_bench_alu_H
+
+#include "c32_types.h"
+
+const uint8_t test_bench_alu[] = {
+    0x05, 0x00, 0x01, 0x00, 0x80, 0x84, 0x1e, 0x00, 0x05, 0x00, 0x02, 0x00, 0x34, 0x12, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x03, 0x00, 0x78, 0x56, 0x00, 0x00, 0x01, 0x02, 0x03, 0x02, 0x00, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x12, 0x03, 0x02, 0x03, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x02, 0x04, 0x03, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x21, 0x00, 0x03, 0x05, 0x05, 0x00, 0x00, 0x00, 0x11, 0x04, 0x05, 0x04, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x10, 0x04, 0x03, 0x05, 0x00, 0x00, 0x00, 0x00, 0x03, 0x02, 0x05, 0x02, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x16, 0x03, 0x03, 0x00, 0x5a, 0x5a, 0x00, 0x00, 0x05, 0x03, 0x03, 0x00, 0x07, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x13, 0x02, 0x03, 0x06, 0x00, 0x00, 0x00, 0x00, 0x02, 0x02, 0x06, 0x02, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x01, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0x61, 0x01, 0x00, 0x00, 0x98, 0xff, 0xff, 0xff  /* 0x0070 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0080 */
+};
+
+const uint32_t test_bench_alu_size = 136;
+
+#endif /* TEST_bench_alu_H */
@@ -0,0 +1,52 @@
+# Benchmark: strlen and bulk memcpy
+# The string kernel with its word copy loop replaced by one MEMCPY:
+# fills an 8 KB string at 0x10000, then 400 times measures it byte by
+# byte and copies it to 0x20000. Finally measures the copy.
+# Expected result: R2 = 401 * 8191
+
+start:
+    # Fill 8191 non-zero bytes followed by a terminator
+    ADDI R10, R0, 0x10000   # Source
+    ADDI R11, R0, 0x11FFF   # Last byte
+    ADDI R7, R10, 0
+fill:
+    ANDI R8, R7, 0x7F
+    ORI R8, R8, 1
+    SB R8, R7, 0
+    ADDI R7, R7, 1
+    BNE R7, R11, fill
+    SB R0, R11, 0
+
+    ADDI R2, R0, 0          # Total length
+    ADDI R20, R0, 400       # Passes
+    ADDI R12, R0, 0x20000   # Destination
+pass:
+    # strlen(source)
+    ADDI R7, R10, 0
+slen:
+    LBU R8, R7, 0
+    ADDI R7, R7, 1
+    BNE R8, R0, slen
+    SUB R7, R7, R10
+    ADDI R7, R7, -1
+    ADD R2, R2, R7
+
+    # memcpy(destination, source, 8192), two pages per pass
+    ADDI R7, R10, 0
+    ADDI R9, R12, 0
+    ADDI R8, R0, 8192
+    MEMCPY R9, R7, R8
+
+    ADDI R20, R20, -1
+    BNE R20, R0, pass
+
+    # strlen(destination) proves the copy
+    ADDI R7, R12, 0
+dlen:
+    LBU R8, R7, 0
+    ADDI R7, R7, 1
+    BNE R8, R0, dlen
+    SUB R7, R7, R12
+    ADDI R7, R7, -1
+    ADD R2, R2, R7
+    SYSCALL                 # Halt
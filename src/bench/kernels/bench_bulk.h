@@ -0,0 +1,33 @@
+/*
+ * Auto-generated from bench_bulk.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_bench_bulk_H
+#define TEST_bench_bulk_H
+
+#include "c32_types.h"
+
+const uint8_t test_bench_bulk[] = {
+    0x05, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x05, 0x00, 0x0b, 0x00, 0xff, 0x1f, 0x01, 0x00  /* 0x0000 */,
+    0x05, 0x0a, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x14, 0x07, 0x08, 0x00, 0x7f, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x15, 0x08, 0x08, 0x00, 0x01, 0x00, 0x00, 0x00, 0x5a, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x07, 0x07, 0x00, 0x01, 0x00, 0x00, 0x00, 0x61, 0x07, 0x0b, 0x00, 0xd8, 0xff, 0xff, 0xff  /* 0x0030 */,
+    0x5a, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x05, 0x00, 0x14, 0x00, 0x90, 0x01, 0x00, 0x00, 0x05, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x02, 0x00  /* 0x0050 */,
+    0x05, 0x0a, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x54, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x07, 0x07, 0x00, 0x01, 0x00, 0x00, 0x00, 0x61, 0x08, 0x00, 0x00, 0xe8, 0xff, 0xff, 0xff  /* 0x0070 */,
+    0x03, 0x07, 0x0a, 0x07, 0x00, 0x00, 0x00, 0x00, 0x05, 0x07, 0x07, 0x00, 0xff, 0xff, 0xff, 0xff  /* 0x0080 */,
+    0x01, 0x02, 0x07, 0x02, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0x05, 0x0c, 0x09, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x08, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x00a0 */,
+    0x5c, 0x07, 0x08, 0x09, 0x00, 0x00, 0x00, 0x00, 0x05, 0x14, 0x14, 0x00, 0xff, 0xff, 0xff, 0xff  /* 0x00b0 */,
+    0x61, 0x14, 0x00, 0x00, 0x98, 0xff, 0xff, 0xff, 0x05, 0x0c, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00c0 */,
+    0x54, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x07, 0x07, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x00d0 */,
+    0x61, 0x08, 0x00, 0x00, 0xe8, 0xff, 0xff, 0xff, 0x03, 0x07, 0x0c, 0x07, 0x00, 0x00, 0x00, 0x00  /* 0x00e0 */,
+    0x05, 0x07, 0x07, 0x00, 0xff, 0xff, 0xff, 0xff, 0x01, 0x02, 0x07, 0x02, 0x00, 0x00, 0x00, 0x00  /* 0x00f0 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0100 */
+};
+
+const uint32_t test_bench_bulk_size = 264;
+
+#endif /* TEST_bench_bulk_H */
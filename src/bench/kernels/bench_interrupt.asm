@@ -0,0 +1,34 @@
+# Benchmark: interrupt storm
+# Raises software interrupt 32 one million times with interrupts
+# enabled; every RAISE is dispatched at once (32 register saves), the
+# handler bumps a counter in memory and returns with IRET (32 restores).
+# The interrupt_banked row runs it with one shadow bank instead, where the
+# saved R29 store below lands in unused stack.
+# Expected result: R2 = 1000000
+
+start:
+    J main
+
+# Handler at 0x1008
+handler:
+    LW R8, R0, 0x6000       # Count the interrupt
+    ADDI R8, R8, 1
+    SW R8, R0, 0x6000
+    ADDI R9, R29, 128       # Saved R29 pops the register save area
+    SW R9, R29, 116
+    IRET
+
+main:
+    ADDI R29, R0, 0x70000   # Stack for register save area
+    SW R0, R0, 0x6000       # Clear counter
+    ADDI R1, R0, 0x1008     # Handler address
+    SW R1, R0, 256          # IVT[32]
+    ADDI R1, R0, 1000000    # Interrupts to raise
+    EI
+loop:
+    RAISE 32
+    ADDI R1, R1, -1
+    BNE R1, R0, loop
+
+    LW R2, R0, 0x6000
+    SYSCALL                 # Halt
@@ -0,0 +1,25 @@
+/*
+ * Auto-generated from bench_interrupt.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_bench_interrupt_H
+#define TEST_bench_interrupt_H
+
+#include "c32_types.h"
+
+const uint8_t test_bench_interrupt[] = {
+    0x70, 0x00, 0x00, 0x00, 0x38, 0x10, 0x00, 0x00, 0x50, 0x00, 0x08, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x08, 0x08, 0x00, 0x01, 0x00, 0x00, 0x00, 0x58, 0x00, 0x08, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x1d, 0x09, 0x00, 0x80, 0x00, 0x00, 0x00, 0x58, 0x1d, 0x09, 0x00, 0x74, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x1d, 0x00, 0x00, 0x00, 0x07, 0x00  /* 0x0030 */,
+    0x58, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x08, 0x10, 0x00, 0x00  /* 0x0040 */,
+    0x58, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x40, 0x42, 0x0f, 0x00  /* 0x0050 */,
+    0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf5, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x01, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0x61, 0x01, 0x00, 0x00, 0xe8, 0xff, 0xff, 0xff  /* 0x0070 */,
+    0x50, 0x00, 0x02, 0x00, 0x00, 0x60, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0080 */
+};
+
+const uint32_t test_bench_interrupt_size = 144;
+
+#endif /* TEST_bench_interrupt_H */
@@ -0,0 +1,37 @@
+# Benchmark: linked-list walk
+# Builds 8192 nodes {next, value} at 0x10000 linked in the scattered
+# order p(k) = k * 3001 mod 8192, then walks the list 400 times summing
+# the values (value of the k-th node in list order is k).
+# Expected result: R2 = 400 * (8191 * 8192 / 2) mod 2^32
+
+start:
+    ADDI R10, R0, 0x10000   # Node array
+    ADDI R11, R0, 0         # k
+    ADDI R12, R0, 0         # p(k)
+    ADDI R13, R0, 8192      # Node count
+build:
+    ADDI R14, R12, 3001     # p(k + 1)
+    ANDI R14, R14, 8191
+    SLL R15, R12, 3         # &node[p(k)]
+    ADD R15, R15, R10
+    SLL R16, R14, 3         # &node[p(k + 1)]
+    ADD R16, R16, R10
+    SW R16, R15, 0          # next
+    SW R11, R15, 4          # value
+    ADDI R12, R14, 0
+    ADDI R11, R11, 1
+    BNE R11, R13, build
+    SW R0, R15, 0           # Terminate the list at the last node
+
+    ADDI R2, R0, 0
+    ADDI R20, R0, 400       # Walks
+walk:
+    ADDI R7, R10, 0         # Head is node[p(0)] = node[0]
+node:
+    LW R8, R7, 4
+    ADD R2, R2, R8
+    LW R7, R7, 0
+    BNE R7, R0, node
+    ADDI R20, R20, -1
+    BNE R20, R0, walk
+    SYSCALL                 # Halt
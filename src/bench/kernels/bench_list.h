@@ -0,0 +1,29 @@
+/*
+ * Auto-generated from bench_list.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_bench_list_H
+#define TEST_bench_list_H
+
+#include "c32_types.h"
+
+const uint8_t test_bench_list[] = {
+    0x05, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x05, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x0d, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x0c, 0x0e, 0x00, 0xb9, 0x0b, 0x00, 0x00, 0x14, 0x0e, 0x0e, 0x00, 0xff, 0x1f, 0x00, 0x00  /* 0x0020 */,
+    0x20, 0x00, 0x0c, 0x0f, 0x03, 0x00, 0x00, 0x00, 0x01, 0x0f, 0x0a, 0x0f, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x20, 0x00, 0x0e, 0x10, 0x03, 0x00, 0x00, 0x00, 0x01, 0x10, 0x0a, 0x10, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x58, 0x0f, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58, 0x0f, 0x0b, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x0e, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0b, 0x0b, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x61, 0x0b, 0x0d, 0x00, 0xa8, 0xff, 0xff, 0xff, 0x58, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x14, 0x00, 0x90, 0x01, 0x00, 0x00  /* 0x0080 */,
+    0x05, 0x0a, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x07, 0x08, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0x01, 0x02, 0x08, 0x02, 0x00, 0x00, 0x00, 0x00, 0x50, 0x07, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00a0 */,
+    0x61, 0x07, 0x00, 0x00, 0xe0, 0xff, 0xff, 0xff, 0x05, 0x14, 0x14, 0x00, 0xff, 0xff, 0xff, 0xff  /* 0x00b0 */,
+    0x61, 0x14, 0x00, 0x00, 0xc8, 0xff, 0xff, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00c0 */
+};
+
+const uint32_t test_bench_list_size = 208;
+
+#endif /* TEST_bench_list_H */
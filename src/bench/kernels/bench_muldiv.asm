@@ -0,0 +1,29 @@
+# Benchmark: multiply/divide heavy loop
+# 1,000,000 iterations mixing MUL, MULHU, DIVU, REMU, DIV and REM.
+# Expected result: R2 = checksum (see bench.c)
+
+start:
+    ADDI R1, R0, 1000000    # Iterations (also the loop index)
+    ADDI R2, R0, 0          # Checksum
+    ADDI R3, R0, 1          # x
+    LUI R10, 0x9E37
+    ORI R10, R10, 0x79B1    # Multiplier 2654435761
+    ADDI R11, R0, 1000003   # Modulus
+    ADDI R12, R0, 7
+loop:
+    MUL R3, R3, R10         # x = x * 2654435761 + i
+    ADD R3, R3, R1
+    ORI R5, R1, 1           # Odd, non-zero divisor
+    DIVU R6, R3, R5
+    MULHU R7, R3, R3
+    REMU R8, R3, R11
+    DIV R9, R3, R12
+    REM R13, R3, R12
+    XOR R6, R6, R7
+    XOR R6, R6, R8
+    XOR R6, R6, R9
+    ADD R6, R6, R13
+    ADD R2, R2, R6
+    ADDI R1, R1, -1
+    BNE R1, R0, loop
+    SYSCALL                 # Halt
@@ -0,0 +1,28 @@
+/*
+ * Auto-generated from bench_muldiv.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_bench_muldiv_H
+#define TEST_bench_muldiv_H
+
+#include "c32_types.h"
+
+const uint8_t test_bench_muldiv[] = {
+    0x05, 0x00, 0x01, 0x00, 0x40, 0x42, 0x0f, 0x00, 0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x17, 0x00, 0x0a, 0x00, 0x37, 0x9e, 0x00, 0x00  /* 0x0010 */,
+    0x15, 0x0a, 0x0a, 0x00, 0xb1, 0x79, 0x00, 0x00, 0x05, 0x00, 0x0b, 0x00, 0x43, 0x42, 0x0f, 0x00  /* 0x0020 */,
+    0x05, 0x00, 0x0c, 0x00, 0x07, 0x00, 0x00, 0x00, 0x40, 0x03, 0x0a, 0x03, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x01, 0x03, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x15, 0x01, 0x05, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x44, 0x03, 0x05, 0x06, 0x00, 0x00, 0x00, 0x00, 0x42, 0x03, 0x03, 0x07, 0x00, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x46, 0x03, 0x0b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x43, 0x03, 0x0c, 0x09, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x45, 0x03, 0x0c, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x12, 0x06, 0x07, 0x06, 0x00, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0x12, 0x06, 0x08, 0x06, 0x00, 0x00, 0x00, 0x00, 0x12, 0x06, 0x09, 0x06, 0x00, 0x00, 0x00, 0x00  /* 0x0080 */,
+    0x01, 0x06, 0x0d, 0x06, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x06, 0x02, 0x00, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0x05, 0x01, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0x61, 0x01, 0x00, 0x00, 0x88, 0xff, 0xff, 0xff  /* 0x00a0 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00b0 */
+};
+
+const uint32_t test_bench_muldiv_size = 184;
+
+#endif /* TEST_bench_muldiv_H */
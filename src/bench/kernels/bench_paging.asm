@@ -0,0 +1,45 @@
+# Benchmark: memory loop in paged user mode
+# Identity-maps all 256 pages of guest memory (U, X, W, V), enters user
+# mode and makes 1000 passes over 112 pages (0x10000-0x7FFFF), reading,
+# summing and incrementing 16 words in each page. 112 pages do not fit
+# the 64-entry TLBs, so every page change is a walk.
+# Expected result: R2 = 1792 * (1000 * 999 / 2)
+
+start:
+    # Page table at 0x80000: PTE[i] = (i << 12) | 0xF
+    ADDI R5, R0, 0x80000    # Page table base
+    ADDI R6, R0, 256        # Number of pages
+    ADDI R7, R0, 0          # Page
+fill:
+    SLL R8, R7, 12
+    ORI R8, R8, 0xF
+    SLL R9, R7, 2
+    ADD R9, R9, R5
+    SW R8, R9, 0
+    ADDI R7, R7, 1
+    BNE R7, R6, fill
+
+    SET_PTBR R5, R6
+    ENABLE_PAGING
+    ENTER_USER
+
+    ADDI R2, R0, 0
+    ADDI R20, R0, 1000      # Passes
+    ADDI R11, R0, 0x80000   # End of data pages
+pass:
+    ADDI R10, R0, 0x10000   # Page
+page:
+    ADDI R7, R10, 0
+    ADDI R12, R10, 64       # 16 words
+word:
+    LW R8, R7, 0
+    ADD R2, R2, R8
+    ADDI R8, R8, 1
+    SW R8, R7, 0
+    ADDI R7, R7, 4
+    BNE R7, R12, word
+    ADDI R10, R10, 0x1000
+    BNE R10, R11, page
+    ADDI R20, R20, -1
+    BNE R20, R0, pass
+    SYSCALL                 # Halt (from user mode)
@@ -0,0 +1,31 @@
+/*
+ * Auto-generated from bench_paging.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_bench_paging_H
+#define TEST_bench_paging_H
+
+#include "c32_types.h"
+
+const uint8_t test_bench_paging[] = {
+    0x05, 0x00, 0x05, 0x00, 0x00, 0x00, 0x08, 0x00, 0x05, 0x00, 0x06, 0x00, 0x00, 0x01, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00, 0x20, 0x00, 0x07, 0x08, 0x0c, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x15, 0x08, 0x08, 0x00, 0x0f, 0x00, 0x00, 0x00, 0x20, 0x00, 0x07, 0x09, 0x02, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x01, 0x09, 0x05, 0x09, 0x00, 0x00, 0x00, 0x00, 0x58, 0x09, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x05, 0x07, 0x07, 0x00, 0x01, 0x00, 0x00, 0x00, 0x61, 0x07, 0x06, 0x00, 0xc8, 0xff, 0xff, 0xff  /* 0x0040 */,
+    0xf9, 0x00, 0x06, 0x05, 0x00, 0x00, 0x00, 0x00, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x00, 0x14, 0x00, 0xe8, 0x03, 0x00, 0x00, 0x05, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x08, 0x00  /* 0x0070 */,
+    0x05, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x05, 0x0a, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0080 */,
+    0x05, 0x0a, 0x0c, 0x00, 0x40, 0x00, 0x00, 0x00, 0x50, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0x01, 0x02, 0x08, 0x02, 0x00, 0x00, 0x00, 0x00, 0x05, 0x08, 0x08, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x00a0 */,
+    0x58, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x07, 0x07, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x00b0 */,
+    0x61, 0x07, 0x0c, 0x00, 0xd0, 0xff, 0xff, 0xff, 0x05, 0x0a, 0x0a, 0x00, 0x00, 0x10, 0x00, 0x00  /* 0x00c0 */,
+    0x61, 0x0a, 0x0b, 0x00, 0xb0, 0xff, 0xff, 0xff, 0x05, 0x14, 0x14, 0x00, 0xff, 0xff, 0xff, 0xff  /* 0x00d0 */,
+    0x61, 0x14, 0x00, 0x00, 0x98, 0xff, 0xff, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00e0 */
+};
+
+const uint32_t test_bench_paging_size = 240;
+
+#endif /* TEST_bench_paging_H */
@@ -0,0 +1,51 @@
+# Benchmark: integer insertion sort
+# Fills 2048 words at 0x10000 from a linear congruential generator
+# (x = x * 1103515245 + 12345, element = x >> 8) and sorts them
+# ascending (unsigned).
+# Expected result: R2 = sum of sorted[i] * (i + 1) mod 2^32
+
+start:
+    ADDI R10, R0, 0x10000   # Array
+    ADDI R11, R0, 0x12000   # Array end (2048 words)
+    ADDI R18, R0, 12345     # Seed
+    LUI R19, 0x41C6
+    ORI R19, R19, 0x4E6D    # Multiplier 1103515245
+    ADDI R12, R10, 0
+gen:
+    MUL R18, R18, R19
+    ADDI R18, R18, 12345
+    SRL R20, R18, 8
+    SW R20, R12, 0
+    ADDI R12, R12, 4
+    BNE R12, R11, gen
+
+    ADDI R12, R10, 4        # &a[1]
+outer:
+    LW R13, R12, 0          # key = a[i]
+    ADDI R14, R12, -4       # &a[i - 1]
+inner:
+    SLTU R15, R14, R10      # Ran off the front?
+    BNE R15, R0, place
+    LW R16, R14, 0
+    SLTU R15, R13, R16      # key < a[j]?
+    BEQ R15, R0, place
+    SW R16, R14, 4          # a[j + 1] = a[j]
+    ADDI R14, R14, -4
+    BEQ R0, R0, inner
+place:
+    SW R13, R14, 4          # a[j + 1] = key
+    ADDI R12, R12, 4
+    BNE R12, R11, outer
+
+    # Position-weighted checksum
+    ADDI R2, R0, 0
+    ADDI R12, R10, 0
+    ADDI R17, R0, 1
+sum:
+    LW R13, R12, 0
+    MUL R13, R13, R17
+    ADD R2, R2, R13
+    ADDI R17, R17, 1
+    ADDI R12, R12, 4
+    BNE R12, R11, sum
+    SYSCALL                 # Halt
@@ -0,0 +1,34 @@
+/*
+ * Auto-generated from bench_sort.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_bench_sort_H
+#define TEST_bench_sort_H
+
+#include "c32_types.h"
+
+const uint8_t test_bench_sort[] = {
+    0x05, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x05, 0x00, 0x0b, 0x00, 0x00, 0x20, 0x01, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x12, 0x00, 0x39, 0x30, 0x00, 0x00, 0x17, 0x00, 0x13, 0x00, 0xc6, 0x41, 0x00, 0x00  /* 0x0010 */,
+    0x15, 0x13, 0x13, 0x00, 0x6d, 0x4e, 0x00, 0x00, 0x05, 0x0a, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x40, 0x12, 0x13, 0x12, 0x00, 0x00, 0x00, 0x00, 0x05, 0x12, 0x12, 0x00, 0x39, 0x30, 0x00, 0x00  /* 0x0030 */,
+    0x21, 0x00, 0x12, 0x14, 0x08, 0x00, 0x00, 0x00, 0x58, 0x0c, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x05, 0x0c, 0x0c, 0x00, 0x04, 0x00, 0x00, 0x00, 0x61, 0x0c, 0x0b, 0x00, 0xd0, 0xff, 0xff, 0xff  /* 0x0050 */,
+    0x05, 0x0a, 0x0c, 0x00, 0x04, 0x00, 0x00, 0x00, 0x50, 0x0c, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x0c, 0x0e, 0x00, 0xfc, 0xff, 0xff, 0xff, 0x31, 0x0e, 0x0a, 0x0f, 0x00, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0x61, 0x0f, 0x00, 0x00, 0x30, 0x00, 0x00, 0x00, 0x50, 0x0e, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0080 */,
+    0x31, 0x0d, 0x10, 0x0f, 0x00, 0x00, 0x00, 0x00, 0x60, 0x0f, 0x00, 0x00, 0x18, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0x58, 0x0e, 0x10, 0x00, 0x04, 0x00, 0x00, 0x00, 0x05, 0x0e, 0x0e, 0x00, 0xfc, 0xff, 0xff, 0xff  /* 0x00a0 */,
+    0x60, 0x00, 0x00, 0x00, 0xc0, 0xff, 0xff, 0xff, 0x58, 0x0e, 0x0d, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x00b0 */,
+    0x05, 0x0c, 0x0c, 0x00, 0x04, 0x00, 0x00, 0x00, 0x61, 0x0c, 0x0b, 0x00, 0x98, 0xff, 0xff, 0xff  /* 0x00c0 */,
+    0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x0c, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00d0 */,
+    0x05, 0x00, 0x11, 0x00, 0x01, 0x00, 0x00, 0x00, 0x50, 0x0c, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00e0 */,
+    0x40, 0x0d, 0x11, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x01, 0x02, 0x0d, 0x02, 0x00, 0x00, 0x00, 0x00  /* 0x00f0 */,
+    0x05, 0x11, 0x11, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x0c, 0x0c, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0100 */,
+    0x61, 0x0c, 0x0b, 0x00, 0xd0, 0xff, 0xff, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0110 */
+};
+
+const uint32_t test_bench_sort_size = 288;
+
+#endif /* TEST_bench_sort_H */
@@ -0,0 +1,37 @@
+# Benchmark: the paging kernel's memory loop through one 4 MB superpage
+# Identity-maps the low 4 MB with a single two-level directory entry
+# (S, U, X, W, V), enters user mode and makes the same 1000 passes over
+# 112 pages. Every 4 KB TLB miss is refilled from the superpage TLB.
+# Expected result: R2 = 1792 * (1000 * 999 / 2)
+
+start:
+    # Directory at 0x80000 with one superpage entry at physical 0
+    ADDI R5, R0, 0x80001    # Directory base, two-level
+    ADDI R6, R0, 1          # Number of directory entries
+    ADDI R8, R0, 0x1F
+    SW R8, R0, 0x80000
+
+    SET_PTBR R5, R6
+    ENABLE_PAGING
+    ENTER_USER
+
+    ADDI R2, R0, 0
+    ADDI R20, R0, 1000      # Passes
+    ADDI R11, R0, 0x80000   # End of data pages
+pass:
+    ADDI R10, R0, 0x10000   # Page
+page:
+    ADDI R7, R10, 0
+    ADDI R12, R10, 64       # 16 words
+word:
+    LW R8, R7, 0
+    ADD R2, R2, R8
+    ADDI R8, R8, 1
+    SW R8, R7, 0
+    ADDI R7, R7, 4
+    BNE R7, R12, word
+    ADDI R10, R10, 0x1000
+    BNE R10, R11, page
+    ADDI R20, R20, -1
+    BNE R20, R0, pass
+    SYSCALL                 # Halt (from user mode)
@@ -0,0 +1,28 @@
+/*
+ * Auto-generated from bench_superpage.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_bench_superpage_H
+#define TEST_bench_superpage_H
+
+#include "c32_types.h"
+
+const uint8_t test_bench_superpage[] = {
+    0x05, 0x00, 0x05, 0x00, 0x01, 0x00, 0x08, 0x00, 0x05, 0x00, 0x06, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x08, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x58, 0x00, 0x08, 0x00, 0x00, 0x00, 0x08, 0x00  /* 0x0010 */,
+    0xf9, 0x00, 0x06, 0x05, 0x00, 0x00, 0x00, 0x00, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x05, 0x00, 0x14, 0x00, 0xe8, 0x03, 0x00, 0x00, 0x05, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x08, 0x00  /* 0x0040 */,
+    0x05, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x01, 0x00, 0x05, 0x0a, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x0a, 0x0c, 0x00, 0x40, 0x00, 0x00, 0x00, 0x50, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x01, 0x02, 0x08, 0x02, 0x00, 0x00, 0x00, 0x00, 0x05, 0x08, 0x08, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0x58, 0x07, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x07, 0x07, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0080 */,
+    0x61, 0x07, 0x0c, 0x00, 0xd0, 0xff, 0xff, 0xff, 0x05, 0x0a, 0x0a, 0x00, 0x00, 0x10, 0x00, 0x00  /* 0x0090 */,
+    0x61, 0x0a, 0x0b, 0x00, 0xb0, 0xff, 0xff, 0xff, 0x05, 0x14, 0x14, 0x00, 0xff, 0xff, 0xff, 0xff  /* 0x00a0 */,
+    0x61, 0x14, 0x00, 0x00, 0x98, 0xff, 0xff, 0xff, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00b0 */
+};
+
+const uint32_t test_bench_superpage_size = 192;
+
+#endif /* TEST_bench_superpage_H */
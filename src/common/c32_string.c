@@ -26,12 +26,23 @@
  * @{
  */
 
+/** @brief Bytes in the word type used by the bulk loops */
+#define WORD_SIZE sizeof(size_t)
+
+/** @brief Mask of the address bits below word alignment */
+#define WORD_MASK (WORD_SIZE - 1)
+
+/** @brief Non-zero if p is word aligned */
+#define WORD_ALIGNED(p) (((size_t)(p) & WORD_MASK) == 0)
+
 /**
  * @brief Copy memory block
  *
  * Copies n bytes from source to destination. The memory areas must not
  * overlap (use memmove for overlapping regions, if available).
- * This is a simple byte-by-byte copy implementation.
+ * When both pointers share the same alignment, the bulk of the block is
+ * moved a word at a time with byte loops for the unaligned head and the
+ * tail; otherwise the copy is byte-by-byte.
  *
  * @param dest Destination pointer
  * @param src Source pointer
@@ -41,10 +52,37 @@
 void *c32_memcpy(void *dest, const void *src, size_t n) {
     unsigned char *d = (unsigned char *)dest;
     const unsigned char *s = (const unsigned char *)src;
-    size_t i;
 
-    for (i = 0; i < n; i++) {
-        d[i] = s[i];
+    if (n >= 2 * WORD_SIZE && (((size_t)d ^ (size_t)s) & WORD_MASK) == 0) {
+        size_t *dw;
+        const size_t *sw;
+
+        while (!WORD_ALIGNED(d)) {
+            *d++ = *s++;
+            n--;
+        }
+
+        dw = (size_t *)d;
+        sw = (const size_t *)s;
+        while (n >= 4 * WORD_SIZE) {
+            dw[0] = sw[0];
+            dw[1] = sw[1];
+            dw[2] = sw[2];
+            dw[3] = sw[3];
+            dw += 4;
+            sw += 4;
+            n -= 4 * WORD_SIZE;
+        }
+        while (n >= WORD_SIZE) {
+            *dw++ = *sw++;
+            n -= WORD_SIZE;
+        }
+        d = (unsigned char *)dw;
+        s = (const unsigned char *)sw;
+    }
+
+    while (n--) {
+        *d++ = *s++;
     }
 
     return dest;
@@ -55,6 +93,7 @@ void *c32_memcpy(void *dest, const void *src, size_t n) {
  *
  * Fills the first n bytes of the memory area pointed to by s with
  * the constant byte c. The value c is converted to unsigned char.
+ * Large fills store a replicated word after aligning the pointer.
  *
  * @param s Pointer to memory area
  * @param c Value to fill (converted to unsigned char)
@@ -63,10 +102,42 @@ void *c32_memcpy(void *dest, const void *src, size_t n) {
  */
 void *c32_memset(void *s, int c, size_t n) {
     unsigned char *p = (unsigned char *)s;
-    size_t i;
+    unsigned char b = (unsigned char)c;
+
+    if (n >= 2 * WORD_SIZE) {
+        size_t *pw;
+        size_t w = b;
+
+        /* Replicate the byte into every lane; split shift avoids >= width */
+        w |= w << 8;
+        w |= w << 16;
+        if (WORD_SIZE > 4) {
+            w |= (w << 16) << 16;
+        }
 
-    for (i = 0; i < n; i++) {
-        p[i] = (unsigned char)c;
+        while (!WORD_ALIGNED(p)) {
+            *p++ = b;
+            n--;
+        }
+
+        pw = (size_t *)p;
+        while (n >= 4 * WORD_SIZE) {
+            pw[0] = w;
+            pw[1] = w;
+            pw[2] = w;
+            pw[3] = w;
+            pw += 4;
+            n -= 4 * WORD_SIZE;
+        }
+        while (n >= WORD_SIZE) {
+            *pw++ = w;
+            n -= WORD_SIZE;
+        }
+        p = (unsigned char *)pw;
+    }
+
+    while (n--) {
+        *p++ = b;
     }
 
     return s;
@@ -79,6 +150,8 @@ void *c32_memset(void *s, int c, size_t n) {
  * Returns an integer less than, equal to, or greater than zero
  * if the first n bytes of s1 is found to be less than, equal to,
  * or greater than the first n bytes of s2.
+ * Equal words are skipped a word at a time when both areas share the
+ * same alignment; the first differing word is resolved bytewise.
  *
  * @param s1 First memory area
  * @param s2 Second memory area
@@ -88,12 +161,36 @@ void *c32_memset(void *s, int c, size_t n) {
 int c32_memcmp(const void *s1, const void *s2, size_t n) {
     const unsigned char *p1 = (const unsigned char *)s1;
     const unsigned char *p2 = (const unsigned char *)s2;
-    size_t i;
 
-    for (i = 0; i < n; i++) {
-        if (p1[i] != p2[i]) {
-            return p1[i] - p2[i];
+    if (n >= 2 * WORD_SIZE && (((size_t)p1 ^ (size_t)p2) & WORD_MASK) == 0) {
+        const size_t *w1, *w2;
+
+        while (!WORD_ALIGNED(p1)) {
+            if (*p1 != *p2) {
+                return *p1 - *p2;
+            }
+            p1++;
+            p2++;
+            n--;
+        }
+
+        w1 = (const size_t *)p1;
+        w2 = (const size_t *)p2;
+        while (n >= WORD_SIZE && *w1 == *w2) {
+            w1++;
+            w2++;
+            n -= WORD_SIZE;
+        }
+        p1 = (const unsigned char *)w1;
+        p2 = (const unsigned char *)w2;
+    }
+
+    while (n--) {
+        if (*p1 != *p2) {
+            return *p1 - *p2;
         }
+        p1++;
+        p2++;
     }
 
     return 0;
@@ -22,9 +22,58 @@
 #include "c32_test.h"
 #include "c32_vm.h"
 #include "c32_string.h"
+#ifdef C32_USE_JIT
+#include "c32_jit.h"
+#endif
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <stdarg.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef C32_USE_JIT
+/** @brief JIT state for c32_run_test() (too large for the stack) */
+static c32_jit_t test_jit;
+#endif
+
+/**
+ * @brief Suite being run and shared scheduling state
+ */
+typedef struct {
+    const c32_test_case_t *tests;
+    int test_count;
+    uint32_t repeat;
+    c32_test_report_t *reports;
+    int print_each;             /**< Print each report as it completes */
+
+    pthread_mutex_t lock;
+    int next_test;              /**< Next unclaimed test (guarded by lock) */
+} test_run_t;
+
+/**
+ * @brief Per-thread arena: everything a worker needs to run a test
+ */
+typedef struct {
+    test_run_t *run;
+    pthread_t thread;
+    uint8_t *memory;
+    uint32_t memory_size;
+#ifdef C32_USE_JIT
+    c32_jit_t *jit;
+#endif
+} test_worker_t;
+
+/**
+ * @brief Monotonic wall clock in seconds
+ */
+static double now_seconds(void) {
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
 
 /**
  * @brief Load a test program into VM memory
@@ -41,28 +90,37 @@ static int load_test_program(c32_vm_t *vm, const uint8_t *program,
         return -1;
     }
     c32_memcpy(vm->memory + load_addr, program, size);
+    c32_vm_icache_invalidate(vm, load_addr, size);
     return 0;
 }
 
 /**
- * @brief Run a single test case
- *
- * Loads the program, executes it, and runs the test validation function.
+ * @brief Run a test case once without printing
  *
  * @param test_case Pointer to test case definition
- * @param memory Memory buffer for VM (must be at least 64KB)
+ * @param memory Memory buffer for VM
  * @param memory_size Size of memory buffer
+ * @param jit Translator to run the program with (JIT builds), or NULL
+ * @param ctx Context receiving the VM and any failure message
+ * @param steps Receives the instructions the program executed
  * @return Test status (PASS, FAIL, or ERROR)
  */
-c32_test_status_t c32_run_test(const c32_test_case_t *test_case,
-                                uint8_t *memory,
-                                uint32_t memory_size) {
+static c32_test_status_t run_case(const c32_test_case_t *test_case,
+                                  uint8_t *memory, uint32_t memory_size,
+                                  void *jit, c32_test_ctx_t *ctx, uint32_t *steps) {
     c32_vm_t vm;
-    c32_test_ctx_t ctx;
+    c32_icache_entry_t icache[C32_TEST_ICACHE_ENTRIES];
     uint32_t load_addr;
     uint32_t max_steps;
-    int step;
-    int result;
+    c32_exit_reason_t reason;
+    int i;
+
+    *steps = 0;
+    ctx->vm = &vm;
+    ctx->has_failure = 0;
+    for (i = 0; i < C32_TEST_MAX_MSG; i++) {
+        ctx->failure_msg[i] = '\0';
+    }
 
     /* Validate inputs */
     if (!test_case || !test_case->program || !test_case->test_fn || !memory) {
@@ -71,6 +129,7 @@ c32_test_status_t c32_run_test(const c32_test_case_t *test_case,
 
     /* Initialize VM */
     c32_vm_init(&vm, memory, memory_size);
+    c32_vm_set_icache(&vm, icache, C32_TEST_ICACHE_ENTRIES);
 
     /* Use defaults if not specified */
     load_addr = test_case->load_addr ? test_case->load_addr : C32_TEST_DEFAULT_LOAD_ADDR;
@@ -86,87 +145,281 @@ c32_test_status_t c32_run_test(const c32_test_case_t *test_case,
     vm.running = 1;
 
     /* Execute program */
-    for (step = 0; step < (int)max_steps && vm.running; step++) {
-        if (c32_vm_step(&vm) != 0) {
-            /* VM error occurred */
-            return C32_TEST_ERROR;
-        }
+#ifdef C32_USE_JIT
+    if (jit && c32_jit_init((c32_jit_t *)jit, &vm) == 0) {
+        reason = c32_jit_run_for((c32_jit_t *)jit, max_steps, steps);
+        c32_jit_destroy((c32_jit_t *)jit);
+    } else {
+        reason = c32_vm_run_for(&vm, max_steps, steps);
+    }
+#else
+    (void)jit;
+    reason = c32_vm_run_for(&vm, max_steps, steps);
+#endif
+    if ((reason == C32_EXIT_FAULT) != (test_case->expect_fault != 0)) {
+        /* Unexpected VM error, or a fault that never came */
+        return C32_TEST_ERROR;
     }
 
     /* Check for timeout */
-    if (vm.running) {
+    if (reason == C32_EXIT_BUDGET) {
         /* Program did not halt within max_steps */
         return C32_TEST_ERROR;
     }
 
-    /* Initialize test context */
-    ctx.vm = &vm;
-    ctx.has_failure = 0;
-    {
-        int i;
-        for (i = 0; i < C32_TEST_MAX_MSG; i++) {
-            ctx.failure_msg[i] = '\0';
-        }
-    }
-
     /* Run test validation function */
-    result = test_case->test_fn(&ctx);
+    return (c32_test_status_t)test_case->test_fn(ctx);
+}
+
+/**
+ * @brief Run a single test case
+ *
+ * Loads the program, executes it, and runs the test validation function.
+ *
+ * @param test_case Pointer to test case definition
+ * @param memory Memory buffer for VM (must be at least 64KB)
+ * @param memory_size Size of memory buffer
+ * @return Test status (PASS, FAIL, or ERROR)
+ */
+c32_test_status_t c32_run_test(const c32_test_case_t *test_case,
+                                uint8_t *memory,
+                                uint32_t memory_size) {
+    c32_test_ctx_t ctx;
+    c32_test_status_t status;
+    uint32_t steps;
+    void *jit = NULL;
+
+#ifdef C32_USE_JIT
+    jit = &test_jit;
+#endif
+    status = run_case(test_case, memory, memory_size, jit, &ctx, &steps);
 
     /* Print failure message if test failed */
-    if (result == C32_TEST_FAIL && ctx.failure_msg[0] != '\0') {
+    if (status == C32_TEST_FAIL && ctx.failure_msg[0] != '\0') {
         printf("    %s\n", ctx.failure_msg);
     }
 
-    return (c32_test_status_t)result;
+    return status;
 }
 
 /**
- * @brief Run a suite of test cases
+ * @brief Run one test case of a suite, repeat times, into its report
+ */
+static void run_report(test_worker_t *worker, int index) {
+    const test_run_t *run = worker->run;
+    c32_test_report_t *report = &run->reports[index];
+    c32_test_ctx_t ctx;
+    void *jit = NULL;
+
+#ifdef C32_USE_JIT
+    jit = worker->jit;
+#endif
+    report->runs = 0;
+    report->seconds = 0.0;
+    report->min_seconds = 0.0;
+    do {
+        double start = now_seconds();
+        double elapsed;
+
+        report->status = run_case(&run->tests[index], worker->memory, worker->memory_size,
+                                  jit, &ctx, &report->steps);
+        elapsed = now_seconds() - start;
+        if (report->runs == 0 || elapsed < report->min_seconds) {
+            report->min_seconds = elapsed;
+        }
+        report->seconds += elapsed;
+        report->runs++;
+    } while (report->status == C32_TEST_PASS && report->runs < run->repeat);
+
+    c32_memcpy(report->failure_msg, ctx.failure_msg, C32_TEST_MAX_MSG);
+}
+
+/**
+ * @brief Print one test's report line (and failure message)
+ */
+static void print_report(const test_run_t *run, int index) {
+    const c32_test_report_t *report = &run->reports[index];
+    static const char *const names[] = { "PASS", "FAIL", "ERROR" };
+
+    printf("[%d/%d] %s ... %s  (%lu steps, %.3f ms", index + 1, run->test_count,
+           run->tests[index].name, names[report->status], (unsigned long)report->steps,
+           report->seconds * 1e3 / report->runs);
+    if (report->runs > 1) {
+        printf(" mean, %.3f ms min, %lu runs", report->min_seconds * 1e3,
+               (unsigned long)report->runs);
+    }
+    printf(")\n");
+    if (report->status == C32_TEST_FAIL && report->failure_msg[0] != '\0') {
+        printf("    %s\n", report->failure_msg);
+    }
+}
+
+/**
+ * @brief Claim the next test case
  *
- * Executes multiple test cases and accumulates results.
+ * @return Test index, or -1 when every case is taken
+ */
+static int claim_test(test_run_t *run) {
+    int index;
+
+    pthread_mutex_lock(&run->lock);
+    index = run->next_test < run->test_count ? run->next_test++ : -1;
+    pthread_mutex_unlock(&run->lock);
+    return index;
+}
+
+/**
+ * @brief Worker thread: run test cases until none are left
+ */
+static void *worker_main(void *arg) {
+    test_worker_t *worker = (test_worker_t *)arg;
+    int index;
+
+    while ((index = claim_test(worker->run)) >= 0) {
+        run_report(worker, index);
+        if (worker->run->print_each) {
+            print_report(worker->run, index);
+            fflush(stdout);
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Run a suite of test cases with options
  *
  * @param tests Array of test cases
  * @param test_count Number of test cases in array
+ * @param options Run options, or NULL for one run on the calling thread
  * @param results Pointer to results structure to populate
+ * @return 0 on success, -1 if worker memory could not be allocated
  */
-void c32_run_test_suite(const c32_test_case_t *tests,
-                        int test_count,
-                        c32_test_results_t *results) {
-    static uint8_t test_memory[65536];
-    int i;
+int c32_run_test_suite_opts(const c32_test_case_t *tests,
+                            int test_count,
+                            const c32_test_options_t *options,
+                            c32_test_results_t *results) {
+    static test_worker_t workers[C32_TEST_MAX_WORKERS];
+    test_run_t run;
+    uint32_t memory_size = C32_TEST_MEMORY_SIZE;
+    double start;
+    int threads = 1, started, i;
 
     c32_test_results_init(results);
 
-    printf("Running test suite (%d tests)...\n\n", test_count);
-
-    for (i = 0; i < test_count; i++) {
-        c32_test_status_t status;
-        const c32_test_case_t *test = &tests[i];
+    run.tests = tests;
+    run.test_count = test_count;
+    run.repeat = 1;
+    run.next_test = 0;
+    if (options) {
+        threads = options->workers;
+        run.repeat = options->repeat ? options->repeat : 1;
+        memory_size = options->memory_size ? options->memory_size : memory_size;
+    }
+    if (threads <= 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (int)online : 1;
+    }
+    if (threads > C32_TEST_MAX_WORKERS) {
+        threads = C32_TEST_MAX_WORKERS;
+    }
+    if (threads > test_count) {
+        threads = test_count > 0 ? test_count : 1;
+    }
 
-        printf("[%d/%d] %s ... ", i + 1, test_count, test->name);
-        fflush(stdout);
+    run.reports = (c32_test_report_t *)calloc(test_count > 0 ? (size_t)test_count : 1,
+                                              sizeof(c32_test_report_t));
+    if (!run.reports) {
+        return -1;
+    }
 
-        status = c32_run_test(test, test_memory, sizeof(test_memory));
+    /* Per-thread arenas; run with fewer workers if memory runs out */
+    for (i = 0; i < threads; i++) {
+        workers[i].run = &run;
+        workers[i].memory_size = memory_size;
+        workers[i].memory = (uint8_t *)malloc(memory_size ? memory_size : 1);
+#ifdef C32_USE_JIT
+        workers[i].jit = (c32_jit_t *)malloc(sizeof(c32_jit_t));
+        if (!workers[i].jit) {
+            free(workers[i].memory);
+            break;
+        }
+#endif
+        if (!workers[i].memory) {
+#ifdef C32_USE_JIT
+            free(workers[i].jit);
+#endif
+            break;
+        }
+    }
+    threads = i;
+    if (threads == 0) {
+        free(run.reports);
+        return -1;
+    }
+    run.print_each = threads == 1;
 
-        results->total++;
+    if (threads == 1) {
+        printf("Running test suite (%d tests)...\n\n", test_count);
+    } else {
+        printf("Running test suite (%d tests, %d workers)...\n\n", test_count, threads);
+    }
+    fflush(stdout);
+    pthread_mutex_init(&run.lock, NULL);
 
-        switch (status) {
-            case C32_TEST_PASS:
-                printf("PASS\n");
-                results->passed++;
-                break;
-            case C32_TEST_FAIL:
-                printf("FAIL\n");
-                results->failed++;
-                break;
-            case C32_TEST_ERROR:
-                printf("ERROR\n");
-                results->errors++;
-                break;
+    /* The calling thread is worker 0; a worker that fails to start is not needed */
+    start = now_seconds();
+    for (started = 1; started < threads; started++) {
+        if (pthread_create(&workers[started].thread, NULL, worker_main,
+                           &workers[started]) != 0) {
+            break;
         }
     }
+    worker_main(&workers[0]);
+    for (i = 1; i < started; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    results->seconds = now_seconds() - start;
+    pthread_mutex_destroy(&run.lock);
 
+    for (i = 0; i < test_count; i++) {
+        if (!run.print_each) {
+            print_report(&run, i);
+        }
+        results->total++;
+        switch (run.reports[i].status) {
+            case C32_TEST_PASS: results->passed++; break;
+            case C32_TEST_FAIL: results->failed++; break;
+            case C32_TEST_ERROR: results->errors++; break;
+        }
+    }
     printf("\n");
+
+    for (i = 0; i < threads; i++) {
+        free(workers[i].memory);
+#ifdef C32_USE_JIT
+        free(workers[i].jit);
+#endif
+    }
+    free(run.reports);
+    return 0;
+}
+
+/**
+ * @brief Run a suite of test cases
+ *
+ * Executes multiple test cases and accumulates results.
+ *
+ * @param tests Array of test cases
+ * @param test_count Number of test cases in array
+ * @param results Pointer to results structure to populate
+ */
+void c32_run_test_suite(const c32_test_case_t *tests,
+                        int test_count,
+                        c32_test_results_t *results) {
+    if (c32_run_test_suite_opts(tests, test_count, NULL, results) != 0) {
+        printf("Cannot allocate test memory\n");
+        results->errors++;
+    }
 }
 
 /**
@@ -179,6 +432,7 @@ void c32_test_results_init(c32_test_results_t *results) {
     results->passed = 0;
     results->failed = 0;
     results->errors = 0;
+    results->seconds = 0.0;
 }
 
 /**
@@ -196,6 +450,7 @@ void c32_test_print_results(const c32_test_results_t *results) {
     printf("Passed: %d\n", results->passed);
     printf("Failed: %d\n", results->failed);
     printf("Errors: %d\n", results->errors);
+    printf("Time:   %.3f s\n", results->seconds);
     printf("========================================\n");
 
     if (results->failed == 0 && results->errors == 0) {
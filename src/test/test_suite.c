@@ -21,6 +21,15 @@
 
 #include "c32_test.h"
 #include "c32_vm.h"
+#include "c32_opcodes.h"
+#include "c32_vring.h"
+#include "c32_checkpoint.h"
+#include "c32_string.h"
+#include "c32_asm.h"
+#include "c32_obj.h"
+
+#include <stdio.h>
+#include <stdlib.h>
 
 /* Include generated test program headers */
 #include "unit/test_add.h"
@@ -34,6 +43,29 @@
 #include "unit/test_compare.h"
 #include "unit/test_branch_variants.h"
 #include "unit/test_div.h"
+#include "unit/test_icache.h"
+#include "unit/test_tlb.h"
+#include "unit/test_interrupt.h"
+#include "unit/test_fusion.h"
+#include "unit/test_snapshot.h"
+#include "unit/test_stats.h"
+#include "unit/test_profile.h"
+#include "unit/test_trace.h"
+#include "unit/test_syscall.h"
+#include "unit/test_mmio.h"
+#include "unit/test_vring.h"
+#include "unit/test_timer.h"
+#include "unit/test_checkpoint.h"
+#include "unit/test_asm_buffer.h"
+#include "unit/test_link.h"
+#include "unit/test_optimize.h"
+#include "unit/test_shadow.h"
+#include "unit/test_superpage.h"
+#include "unit/test_bulk.h"
+#include "unit/test_fetch_fault.h"
+#include "unit/test_fetch_top.h"
+#include "unit/test_fused_opcode.h"
+#include "unit/test_reg_field.h"
 
 /**
  * @brief Test validation function for ADD instruction
@@ -109,6 +141,9 @@ static int test_branch_validation(c32_test_ctx_t *ctx) {
 static int test_load_store_validation(c32_test_ctx_t *ctx) {
     C32_ASSERT_REG_EQ(ctx, 1, 0x12345678);
     C32_ASSERT_REG_EQ(ctx, 2, 0x12345678);
+    C32_ASSERT_REG_EQ(ctx, 4, 77);        /* Loads past the top of memory do nothing */
+    C32_ASSERT_REG_EQ(ctx, 5, 77);
+    C32_ASSERT_REG_EQ(ctx, 6, 77);
     C32_ASSERT_MEM_WORD_EQ(ctx, 0x2000, 0x12345678);
     C32_ASSERT_HALTED(ctx);
     return C32_TEST_PASS;
@@ -160,6 +195,1131 @@ static int test_div_validation(c32_test_ctx_t *ctx) {
     C32_ASSERT_REG_EQ(ctx, 8, 0);         /* 1000 % 25 */
     C32_ASSERT_REG_EQ(ctx, 10, 1);        /* MULH: high bits of 65536*65536 */
     C32_ASSERT_REG_EQ(ctx, 11, 1);        /* MULHU: high bits of 65536*65536 */
+    C32_ASSERT_REG_EQ(ctx, 13, 0xFFFFFFFE); /* MULHU: carry from partial products */
+    C32_ASSERT_REG_EQ(ctx, 14, 0);        /* MULH: -1 * -1 */
+    C32_ASSERT_REG_EQ(ctx, 16, 0x80000000); /* INT_MIN / -1 */
+    C32_ASSERT_REG_EQ(ctx, 17, 0);        /* INT_MIN % -1 */
+    C32_ASSERT_REG_EQ(ctx, 19, 100);      /* -100 / -1 */
+    C32_ASSERT_HALTED(ctx);
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for self-modifying code
+ */
+static int test_icache_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_REG_EQ(ctx, 3, 101);       /* 1 + 100 after patch */
+    C32_ASSERT_REG_EQ(ctx, 5, 2);         /* Patched instruction ran twice */
+    C32_ASSERT_HALTED(ctx);
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for TLB invalidation on page table store
+ */
+static int test_tlb_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_REG_EQ(ctx, 10, 11);       /* Original mapping */
+    C32_ASSERT_REG_EQ(ctx, 12, 22);       /* Remapped after PTE store */
+    C32_ASSERT_HALTED(ctx);
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for two-level tables and superpages
+ */
+static int test_superpage_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_REG_EQ(ctx, 10, 11);       /* Superpage identity map */
+    C32_ASSERT_REG_EQ(ctx, 11, 22);       /* Second-level PTE */
+    C32_ASSERT_REG_EQ(ctx, 12, 11);       /* Superpage alias */
+    C32_ASSERT_REG_EQ(ctx, 13, 33);       /* Remapped after PTE store */
+    C32_ASSERT_REG_EQ(ctx, 14, 22);       /* Superpage replaced by a table */
+    C32_ASSERT_REG_EQ(ctx, 15, 44);       /* Table replaced by a superpage */
+    C32_ASSERT_HALTED(ctx);
+
+    /* The code and low data ran through one cached superpage entry */
+    if (ctx->vm->stlb[0].vpn != 0) {
+        C32_ASSERT_FAIL(ctx, "Superpage 0 not in the superpage TLB");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for bulk memory instructions
+ */
+static int test_bulk_validation(c32_test_ctx_t *ctx) {
+    static c32_asm_state_t state;
+    static const char alias[] = "MEMCPY R1, R2, R1\n";
+    static uint8_t buf[16];
+
+    C32_ASSERT_REG_EQ(ctx, 1, 0x6389);          /* MEMCPY advanced both */
+    C32_ASSERT_REG_EQ(ctx, 2, 0x438B);
+    C32_ASSERT_REG_EQ(ctx, 3, 0);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x5001, 0x00300400);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x6002, 0x00004004);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x6385, 0x00438800);
+    C32_ASSERT_MEM_BYTE_EQ(ctx, 0x6389, 0x77);
+
+    C32_ASSERT_REG_EQ(ctx, 4, 0x712D);          /* MEMSET keeps the value */
+    C32_ASSERT_REG_EQ(ctx, 5, 0x1AB);
+    C32_ASSERT_REG_EQ(ctx, 6, 0);
+    C32_ASSERT_MEM_BYTE_EQ(ctx, 0x7000, 0x66);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x7001, 0xABABABAB);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x7129, 0xABABABAB);
+    C32_ASSERT_MEM_BYTE_EQ(ctx, 0x712D, 0x77);
+
+    C32_ASSERT_REG_EQ(ctx, 7, 0x6389);          /* Equal: length reaches 0 */
+    C32_ASSERT_REG_EQ(ctx, 9, 0);
+    C32_ASSERT_REG_EQ(ctx, 10, 0x6195);         /* Differ: stops at the byte */
+    C32_ASSERT_REG_EQ(ctx, 11, 0x4197);
+    C32_ASSERT_REG_EQ(ctx, 12, 500);
+
+    C32_ASSERT_REG_EQ(ctx, 13, 0xC800);         /* Restarted after the fault */
+    C32_ASSERT_REG_EQ(ctx, 14, 0x4000);
+    C32_ASSERT_REG_EQ(ctx, 15, 0);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x9000, 1);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0xB800, 0x3000);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0xC7FC, 0x3FFC);
+    C32_ASSERT_HALTED(ctx);
+
+    /* Operand registers are updated in place, so they may not alias */
+    c32_asm_init(&state);
+    if (c32_asm_assemble_buffer(&state, alias, sizeof(alias) - 1, buf, sizeof(buf)) != -1) {
+        C32_ASSERT_FAIL(ctx, "Aliased MEMCPY registers accepted");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for superinstruction fusion
+ */
+static int test_fusion_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_REG_EQ(ctx, 1, 0x12340009);   /* Patched second half */
+    C32_ASSERT_REG_EQ(ctx, 11, 0x24685681);  /* Both passes */
+    C32_ASSERT_REG_EQ(ctx, 10, 2);           /* Branches taken */
+    C32_ASSERT_REG_EQ(ctx, 20, 2);
+    C32_ASSERT_HALTED(ctx);
+
+    /* Fusion only happens through the decoded instruction cache */
+    if (ctx->vm->icache) {
+        if (ctx->vm->fusion_hits[C32_FUSE_LUI_ORI] != 2) {
+            C32_ASSERT_FAIL(ctx, "LUI+ORI not fused on both passes");
+        }
+        if (ctx->vm->fusion_hits[C32_FUSE_SLT_BNE] != 2) {
+            C32_ASSERT_FAIL(ctx, "SLT+BNE not fused on both passes");
+        }
+        if (ctx->vm->fusion_hits[C32_FUSE_SLTU_BEQ] != 2) {
+            C32_ASSERT_FAIL(ctx, "SLTU+BEQ not fused on both passes");
+        }
+        if (ctx->vm->fusion_hits[C32_FUSE_ADDI_BNE] != 2) {
+            C32_ASSERT_FAIL(ctx, "ADDI+BNE not fused on both passes");
+        }
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for snapshot and restore
+ *
+ * Runs phase 2 from a snapshot twice; the second run must not see the
+ * first one's register or memory writes.
+ */
+static int test_snapshot_validation(c32_test_ctx_t *ctx) {
+    static uint8_t image[65536];
+    static c32_snapshot_t snap;
+    c32_exit_reason_t reason;
+
+    C32_ASSERT_REG_EQ(ctx, 1, 7);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x2000, 7);
+    C32_ASSERT_HALTED(ctx);
+
+    if (c32_vm_snapshot(ctx->vm, &snap, image, 16) != -1) {
+        C32_ASSERT_FAIL(ctx, "Snapshot into a short image not rejected");
+    }
+    if (c32_vm_snapshot(ctx->vm, &snap, image, sizeof(image)) != 0) {
+        C32_ASSERT_FAIL(ctx, "Snapshot failed");
+    }
+
+    /* First resume */
+    ctx->vm->running = 1;
+    reason = c32_vm_run_for(ctx->vm, 100, NULL);
+    if (reason != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "First resume did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 3, 1);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x2000, 8);
+
+    /* Roll back and resume again */
+    c32_vm_restore(ctx->vm, &snap, ctx->vm->memory);
+    C32_ASSERT_REG_EQ(ctx, 3, 0);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x2000, 7);
+    C32_ASSERT_HALTED(ctx);
+
+    ctx->vm->running = 1;
+    reason = c32_vm_run_for(ctx->vm, 100, NULL);
+    if (reason != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Second resume did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 1, 7);
+    C32_ASSERT_REG_EQ(ctx, 2, 8);
+    C32_ASSERT_REG_EQ(ctx, 3, 1);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x2000, 8);
+    C32_ASSERT_HALTED(ctx);
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for execution counters
+ */
+static int test_stats_validation(c32_test_ctx_t *ctx) {
+    c32_stats_t stats;
+    uint32_t histogram = 0;
+    int i;
+
+    C32_ASSERT_REG_EQ(ctx, 2, 6);
+    C32_ASSERT_HALTED(ctx);
+
+    /* Counters exist only with STATS=1 */
+    if (c32_vm_get_stats(ctx->vm, &stats) != 0) {
+        return C32_TEST_PASS;
+    }
+    if (stats.instructions != 19 || stats.instructions_hi != 0) {
+        C32_ASSERT_FAIL(ctx, "Retired instruction count wrong");
+    }
+
+    /* Translated code (JIT) only counts retired instructions, so the
+     * histogram covers every instruction only if all were interpreted */
+    for (i = 0; i < 256; i++) {
+        histogram += stats.opcodes[i];
+    }
+    if (histogram == stats.instructions) {
+        if (stats.loads != 3 || stats.stores != 3 || stats.opcodes[OP_SW] != 3) {
+            C32_ASSERT_FAIL(ctx, "Load/store counts wrong");
+        }
+        if (stats.branches_taken != 3 || stats.branches_not_taken != 1) {
+            C32_ASSERT_FAIL(ctx, "Branch counts wrong");
+        }
+        if (stats.interrupts != 0 || stats.irets != 0 || stats.translations != 0) {
+            C32_ASSERT_FAIL(ctx, "Unexpected interrupt or translation counts");
+        }
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for the PC profiler
+ *
+ * Re-runs the program one instruction per slice with a profile attached,
+ * sampling after every slice as crisp32 --profile does.
+ */
+static int test_profile_validation(c32_test_ctx_t *ctx) {
+    static uint32_t samples[16];
+    static uint32_t calls[16];
+    static c32_profile_t prof;
+    c32_exit_reason_t reason = C32_EXIT_BUDGET;
+    uint32_t steps = 0;
+    uint32_t i;
+
+    C32_ASSERT_REG_EQ(ctx, 1, 4);
+    C32_ASSERT_HALTED(ctx);
+
+    /* Buckets of one instruction each over 0x1000-0x107F */
+    c32_profile_init(&prof, samples, calls, 16, 0x1000, 3);
+    c32_vm_set_profile(ctx->vm, &prof);
+    ctx->vm->pc = 0x1000;
+    ctx->vm->running = 1;
+    while (reason == C32_EXIT_BUDGET && steps < 100) {
+        uint32_t count;
+
+        reason = c32_vm_run_for(ctx->vm, 1, &count);
+        steps += count;
+        if (reason == C32_EXIT_BUDGET) {
+            c32_profile_sample(&prof, ctx->vm->pc);
+        }
+    }
+    c32_vm_set_profile(ctx->vm, NULL);
+    if (reason != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Profiled run did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 1, 4);
+
+    /* All four calls target func at 0x1038 */
+    if (calls[(0x1038 - 0x1000) >> 3] != 4) {
+        C32_ASSERT_FAIL(ctx, "Call count for func wrong");
+    }
+    for (i = 0; i < 16; i++) {
+        if (i != ((0x1038 - 0x1000) >> 3) && calls[i] != 0) {
+            C32_ASSERT_FAIL(ctx, "Call counted outside func");
+        }
+    }
+
+    /* Each of the four function entries was sampled once */
+    if (samples[(0x1038 - 0x1000) >> 3] != 4 || prof.total != steps - 1 || prof.dropped != 0) {
+        C32_ASSERT_FAIL(ctx, "Sample counts wrong");
+    }
+    c32_profile_sample(&prof, 0x0FF8);
+    c32_profile_sample(&prof, 0x1080);
+    if (prof.dropped != 2 || prof.total != steps - 1) {
+        C32_ASSERT_FAIL(ctx, "Out-of-range samples not dropped");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for the execution trace ring
+ *
+ * Re-runs the program into a four-record ring, so the first record is
+ * overwritten and the rest wrap around the end of the buffer.
+ */
+static int test_trace_validation(c32_test_ctx_t *ctx) {
+    static c32_trace_record_t records[4];
+    static c32_trace_t trace;
+    const c32_trace_record_t *chunk;
+    c32_exit_reason_t reason;
+
+    C32_ASSERT_REG_EQ(ctx, 3, 5);
+    C32_ASSERT_HALTED(ctx);
+
+    if (c32_trace_init(&trace, records, 3) != -1) {
+        C32_ASSERT_FAIL(ctx, "Ring size that is not a power of two accepted");
+    }
+    c32_trace_init(&trace, records, 4);
+    c32_vm_set_trace(ctx->vm, &trace);
+    ctx->vm->pc = 0x1000;
+    ctx->vm->running = 1;
+    reason = c32_vm_run_for(ctx->vm, 100, NULL);
+    c32_vm_set_trace(ctx->vm, NULL);
+    if (reason != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Traced run did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 3, 5);
+
+    /* Five records into four slots: the first ADDI is gone */
+    if (trace.head != 5 || trace.tail != 1 || trace.lost != 1) {
+        C32_ASSERT_FAIL(ctx, "Ring counters wrong");
+    }
+
+    /* Oldest chunk runs from slot 1 to the end of the buffer */
+    if (c32_trace_peek(&trace, &chunk) != 3 || chunk != &records[1]) {
+        C32_ASSERT_FAIL(ctx, "First chunk wrong");
+    }
+    if (chunk[0].pc != 0x1008 || chunk[0].opcode != OP_ADDI || chunk[0].addr != 0) {
+        C32_ASSERT_FAIL(ctx, "ADDI record wrong");
+    }
+    if (chunk[1].pc != 0x1010 || chunk[1].opcode != OP_SW || chunk[1].rt != 2 ||
+        chunk[1].rs != 1 || chunk[1].imm != 4 || chunk[1].addr != 0x2004) {
+        C32_ASSERT_FAIL(ctx, "SW record wrong");
+    }
+    if (chunk[2].pc != 0x1018 || chunk[2].opcode != OP_LW || chunk[2].addr != 0x2004) {
+        C32_ASSERT_FAIL(ctx, "LW record wrong");
+    }
+    c32_trace_consume(&trace, 3);
+
+    /* The newest record wrapped to slot 0 */
+    if (c32_trace_peek(&trace, &chunk) != 1 || chunk != &records[0] ||
+        chunk[0].pc != 0x1020 || chunk[0].opcode != OP_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Wrapped chunk wrong");
+    }
+    c32_trace_consume(&trace, 1);
+    if (c32_trace_peek(&trace, &chunk) != 0) {
+        C32_ASSERT_FAIL(ctx, "Drained ring not empty");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Host syscall handler for test_syscall: 1 adds, 2 doubles
+ */
+static c32_syscall_status_t test_syscall_handler(c32_vm_t *vm, c32_syscall_t *call,
+                                                 void *ctx) {
+    (void)vm;
+    (*(int *)ctx)++;
+    switch (call->number) {
+        case 1:
+            call->result = call->args[0] + call->args[1];
+            return C32_SYSCALL_DONE;
+        case 2:
+            call->result = call->args[0] * 2;
+            return C32_SYSCALL_DONE;
+        default:
+            return C32_SYSCALL_HALT;
+    }
+}
+
+/**
+ * @brief Test validation function for host syscalls
+ *
+ * Re-runs the program with a handler attached; it must run through both
+ * serviced SYSCALLs and stop at the one the handler refuses.
+ */
+static int test_syscall_validation(c32_test_ctx_t *ctx) {
+    c32_exit_reason_t reason;
+    int calls = 0;
+
+    /* Default behaviour: the first SYSCALL halts */
+    C32_ASSERT_REG_EQ(ctx, 10, 0);
+    C32_ASSERT_HALTED(ctx);
+
+    c32_vm_set_syscall_handler(ctx->vm, test_syscall_handler, &calls);
+    ctx->vm->pc = 0x1000;
+    ctx->vm->running = 1;
+    reason = c32_vm_run_for(ctx->vm, 100, NULL);
+    c32_vm_set_syscall_handler(ctx->vm, NULL, NULL);
+    if (reason != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Run did not stop at the refused SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 10, 42);
+    C32_ASSERT_REG_EQ(ctx, 11, 2);
+    C32_ASSERT_REG_EQ(ctx, 12, 42);
+    C32_ASSERT_REG_EQ(ctx, 13, 105);
+    C32_ASSERT_MEM_WORD_EQ(ctx, 0x2000 + 28, 42);
+    C32_ASSERT_HALTED(ctx);
+    if (calls != 4) {
+        C32_ASSERT_FAIL(ctx, "Handler call count wrong");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Register file for test_mmio: four words plus an access count
+ */
+typedef struct {
+    uint32_t regs[4];
+    uint32_t accesses;
+} test_mmio_regs_t;
+
+/**
+ * @brief Device read for test_mmio
+ */
+static uint32_t test_mmio_read(c32_vm_t *vm, void *ctx, uint32_t offset, uint32_t width) {
+    test_mmio_regs_t *dev = (test_mmio_regs_t *)ctx;
+
+    (void)vm;
+    (void)width;
+    dev->accesses++;
+    return dev->regs[offset >> 2];
+}
+
+/**
+ * @brief Device write for test_mmio
+ */
+static void test_mmio_write(c32_vm_t *vm, void *ctx, uint32_t offset, uint32_t width,
+                            uint32_t value) {
+    test_mmio_regs_t *dev = (test_mmio_regs_t *)ctx;
+
+    (void)vm;
+    (void)width;
+    dev->accesses++;
+    dev->regs[offset >> 2] = value;
+}
+
+/**
+ * @brief Test validation function for the MMIO device bus
+ */
+static int test_mmio_validation(c32_test_ctx_t *ctx) {
+    static test_mmio_regs_t regs;
+    c32_device_t dev;
+    c32_exit_reason_t reason;
+
+    /* No device: loads above RAM leave registers unchanged */
+    C32_ASSERT_REG_EQ(ctx, 10, 0);
+    C32_ASSERT_REG_EQ(ctx, 11, 0);
+    C32_ASSERT_REG_EQ(ctx, 15, 7);
+    C32_ASSERT_REG_EQ(ctx, 16, 0x1234);
+    C32_ASSERT_HALTED(ctx);
+
+    /* Static for the device callbacks; cleared so repeated runs start alike */
+    c32_memset(&regs, 0, sizeof(regs));
+    dev.base = 0;
+    dev.size = sizeof(regs.regs);
+    dev.read = test_mmio_read;
+    dev.write = test_mmio_write;
+    dev.ctx = &regs;
+    if (c32_vm_set_devices(ctx->vm, &dev, 1) != -1) {
+        C32_ASSERT_FAIL(ctx, "Device overlapping RAM accepted");
+    }
+    dev.base = 0xFFFFFFFF - sizeof(regs.regs) + 1;
+    if (c32_vm_set_devices(ctx->vm, &dev, 1) != -1) {
+        C32_ASSERT_FAIL(ctx, "Device reaching 0xFFFFFFFF accepted");
+    }
+    dev.base = 0xF0000000;
+    if (c32_vm_set_devices(ctx->vm, &dev, 1) != 0) {
+        C32_ASSERT_FAIL(ctx, "Device above RAM refused");
+    }
+
+    ctx->vm->pc = 0x1000;
+    ctx->vm->running = 1;
+    reason = c32_vm_run_for(ctx->vm, 100, NULL);
+    c32_vm_set_devices(ctx->vm, NULL, 0);
+    if (reason != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Run with device did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 10, 0x1234);
+    C32_ASSERT_REG_EQ(ctx, 11, 0xFFFFFFFE);
+    C32_ASSERT_REG_EQ(ctx, 12, 0xFFFE);
+    C32_ASSERT_REG_EQ(ctx, 13, 0xFFFFFFFE);
+    C32_ASSERT_REG_EQ(ctx, 14, 0xFE);
+    C32_ASSERT_REG_EQ(ctx, 15, 7);
+    C32_ASSERT_REG_EQ(ctx, 16, 0x1234);
+    if (regs.regs[1] != 0xFFFE || regs.regs[2] != 0xFE) {
+        C32_ASSERT_FAIL(ctx, "Narrow store not truncated");
+    }
+    if (regs.accesses != 8) {
+        C32_ASSERT_FAIL(ctx, "Device access count wrong");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Ring service for test_vring: sums request bytes into the response
+ */
+static void test_vring_service(c32_vm_t *vm, c32_vring_t *ring, void *ctx) {
+    int *chains = (int *)ctx;
+    c32_vring_buf_t bufs[4];
+    uint32_t num_bufs, i, j;
+    uint16_t head;
+
+    while (c32_vring_pop(ring, vm, &head, bufs, 4, &num_bufs) == 1) {
+        uint32_t sum = 0;
+        uint32_t written = 0;
+
+        for (i = 0; i < num_bufs; i++) {
+            if (!bufs[i].writable) {
+                for (j = 0; j < bufs[i].len; j++) {
+                    sum += bufs[i].data[j];
+                }
+            } else if (!written && bufs[i].len >= 4) {
+                c32_write_word(bufs[i].data, sum);
+                written = 4;
+            }
+        }
+        c32_vring_push(ring, vm, head, written);
+        (*chains)++;
+    }
+    c32_vring_notify(ring, vm);
+}
+
+/**
+ * @brief Test validation function for shared-memory request rings
+ */
+static int test_vring_validation(c32_test_ctx_t *ctx) {
+    static c32_vring_t ring;
+    c32_device_t dev;
+    c32_exit_reason_t reason;
+    int chains = 0;
+
+    /* No device: the doorbell is ignored and nothing completes */
+    C32_ASSERT_REG_EQ(ctx, 10, 0);
+    C32_ASSERT_REG_EQ(ctx, 14, 0);
+    C32_ASSERT_HALTED(ctx);
+
+    c32_vring_init(&ring, 0x21, test_vring_service, &chains);
+    if (c32_vring_setup(&ring, ctx->vm, 3, 0x4000, 0x4040, 0x4080) != -1) {
+        C32_ASSERT_FAIL(ctx, "Ring size that is not a power of two accepted");
+    }
+    c32_vring_device(&dev, 0xF0002000, &ring);
+    c32_vm_set_devices(ctx->vm, &dev, 1);
+
+    ctx->vm->pc = 0x1000;
+    ctx->vm->running = 1;
+    reason = c32_vm_run_for(ctx->vm, 200, NULL);
+    c32_vm_set_devices(ctx->vm, NULL, 0);
+    if (reason != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Run with ring did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 10, 2);
+    C32_ASSERT_REG_EQ(ctx, 11, 0);
+    C32_ASSERT_REG_EQ(ctx, 12, 2);
+    C32_ASSERT_REG_EQ(ctx, 13, 4);
+    C32_ASSERT_REG_EQ(ctx, 14, 10);
+    C32_ASSERT_REG_EQ(ctx, 15, 48);
+    C32_ASSERT_REG_EQ(ctx, 16, 1);
+    if (chains != 2) {
+        C32_ASSERT_FAIL(ctx, "Service did not see both chains");
+    }
+    if (!(ctx->vm->interrupts.pending[1] & 0x2)) { /* Interrupt 0x21 */
+        C32_ASSERT_FAIL(ctx, "Completion interrupt not raised");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for the instruction-count timer
+ */
+static int test_timer_validation(c32_test_ctx_t *ctx) {
+    c32_vm_t *vm = ctx->vm;
+
+    C32_ASSERT_REG_EQ(ctx, 10, 18);       /* Preempted at the same points every run */
+    C32_ASSERT_REG_EQ(ctx, 11, 3);
+    C32_ASSERT_REG_EQ(ctx, 12, 3);        /* Stopped timer stays quiet */
+    C32_ASSERT_HALTED(ctx);
+    if (vm->timer.count != 0) {
+        C32_ASSERT_FAIL(ctx, "SET_TIMER R0 did not stop the timer");
+    }
+
+    /* Host programming: expiry raises the interrupt and reloads the period */
+    c32_vm_set_timer(vm, 4, 0x22);
+    c32_vm_timer_elapse(vm, 3);
+    if (vm->interrupts.pending[1] & 0x4) {
+        C32_ASSERT_FAIL(ctx, "Timer expired early");
+    }
+    c32_vm_timer_elapse(vm, 1);
+    if (!(vm->interrupts.pending[1] & 0x4) || vm->timer.count != 4) { /* Interrupt 0x22 */
+        C32_ASSERT_FAIL(ctx, "Timer did not raise its interrupt and reload");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief In-memory checkpoint stream for test_checkpoint
+ */
+typedef struct {
+    uint8_t *buf;
+    uint32_t size;
+    uint32_t pos;
+} test_stream_t;
+
+/**
+ * @brief Checkpoint output into a test_stream_t
+ */
+static int test_stream_write(void *ctx, const uint8_t *data, uint32_t size) {
+    test_stream_t *st = (test_stream_t *)ctx;
+
+    if (size > st->size - st->pos) {
+        return -1;
+    }
+    c32_memcpy(st->buf + st->pos, data, size);
+    st->pos += size;
+    return 0;
+}
+
+/**
+ * @brief Checkpoint input from a test_stream_t
+ */
+static int test_stream_read(void *ctx, uint8_t *data, uint32_t size) {
+    test_stream_t *st = (test_stream_t *)ctx;
+
+    if (size > st->size - st->pos) {
+        return -1;
+    }
+    c32_memcpy(data, st->buf + st->pos, size);
+    st->pos += size;
+    return 0;
+}
+
+/**
+ * @brief Test validation function for dirty pages and incremental checkpoints
+ */
+static int test_checkpoint_validation(c32_test_ctx_t *ctx) {
+    static uint8_t full_buf[80000];
+    static uint8_t incr_buf[32768];
+    static uint8_t copy_mem[65536];
+    static uint32_t map[C32_DIRTY_MAP_WORDS(65536)];
+    c32_vm_t *vm = ctx->vm;
+    c32_vm_t copy;
+    test_stream_t full, incr;
+    uint32_t pages;
+
+    C32_ASSERT_REG_EQ(ctx, 10, 0x1234);
+    C32_ASSERT_HALTED(ctx);
+
+    if (c32_vm_set_dirty_map(vm, map, 0) != -1 ||
+        c32_checkpoint_save(vm, 0, test_stream_write, &full, NULL) != -1) {
+        C32_ASSERT_FAIL(ctx, "Missing or short dirty map accepted");
+    }
+    c32_vm_set_dirty_map(vm, map, sizeof(map) / sizeof(map[0]));
+
+    full.buf = full_buf;
+    full.size = sizeof(full_buf);
+    full.pos = 0;
+    if (c32_checkpoint_save(vm, 1, test_stream_write, &full, &pages) != 0 || pages != 16) {
+        C32_ASSERT_FAIL(ctx, "Full checkpoint failed");
+    }
+
+    /* Run again: only the pages the program writes become dirty */
+    vm->interrupts.pending[0] = 0;          /* Left by the first SYSCALL */
+    vm->interrupts.pending_summary = 0;
+    vm->pc = 0x1000;
+    vm->running = 1;
+    if (c32_vm_run_for(vm, 100, NULL) != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Re-run did not reach SYSCALL");
+    }
+    incr.buf = incr_buf;
+    incr.size = sizeof(incr_buf);
+    incr.pos = 0;
+    if (c32_checkpoint_save(vm, 0, test_stream_write, &incr, &pages) != 0 || pages != 6) {
+        C32_ASSERT_FAIL(ctx, "Incremental checkpoint did not hold the 6 written pages");
+    }
+    if (c32_vm_dirty_collect(vm, NULL) != 0) {
+        C32_ASSERT_FAIL(ctx, "Checkpoint did not clear the dirty map");
+    }
+    c32_vm_set_dirty_map(vm, NULL, 0);
+
+    /* Full then incremental rebuilds the VM elsewhere */
+    c32_vm_init(&copy, copy_mem, sizeof(copy_mem));
+    full.size = full.pos;
+    full.pos = 0;
+    incr.size = incr.pos;
+    incr.pos = 0;
+    if (c32_checkpoint_load(&copy, test_stream_read, &full, NULL) != 0 ||
+        c32_checkpoint_load(&copy, test_stream_read, &incr, &pages) != 0 || pages != 6) {
+        C32_ASSERT_FAIL(ctx, "Checkpoint load failed");
+    }
+    if (c32_memcmp(copy_mem, vm->memory, sizeof(copy_mem)) != 0 || copy.pc != vm->pc ||
+        copy.regs[10] != 0x1234 || copy.interrupts.enabled != vm->interrupts.enabled) {
+        C32_ASSERT_FAIL(ctx, "Restored VM differs from the original");
+    }
+
+    /* A checkpoint only loads into memory of the same size */
+    c32_vm_init(&copy, copy_mem, 32768);
+    full.pos = 0;
+    if (c32_checkpoint_load(&copy, test_stream_read, &full, NULL) != -1) {
+        C32_ASSERT_FAIL(ctx, "Checkpoint loaded into a different memory size");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for pending interrupt priority
+ */
+static int test_interrupt_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_REG_EQ(ctx, 10, 3);        /* Highest priority first */
+    C32_ASSERT_REG_EQ(ctx, 11, 20);
+    C32_ASSERT_REG_EQ(ctx, 12, 200);
+    C32_ASSERT_REG_EQ(ctx, 13, 255);      /* Lowest priority last */
+    C32_ASSERT_REG_EQ(ctx, 14, 16);       /* Four handler runs */
+    C32_ASSERT_HALTED(ctx);
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for the in-memory assembler
+ */
+static int test_asm_buffer_validation(c32_test_ctx_t *ctx) {
+    static c32_asm_state_t state;
+    static const char source[] =
+        "start:\n"
+        "    ADDI R1, R0, 5\r\n"
+        "    JAL square          # Forward reference\n"
+        "    BEQ R0, R0, done\n"
+        "square:\n"
+        "    MUL R2, R1, R1\n"
+        "    JR R31\n"
+        "done:\n"
+        "    ADDI R10, R2, 0\n"
+        "    SYSCALL";
+    static const char bad[] = "ADDI R1, R0, 1\nBOGUS R1\n";
+    static const char undefined[] = "J nowhere\n";
+    static uint8_t buf[64];
+    c32_vm_t *vm = ctx->vm;
+    int idx;
+
+    C32_ASSERT_REG_EQ(ctx, 10, 1);
+    C32_ASSERT_HALTED(ctx);
+
+    /* Assemble over the code just run; its cached decode must be dropped */
+    c32_asm_init(&state);
+    if (c32_asm_assemble_to_vm(&state, vm, 0x1000, source, sizeof(source) - 1) != 0 ||
+        c32_asm_image_size(&state) != 56 || state.num_symbols != 3) {
+        C32_ASSERT_FAIL(ctx, "In-memory assembly failed");
+    }
+    idx = c32_asm_find_symbol(&state, "done");
+    if (idx < 0 || state.symbols[idx].address != 40) {
+        C32_ASSERT_FAIL(ctx, "Symbol table not returned");
+    }
+
+    vm->interrupts.pending[0] = 0;          /* Left by the first SYSCALL */
+    vm->interrupts.pending_summary = 0;
+    vm->pc = 0x1000;
+    vm->running = 1;
+    if (c32_vm_run_for(vm, 100, NULL) != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Assembled program did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 10, 25);
+
+    /* Errors are reported by line, and undefined labels fail */
+    c32_asm_init(&state);
+    if (c32_asm_assemble_buffer(&state, bad, sizeof(bad) - 1, buf, sizeof(buf)) != -1 ||
+        state.error_line != 2) {
+        C32_ASSERT_FAIL(ctx, "Bad line not reported");
+    }
+    c32_asm_init(&state);
+    if (c32_asm_assemble_buffer(&state, undefined, sizeof(undefined) - 1, buf,
+                                sizeof(buf)) != -1 ||
+        c32_asm_assemble_buffer(&state, source, sizeof(source) - 1, buf, 48) != -1) {
+        C32_ASSERT_FAIL(ctx, "Undefined label or overflow accepted");
+    }
+
+    /* Every mnemonic in the instruction list resolves to its opcode */
+#define C32_OP_CHECK(name, format)                                      \
+    if (!c32_asm_lookup_op(#name) || c32_asm_lookup_op(#name)->opcode != OP_##name) { \
+        C32_ASSERT_FAIL(ctx, "Mnemonic " #name " not found");           \
+    }
+    C32_INSTRUCTIONS(C32_OP_CHECK)
+#undef C32_OP_CHECK
+    if (c32_asm_lookup_op("ADDX") || c32_asm_lookup_op("AD") || c32_asm_lookup_op("")) {
+        C32_ASSERT_FAIL(ctx, "Unknown mnemonic found");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for the peephole optimizer
+ */
+static int test_optimize_validation(c32_test_ctx_t *ctx) {
+    static c32_asm_state_t state;
+    static const char source[] =
+        "start:\n"
+        "    LUI R1, 0x1234\n"
+        "    ORI R1, R1, 0x5678\n"
+        "    NOP\n"
+        "    ADD R0, R1, R1\n"
+        "    OR R2, R2, R0\n"
+        "    LUI R3, %hi(done)\n"
+        "    ADDIU R3, R3, %lo(done)\n"
+        "    JAL hop\n"
+        "    BEQ R1, R0, next\n"
+        "next:\n"
+        "    BNE R0, R0, start\n"
+        "    J done\n"
+        "hop:\n"
+        "    J func\n"
+        "func:\n"
+        "    ADDI R4, R0, 9\n"
+        "    JR R31\n"
+        "done:\n"
+        "    ADDI R10, R0, 1\n"
+        "    SYSCALL\n";
+    static const char outside[] = "BEQ R0, R0, 64\n";
+    static uint8_t work[C32_ASM_OPT_WORK_SIZE(128)];
+    static uint8_t buf[128];
+    c32_vm_t *vm = ctx->vm;
+    int func, done;
+
+    C32_ASSERT_REG_EQ(ctx, 1, 0x12345678);
+    C32_ASSERT_REG_EQ(ctx, 3, 0x1070);
+    C32_ASSERT_REG_EQ(ctx, 4, 9);
+    C32_ASSERT_REG_EQ(ctx, 10, 1);
+    C32_ASSERT_HALTED(ctx);
+
+    /* 16 instructions: 5 removed, 2 LUIs folded and hop threaded away */
+    c32_asm_init(&state);
+    c32_asm_set_optimize(&state, work, sizeof(work));
+    if (c32_asm_assemble_to_vm(&state, vm, 0x1000, source, sizeof(source) - 1) != 0 ||
+        c32_asm_image_size(&state) != 64 || state.opt_removed != 8) {
+        C32_ASSERT_FAIL(ctx, "Optimized assembly failed");
+    }
+    func = c32_asm_find_symbol(&state, "func");
+    done = c32_asm_find_symbol(&state, "done");
+    if (func < 0 || state.symbols[func].address != 32 ||
+        done < 0 || state.symbols[done].address != 48) {
+        C32_ASSERT_FAIL(ctx, "Labels not moved with the code");
+    }
+    if (vm->memory[0x1000] != OP_ORI || vm->memory[0x1001] != 0 ||
+        c32_read_word(vm->memory + 0x1014) != 0x1020) {
+        C32_ASSERT_FAIL(ctx, "Constant not folded or jump not threaded");
+    }
+
+    c32_memset(vm->regs, 0, sizeof(vm->regs));
+    vm->interrupts.pending[0] = 0;          /* Left by the first SYSCALL */
+    vm->interrupts.pending_summary = 0;
+    vm->pc = 0x1000;
+    vm->running = 1;
+    if (c32_vm_run_for(vm, 100, NULL) != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Optimized program did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 1, 0x12345678);
+    C32_ASSERT_REG_EQ(ctx, 2, 0);
+    C32_ASSERT_REG_EQ(ctx, 3, 0x1030);
+    C32_ASSERT_REG_EQ(ctx, 4, 9);
+    C32_ASSERT_REG_EQ(ctx, 10, 1);
+
+    /* Too little work memory, or a numeric branch that cannot be moved */
+    c32_asm_init(&state);
+    c32_asm_set_optimize(&state, work, 16);
+    if (c32_asm_assemble_buffer(&state, source, sizeof(source) - 1, buf, sizeof(buf)) != -1) {
+        C32_ASSERT_FAIL(ctx, "Small work memory accepted");
+    }
+    c32_asm_init(&state);
+    c32_asm_set_optimize(&state, work, sizeof(work));
+    if (c32_asm_assemble_buffer(&state, outside, sizeof(outside) - 1, buf, sizeof(buf)) != -1) {
+        C32_ASSERT_FAIL(ctx, "Branch out of the image accepted");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Rerun the shadow bank program with banks and optional nesting
+ */
+static int test_shadow_rerun(c32_vm_t *vm, uint32_t banks, uint32_t nest) {
+    c32_memset(vm->memory + 0x6000, 0, 0x1000);
+    c32_vm_reset(vm);
+    vm->regs[20] = nest;
+    if (c32_vm_set_shadow_banks(vm, banks) != 0) {
+        return -1;
+    }
+    vm->interrupts.pending[0] = 0;          /* Left by the last SYSCALL */
+    vm->interrupts.pending_summary = 0;
+    vm->interrupts.enabled = 0;
+    vm->pc = 0x1000;
+    vm->running = 1;
+    return c32_vm_run_for(vm, 200, NULL) == C32_EXIT_SYSCALL ? 0 : -1;
+}
+
+/**
+ * @brief Test validation function for shadow register banks
+ */
+static int test_shadow_validation(c32_test_ctx_t *ctx) {
+    c32_vm_t *vm = ctx->vm;
+    uint32_t frame = 0x6F80;                /* R29 - 128 at entry */
+
+    /* Memory frames: the outer context is saved below R29 */
+    C32_ASSERT_REG_EQ(ctx, 5, 5);
+    C32_ASSERT_REG_EQ(ctx, 6, 6);
+    C32_ASSERT_REG_EQ(ctx, 10, 0x10C8);
+    C32_ASSERT_REG_EQ(ctx, 11, 0);
+    C32_ASSERT_REG_EQ(ctx, 29, 0x6F80);
+    C32_ASSERT_MEM_WORD_EQ(ctx, frame + 4 * 5, 5);
+    C32_ASSERT_HALTED(ctx);
+    if (c32_vm_set_shadow_banks(vm, C32_SHADOW_BANKS + 1) != -1) {
+        C32_ASSERT_FAIL(ctx, "Too many banks accepted");
+    }
+
+    /* Two banks: both levels nest without touching the stack */
+    if (test_shadow_rerun(vm, 2, 1) != 0) {
+        C32_ASSERT_FAIL(ctx, "Banked run did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 5, 5);
+    C32_ASSERT_REG_EQ(ctx, 6, 6);
+    C32_ASSERT_REG_EQ(ctx, 10, 0x10C8);     /* Outer saved PC back after nesting */
+    C32_ASSERT_REG_EQ(ctx, 11, 1);
+    C32_ASSERT_REG_EQ(ctx, 29, 0x7000);
+    C32_ASSERT_MEM_WORD_EQ(ctx, frame + 4 * 5, 0);
+    C32_ASSERT_MEM_WORD_EQ(ctx, frame - 128 + 4 * 5, 0);
+    if (vm->interrupts.shadow_depth != 0) {
+        C32_ASSERT_FAIL(ctx, "Bank left in use after IRET");
+    }
+
+    /* One bank: the nested interrupt spills its frame to memory */
+    if (test_shadow_rerun(vm, 1, 1) != 0) {
+        C32_ASSERT_FAIL(ctx, "Spilling run did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 5, 5);
+    C32_ASSERT_REG_EQ(ctx, 6, 6);
+    C32_ASSERT_REG_EQ(ctx, 10, 0x10C8);
+    C32_ASSERT_REG_EQ(ctx, 11, 1);
+    C32_ASSERT_REG_EQ(ctx, 29, 0x7000);
+    C32_ASSERT_MEM_WORD_EQ(ctx, frame + 4 * 5, 111);     /* Outer handler's R5 */
+
+    /* C32_IVT_SPILL asks for the memory frame even with banks free */
+    c32_write_word(vm->memory + 320 + 4, C32_IVT_SPILL);
+    if (test_shadow_rerun(vm, 2, 0) != 0) {
+        C32_ASSERT_FAIL(ctx, "C32_IVT_SPILL run did not reach SYSCALL");
+    }
+    c32_write_word(vm->memory + 320 + 4, 0);
+    C32_ASSERT_REG_EQ(ctx, 5, 5);
+    C32_ASSERT_REG_EQ(ctx, 29, 0x6F80);
+    C32_ASSERT_MEM_WORD_EQ(ctx, frame + 4 * 5, 5);
+
+    /* A frame that would wrap below address 0 is not written */
+    c32_vm_set_shadow_banks(vm, 0);
+    vm->interrupts.pending[0] = 0;
+    vm->interrupts.pending_summary = 0;
+    c32_raise_interrupt(vm, 41);
+    vm->interrupts.enabled = 1;
+    vm->regs[6] = 6;
+    vm->regs[29] = 64;
+    vm->pc = 0x10E0;
+    vm->running = 1;
+    if (c32_vm_run_for(vm, 100, NULL) != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Interrupt with a low stack did not return");
+    }
+    C32_ASSERT_REG_EQ(ctx, 6, 222);         /* Nothing to restore from */
+    C32_ASSERT_REG_EQ(ctx, 29, 0xFFFFFFC0);
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Object output into a test_stream_t (offsets must be sequential)
+ */
+static int test_object_write(void *ctx, uint32_t offset, const uint8_t *data, uint32_t size) {
+    test_stream_t *st = (test_stream_t *)ctx;
+
+    if (offset != st->pos) {
+        return -1;
+    }
+    return test_stream_write(ctx, data, size);
+}
+
+/**
+ * @brief Assemble source text into an object in a test_stream_t
+ */
+static int test_assemble_object(c32_asm_state_t *state, const char *source, uint32_t length,
+                                test_stream_t *obj) {
+    static uint8_t code[256];
+
+    c32_asm_init(state);
+    state->object = 1;
+    obj->pos = 0;
+    if (c32_asm_assemble_buffer(state, source, length, code, sizeof(code)) != 0 ||
+        c32_asm_write_object(state, test_object_write, obj) != 0) {
+        return -1;
+    }
+    obj->size = obj->pos;
+    return 0;
+}
+
+/**
+ * @brief Test validation function for relocatable objects and the linker
+ */
+static int test_link_validation(c32_test_ctx_t *ctx) {
+    static c32_asm_state_t state;
+    static const char main_source[] =
+        ".global start\n"
+        "start:\n"
+        "    JAL fill                # Imported: jump relocation\n"
+        "    LUI R5, %hi(counter)    # Imported .bss label\n"
+        "    ORI R5, R5, %lo(counter)\n"
+        "    LW R10, R5, 0\n"
+        "    BEQ R0, R0, done        # Local: resolved by the assembler\n"
+        "    ADDI R10, R0, 0\n"
+        "done:\n"
+        "    BEQ R0, R0, finish      # Imported: branch relocation\n";
+    static const char lib_source[] =
+        ".global fill\n"
+        ".global counter\n"
+        ".global finish\n"
+        "fill:\n"
+        "    LUI R6, %hi(counter)\n"
+        "    ORI R6, R6, %lo(counter)\n"
+        "    ADDI R7, R0, 7\n"
+        "    SW R7, R6, 0\n"
+        "    JR R31\n"
+        "finish:\n"
+        "    ADDI R11, R0, 3\n"
+        "    SYSCALL\n"
+        ".bss\n"
+        "pad:\n"
+        "    .space 4\n"
+        "counter:\n"
+        "    .space 4\n";
+    static uint8_t main_buf[512], lib_buf[512], image[256];
+    test_stream_t main_obj, lib_obj;
+    c32_link_input_t inputs[3];
+    c32_link_result_t result;
+    c32_vm_t *vm = ctx->vm;
+    int idx;
+
+    C32_ASSERT_REG_EQ(ctx, 10, 1);
+    C32_ASSERT_HALTED(ctx);
+
+    main_obj.buf = main_buf;
+    main_obj.size = sizeof(main_buf);
+    lib_obj.buf = lib_buf;
+    lib_obj.size = sizeof(lib_buf);
+    if (test_assemble_object(&state, main_source, sizeof(main_source) - 1, &main_obj) != 0 ||
+        state.num_fixups != 4) {
+        C32_ASSERT_FAIL(ctx, "Main object not assembled");
+    }
+    if (test_assemble_object(&state, lib_source, sizeof(lib_source) - 1, &lib_obj) != 0 ||
+        state.num_fixups != 2 || state.bss_size != 8) {
+        C32_ASSERT_FAIL(ctx, "Library object not assembled");
+    }
+    inputs[0].data = main_buf;
+    inputs[0].size = main_obj.size;
+    inputs[1].data = lib_buf;
+    inputs[1].size = lib_obj.size;
+    inputs[2] = inputs[1];
+
+    /* Link over the code just run; its cached decode must be dropped */
+    c32_asm_init(&state);
+    if (c32_link(&state, inputs, 2, vm->memory + 0x1000, vm->memory_size - 0x1000,
+                 &result) != 0 ||
+        result.text_size != 112 || result.bss_start != 112 || result.bss_size != 8) {
+        C32_ASSERT_FAIL(ctx, "Link failed");
+    }
+    c32_vm_host_write(vm, 0x1000, result.text_size);
+    idx = c32_asm_find_symbol(&state, "counter");
+    if (idx < 0 || state.symbols[idx].address != 116) {
+        C32_ASSERT_FAIL(ctx, "Global .bss label misplaced");
+    }
+
+    vm->interrupts.pending[0] = 0;          /* Left by the first SYSCALL */
+    vm->interrupts.pending_summary = 0;
+    vm->pc = 0x1000;
+    vm->running = 1;
+    if (c32_vm_run_for(vm, 100, NULL) != C32_EXIT_SYSCALL) {
+        C32_ASSERT_FAIL(ctx, "Linked program did not reach SYSCALL");
+    }
+    C32_ASSERT_REG_EQ(ctx, 10, 7);
+    C32_ASSERT_REG_EQ(ctx, 11, 3);
+    C32_ASSERT_REG_EQ(ctx, 5, 0x1074);
+
+    /* Missing, duplicate and malformed objects are reported by input */
+    c32_asm_init(&state);
+    if (c32_link(&state, inputs, 1, image, sizeof(image), &result) != -1 ||
+        result.error != C32_LINK_UNDEFINED || result.error_object != 0 ||
+        c32_strcmp(result.error_symbol, "fill") != 0) {
+        C32_ASSERT_FAIL(ctx, "Undefined label not reported");
+    }
+    c32_asm_init(&state);
+    if (c32_link(&state, inputs + 1, 2, image, sizeof(image), &result) != -1 ||
+        result.error != C32_LINK_DUPLICATE || result.error_object != 1) {
+        C32_ASSERT_FAIL(ctx, "Duplicate label not reported");
+    }
+    c32_asm_init(&state);
+    inputs[1].size--;
+    if (c32_link(&state, inputs, 2, image, sizeof(image), &result) != -1 ||
+        result.error != C32_LINK_BAD_OBJECT || result.error_object != 1) {
+        C32_ASSERT_FAIL(ctx, "Truncated object accepted");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for a misaligned instruction fetch
+ */
+static int test_fetch_fault_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_PC_EQ(ctx, 0x1024);          /* Stopped at the bad fetch */
+    C32_ASSERT_REG_EQ(ctx, 3, 7);
+    C32_ASSERT_RUNNING(ctx);
+    if (!(ctx->vm->interrupts.pending[0] & (1u << 2))) {
+        C32_ASSERT_FAIL(ctx, "MEM_FAULT not raised");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for a fetch at the empty cache tag
+ */
+static int test_fetch_top_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_PC_EQ(ctx, 0xFFFFFFFF);      /* Not run from an empty entry */
+    C32_ASSERT_REG_EQ(ctx, 3, 7);
+    C32_ASSERT_RUNNING(ctx);
+    if (!(ctx->vm->interrupts.pending[0] & (1u << 2))) {
+        C32_ASSERT_FAIL(ctx, "MEM_FAULT not raised");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for an opcode in the fused handler range
+ */
+static int test_fused_opcode_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_REG_EQ(ctx, 3, 7);
+    C32_ASSERT_REG_EQ(ctx, 4, 0);          /* Not run as a fused SLT */
+    C32_ASSERT_HALTED(ctx);
+    if (!(ctx->vm->interrupts.pending[0] & (1u << 1))) {
+        C32_ASSERT_FAIL(ctx, "ILLEGAL_OP not raised");
+    }
+    return C32_TEST_PASS;
+}
+
+/**
+ * @brief Test validation function for register fields above 31
+ */
+static int test_reg_field_validation(c32_test_ctx_t *ctx) {
+    C32_ASSERT_REG_EQ(ctx, 5, 7);          /* 0xE5 selects R5 */
+    C32_ASSERT_REG_EQ(ctx, 4, 0);
     C32_ASSERT_HALTED(ctx);
     return C32_TEST_PASS;
 }
@@ -174,7 +1334,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_add_size,
         0x1000,
         100,
-        test_add_validation
+        test_add_validation,
+        0
     },
     {
         "SUB instruction",
@@ -182,7 +1343,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_sub_size,
         0x1000,
         100,
-        test_sub_validation
+        test_sub_validation,
+        0
     },
     {
         "MUL instruction",
@@ -190,7 +1352,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_mul_size,
         0x1000,
         100,
-        test_mul_validation
+        test_mul_validation,
+        0
     },
     {
         "Logical operations (AND, OR, XOR)",
@@ -198,7 +1361,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_logical_size,
         0x1000,
         100,
-        test_logical_validation
+        test_logical_validation,
+        0
     },
     {
         "Shift operations (SLL, SRL)",
@@ -206,7 +1370,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_shift_size,
         0x1000,
         100,
-        test_shift_validation
+        test_shift_validation,
+        0
     },
     {
         "Branch instructions (BEQ)",
@@ -214,7 +1379,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_branch_size,
         0x1000,
         100,
-        test_branch_validation
+        test_branch_validation,
+        0
     },
     {
         "Load/Store instructions (LW, SW)",
@@ -222,7 +1388,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_load_store_size,
         0x1000,
         100,
-        test_load_store_validation
+        test_load_store_validation,
+        0
     },
     {
         "Jump instructions (JAL, JR, J)",
@@ -230,7 +1397,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_jump_size,
         0x1000,
         100,
-        test_jump_validation
+        test_jump_validation,
+        0
     },
     {
         "Comparison operations (SLT, SLTU, SLTI, SLTIU)",
@@ -238,7 +1406,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_compare_size,
         0x1000,
         100,
-        test_compare_validation
+        test_compare_validation,
+        0
     },
     {
         "Branch variants (BNE, BLEZ, BGTZ, BLTZ, BGEZ)",
@@ -246,7 +1415,8 @@ static const c32_test_case_t test_suite[] = {
         test_test_branch_variants_size,
         0x1000,
         100,
-        test_branch_variants_validation
+        test_branch_variants_validation,
+        0
     },
     {
         "Division and multiply high (DIV, DIVU, REM, REMU, MULH, MULHU)",
@@ -254,19 +1424,276 @@ static const c32_test_case_t test_suite[] = {
         test_test_div_size,
         0x1000,
         100,
-        test_div_validation
+        test_div_validation,
+        0
+    },
+    {
+        "Self-modifying code (decoded instruction cache)",
+        test_test_icache,
+        test_test_icache_size,
+        0x1000,
+        100,
+        test_icache_validation,
+        0
+    },
+    {
+        "Paged user mode (software TLB invalidation)",
+        test_test_tlb,
+        test_test_tlb_size,
+        0x1000,
+        100,
+        test_tlb_validation,
+        0
+    },
+    {
+        "Interrupt priority (pending summary and find-first-set)",
+        test_test_interrupt,
+        test_test_interrupt_size,
+        0x1000,
+        100,
+        test_interrupt_validation,
+        0
+    },
+    {
+        "Superinstruction fusion (LUI+ORI, SLT/SLTU+branch, ADDI+BNE)",
+        test_test_fusion,
+        test_test_fusion_size,
+        0x1000,
+        100,
+        test_fusion_validation,
+        0
+    },
+    {
+        "Snapshot and restore",
+        test_test_snapshot,
+        test_test_snapshot_size,
+        0x1000,
+        100,
+        test_snapshot_validation,
+        0
+    },
+    {
+        "Execution counters",
+        test_test_stats,
+        test_test_stats_size,
+        0x1000,
+        100,
+        test_stats_validation,
+        0
+    },
+    {
+        "PC profiler call counts",
+        test_test_profile,
+        test_test_profile_size,
+        0x1000,
+        100,
+        test_profile_validation,
+        0
+    },
+    {
+        "Execution trace ring",
+        test_test_trace,
+        test_test_trace_size,
+        0x1000,
+        100,
+        test_trace_validation,
+        0
+    },
+    {
+        "Host syscall handler and batches",
+        test_test_syscall,
+        test_test_syscall_size,
+        0x1000,
+        100,
+        test_syscall_validation,
+        0
+    },
+    {
+        "Memory-mapped device bus",
+        test_test_mmio,
+        test_test_mmio_size,
+        0x1000,
+        100,
+        test_mmio_validation,
+        0
+    },
+    {
+        "Shared-memory request ring",
+        test_test_vring,
+        test_test_vring_size,
+        0x1000,
+        200,
+        test_vring_validation,
+        0
+    },
+    {
+        "Instruction-count timer",
+        test_test_timer,
+        test_test_timer_size,
+        0x1000,
+        200,
+        test_timer_validation,
+        0
+    },
+    {
+        "Dirty pages and incremental checkpoints",
+        test_test_checkpoint,
+        test_test_checkpoint_size,
+        0x1000,
+        100,
+        test_checkpoint_validation,
+        0
+    },
+    {
+        "In-memory assembler",
+        test_test_asm_buffer,
+        test_test_asm_buffer_size,
+        0x1000,
+        100,
+        test_asm_buffer_validation,
+        0
+    },
+    {
+        "Relocatable objects and linker",
+        test_test_link,
+        test_test_link_size,
+        0x1000,
+        100,
+        test_link_validation,
+        0
+    },
+    {
+        "Peephole optimizer",
+        test_test_optimize,
+        test_test_optimize_size,
+        0x1000,
+        100,
+        test_optimize_validation,
+        0
+    },
+    {
+        "Shadow register banks",
+        test_test_shadow,
+        test_test_shadow_size,
+        0x1000,
+        200,
+        test_shadow_validation,
+        0
+    },
+    {
+        "Two-level page table and superpages",
+        test_test_superpage,
+        test_test_superpage_size,
+        0x1000,
+        100,
+        test_superpage_validation,
+        0
+    },
+    {
+        "Bulk memory instructions",
+        test_test_bulk,
+        test_test_bulk_size,
+        0x1000,
+        5000,
+        test_bulk_validation,
+        0
+    },
+    {
+        "Misaligned instruction fetch",
+        test_test_fetch_fault,
+        test_test_fetch_fault_size,
+        0x1000,
+        100,
+        test_fetch_fault_validation,
+        1
+    },
+    {
+        "Instruction fetch at 0xFFFFFFFF",
+        test_test_fetch_top,
+        test_test_fetch_top_size,
+        0x1000,
+        100,
+        test_fetch_top_validation,
+        1
+    },
+    {
+        "Guest opcode in the fused handler range",
+        test_test_fused_opcode,
+        test_test_fused_opcode_size,
+        0x1000,
+        100,
+        test_fused_opcode_validation,
+        0
+    },
+    {
+        "Register fields above 31",
+        test_test_reg_field,
+        test_test_reg_field_size,
+        0x1000,
+        100,
+        test_reg_field_validation,
+        0
     }
 };
 
+/**
+ * @brief Print usage information
+ *
+ * @param program_name Name of the program
+ */
+static void print_usage(const char *program_name) {
+    printf("Usage: %s [-j workers] [-r runs]\n\n", program_name);
+    printf("Options:\n");
+    printf("  -j workers  Worker threads (0 = online CPUs; default: 1)\n");
+    printf("  -r runs     Run every test this many times and report mean/min time\n");
+}
+
 /**
  * @brief Main entry point for test suite
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return 0 if every test passed, 1 otherwise
  */
-int main(void) {
+int main(int argc, char **argv) {
     c32_test_results_t results;
+    c32_test_options_t options;
     int test_count = sizeof(test_suite) / sizeof(test_suite[0]);
+    int argi;
+
+    options.workers = 1;
+    options.repeat = 1;
+    options.memory_size = 0;
+
+    /* Parse options */
+    for (argi = 1; argi < argc; argi += 2) {
+        char *end;
+        long value;
+
+        if (argi + 1 >= argc || argv[argi][0] != '-' || argv[argi][2] != '\0') {
+            print_usage(argv[0]);
+            return 1;
+        }
+        value = strtol(argv[argi + 1], &end, 0);
+        if (*argv[argi + 1] == '\0' || *end != '\0' || value < 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        if (argv[argi][1] == 'j') {
+            options.workers = (int)value;
+        } else if (argv[argi][1] == 'r' && value > 0) {
+            options.repeat = (uint32_t)value;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
 
     /* Run all tests */
-    c32_run_test_suite(test_suite, test_count, &results);
+    if (c32_run_test_suite_opts(test_suite, test_count, &options, &results) != 0) {
+        printf("Cannot allocate test memory\n");
+        return 1;
+    }
 
     /* Print summary */
     c32_test_print_results(&results);
@@ -0,0 +1,10 @@
+# Unit Test: in-memory assembler
+# Runs once so that its code is cached; the validation then assembles a new
+# program over it from source text in memory and runs that.
+# Expected results:
+#   R10 = 1 (this program)
+#   R10 = 25 (the program assembled in memory: 5 squared)
+
+start:
+    ADDI R10, R0, 1
+    SYSCALL
@@ -0,0 +1,88 @@
+# Unit Test: Bulk memory instructions (MEMCPY, MEMSET, MEMCMP)
+# Expected results:
+#   R1-R3 = 0x6389, 0x438B, 0     (5000 unaligned bytes copied across pages)
+#   R4-R6 = 0x712D, 0x1AB, 0      (300 bytes set to 0xAB)
+#   R7-R9 = 0x6389, 0x438B, 0     (copy compares equal)
+#   R10-R12 = 0x6195, 0x4197, 500 (stopped at the first differing byte)
+#   R13-R15 = 0xC800, 0x4000, 0   (user copy restarted after a page fault)
+#   mem[0x9000] = 1               (page faults taken)
+
+start:
+    J main
+
+# Page fault handler at 0x1008: count the fault and map virtual page 12
+handler:
+    LW R8, R0, 0x9000
+    ADDI R8, R8, 1
+    SW R8, R0, 0x9000
+    ADDI R8, R0, 0xC00F     # VPN 12 -> 0xC000 (U, X, W, V)
+    SW R8, R0, 0x8030
+    IRET
+
+main:
+    ADDI R29, R0, 0xA000    # Stack for register save area
+    SW R0, R0, 0x9000       # Clear fault count
+    ADDI R1, R0, 0x1008     # Handler address
+    SW R1, R0, 64           # IVT[8]
+
+    # Source pattern at 0x3000-0x43FF: each word holds its own address
+    ADDI R7, R0, 0x3000
+    ADDI R8, R0, 0x4400
+fill:
+    SW R7, R7, 0
+    ADDI R7, R7, 4
+    BNE R7, R8, fill
+
+    # Sentinels just outside the destinations
+    ADDI R1, R0, 0x77
+    SB R1, R0, 0x6389
+    SB R1, R0, 0x712D
+    ADDI R1, R0, 0x66
+    SB R1, R0, 0x7000
+
+    ADDI R1, R0, 0x5001     # Destination
+    ADDI R2, R0, 0x3003     # Source
+    ADDI R3, R0, 5000       # Length
+    MEMCPY R1, R2, R3
+
+    ADDI R4, R0, 0x7001
+    ADDI R5, R0, 0x1AB      # Only the low byte is stored
+    ADDI R6, R0, 300
+    MEMSET R4, R5, R6
+
+    ADDI R7, R0, 0x5001
+    ADDI R8, R0, 0x3003
+    ADDI R9, R0, 5000
+    MEMCMP R7, R8, R9
+
+    ADDI R1, R0, 0xEE       # Corrupt the copy 4500 bytes in
+    SB R1, R0, 0x6195
+    ADDI R1, R0, 0x6389
+    ADDI R10, R0, 0x5001
+    ADDI R11, R0, 0x3003
+    ADDI R12, R0, 5000
+    MEMCMP R10, R11, R12
+
+    # Identity page table at 0x8000 for 16 pages, VPN 12 left invalid
+    ADDI R20, R0, 0
+    ADDI R21, R0, 16
+map:
+    SLL R22, R20, 12
+    ORI R22, R22, 0xF
+    SLL R23, R20, 2
+    SW R22, R23, 0x8000
+    ADDI R20, R20, 1
+    BNE R20, R21, map
+    SW R0, R0, 0x8030
+
+    ADDI R22, R0, 0x8000
+    SET_PTBR R22, R21
+    ENABLE_PAGING
+    EI
+    ENTER_USER
+
+    ADDI R13, R0, 0xB800    # Half a page before the unmapped page
+    ADDI R14, R0, 0x3000
+    ADDI R15, R0, 0x1000
+    MEMCPY R13, R14, R15    # Faults at 0xC000, resumes after IRET
+    SYSCALL                 # Halt
@@ -0,0 +1,46 @@
+/*
+ * Auto-generated from test_bulk.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_bulk_H
+#define TEST_test_bulk_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_bulk[] = {
+    0x70, 0x00, 0x00, 0x00, 0x38, 0x10, 0x00, 0x00, 0x50, 0x00, 0x08, 0x00, 0x00, 0x90, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x08, 0x08, 0x00, 0x01, 0x00, 0x00, 0x00, 0x58, 0x00, 0x08, 0x00, 0x00, 0x90, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x00, 0x08, 0x00, 0x0f, 0xc0, 0x00, 0x00, 0x58, 0x00, 0x08, 0x00, 0x30, 0x80, 0x00, 0x00  /* 0x0020 */,
+    0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x1d, 0x00, 0x00, 0xa0, 0x00, 0x00  /* 0x0030 */,
+    0x58, 0x00, 0x00, 0x00, 0x00, 0x90, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x08, 0x10, 0x00, 0x00  /* 0x0040 */,
+    0x58, 0x00, 0x01, 0x00, 0x40, 0x00, 0x00, 0x00, 0x05, 0x00, 0x07, 0x00, 0x00, 0x30, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x00, 0x08, 0x00, 0x00, 0x44, 0x00, 0x00, 0x58, 0x07, 0x07, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x07, 0x07, 0x00, 0x04, 0x00, 0x00, 0x00, 0x61, 0x07, 0x08, 0x00, 0xe8, 0xff, 0xff, 0xff  /* 0x0070 */,
+    0x05, 0x00, 0x01, 0x00, 0x77, 0x00, 0x00, 0x00, 0x5a, 0x00, 0x01, 0x00, 0x89, 0x63, 0x00, 0x00  /* 0x0080 */,
+    0x5a, 0x00, 0x01, 0x00, 0x2d, 0x71, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x66, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0x5a, 0x00, 0x01, 0x00, 0x00, 0x70, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x01, 0x50, 0x00, 0x00  /* 0x00a0 */,
+    0x05, 0x00, 0x02, 0x00, 0x03, 0x30, 0x00, 0x00, 0x05, 0x00, 0x03, 0x00, 0x88, 0x13, 0x00, 0x00  /* 0x00b0 */,
+    0x5c, 0x02, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x04, 0x00, 0x01, 0x70, 0x00, 0x00  /* 0x00c0 */,
+    0x05, 0x00, 0x05, 0x00, 0xab, 0x01, 0x00, 0x00, 0x05, 0x00, 0x06, 0x00, 0x2c, 0x01, 0x00, 0x00  /* 0x00d0 */,
+    0x5d, 0x05, 0x06, 0x04, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x07, 0x00, 0x01, 0x50, 0x00, 0x00  /* 0x00e0 */,
+    0x05, 0x00, 0x08, 0x00, 0x03, 0x30, 0x00, 0x00, 0x05, 0x00, 0x09, 0x00, 0x88, 0x13, 0x00, 0x00  /* 0x00f0 */,
+    0x5e, 0x08, 0x09, 0x07, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0xee, 0x00, 0x00, 0x00  /* 0x0100 */,
+    0x5a, 0x00, 0x01, 0x00, 0x95, 0x61, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x89, 0x63, 0x00, 0x00  /* 0x0110 */,
+    0x05, 0x00, 0x0a, 0x00, 0x01, 0x50, 0x00, 0x00, 0x05, 0x00, 0x0b, 0x00, 0x03, 0x30, 0x00, 0x00  /* 0x0120 */,
+    0x05, 0x00, 0x0c, 0x00, 0x88, 0x13, 0x00, 0x00, 0x5e, 0x0b, 0x0c, 0x0a, 0x00, 0x00, 0x00, 0x00  /* 0x0130 */,
+    0x05, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x15, 0x00, 0x10, 0x00, 0x00, 0x00  /* 0x0140 */,
+    0x20, 0x00, 0x14, 0x16, 0x0c, 0x00, 0x00, 0x00, 0x15, 0x16, 0x16, 0x00, 0x0f, 0x00, 0x00, 0x00  /* 0x0150 */,
+    0x20, 0x00, 0x14, 0x17, 0x02, 0x00, 0x00, 0x00, 0x58, 0x17, 0x16, 0x00, 0x00, 0x80, 0x00, 0x00  /* 0x0160 */,
+    0x05, 0x14, 0x14, 0x00, 0x01, 0x00, 0x00, 0x00, 0x61, 0x14, 0x15, 0x00, 0xd0, 0xff, 0xff, 0xff  /* 0x0170 */,
+    0x58, 0x00, 0x00, 0x00, 0x30, 0x80, 0x00, 0x00, 0x05, 0x00, 0x16, 0x00, 0x00, 0x80, 0x00, 0x00  /* 0x0180 */,
+    0xf9, 0x00, 0x15, 0x16, 0x00, 0x00, 0x00, 0x00, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0190 */,
+    0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x01a0 */,
+    0x05, 0x00, 0x0d, 0x00, 0x00, 0xb8, 0x00, 0x00, 0x05, 0x00, 0x0e, 0x00, 0x00, 0x30, 0x00, 0x00  /* 0x01b0 */,
+    0x05, 0x00, 0x0f, 0x00, 0x00, 0x10, 0x00, 0x00, 0x5c, 0x0e, 0x0f, 0x0d, 0x00, 0x00, 0x00, 0x00  /* 0x01c0 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x01d0 */
+};
+
+const uint32_t test_test_bulk_size = 472;
+
+#endif /* TEST_test_bulk_H */
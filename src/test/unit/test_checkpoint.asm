@@ -0,0 +1,28 @@
+# Unit Test: dirty page tracking and incremental checkpoints
+# The host re-runs the program with a dirty map attached after a full
+# checkpoint; it writes pages 0 (IVT), 3, 5, 6 and 7 (a word across the
+# boundary) and 8 (register save area on interrupt entry).
+# Expected results:
+#   R10 = 0x1234
+#   Incremental checkpoint holds 6 pages
+
+start:
+    J main
+
+# Interrupt handler at 0x1008
+handler:
+    IRET
+
+main:
+    ADDI R29, R0, 0x9000    # Register save area at 0x8F80
+    ADDI R1, R0, 0x1008
+    SW R1, R0, 128          # IVT[16]
+    ADDI R2, R0, 0x1234
+    SW R2, R0, 0x3000
+    SB R2, R0, 0x5FFF
+    SW R2, R0, 0x6FFE       # Spans pages 6 and 7
+    EI
+    RAISE 16
+    NOP
+    ADD R10, R2, R0
+    SYSCALL                 # Halt
@@ -0,0 +1,23 @@
+/*
+ * Auto-generated from test_checkpoint.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_checkpoint_H
+#define TEST_test_checkpoint_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_checkpoint[] = {
+    0x70, 0x00, 0x00, 0x00, 0x10, 0x10, 0x00, 0x00, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x1d, 0x00, 0x00, 0x90, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x08, 0x10, 0x00, 0x00  /* 0x0010 */,
+    0x58, 0x00, 0x01, 0x00, 0x80, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x34, 0x12, 0x00, 0x00  /* 0x0020 */,
+    0x58, 0x00, 0x02, 0x00, 0x00, 0x30, 0x00, 0x00, 0x5a, 0x00, 0x02, 0x00, 0xff, 0x5f, 0x00, 0x00  /* 0x0030 */,
+    0x58, 0x00, 0x02, 0x00, 0xfe, 0x6f, 0x00, 0x00, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0xf5, 0x00, 0x00, 0x00, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x01, 0x02, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */
+};
+
+const uint32_t test_test_checkpoint_size = 112;
+
+#endif /* TEST_test_checkpoint_H */
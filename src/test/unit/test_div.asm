@@ -7,6 +7,11 @@
 #   R8  = 0  (1000 % 25, unsigned remainder)
 #   R10 = 1  (high 32 bits of 65536 * 65536, signed)
 #   R11 = 1  (high 32 bits of 65536 * 65536, unsigned)
+#   R13 = 0xFFFFFFFE (high 32 bits of 0xFFFFFFFF * 0xFFFFFFFF, unsigned)
+#   R14 = 0  (high 32 bits of -1 * -1, signed)
+#   R16 = 0x80000000 (INT_MIN / -1 wraps)
+#   R17 = 0  (INT_MIN % -1)
+#   R19 = 100 (-100 / -1)
 
 main:
     # Test DIV (signed division): 100 / 7 = 14
@@ -34,4 +39,17 @@ main:
     # Test MULHU (multiply high, unsigned)
     MULHU R11, R9, R9       # R11 = 1
 
+    # Partial products whose sum carries out of 32 bits
+    ADDI R12, R0, -1        # R12 = 0xFFFFFFFF
+    MULHU R13, R12, R12     # R13 = 0xFFFFFFFE
+    MULH R14, R12, R12      # R14 = 0
+
+    # Signed overflow: INT_MIN / -1 must not trap the host
+    LUI R15, 0x8000         # R15 = 0x80000000
+    DIV R16, R15, R12       # R16 = 0x80000000
+    ADDI R17, R0, 5
+    REM R17, R15, R12       # R17 = 0
+    ADDI R18, R0, -100
+    DIV R19, R18, R12       # R19 = 100
+
     SYSCALL                 # Halt
@@ -14,9 +14,14 @@ const uint8_t test_test_div[] = {
     0x05, 0x00, 0x05, 0x00, 0xe8, 0x03, 0x00, 0x00, 0x05, 0x00, 0x06, 0x00, 0x19, 0x00, 0x00, 0x00  /* 0x0020 */,
     0x44, 0x05, 0x06, 0x07, 0x00, 0x00, 0x00, 0x00, 0x46, 0x05, 0x06, 0x08, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
     0x17, 0x00, 0x09, 0x00, 0x01, 0x00, 0x00, 0x00, 0x41, 0x09, 0x09, 0x0a, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
-    0x42, 0x09, 0x09, 0x0b, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0050 */
+    0x42, 0x09, 0x09, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x0c, 0x00, 0xff, 0xff, 0xff, 0xff  /* 0x0050 */,
+    0x42, 0x0c, 0x0c, 0x0d, 0x00, 0x00, 0x00, 0x00, 0x41, 0x0c, 0x0c, 0x0e, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x17, 0x00, 0x0f, 0x00, 0x00, 0x80, 0x00, 0x00, 0x43, 0x0f, 0x0c, 0x10, 0x00, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0x05, 0x00, 0x11, 0x00, 0x05, 0x00, 0x00, 0x00, 0x45, 0x0f, 0x0c, 0x11, 0x00, 0x00, 0x00, 0x00  /* 0x0080 */,
+    0x05, 0x00, 0x12, 0x00, 0x9c, 0xff, 0xff, 0xff, 0x43, 0x12, 0x0c, 0x13, 0x00, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00a0 */
 };
 
-const uint32_t test_test_div_size = 96;
+const uint32_t test_test_div_size = 168;
 
 #endif /* TEST_test_div_H */
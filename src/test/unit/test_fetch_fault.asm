@@ -0,0 +1,12 @@
+# Unit Test: Fetch from a misaligned PC
+# Expected results:
+#   Run stops with C32_EXIT_FAULT at PC 0x1024 (interrupt 2 pending)
+#   R3 = 7 (nothing past the jump executes)
+
+start:
+    ADDI R1, R0, 0x1024     # Inside the ADDI below, not on an 8-byte boundary
+    ADDI R3, R0, 7
+    JR R1
+    NOP
+    ADDI R3, R0, 99
+    SYSCALL
@@ -0,0 +1,19 @@
+/*
+ * Auto-generated from test_fetch_fault.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_fetch_fault_H
+#define TEST_test_fetch_fault_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_fetch_fault[] = {
+    0x05, 0x00, 0x01, 0x00, 0x24, 0x10, 0x00, 0x00, 0x05, 0x00, 0x03, 0x00, 0x07, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x72, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x00, 0x03, 0x00, 0x63, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */
+};
+
+const uint32_t test_test_fetch_fault_size = 48;
+
+#endif /* TEST_test_fetch_fault_H */
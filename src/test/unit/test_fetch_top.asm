@@ -0,0 +1,13 @@
+# Unit Test: Fetch from PC 0xFFFFFFFF
+# 0xFFFFFFFF is also the tag of an empty decoded-instruction cache entry,
+# so the fetch must not be taken as a cache hit.
+# Expected results:
+#   Run stops with C32_EXIT_FAULT at PC 0xFFFFFFFF (interrupt 2 pending)
+#   R3 = 7 (nothing past the jump executes)
+
+start:
+    ADDI R1, R0, -1         # R1 = 0xFFFFFFFF
+    ADDI R3, R0, 7
+    JR R1
+    ADDI R3, R0, 99
+    SYSCALL
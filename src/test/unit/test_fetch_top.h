@@ -0,0 +1,19 @@
+/*
+ * Auto-generated from test_fetch_top.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_fetch_top_H
+#define TEST_test_fetch_top_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_fetch_top[] = {
+    0x05, 0x00, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff, 0x05, 0x00, 0x03, 0x00, 0x07, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x72, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x03, 0x00, 0x63, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */
+};
+
+const uint32_t test_test_fetch_top_size = 40;
+
+#endif /* TEST_test_fetch_top_H */
@@ -0,0 +1,19 @@
+# Unit Test: Guest opcode in the fused pair handler range
+# 0x81 is not an instruction, but it is also the handler index of a fused
+# SLT+BEQ pair, so decoding it must not select that handler.
+# Expected results:
+#   Run stops with C32_EXIT_ILLEGAL (interrupt 1 pending)
+#   R3 = 7, R4 = 0 (the patched instruction does not run as SLT)
+
+start:
+    ADDI R3, R0, 7
+    ADDI R4, R0, 0
+    JAL here            # R31 = address of 'here'
+here:
+    ADDI R6, R31, 24    # R6 = address of 'bad'
+    ADDI R7, R0, 0x81   # Opcode of the fused SLT+BEQ handler
+    SB R7, R6, 0        # Overwrite opcode byte of 'bad'
+bad:
+    SLT R4, R0, R3      # Would set R4 = 1 if run as SLT
+    ADDI R3, R0, 99
+    SYSCALL
@@ -0,0 +1,34 @@
+# Unit Test: Superinstruction fusion (LUI+ORI, SLT/SLTU+branch, ADDI+BNE)
+# Expected results:
+#   R1  = 0x12340009 (ORI immediate patched to 9 after first pass)
+#   R11 = 0x24685681 (0x12345678 + 0x12340009)
+#   R10 = 2          (fused branches always taken, one increment per pass)
+#   R20 = 2          (loop counter)
+
+start:
+    ADDI R20, R0, 0     # R20 = iteration
+    ADDI R21, R0, 2     # R21 = iteration count
+    ADDI R10, R0, 0     # R10 = 0
+    ADDI R11, R0, 0     # R11 = 0
+    JAL here            # R31 = address of 'here'
+here:
+    ADDI R6, R31, 24    # R6 = address of 'orilo'
+    ADDI R7, R0, 9      # R7 = replacement immediate
+loop:
+    LUI R1, 0x1234      # Fused with the ORI below
+orilo:
+    ORI R1, R1, 0x5678  # Immediate patched to 9 after first pass
+    ADD R11, R11, R1    # Accumulate both constants
+    SLT R2, R20, R21    # R2 = 1
+    BNE R2, R0, lt      # Taken (fused with SLT)
+    ADDI R10, R10, 100  # Skipped
+lt:
+    SLTU R3, R21, R20   # R3 = 0
+    BEQ R3, R0, ge      # Taken (fused with SLTU)
+    ADDI R10, R10, 100  # Skipped
+ge:
+    ADDI R10, R10, 1    # R10++
+    SW R7, R6, 4        # Overwrite immediate of 'orilo'
+    ADDI R20, R20, 1    # R20++
+    BNE R20, R21, loop  # Loop (fused with ADDI)
+    SYSCALL             # Halt
@@ -0,0 +1,27 @@
+/*
+ * Auto-generated from test_fusion.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_fusion_H
+#define TEST_test_fusion_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_fusion[] = {
+    0x05, 0x00, 0x14, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x15, 0x00, 0x02, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x71, 0x00, 0x00, 0x00, 0x28, 0x10, 0x00, 0x00, 0x05, 0x1f, 0x06, 0x00, 0x18, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x00, 0x07, 0x00, 0x09, 0x00, 0x00, 0x00, 0x17, 0x00, 0x01, 0x00, 0x34, 0x12, 0x00, 0x00  /* 0x0030 */,
+    0x15, 0x01, 0x01, 0x00, 0x78, 0x56, 0x00, 0x00, 0x01, 0x0b, 0x01, 0x0b, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x30, 0x14, 0x15, 0x02, 0x00, 0x00, 0x00, 0x00, 0x61, 0x02, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x0a, 0x0a, 0x00, 0x64, 0x00, 0x00, 0x00, 0x31, 0x15, 0x14, 0x03, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x60, 0x03, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x0a, 0x00, 0x64, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0x05, 0x0a, 0x0a, 0x00, 0x01, 0x00, 0x00, 0x00, 0x58, 0x06, 0x07, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0080 */,
+    0x05, 0x14, 0x14, 0x00, 0x01, 0x00, 0x00, 0x00, 0x61, 0x14, 0x15, 0x00, 0x98, 0xff, 0xff, 0xff  /* 0x0090 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00a0 */
+};
+
+const uint32_t test_test_fusion_size = 168;
+
+#endif /* TEST_test_fusion_H */
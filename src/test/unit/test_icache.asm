@@ -0,0 +1,19 @@
+# Unit Test: Self-modifying code (decoded instruction cache invalidation)
+# Expected results:
+#   R3 = 101 (first pass adds 1, patched second pass adds 100)
+#   R5 = 2   (patched instruction executed twice)
+
+start:
+    ADDI R3, R0, 0      # R3 = 0
+    ADDI R5, R0, 0      # R5 = 0
+    ADDI R8, R0, 2      # R8 = loop count
+    JAL here            # R31 = address of 'here'
+here:
+    ADDI R6, R31, 16    # R6 = address of 'patch'
+    ADDI R7, R0, 100    # R7 = replacement immediate
+patch:
+    ADDI R3, R3, 1      # Immediate patched to 100 after first pass
+    ADDI R5, R5, 1      # R5++
+    SW R7, R6, 4        # Overwrite immediate of 'patch'
+    BNE R5, R8, patch   # Re-execute patched instruction
+    SYSCALL             # Halt
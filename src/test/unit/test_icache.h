@@ -0,0 +1,22 @@
+/*
+ * Auto-generated from test_icache.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_icache_H
+#define TEST_test_icache_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_icache[] = {
+    0x05, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x08, 0x00, 0x02, 0x00, 0x00, 0x00, 0x71, 0x00, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x1f, 0x06, 0x00, 0x10, 0x00, 0x00, 0x00, 0x05, 0x00, 0x07, 0x00, 0x64, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x03, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x05, 0x05, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x58, 0x06, 0x07, 0x00, 0x04, 0x00, 0x00, 0x00, 0x61, 0x05, 0x08, 0x00, 0xe0, 0xff, 0xff, 0xff  /* 0x0040 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0050 */
+};
+
+const uint32_t test_test_icache_size = 88;
+
+#endif /* TEST_test_icache_H */
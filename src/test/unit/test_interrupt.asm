@@ -0,0 +1,38 @@
+# Unit Test: Pending interrupt priority (lowest number dispatched first)
+# Expected results:
+#   R10-R13 = 3, 20, 200, 255 (dispatch order logged by handler)
+#   R14 = 16 (four interrupts logged)
+
+start:
+    J main
+
+# Shared handler at 0x1008: append interrupt number (R4) to log at 0x6004
+handler:
+    LW R8, R0, 0x6000       # Log offset
+    SW R4, R8, 0x6004
+    ADDI R8, R8, 4
+    SW R8, R0, 0x6000
+    IRET
+
+main:
+    ADDI R29, R0, 0x7000    # Stack for register save area
+    SW R0, R0, 0x6000       # Clear log offset
+    ADDI R1, R0, 0x1008     # Handler address
+    SW R1, R0, 24           # IVT[3]
+    SW R1, R0, 160          # IVT[20]
+    SW R1, R0, 1600         # IVT[200]
+    SW R1, R0, 2040         # IVT[255]
+
+    RAISE 200               # Raised out of priority order
+    RAISE 20                # while interrupts are disabled
+    RAISE 255
+    RAISE 3
+    EI                      # All four dispatch back to back
+    NOP
+
+    LW R10, R0, 0x6004
+    LW R11, R0, 0x6008
+    LW R12, R0, 0x600C
+    LW R13, R0, 0x6010
+    LW R14, R0, 0x6000
+    SYSCALL                 # Halt
@@ -0,0 +1,29 @@
+/*
+ * Auto-generated from test_interrupt.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_interrupt_H
+#define TEST_test_interrupt_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_interrupt[] = {
+    0x70, 0x00, 0x00, 0x00, 0x30, 0x10, 0x00, 0x00, 0x50, 0x00, 0x08, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x0000 */,
+    0x58, 0x08, 0x04, 0x00, 0x04, 0x60, 0x00, 0x00, 0x05, 0x08, 0x08, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x58, 0x00, 0x08, 0x00, 0x00, 0x60, 0x00, 0x00, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x00, 0x1d, 0x00, 0x00, 0x70, 0x00, 0x00, 0x58, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x0030 */,
+    0x05, 0x00, 0x01, 0x00, 0x08, 0x10, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x18, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x58, 0x00, 0x01, 0x00, 0xa0, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x40, 0x06, 0x00, 0x00  /* 0x0050 */,
+    0x58, 0x00, 0x01, 0x00, 0xf8, 0x07, 0x00, 0x00, 0xf5, 0x00, 0x00, 0x00, 0xc8, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0xf5, 0x00, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00, 0xf5, 0x00, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0xf5, 0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0080 */,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x00, 0x0a, 0x00, 0x04, 0x60, 0x00, 0x00  /* 0x0090 */,
+    0x50, 0x00, 0x0b, 0x00, 0x08, 0x60, 0x00, 0x00, 0x50, 0x00, 0x0c, 0x00, 0x0c, 0x60, 0x00, 0x00  /* 0x00a0 */,
+    0x50, 0x00, 0x0d, 0x00, 0x10, 0x60, 0x00, 0x00, 0x50, 0x00, 0x0e, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x00b0 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00c0 */
+};
+
+const uint32_t test_test_interrupt_size = 200;
+
+#endif /* TEST_test_interrupt_H */
@@ -0,0 +1,10 @@
+# Unit Test: relocatable objects and the linker
+# Runs once so that its code is cached; the validation then assembles two
+# object modules in memory, links them over it and runs the result.
+# Expected results:
+#   R10 = 1 (this program)
+#   R10 = 7, R11 = 3 (the linked program: stored through an extern .bss label)
+
+start:
+    ADDI R10, R0, 1
+    SYSCALL
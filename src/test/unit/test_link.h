@@ -0,0 +1,17 @@
+/*
+ * Auto-generated from test_link.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_link_H
+#define TEST_test_link_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_link[] = {
+    0x05, 0x00, 0x0a, 0x00, 0x01, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0000 */
+};
+
+const uint32_t test_test_link_size = 16;
+
+#endif /* TEST_test_link_H */
@@ -2,6 +2,8 @@
 # Expected results:
 #   R1 = 0x12345678
 #   Memory[0x2000] = 0x12345678
+#   R4-R6 = 77 (accesses at the top of the address space, far past RAM,
+#               are ignored rather than wrapping around to address 0)
 
 start:
     LUI R1, 0x1234      # R1 = 0x12340000
@@ -9,4 +11,15 @@ start:
     SW R1, R0, 0x2000   # Memory[0x2000] = R1
     ADDI R2, R0, 0      # R2 = 0
     LW R2, R0, 0x2000   # R2 = Memory[0x2000]
+
+    ADDI R3, R0, -3     # R3 = 0xFFFFFFFD
+    ADDI R4, R0, 77
+    ADDI R5, R0, 77
+    ADDI R6, R0, 77
+    SW R1, R3, 0
+    SH R1, R3, 1
+    SB R1, R3, 2
+    LW R4, R3, 0
+    LHU R5, R3, 1
+    LBU R6, R3, 2
     SYSCALL             # Halt
@@ -11,9 +11,14 @@
 const uint8_t test_test_load_store[] = {
     0x17, 0x00, 0x01, 0x00, 0x34, 0x12, 0x00, 0x00, 0x15, 0x01, 0x01, 0x00, 0x78, 0x56, 0x00, 0x00  /* 0x0000 */,
     0x58, 0x00, 0x01, 0x00, 0x00, 0x20, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0010 */,
-    0x50, 0x00, 0x02, 0x00, 0x00, 0x20, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */
+    0x50, 0x00, 0x02, 0x00, 0x00, 0x20, 0x00, 0x00, 0x05, 0x00, 0x03, 0x00, 0xfd, 0xff, 0xff, 0xff  /* 0x0020 */,
+    0x05, 0x00, 0x04, 0x00, 0x4d, 0x00, 0x00, 0x00, 0x05, 0x00, 0x05, 0x00, 0x4d, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x05, 0x00, 0x06, 0x00, 0x4d, 0x00, 0x00, 0x00, 0x58, 0x03, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x59, 0x03, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x5a, 0x03, 0x01, 0x00, 0x02, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x50, 0x03, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x52, 0x03, 0x05, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x54, 0x03, 0x06, 0x00, 0x02, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0070 */
 };
 
-const uint32_t test_test_load_store_size = 48;
+const uint32_t test_test_load_store_size = 128;
 
 #endif /* TEST_test_load_store_H */
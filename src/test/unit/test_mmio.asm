@@ -0,0 +1,32 @@
+# Unit Test: memory-mapped device bus
+# Loads and stores at 0xF0000000 hit nothing (loads leave registers
+# unchanged) until the test re-runs the program with a four-word register
+# device mapped there.
+# Expected results (with the device):
+#   R10 = 0x1234 (word written and read back)
+#   R11 = 0xFFFFFFFE, R12 = 0xFFFE (halfword, sign and zero extended)
+#   R13 = 0xFFFFFFFE, R14 = 0xFE (byte, sign and zero extended)
+#   R15 = 7 (load past the end of the device window is ignored)
+#   R16 = 0x1234 (ordinary RAM access)
+
+start:
+    LUI R1, 0xF000      # R1 = 0xF0000000 (device window)
+    ADDI R2, R0, 0x1234
+    SW R2, R1, 0        # Device word 0
+    LW R10, R1, 0
+
+    ADDI R3, R0, -2
+    SH R3, R1, 4        # Device word 1, low half
+    LH R11, R1, 4
+    LHU R12, R1, 4
+    SB R3, R1, 8        # Device word 2, low byte
+    LB R13, R1, 8
+    LBU R14, R1, 8
+
+    ADDI R15, R0, 7
+    LW R15, R1, 0x100   # Outside the window: no device
+
+    ADDI R4, R0, 0x2000
+    SW R2, R4, 0        # RAM
+    LW R16, R4, 0
+    SYSCALL
@@ -0,0 +1,25 @@
+/*
+ * Auto-generated from test_mmio.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_mmio_H
+#define TEST_test_mmio_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_mmio[] = {
+    0x17, 0x00, 0x01, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x34, 0x12, 0x00, 0x00  /* 0x0000 */,
+    0x58, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x01, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x00, 0x03, 0x00, 0xfe, 0xff, 0xff, 0xff, 0x59, 0x01, 0x03, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x51, 0x01, 0x0b, 0x00, 0x04, 0x00, 0x00, 0x00, 0x52, 0x01, 0x0c, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x5a, 0x01, 0x03, 0x00, 0x08, 0x00, 0x00, 0x00, 0x53, 0x01, 0x0d, 0x00, 0x08, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x54, 0x01, 0x0e, 0x00, 0x08, 0x00, 0x00, 0x00, 0x05, 0x00, 0x0f, 0x00, 0x07, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x50, 0x01, 0x0f, 0x00, 0x00, 0x01, 0x00, 0x00, 0x05, 0x00, 0x04, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0060 */,
+    0x58, 0x04, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x04, 0x10, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0080 */
+};
+
+const uint32_t test_test_mmio_size = 136;
+
+#endif /* TEST_test_mmio_H */
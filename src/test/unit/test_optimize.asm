@@ -0,0 +1,30 @@
+# Unit Test: peephole optimizer
+# Runs unoptimized; the validation assembles the same program with the
+# optimizer and checks that it is shorter and computes the same results.
+# Expected results:
+#   R1 = 0x12345678 (LUI + ORI)
+#   R3 = address of done (%hi/%lo)
+#   R4 = 9 (reached through a jump chain)
+#   R10 = 1
+
+start:
+    LUI R1, 0x1234
+    ORI R1, R1, 0x5678      # Folds into ORI R1, R0, 0x12345678
+    NOP                     # Removed
+    ADD R0, R1, R1          # Writes R0: removed
+    OR R2, R2, R0           # Moves R2 to itself: removed
+    LUI R3, %hi(done)
+    ADDIU R3, R3, %lo(done) # Folds into ADDIU R3, R0, done
+    JAL hop                 # Threaded to func
+    BEQ R1, R0, next        # Branch to the next instruction: removed
+next:
+    BNE R0, R0, start       # Never taken: removed
+    J done
+hop:
+    J func
+func:
+    ADDI R4, R0, 9
+    JR R31
+done:
+    ADDI R10, R0, 1
+    SYSCALL
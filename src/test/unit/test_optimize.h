@@ -0,0 +1,24 @@
+/*
+ * Auto-generated from test_optimize.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_optimize_H
+#define TEST_test_optimize_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_optimize[] = {
+    0x17, 0x00, 0x01, 0x00, 0x34, 0x12, 0x00, 0x00, 0x15, 0x01, 0x01, 0x00, 0x78, 0x56, 0x00, 0x00  /* 0x0000 */,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x11, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x17, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x06, 0x03, 0x03, 0x00, 0x70, 0x10, 0x00, 0x00, 0x71, 0x00, 0x00, 0x00, 0x58, 0x10, 0x00, 0x00  /* 0x0030 */,
+    0x60, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x61, 0x00, 0x00, 0x00, 0xb0, 0xff, 0xff, 0xff  /* 0x0040 */,
+    0x70, 0x00, 0x00, 0x00, 0x70, 0x10, 0x00, 0x00, 0x70, 0x00, 0x00, 0x00, 0x60, 0x10, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x00, 0x04, 0x00, 0x09, 0x00, 0x00, 0x00, 0x72, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x00, 0x0a, 0x00, 0x01, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0070 */
+};
+
+const uint32_t test_test_optimize_size = 128;
+
+#endif /* TEST_test_optimize_H */
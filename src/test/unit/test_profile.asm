@@ -0,0 +1,19 @@
+# Unit Test: PC profiler call counts
+# Calls one function three times with JAL and once with JALR. The test
+# re-runs the program with a profile attached and checks that all four
+# calls land in the function's bucket.
+# Expected results:
+#   R1 = 4 (function ran four times)
+
+start:
+    ADDI R1, R0, 0      # 0x1000: call counter
+    JAL func            # 0x1008: call 1
+    JAL func            # 0x1010: call 2
+    JAL func            # 0x1018: call 3, R31 = 0x1020
+    ADDI R5, R31, 0x18  # 0x1020: R5 = 0x1038 (func)
+    JALR R31, R5        # 0x1028: call 4
+    SYSCALL             # 0x1030: done
+
+func:
+    ADDI R1, R1, 1      # 0x1038: count the call
+    JR R31              # 0x1040: return
@@ -0,0 +1,21 @@
+/*
+ * Auto-generated from test_profile.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_profile_H
+#define TEST_test_profile_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_profile[] = {
+    0x05, 0x00, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x71, 0x00, 0x00, 0x00, 0x38, 0x10, 0x00, 0x00  /* 0x0000 */,
+    0x71, 0x00, 0x00, 0x00, 0x38, 0x10, 0x00, 0x00, 0x71, 0x00, 0x00, 0x00, 0x38, 0x10, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x1f, 0x05, 0x00, 0x18, 0x00, 0x00, 0x00, 0x73, 0x05, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x01, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x72, 0x1f, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */
+};
+
+const uint32_t test_test_profile_size = 72;
+
+#endif /* TEST_test_profile_H */
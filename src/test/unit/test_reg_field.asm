@@ -0,0 +1,18 @@
+# Unit Test: Register fields use only their low 5 bits
+# The rd byte of 'patch' is rewritten to 0xE5, which must select R5.
+# Expected results:
+#   R5 = 7 (0xE5 & 0x1F = 5)
+#   R4 = 0 (original destination never written)
+
+start:
+    ADDI R3, R0, 7
+    ADDI R4, R0, 0
+    ADDI R5, R0, 0
+    JAL here            # R31 = address of 'here'
+here:
+    ADDI R6, R31, 24    # R6 = address of 'patch'
+    ADDI R7, R0, 0xE5   # Register byte with the upper bits set
+    SB R7, R6, 3        # Overwrite rd byte of 'patch'
+patch:
+    ADD R4, R3, R0      # Becomes rd = 0xE5
+    SYSCALL
@@ -0,0 +1,21 @@
+/*
+ * Auto-generated from test_reg_field.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_reg_field_H
+#define TEST_test_reg_field_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_reg_field[] = {
+    0x05, 0x00, 0x03, 0x00, 0x07, 0x00, 0x00, 0x00, 0x05, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x71, 0x00, 0x00, 0x00, 0x20, 0x10, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x1f, 0x06, 0x00, 0x18, 0x00, 0x00, 0x00, 0x05, 0x00, 0x07, 0x00, 0xe5, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x5a, 0x06, 0x07, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01, 0x03, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */
+};
+
+const uint32_t test_test_reg_field_size = 72;
+
+#endif /* TEST_test_reg_field_H */
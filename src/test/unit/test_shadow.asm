@@ -0,0 +1,50 @@
+# Unit Test: shadow register banks
+# Runs with register frames in guest memory; the validation reruns it with
+# shadow banks, nesting the second interrupt inside the first.
+# Expected results:
+#   R5 = 5, R6 = 6 (restored by IRET)
+#   R10 = address of back (GETPC in the outer handler)
+#   R11 = 0 (inner handler runs only when nesting)
+#   R29 = 0x6F80 (the memory frame is left on the stack)
+
+start:
+    J main
+
+# Outer handler (IVT[40]); nests IVT[41] when R20 is set
+outer:
+    ADDI R5, R0, 111        # Clobbered; IRET restores it
+    BEQ R20, R0, outer_done
+    RAISE 41
+    EI                      # Inner handler runs here
+    NOP
+    DI
+outer_done:
+    GETPC R7
+    SW R7, R0, 0x6000       # Saved PC of the outer level
+    IRET
+
+# Inner handler (IVT[41]); counts its runs at 0x6004
+inner:
+    ADDI R6, R0, 222        # Clobbered; IRET restores it
+    LW R8, R0, 0x6004
+    ADDI R8, R8, 1
+    SW R8, R0, 0x6004
+    IRET
+
+main:
+    ADDI R29, R0, 0x7000    # Stack for register frames
+    SW R0, R0, 0x6004       # Clear the inner handler count
+    ORI R1, R0, %lo(outer)
+    SW R1, R0, 320          # IVT[40]
+    ORI R1, R0, %lo(inner)
+    SW R1, R0, 328          # IVT[41]
+    ADDI R5, R0, 5
+    ADDI R6, R0, 6
+    RAISE 40
+    EI                      # Outer handler runs here
+back:
+    NOP
+    LW R10, R0, 0x6000
+    LW R11, R0, 0x6004
+done:
+    SYSCALL                 # Halt
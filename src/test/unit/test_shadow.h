@@ -0,0 +1,31 @@
+/*
+ * Auto-generated from test_shadow.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_shadow_H
+#define TEST_test_shadow_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_shadow[] = {
+    0x70, 0x00, 0x00, 0x00, 0x78, 0x10, 0x00, 0x00, 0x05, 0x00, 0x05, 0x00, 0x6f, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x60, 0x14, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0xf5, 0x00, 0x00, 0x00, 0x29, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0xf3, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf6, 0x00, 0x00, 0x07, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x58, 0x00, 0x07, 0x00, 0x00, 0x60, 0x00, 0x00, 0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x05, 0x00, 0x06, 0x00, 0xde, 0x00, 0x00, 0x00, 0x50, 0x00, 0x08, 0x00, 0x04, 0x60, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x08, 0x08, 0x00, 0x01, 0x00, 0x00, 0x00, 0x58, 0x00, 0x08, 0x00, 0x04, 0x60, 0x00, 0x00  /* 0x0060 */,
+    0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x1d, 0x00, 0x00, 0x70, 0x00, 0x00  /* 0x0070 */,
+    0x58, 0x00, 0x00, 0x00, 0x04, 0x60, 0x00, 0x00, 0x15, 0x00, 0x01, 0x00, 0x08, 0x10, 0x00, 0x00  /* 0x0080 */,
+    0x58, 0x00, 0x01, 0x00, 0x40, 0x01, 0x00, 0x00, 0x15, 0x00, 0x01, 0x00, 0x50, 0x10, 0x00, 0x00  /* 0x0090 */,
+    0x58, 0x00, 0x01, 0x00, 0x48, 0x01, 0x00, 0x00, 0x05, 0x00, 0x05, 0x00, 0x05, 0x00, 0x00, 0x00  /* 0x00a0 */,
+    0x05, 0x00, 0x06, 0x00, 0x06, 0x00, 0x00, 0x00, 0xf5, 0x00, 0x00, 0x00, 0x28, 0x00, 0x00, 0x00  /* 0x00b0 */,
+    0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00c0 */,
+    0x50, 0x00, 0x0a, 0x00, 0x00, 0x60, 0x00, 0x00, 0x50, 0x00, 0x0b, 0x00, 0x04, 0x60, 0x00, 0x00  /* 0x00d0 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00e0 */
+};
+
+const uint32_t test_test_shadow_size = 232;
+
+#endif /* TEST_test_shadow_H */
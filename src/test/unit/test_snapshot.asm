@@ -0,0 +1,18 @@
+# Unit Test: VM snapshot and restore
+# The program stops twice. The test snapshots at the first SYSCALL,
+# resumes, restores, and resumes again; both resumes must end the same.
+# Expected results (after the second resume):
+#   R1 = 7 (from before the snapshot)
+#   R2 = 8, R3 = 1 (phase 2 ran once from the snapshot, not twice)
+#   Memory[0x2000] = 8
+
+start:
+    ADDI R1, R0, 7      # R1 = 7
+    SW R1, R0, 0x2000   # Memory[0x2000] = 7
+    SYSCALL             # Phase 1 done: snapshot here
+
+    LW R2, R0, 0x2000   # R2 = Memory[0x2000]
+    ADDI R2, R2, 1      # R2 = R2 + 1
+    SW R2, R0, 0x2000   # Memory[0x2000] = R2
+    ADDI R3, R3, 1      # Count phase 2 runs
+    SYSCALL             # Phase 2 done
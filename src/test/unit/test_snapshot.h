@@ -0,0 +1,20 @@
+/*
+ * Auto-generated from test_snapshot.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_snapshot_H
+#define TEST_test_snapshot_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_snapshot[] = {
+    0x05, 0x00, 0x01, 0x00, 0x07, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0000 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x00, 0x02, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x02, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x58, 0x00, 0x02, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x03, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */
+};
+
+const uint32_t test_test_snapshot_size = 64;
+
+#endif /* TEST_test_snapshot_H */
@@ -0,0 +1,19 @@
+# Unit Test: Execution counters (checked when built with STATS=1)
+# Expected results:
+#   R2 = 6 (3 + 2 + 1)
+#   19 instructions, 3 loads, 3 stores
+#   3 branches taken, 1 not taken
+
+start:
+    ADDI R1, R0, 3      # Loop counter
+    ADDI R2, R0, 0      # Sum
+loop:
+    SW R1, R0, 0x2000   # Store counter
+    LW R3, R0, 0x2000   # Load it back
+    ADD R2, R2, R3      # Sum += counter
+    ADDI R1, R1, -1     # Counter--
+    BNE R1, R0, loop    # Taken twice, then falls through
+    BEQ R0, R0, done    # Always taken
+    ADDI R2, R0, 0      # Skipped
+done:
+    SYSCALL             # Halt
@@ -0,0 +1,21 @@
+/*
+ * Auto-generated from test_stats.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_stats_H
+#define TEST_test_stats_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_stats[] = {
+    0x05, 0x00, 0x01, 0x00, 0x03, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x58, 0x00, 0x01, 0x00, 0x00, 0x20, 0x00, 0x00, 0x50, 0x00, 0x03, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0010 */,
+    0x01, 0x02, 0x03, 0x02, 0x00, 0x00, 0x00, 0x00, 0x05, 0x01, 0x01, 0x00, 0xff, 0xff, 0xff, 0xff  /* 0x0020 */,
+    0x61, 0x01, 0x00, 0x00, 0xd8, 0xff, 0xff, 0xff, 0x60, 0x00, 0x00, 0x00, 0x08, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x05, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0040 */
+};
+
+const uint32_t test_test_stats_size = 80;
+
+#endif /* TEST_test_stats_H */
@@ -0,0 +1,58 @@
+# Unit Test: Two-level page table with 4 MB superpages
+# Expected results:
+#   R10 = 11  (superpage 0 identity-maps the low 4 MB)
+#   R11 = 22  (virtual 0x402000 goes through the table at 0x9000 to 0x4000)
+#   R12 = 11  (superpage 2 aliases physical 0, fills the superpage TLB)
+#   R13 = 33  (user store rewrites the second-level PTE, now 0x5000)
+#   R14 = 22  (user store turns directory entry 2 into a table pointer)
+#   R15 = 44  (user store turns directory entry 1 into a superpage)
+
+start:
+    # Data words in four physical pages
+    ADDI R1, R0, 44
+    SW R1, R0, 0x2000
+    ADDI R1, R0, 11
+    SW R1, R0, 0x3000
+    ADDI R1, R0, 22
+    SW R1, R0, 0x4000
+    ADDI R1, R0, 33
+    SW R1, R0, 0x5000
+
+    # Second-level table at 0x9000 for virtual 0x400000-0x7FFFFF
+    ADDI R1, R0, 0x400B     # Page 2 -> 0x4000 (U, W, V)
+    SW R1, R0, 0x9008
+    ADDI R1, R0, 0x400B     # Page 3 -> 0x4000 (U, W, V)
+    SW R1, R0, 0x900C
+
+    # Directory at 0x8000
+    ADDI R1, R0, 0x1F       # 0-4 MB: superpage at 0 (S, U, X, W, V)
+    SW R1, R0, 0x8000
+    ADDI R1, R0, 0x9001     # 4-8 MB: table at 0x9000
+    SW R1, R0, 0x8004
+    ADDI R1, R0, 0x1B       # 8-12 MB: superpage at 0 (S, U, W, V)
+    SW R1, R0, 0x8008
+
+    ADDI R5, R0, 0x8001     # Directory base, two-level
+    ADDI R6, R0, 3          # Number of directory entries
+    SET_PTBR R5, R6
+    ENABLE_PAGING
+    ENTER_USER
+
+    LUI R20, 0x40           # R20 = 0x400000
+    LUI R21, 0x80           # R21 = 0x800000
+    LW R10, R0, 0x3000
+    LW R11, R20, 0x2000
+    LW R12, R21, 0x3000
+
+    ADDI R1, R0, 0x500B     # Page 2 -> 0x5000 (U, W, V)
+    SW R1, R0, 0x9008
+    LW R13, R20, 0x2000
+
+    ADDI R1, R0, 0x9001     # 8-12 MB: table at 0x9000
+    SW R1, R0, 0x8008
+    LW R14, R21, 0x3000
+
+    ADDI R1, R0, 0x1B       # 4-8 MB: superpage at 0 (S, U, W, V)
+    SW R1, R0, 0x8004
+    LW R15, R20, 0x2000
+    SYSCALL                 # Halt
@@ -0,0 +1,35 @@
+/*
+ * Auto-generated from test_superpage.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_superpage_H
+#define TEST_test_superpage_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_superpage[] = {
+    0x05, 0x00, 0x01, 0x00, 0x2c, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x01, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x00, 0x30, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x00, 0x01, 0x00, 0x16, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x00, 0x40, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x00, 0x01, 0x00, 0x21, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x00, 0x50, 0x00, 0x00  /* 0x0030 */,
+    0x05, 0x00, 0x01, 0x00, 0x0b, 0x40, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x08, 0x90, 0x00, 0x00  /* 0x0040 */,
+    0x05, 0x00, 0x01, 0x00, 0x0b, 0x40, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x0c, 0x90, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x00, 0x01, 0x00, 0x1f, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x00, 0x80, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x00, 0x01, 0x00, 0x01, 0x90, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x04, 0x80, 0x00, 0x00  /* 0x0070 */,
+    0x05, 0x00, 0x01, 0x00, 0x1b, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x08, 0x80, 0x00, 0x00  /* 0x0080 */,
+    0x05, 0x00, 0x05, 0x00, 0x01, 0x80, 0x00, 0x00, 0x05, 0x00, 0x06, 0x00, 0x03, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0xf9, 0x00, 0x06, 0x05, 0x00, 0x00, 0x00, 0x00, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00a0 */,
+    0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x17, 0x00, 0x14, 0x00, 0x40, 0x00, 0x00, 0x00  /* 0x00b0 */,
+    0x17, 0x00, 0x15, 0x00, 0x80, 0x00, 0x00, 0x00, 0x50, 0x00, 0x0a, 0x00, 0x00, 0x30, 0x00, 0x00  /* 0x00c0 */,
+    0x50, 0x14, 0x0b, 0x00, 0x00, 0x20, 0x00, 0x00, 0x50, 0x15, 0x0c, 0x00, 0x00, 0x30, 0x00, 0x00  /* 0x00d0 */,
+    0x05, 0x00, 0x01, 0x00, 0x0b, 0x50, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x08, 0x90, 0x00, 0x00  /* 0x00e0 */,
+    0x50, 0x14, 0x0d, 0x00, 0x00, 0x20, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x01, 0x90, 0x00, 0x00  /* 0x00f0 */,
+    0x58, 0x00, 0x01, 0x00, 0x08, 0x80, 0x00, 0x00, 0x50, 0x15, 0x0e, 0x00, 0x00, 0x30, 0x00, 0x00  /* 0x0100 */,
+    0x05, 0x00, 0x01, 0x00, 0x1b, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x04, 0x80, 0x00, 0x00  /* 0x0110 */,
+    0x50, 0x14, 0x0f, 0x00, 0x00, 0x20, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0120 */
+};
+
+const uint32_t test_test_superpage_size = 304;
+
+#endif /* TEST_test_superpage_H */
@@ -0,0 +1,38 @@
+# Unit Test: host syscall handler and batched requests
+# Without a handler the first SYSCALL halts the VM. The test re-runs the
+# program with a handler (1: add, 2: double, anything else: halt).
+# Expected results (with the handler):
+#   R10 = 42 (inline call 1(40, 2))
+#   R11 = 2 (both batch requests completed)
+#   R12 = 42, R13 = 105 (batch results 2(21) and 1(100, 5))
+
+start:
+    ADDI R4, R0, 1      # Syscall 1: add
+    ADDI R5, R0, 40
+    ADDI R6, R0, 2
+    SYSCALL             # R2 = 42 (halts here without a handler)
+    ADD R10, R2, R0
+
+    # Two requests at 0x2000, 32 bytes each
+    ADDI R1, R0, 0x2000
+    ADDI R3, R0, 2
+    SW R3, R1, 0        # Request 0: number 2
+    ADDI R3, R0, 21
+    SW R3, R1, 4        # Request 0: argument 0
+    ADDI R3, R0, 1
+    SW R3, R1, 32       # Request 1: number 1
+    ADDI R3, R0, 100
+    SW R3, R1, 36       # Request 1: argument 0
+    ADDI R3, R0, 5
+    SW R3, R1, 40       # Request 1: argument 1
+
+    ADDI R4, R0, 0xFFFF # Batch
+    ADDI R5, R0, 0x2000 # Table
+    ADDI R6, R0, 2      # Count
+    SYSCALL             # R2 = requests completed
+    ADD R11, R2, R0
+    LW R12, R1, 28      # Request 0 result
+    LW R13, R1, 60      # Request 1 result
+
+    ADDI R4, R0, 0      # Unknown syscall: the handler halts
+    SYSCALL
@@ -0,0 +1,29 @@
+/*
+ * Auto-generated from test_syscall.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_syscall_H
+#define TEST_test_syscall_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_syscall[] = {
+    0x05, 0x00, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x05, 0x00, 0x05, 0x00, 0x28, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x06, 0x00, 0x02, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x01, 0x02, 0x00, 0x0a, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x00, 0x03, 0x00, 0x02, 0x00, 0x00, 0x00, 0x58, 0x01, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x05, 0x00, 0x03, 0x00, 0x15, 0x00, 0x00, 0x00, 0x58, 0x01, 0x03, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x05, 0x00, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x58, 0x01, 0x03, 0x00, 0x20, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x00, 0x03, 0x00, 0x64, 0x00, 0x00, 0x00, 0x58, 0x01, 0x03, 0x00, 0x24, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x00, 0x03, 0x00, 0x05, 0x00, 0x00, 0x00, 0x58, 0x01, 0x03, 0x00, 0x28, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0x05, 0x00, 0x04, 0x00, 0xff, 0xff, 0x00, 0x00, 0x05, 0x00, 0x05, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0080 */,
+    0x05, 0x00, 0x06, 0x00, 0x02, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0x01, 0x02, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x00, 0x50, 0x01, 0x0c, 0x00, 0x1c, 0x00, 0x00, 0x00  /* 0x00a0 */,
+    0x50, 0x01, 0x0d, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x05, 0x00, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00b0 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00c0 */
+};
+
+const uint32_t test_test_syscall_size = 200;
+
+#endif /* TEST_test_syscall_H */
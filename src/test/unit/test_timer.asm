@@ -0,0 +1,41 @@
+# Unit Test: instruction-count timer
+# A period-20 timer on interrupt 0x20 preempts a counting loop until the
+# handler has run three times; then the timer is stopped.
+# Expected results:
+#   R10 = 18 (loop iterations until the third tick is seen)
+#   R11 = 3 (ticks counted by the handler)
+#   R12 = 3 (no tick after SET_TIMER R0)
+
+start:
+    J main
+
+# Timer handler at 0x1008: count ticks at 0x6000
+handler:
+    LW R8, R0, 0x6000
+    ADDI R8, R8, 1
+    SW R8, R0, 0x6000
+    IRET
+
+main:
+    ADDI R29, R0, 0x7000    # Stack for register save area
+    SW R0, R0, 0x6000       # Clear tick count
+    ADDI R1, R0, 0x1008     # Handler address
+    SW R1, R0, 256          # IVT[0x20]
+    ADDI R2, R0, 20         # Period
+    ADDI R3, R0, 3          # Ticks wanted
+    SET_TIMER R2, 0x20
+    EI
+
+loop:
+    ADDI R10, R10, 1
+    LW R9, R0, 0x6000
+    BNE R9, R3, loop
+
+    SET_TIMER R0, 0x20      # Stop the timer
+    LW R11, R0, 0x6000
+    ADDI R4, R0, 30
+spin:
+    ADDI R4, R4, -1         # Outlast a period with the timer stopped
+    BGTZ R4, spin
+    LW R12, R0, 0x6000
+    SYSCALL                 # Halt
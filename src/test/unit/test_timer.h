@@ -0,0 +1,28 @@
+/*
+ * Auto-generated from test_timer.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_timer_H
+#define TEST_test_timer_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_timer[] = {
+    0x70, 0x00, 0x00, 0x00, 0x28, 0x10, 0x00, 0x00, 0x50, 0x00, 0x08, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x08, 0x08, 0x00, 0x01, 0x00, 0x00, 0x00, 0x58, 0x00, 0x08, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x0010 */,
+    0xf4, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x00, 0x1d, 0x00, 0x00, 0x70, 0x00, 0x00  /* 0x0020 */,
+    0x58, 0x00, 0x00, 0x00, 0x00, 0x60, 0x00, 0x00, 0x05, 0x00, 0x01, 0x00, 0x08, 0x10, 0x00, 0x00  /* 0x0030 */,
+    0x58, 0x00, 0x01, 0x00, 0x00, 0x01, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x14, 0x00, 0x00, 0x00  /* 0x0040 */,
+    0x05, 0x00, 0x03, 0x00, 0x03, 0x00, 0x00, 0x00, 0xfa, 0x02, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0xf2, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x05, 0x0a, 0x0a, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x50, 0x00, 0x09, 0x00, 0x00, 0x60, 0x00, 0x00, 0x61, 0x09, 0x03, 0x00, 0xe8, 0xff, 0xff, 0xff  /* 0x0070 */,
+    0xfa, 0x00, 0x00, 0x00, 0x20, 0x00, 0x00, 0x00, 0x50, 0x00, 0x0b, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x0080 */,
+    0x05, 0x00, 0x04, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x05, 0x04, 0x04, 0x00, 0xff, 0xff, 0xff, 0xff  /* 0x0090 */,
+    0x63, 0x04, 0x00, 0x00, 0xf0, 0xff, 0xff, 0xff, 0x50, 0x00, 0x0c, 0x00, 0x00, 0x60, 0x00, 0x00  /* 0x00a0 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x00b0 */
+};
+
+const uint32_t test_test_timer_size = 184;
+
+#endif /* TEST_test_timer_H */
@@ -0,0 +1,31 @@
+# Unit Test: Software TLB invalidation on page table store
+# Expected results:
+#   R10 = 11  (virtual page 2 initially maps physical page 3)
+#   R12 = 22  (user store remaps virtual page 2 to physical page 4)
+
+start:
+    # Data words in the two physical pages
+    ADDI R1, R0, 11
+    SW R1, R0, 0x3000
+    ADDI R1, R0, 22
+    SW R1, R0, 0x4000
+
+    # Page table at 0x8000: code, data, and the table itself
+    ADDI R1, R0, 0x100D     # VPN 1 -> 0x1000 (U, X, V)
+    SW R1, R0, 0x8004
+    ADDI R1, R0, 0x300B     # VPN 2 -> 0x3000 (U, W, V)
+    SW R1, R0, 0x8008
+    ADDI R1, R0, 0x800B     # VPN 3 -> 0x8000 (U, W, V)
+    SW R1, R0, 0x800C
+
+    ADDI R5, R0, 0x8000     # Page table base
+    ADDI R6, R0, 16         # Number of pages
+    SET_PTBR R5, R6
+    ENABLE_PAGING
+    ENTER_USER
+
+    LW R10, R0, 0x2000      # Loads 11 and fills the data TLB
+    ADDI R11, R0, 0x400B    # VPN 2 -> 0x4000 (U, W, V)
+    SW R11, R0, 0x3008      # Rewrite PTE for VPN 2 through VPN 3
+    LW R12, R0, 0x2000      # Must see the new mapping
+    SYSCALL                 # Halt
@@ -0,0 +1,26 @@
+/*
+ * Auto-generated from test_tlb.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_tlb_H
+#define TEST_test_tlb_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_tlb[] = {
+    0x05, 0x00, 0x01, 0x00, 0x0b, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x00, 0x30, 0x00, 0x00  /* 0x0000 */,
+    0x05, 0x00, 0x01, 0x00, 0x16, 0x00, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x00, 0x40, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x00, 0x01, 0x00, 0x0d, 0x10, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x04, 0x80, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x00, 0x01, 0x00, 0x0b, 0x30, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x08, 0x80, 0x00, 0x00  /* 0x0030 */,
+    0x05, 0x00, 0x01, 0x00, 0x0b, 0x80, 0x00, 0x00, 0x58, 0x00, 0x01, 0x00, 0x0c, 0x80, 0x00, 0x00  /* 0x0040 */,
+    0x05, 0x00, 0x05, 0x00, 0x00, 0x80, 0x00, 0x00, 0x05, 0x00, 0x06, 0x00, 0x10, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0xf9, 0x00, 0x06, 0x05, 0x00, 0x00, 0x00, 0x00, 0xf7, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0xfb, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x50, 0x00, 0x0a, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0070 */,
+    0x05, 0x00, 0x0b, 0x00, 0x0b, 0x40, 0x00, 0x00, 0x58, 0x00, 0x0b, 0x00, 0x08, 0x30, 0x00, 0x00  /* 0x0080 */,
+    0x50, 0x00, 0x0c, 0x00, 0x00, 0x20, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0090 */
+};
+
+const uint32_t test_test_tlb_size = 160;
+
+#endif /* TEST_test_tlb_H */
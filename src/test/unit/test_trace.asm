@@ -0,0 +1,12 @@
+# Unit Test: execution trace ring
+# Five instructions, one store and one load. The test re-runs the program
+# with a trace ring attached and checks the records.
+# Expected results:
+#   R3 = 5 (loaded back from Memory[0x2004])
+
+start:
+    ADDI R1, R0, 0x2000 # 0x1000: base address
+    ADDI R2, R0, 5      # 0x1008: value
+    SW R2, R1, 4        # 0x1010: store to 0x2004
+    LW R3, R1, 4        # 0x1018: load from 0x2004
+    SYSCALL             # 0x1020: done
@@ -0,0 +1,19 @@
+/*
+ * Auto-generated from test_trace.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_trace_H
+#define TEST_test_trace_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_trace[] = {
+    0x05, 0x00, 0x01, 0x00, 0x00, 0x20, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x05, 0x00, 0x00, 0x00  /* 0x0000 */,
+    0x58, 0x01, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x50, 0x01, 0x03, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0020 */
+};
+
+const uint32_t test_test_trace_size = 40;
+
+#endif /* TEST_test_trace_H */
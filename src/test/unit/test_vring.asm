@@ -0,0 +1,89 @@
+# Unit Test: shared-memory request ring
+# Builds a four-entry ring at 0x4000 holding two chains (a request buffer
+# followed by a response buffer), publishes both and rings the doorbell
+# at 0xF0002000 once. The test re-runs the program with a ring device
+# mapped there whose host adds up the request bytes into the response.
+# Expected results (with the device):
+#   R10 = 2 (used ring index), R11 = 0, R12 = 2 (completed heads)
+#   R13 = 4 (bytes written for chain 2)
+#   R14 = 10 (1 + 2 + 3 + 4), R15 = 48 (0x10 + 0x20)
+#   R16 = 1 (ring still running)
+
+start:
+    ADDI R1, R0, 0x4000 # Descriptor table
+
+    ADDI R2, R0, 0x5000 # 0: request, 4 bytes, next 1
+    SW R2, R1, 0
+    SW R0, R1, 4
+    ADDI R2, R0, 4
+    SW R2, R1, 8
+    ADDI R2, R0, 1
+    SH R2, R1, 12
+    SH R2, R1, 14
+
+    ADDI R2, R0, 0x5100 # 1: response, 4 bytes, host writes
+    SW R2, R1, 16
+    SW R0, R1, 20
+    ADDI R2, R0, 4
+    SW R2, R1, 24
+    ADDI R2, R0, 2
+    SH R2, R1, 28
+    SH R0, R1, 30
+
+    ADDI R2, R0, 0x5004 # 2: request, 2 bytes, next 3
+    SW R2, R1, 32
+    SW R0, R1, 36
+    ADDI R2, R0, 2
+    SW R2, R1, 40
+    ADDI R2, R0, 1
+    SH R2, R1, 44
+    ADDI R2, R0, 3
+    SH R2, R1, 46
+
+    ADDI R2, R0, 0x5104 # 3: response, 4 bytes, host writes
+    SW R2, R1, 48
+    SW R0, R1, 52
+    ADDI R2, R0, 4
+    SW R2, R1, 56
+    ADDI R2, R0, 2
+    SH R2, R1, 60
+    SH R0, R1, 62
+
+    ADDI R3, R0, 0x5000 # Request data and cleared responses
+    LUI R2, 0x0403
+    ORI R2, R2, 0x0201
+    SW R2, R3, 0
+    ADDI R2, R0, 0x2010
+    SW R2, R3, 4
+    SW R0, R3, 0x100
+    SW R0, R3, 0x104
+
+    ADDI R4, R0, 0x4040 # Available ring: heads 0 and 2
+    SH R0, R4, 4
+    ADDI R2, R0, 2
+    SH R2, R4, 6
+    SH R0, R4, 0        # Flags: completion interrupt wanted
+    SH R2, R4, 2        # Index: two chains published
+
+    ADDI R5, R0, 0x4080 # Used ring
+    SW R0, R5, 0
+
+    LUI R6, 0xF000      # Doorbell device
+    ORI R6, R6, 0x2000
+    ADDI R2, R0, 4
+    SW R2, R6, 0        # NUM
+    SW R1, R6, 4        # DESC
+    SW R4, R6, 8        # AVAIL
+    SW R5, R6, 12       # USED
+    ADDI R2, R0, 1
+    SW R2, R6, 16       # READY
+    SW R0, R6, 20       # NOTIFY: one trap for both chains
+
+    LHU R10, R5, 2
+    LW R11, R5, 4
+    LW R12, R5, 12
+    LW R13, R5, 16
+    LW R14, R3, 0x100
+    LW R15, R3, 0x104
+    LW R16, R6, 16
+    SYSCALL
@@ -0,0 +1,50 @@
+/*
+ * Auto-generated from test_vring.bin
+ * DO NOT EDIT - Generated by bin2h
+ */
+
+#ifndef TEST_test_vring_H
+#define TEST_test_vring_H
+
+#include "c32_types.h"
+
+const uint8_t test_test_vring[] = {
+    0x05, 0x00, 0x01, 0x00, 0x00, 0x40, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x00, 0x50, 0x00, 0x00  /* 0x0000 */,
+    0x58, 0x01, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00, 0x58, 0x01, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0010 */,
+    0x05, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x58, 0x01, 0x02, 0x00, 0x08, 0x00, 0x00, 0x00  /* 0x0020 */,
+    0x05, 0x00, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x59, 0x01, 0x02, 0x00, 0x0c, 0x00, 0x00, 0x00  /* 0x0030 */,
+    0x59, 0x01, 0x02, 0x00, 0x0e, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x00, 0x51, 0x00, 0x00  /* 0x0040 */,
+    0x58, 0x01, 0x02, 0x00, 0x10, 0x00, 0x00, 0x00, 0x58, 0x01, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00  /* 0x0050 */,
+    0x05, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x58, 0x01, 0x02, 0x00, 0x18, 0x00, 0x00, 0x00  /* 0x0060 */,
+    0x05, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x59, 0x01, 0x02, 0x00, 0x1c, 0x00, 0x00, 0x00  /* 0x0070 */,
+    0x59, 0x01, 0x00, 0x00, 0x1e, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x04, 0x50, 0x00, 0x00  /* 0x0080 */,
+    0x58, 0x01, 0x02, 0x00, 0x20, 0x00, 0x00, 0x00, 0x58, 0x01, 0x00, 0x00, 0x24, 0x00, 0x00, 0x00  /* 0x0090 */,
+    0x05, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x58, 0x01, 0x02, 0x00, 0x28, 0x00, 0x00, 0x00  /* 0x00a0 */,
+    0x05, 0x00, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00, 0x59, 0x01, 0x02, 0x00, 0x2c, 0x00, 0x00, 0x00  /* 0x00b0 */,
+    0x05, 0x00, 0x02, 0x00, 0x03, 0x00, 0x00, 0x00, 0x59, 0x01, 0x02, 0x00, 0x2e, 0x00, 0x00, 0x00  /* 0x00c0 */,
+    0x05, 0x00, 0x02, 0x00, 0x04, 0x51, 0x00, 0x00, 0x58, 0x01, 0x02, 0x00, 0x30, 0x00, 0x00, 0x00  /* 0x00d0 */,
+    0x58, 0x01, 0x00, 0x00, 0x34, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x00e0 */,
+    0x58, 0x01, 0x02, 0x00, 0x38, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00  /* 0x00f0 */,
+    0x59, 0x01, 0x02, 0x00, 0x3c, 0x00, 0x00, 0x00, 0x59, 0x01, 0x00, 0x00, 0x3e, 0x00, 0x00, 0x00  /* 0x0100 */,
+    0x05, 0x00, 0x03, 0x00, 0x00, 0x50, 0x00, 0x00, 0x17, 0x00, 0x02, 0x00, 0x03, 0x04, 0x00, 0x00  /* 0x0110 */,
+    0x15, 0x02, 0x02, 0x00, 0x01, 0x02, 0x00, 0x00, 0x58, 0x03, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0120 */,
+    0x05, 0x00, 0x02, 0x00, 0x10, 0x20, 0x00, 0x00, 0x58, 0x03, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0130 */,
+    0x58, 0x03, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x58, 0x03, 0x00, 0x00, 0x04, 0x01, 0x00, 0x00  /* 0x0140 */,
+    0x05, 0x00, 0x04, 0x00, 0x40, 0x40, 0x00, 0x00, 0x59, 0x04, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x0150 */,
+    0x05, 0x00, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00, 0x59, 0x04, 0x02, 0x00, 0x06, 0x00, 0x00, 0x00  /* 0x0160 */,
+    0x59, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x59, 0x04, 0x02, 0x00, 0x02, 0x00, 0x00, 0x00  /* 0x0170 */,
+    0x05, 0x00, 0x05, 0x00, 0x80, 0x40, 0x00, 0x00, 0x58, 0x05, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0180 */,
+    0x17, 0x00, 0x06, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x15, 0x06, 0x06, 0x00, 0x00, 0x20, 0x00, 0x00  /* 0x0190 */,
+    0x05, 0x00, 0x02, 0x00, 0x04, 0x00, 0x00, 0x00, 0x58, 0x06, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x01a0 */,
+    0x58, 0x06, 0x01, 0x00, 0x04, 0x00, 0x00, 0x00, 0x58, 0x06, 0x04, 0x00, 0x08, 0x00, 0x00, 0x00  /* 0x01b0 */,
+    0x58, 0x06, 0x05, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x05, 0x00, 0x02, 0x00, 0x01, 0x00, 0x00, 0x00  /* 0x01c0 */,
+    0x58, 0x06, 0x02, 0x00, 0x10, 0x00, 0x00, 0x00, 0x58, 0x06, 0x00, 0x00, 0x14, 0x00, 0x00, 0x00  /* 0x01d0 */,
+    0x52, 0x05, 0x0a, 0x00, 0x02, 0x00, 0x00, 0x00, 0x50, 0x05, 0x0b, 0x00, 0x04, 0x00, 0x00, 0x00  /* 0x01e0 */,
+    0x50, 0x05, 0x0c, 0x00, 0x0c, 0x00, 0x00, 0x00, 0x50, 0x05, 0x0d, 0x00, 0x10, 0x00, 0x00, 0x00  /* 0x01f0 */,
+    0x50, 0x03, 0x0e, 0x00, 0x00, 0x01, 0x00, 0x00, 0x50, 0x03, 0x0f, 0x00, 0x04, 0x01, 0x00, 0x00  /* 0x0200 */,
+    0x50, 0x06, 0x10, 0x00, 0x10, 0x00, 0x00, 0x00, 0xf0, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00  /* 0x0210 */
+};
+
+const uint32_t test_test_vring_size = 544;
+
+#endif /* TEST_test_vring_H */
@@ -0,0 +1,132 @@
+/*
+ * c32ophash - Mnemonic Hash Table Generator
+ * Builds the assembler's collision-free mnemonic lookup table from the
+ * instruction list in c32_opcodes.h
+ */
+
+#include <stdio.h>
+#include <string.h>
+
+#include "c32_opcodes.h"
+
+/* Slots in the generated table (must match the top-bits shift below) */
+#define SLOT_BITS 8
+#define SLOT_COUNT (1 << SLOT_BITS)
+
+/* Highest seed tried before giving up */
+#define MAX_SEED 0x01000000UL
+
+/* Mnemonics in C32_INSTRUCTIONS order, so index i is op_table[i] */
+static const char *const mnemonics[] = {
+#define C32_OP_NAME(name, format) #name,
+    C32_INSTRUCTIONS(C32_OP_NAME)
+#undef C32_OP_NAME
+};
+
+#define MNEMONIC_COUNT (sizeof(mnemonics) / sizeof(mnemonics[0]))
+
+/* FNV-1a over the mnemonic, starting from seed (same as C32_OPHASH_STEP) */
+static unsigned long hash_mnemonic(const char *name, unsigned long seed) {
+    unsigned long h = seed;
+
+    while (*name) {
+        h = ((h ^ (unsigned char)*name) * 16777619UL) & 0xFFFFFFFFUL;
+        name++;
+    }
+
+    return h >> (32 - SLOT_BITS);
+}
+
+/* Fill slots for seed; returns 0 if two mnemonics share a slot */
+static int place_mnemonics(unsigned long seed, unsigned int *slots) {
+    size_t i;
+
+    memset(slots, 0, SLOT_COUNT * sizeof(slots[0]));
+    for (i = 0; i < MNEMONIC_COUNT; i++) {
+        unsigned long slot = hash_mnemonic(mnemonics[i], seed);
+        if (slots[slot] != 0) {
+            return 0;
+        }
+        slots[slot] = (unsigned int)i + 1;
+    }
+
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    unsigned int slots[SLOT_COUNT];
+    unsigned long seed;
+    size_t i, max_len = 0;
+    FILE *output;
+
+    if (argc != 2) {
+        fprintf(stderr, "Usage: %s <output.h>\n", argv[0]);
+        return 1;
+    }
+
+    if (MNEMONIC_COUNT >= 256) {
+        fprintf(stderr, "Error: too many instructions for 8-bit slots\n");
+        return 1;
+    }
+
+    for (i = 0; i < MNEMONIC_COUNT; i++) {
+        if (strlen(mnemonics[i]) > max_len) {
+            max_len = strlen(mnemonics[i]);
+        }
+    }
+
+    for (seed = 0; seed < MAX_SEED; seed++) {
+        if (place_mnemonics(seed, slots)) {
+            break;
+        }
+    }
+    if (seed == MAX_SEED) {
+        fprintf(stderr, "Error: no collision-free seed below 0x%lX\n", MAX_SEED);
+        return 1;
+    }
+
+    output = fopen(argv[1], "w");
+    if (!output) {
+        fprintf(stderr, "Error: Cannot create output file '%s'\n", argv[1]);
+        return 1;
+    }
+
+    fprintf(output, "/*\n");
+    fprintf(output, " * Mnemonic hash table, generated by c32ophash from C32_INSTRUCTIONS\n");
+    fprintf(output, " * Do not edit: run 'make' after changing c32_opcodes.h\n");
+    fprintf(output, " */\n\n");
+    fprintf(output, "#ifndef C32_OPHASH_H\n");
+    fprintf(output, "#define C32_OPHASH_H\n\n");
+    fprintf(output, "/* Number of instructions the table was built for */\n");
+    fprintf(output, "#define C32_OPHASH_COUNT %lu\n\n", (unsigned long)MNEMONIC_COUNT);
+    fprintf(output, "/* Length of the longest mnemonic */\n");
+    fprintf(output, "#define C32_OPHASH_MAX_LEN %lu\n\n", (unsigned long)max_len);
+    fprintf(output, "/* FNV-1a starting value that places every mnemonic in its own slot */\n");
+    fprintf(output, "#define C32_OPHASH_SEED 0x%08lXUL\n\n", seed);
+    fprintf(output, "/* Fold one character into the 32-bit hash h */\n");
+    fprintf(output, "#define C32_OPHASH_STEP(h, c) \\\n");
+    fprintf(output, "    ((((h) ^ (unsigned char)(c)) * 16777619UL) & 0xFFFFFFFFUL)\n\n");
+    fprintf(output, "/* Slot index of a finished hash */\n");
+    fprintf(output, "#define C32_OPHASH_SLOT(h) ((h) >> %d)\n\n", 32 - SLOT_BITS);
+    fprintf(output, "/* Instruction table index + 1 for every slot (0 = empty) */\n");
+    fprintf(output, "static const unsigned char op_hash_slots[%d] = {\n", SLOT_COUNT);
+    for (i = 0; i < SLOT_COUNT; i++) {
+        if (i % 16 == 0) {
+            fprintf(output, "    ");
+        }
+        fprintf(output, "%u", slots[i]);
+        if (i < SLOT_COUNT - 1) {
+            fprintf(output, ",");
+        }
+        if (i % 16 == 15) {
+            fprintf(output, "\n");
+        } else {
+            fprintf(output, " ");
+        }
+    }
+    fprintf(output, "};\n\n");
+    fprintf(output, "#endif /* C32_OPHASH_H */\n");
+
+    fclose(output);
+    return 0;
+}
@@ -0,0 +1,232 @@
+/*
+ * c32prof - CRISP-32 Profile Report
+ * Attributes crisp32 --profile samples and call counts to the functions in
+ * a c32asm -m symbol map and prints a flat profile. A function is the entry
+ * label or a label that a JAL or JALR called; other labels (loops, branch
+ * targets) count towards the function they are in.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define MAX_NAME 64
+#define MAX_LINE 256
+
+typedef struct {
+    unsigned long address;
+    char name[MAX_NAME];
+    unsigned long samples;
+    unsigned long calls;
+    int function;               /* Entry label or call target */
+} func_t;
+
+static func_t *funcs = NULL;
+static int num_funcs = 0;
+static int max_funcs = 0;
+
+/* Make room for one more label, doubling the table */
+static func_t *add_func(void) {
+    if (num_funcs == max_funcs) {
+        int grown = max_funcs ? 2 * max_funcs : 1024;
+        func_t *table = (func_t *)realloc(funcs, (size_t)grown * sizeof(func_t));
+
+        if (!table) {
+            return NULL;
+        }
+        funcs = table;
+        max_funcs = grown;
+    }
+    memset(&funcs[num_funcs], 0, sizeof(func_t));
+    return &funcs[num_funcs];
+}
+
+/* Load a symbol map; entries are written in ascending address order */
+static int load_map(const char *filename) {
+    FILE *fp;
+    char line[MAX_LINE];
+
+    fp = fopen(filename, "r");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot open map '%s'\n", filename);
+        return -1;
+    }
+
+    /* Slot 0 collects anything below the first label */
+    num_funcs = 0;
+    if (!add_func()) {
+        fprintf(stderr, "Error: Out of memory\n");
+        fclose(fp);
+        return -1;
+    }
+    strcpy(funcs[0].name, "[unknown]");
+    funcs[0].function = 1;
+    num_funcs = 1;
+
+    while (fgets(line, sizeof(line), fp)) {
+        func_t *f;
+
+        if (line[0] == '#' || line[0] == '\n') {
+            continue;
+        }
+        f = add_func();
+        if (!f) {
+            fprintf(stderr, "Error: Out of memory reading '%s'\n", filename);
+            fclose(fp);
+            return -1;
+        }
+        if (sscanf(line, "%lx %63s", &f->address, f->name) != 2) {
+            continue;
+        }
+        if (num_funcs > 1 && f->address < funcs[num_funcs - 1].address) {
+            fprintf(stderr, "Error: Map '%s' is not sorted by address\n", filename);
+            fclose(fp);
+            return -1;
+        }
+        num_funcs++;
+    }
+
+    /* The lowest label is the program entry */
+    if (num_funcs > 1) {
+        funcs[1].function = 1;
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+/* Find the last label at or below an address */
+static func_t *lookup(unsigned long address) {
+    int lo = 1;
+    int hi = num_funcs - 1;
+    int found = 0;
+
+    while (lo <= hi) {
+        int mid = (lo + hi) / 2;
+
+        if (funcs[mid].address <= address) {
+            found = mid;
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+
+    return &funcs[found];
+}
+
+/* Load a profile and attribute every record to its function */
+static int load_profile(const char *filename, unsigned long *interval,
+                        unsigned long *total, unsigned long *dropped) {
+    FILE *fp;
+    char line[MAX_LINE];
+    char kind[16];
+    unsigned long a, b;
+
+    fp = fopen(filename, "r");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot open profile '%s'\n", filename);
+        return -1;
+    }
+    if (!fgets(line, sizeof(line), fp) || strcmp(line, "# CRISP-32 profile\n") != 0) {
+        fprintf(stderr, "Error: '%s' is not a crisp32 --profile file\n", filename);
+        fclose(fp);
+        return -1;
+    }
+
+    while (fgets(line, sizeof(line), fp)) {
+        if (line[0] == '#') {
+            continue;
+        }
+        if (sscanf(line, "%15s %lx %lu", kind, &a, &b) == 3) {
+            if (strcmp(kind, "pc") == 0) {
+                lookup(a)->samples += b;
+                *total += b;
+            } else if (strcmp(kind, "call") == 0) {
+                func_t *f = lookup(a);
+
+                f->calls += b;
+                f->function = 1;
+            }
+        } else if (sscanf(line, "%15s %lu", kind, &a) == 2) {
+            if (strcmp(kind, "interval") == 0) {
+                *interval = a;
+            } else if (strcmp(kind, "dropped") == 0) {
+                *dropped = a;
+            }
+        }
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+/* Fold the samples of every other label into the function before it */
+static void fold_labels(void) {
+    func_t *owner = &funcs[0];
+    int i;
+
+    for (i = 1; i < num_funcs; i++) {
+        if (funcs[i].function) {
+            owner = &funcs[i];
+        } else {
+            owner->samples += funcs[i].samples;
+            funcs[i].samples = 0;
+        }
+    }
+}
+
+/* Sort by samples, then calls, descending */
+static int compare_funcs(const void *a, const void *b) {
+    const func_t *fa = (const func_t *)a;
+    const func_t *fb = (const func_t *)b;
+
+    if (fa->samples != fb->samples) {
+        return fa->samples < fb->samples ? 1 : -1;
+    }
+    if (fa->calls != fb->calls) {
+        return fa->calls < fb->calls ? 1 : -1;
+    }
+    return fa->address < fb->address ? -1 : (fa->address > fb->address);
+}
+
+int main(int argc, char **argv) {
+    unsigned long interval = 0;
+    unsigned long total = 0;
+    unsigned long dropped = 0;
+    int i;
+
+    if (argc != 3) {
+        fprintf(stderr, "Usage: %s <program.map> <program.prof>\n", argv[0]);
+        fprintf(stderr, "\nPrints a flat profile from a c32asm -m symbol map and a\n");
+        fprintf(stderr, "crisp32 --profile output file\n");
+        fprintf(stderr, "Example: %s program.map program.prof\n", argv[0]);
+        return 1;
+    }
+
+    if (load_map(argv[1]) < 0 || load_profile(argv[2], &interval, &total, &dropped) < 0) {
+        return 1;
+    }
+
+    fold_labels();
+    qsort(funcs, num_funcs, sizeof(func_t), compare_funcs);
+
+    printf("Flat profile: %lu samples, one every %lu instructions", total, interval);
+    if (dropped) {
+        printf(" (%lu outside profiled range)", dropped);
+    }
+    printf("\n\n");
+    printf("  %%time     samples       calls  function\n");
+    for (i = 0; i < num_funcs; i++) {
+        const func_t *f = &funcs[i];
+
+        if (!f->samples && !f->calls) {
+            continue;
+        }
+        printf("%7.2f %11lu %11lu  %s\n",
+               total ? 100.0 * (double)f->samples / (double)total : 0.0,
+               f->samples, f->calls, f->name);
+    }
+
+    return 0;
+}
@@ -0,0 +1,169 @@
+/*
+ * c32trace - CRISP-32 Trace Decoder
+ * Prints a crisp32 --trace file as disassembly, one executed instruction
+ * per line, with the effective address of every load and store
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "c32_opcodes.h"
+
+#define HEADER_SIZE 16
+#define RECORD_SIZE 16
+
+typedef struct {
+    int opcode;
+    const char *name;
+    int format;
+} op_info_t;
+
+/* Mnemonics and operand layouts, from the assembler's instruction list */
+static const op_info_t ops[] = {
+#define OP_ENTRY(name, format) { OP_##name, #name, C32_FMT_##format },
+    C32_INSTRUCTIONS(OP_ENTRY)
+#undef OP_ENTRY
+};
+
+static const op_info_t *op_table[256];
+
+/* Little-endian 32-bit field */
+static unsigned long get_word(const unsigned char *p) {
+    return (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+           ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+/* Signed value of a 32-bit immediate */
+static long signed_imm(unsigned long imm) {
+    return imm & 0x80000000UL ? -(long)(0xFFFFFFFFUL - imm) - 1 : (long)imm;
+}
+
+/* Print one record as "pc  MNEMONIC operands" */
+static void print_record(const unsigned char *rec) {
+    unsigned long pc = get_word(rec);
+    int opcode = rec[4];
+    int rs = rec[5], rt = rec[6], rd = rec[7];
+    unsigned long imm = get_word(rec + 8);
+    unsigned long addr = get_word(rec + 12);
+    const op_info_t *op = op_table[opcode];
+
+    printf("0x%08lx  ", pc);
+    if (!op) {
+        printf(".illegal 0x%02x\n", opcode);
+        return;
+    }
+
+    printf(op->format == C32_FMT_NONE ? "%s" : "%-8s", op->name);
+    switch (op->format) {
+        case C32_FMT_R:
+        case C32_FMT_BULK:
+            printf(" R%d, R%d, R%d", rd, rs, rt);
+            break;
+        case C32_FMT_I:
+            printf(" R%d, R%d, %ld", rt, rs, signed_imm(imm));
+            break;
+        case C32_FMT_LOGIC:
+            printf(" R%d, R%d, 0x%lx", rt, rs, imm);
+            break;
+        case C32_FMT_LUI:
+            printf(" R%d, 0x%lx", rt, imm);
+            break;
+        case C32_FMT_SHIFT:
+            printf(" R%d, R%d, %lu", rd, rt, imm);
+            break;
+        case C32_FMT_MEM:
+            printf(" R%d, R%d, %ld", rt, rs, signed_imm(imm));
+            printf("    ; [0x%08lx]", addr);
+            break;
+        case C32_FMT_BRANCH2:
+            printf(" R%d, R%d, 0x%08lx", rs, rt, (pc + 8 + imm) & 0xFFFFFFFFUL);
+            break;
+        case C32_FMT_BRANCH1:
+            printf(" R%d, 0x%08lx", rs, (pc + 8 + imm) & 0xFFFFFFFFUL);
+            break;
+        case C32_FMT_JUMP:
+            printf(" 0x%08lx", imm);
+            break;
+        case C32_FMT_RS:
+            printf(" R%d", rs);
+            break;
+        case C32_FMT_RD_RS:
+            printf(" R%d, R%d", rd, rs);
+            break;
+        case C32_FMT_RD:
+            printf(" R%d", rd);
+            break;
+        case C32_FMT_RD_RT:
+            printf(" R%d, R%d", rd, rt);
+            break;
+        case C32_FMT_RS_IMM:
+            printf(" R%d, %lu", rs, imm);
+            break;
+        case C32_FMT_IMM:
+            printf(" %lu", imm);
+            break;
+        default:
+            break;
+    }
+    printf("\n");
+}
+
+int main(int argc, char **argv) {
+    FILE *fp;
+    unsigned char header[HEADER_SIZE];
+    unsigned char rec[RECORD_SIZE];
+    unsigned long last = 0;
+    const char *filename;
+    size_t i;
+
+    if (argc == 4 && strcmp(argv[1], "-n") == 0) {
+        last = strtoul(argv[2], NULL, 0);
+        filename = argv[3];
+    } else if (argc == 2) {
+        filename = argv[1];
+    } else {
+        fprintf(stderr, "Usage: %s [-n count] <program.trace>\n", argv[0]);
+        fprintf(stderr, "\nPrints a crisp32 --trace file as disassembly\n");
+        fprintf(stderr, "  -n count  Only print the last count instructions\n");
+        fprintf(stderr, "Example: %s -n 100 program.trace\n", argv[0]);
+        return 1;
+    }
+
+    for (i = 0; i < sizeof(ops) / sizeof(ops[0]); i++) {
+        op_table[ops[i].opcode] = &ops[i];
+    }
+
+    fp = fopen(filename, "rb");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot open trace '%s'\n", filename);
+        return 1;
+    }
+    if (fread(header, 1, HEADER_SIZE, fp) != HEADER_SIZE ||
+        memcmp(header, "C32TRACE", 8) != 0 || get_word(header + 8) != 1 ||
+        get_word(header + 12) != RECORD_SIZE) {
+        fprintf(stderr, "Error: '%s' is not a CRISP-32 trace\n", filename);
+        fclose(fp);
+        return 1;
+    }
+
+    /* Records are fixed-size, so the tail can be found without reading it all */
+    if (last) {
+        long size;
+
+        fseek(fp, 0, SEEK_END);
+        size = (ftell(fp) - HEADER_SIZE) / RECORD_SIZE;
+        if ((unsigned long)size > last) {
+            fseek(fp, HEADER_SIZE + (long)(size - (long)last) * RECORD_SIZE, SEEK_SET);
+        } else {
+            fseek(fp, HEADER_SIZE, SEEK_SET);
+        }
+    }
+
+    while (fread(rec, 1, RECORD_SIZE, fp) == RECORD_SIZE) {
+        print_record(rec);
+    }
+
+    fclose(fp);
+    return 0;
+}
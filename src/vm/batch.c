@@ -0,0 +1,530 @@
+/**
+ * @file batch.c
+ * @brief CRISP-32 Virtual Machine - Parallel Batch Runner
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_vm.h"
+#include "c32_string.h"
+#include "c32_fork.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+/**
+ * @defgroup vm_batch Batch Runner
+ * @brief Runs many independent guests across a pool of host threads
+ *
+ * Every binary on the command line is run once per input set. A job is
+ * one (binary, input) pair and starts from a clean VM with R4 = input
+ * index and R5 = input count (the first two argument registers). Worker
+ * threads pull jobs from a shared counter in small chunks and run them
+ * in a private arena holding guest memory and a decoded instruction
+ * cache, so no guest state is shared between threads.
+ *
+ * With -b each binary is booted once, up to its first BREAK, and every
+ * job starts as a copy-on-write fork of that state instead of a fresh
+ * load. Jobs then skip the guest's initialization and only pay for the
+ * pages they write.
+ * @{
+ */
+
+/** @brief Default guest memory size per job (64KB) */
+#define BATCH_MEMORY_SIZE 65536
+
+/** @brief Default program load address */
+#define BATCH_LOAD_ADDR 0x1000
+
+/** @brief Default instruction budget per job */
+#define BATCH_MAX_STEPS 1000000
+
+/** @brief Decoded instruction cache entries per worker */
+#define BATCH_ICACHE_ENTRIES 4096
+
+/** @brief Jobs claimed from the shared counter at a time */
+#define BATCH_CHUNK 16
+
+/** @brief Upper bound on worker threads */
+#define BATCH_MAX_THREADS 256
+
+/**
+ * @brief Program image loaded once and shared read-only by all workers
+ */
+typedef struct {
+    const char *name;
+    uint8_t *data;
+    uint32_t size;
+} batch_image_t;
+
+/**
+ * @brief Outcome of one job
+ */
+typedef struct {
+    c32_exit_reason_t reason;
+    uint32_t steps;
+    uint32_t result;            /**< R2 (v0) at exit */
+} batch_result_t;
+
+/**
+ * @brief Batch configuration and shared scheduling state
+ */
+typedef struct {
+    batch_image_t *images;
+    uint32_t num_images;
+    uint32_t inputs;            /**< Input sets per image */
+    uint32_t num_jobs;
+    uint32_t memory_size;
+    uint32_t load_addr;
+    uint32_t max_steps;
+    batch_result_t *results;
+    c32_fork_base_t *bases;     /**< Booted state per image (-b), or NULL */
+
+    pthread_mutex_t lock;
+    uint32_t next_job;          /**< Next unclaimed job (guarded by lock) */
+} batch_t;
+
+/**
+ * @brief Per-thread arena: everything a worker needs to run a guest
+ */
+typedef struct {
+    batch_t *batch;
+    pthread_t thread;
+    uint8_t *memory;
+    c32_icache_entry_t *icache;
+    c32_vm_t clone;             /**< Forked guest (-b) */
+    uint32_t clone_image;       /**< Image index + 1 of clone, 0 if none */
+} batch_worker_t;
+
+/**
+ * @brief Read a whole file into a freshly allocated buffer
+ *
+ * @param image Image to fill
+ * @param filename Path to binary file
+ * @return 0 on success, -1 on failure
+ */
+static int load_image(batch_image_t *image, const char *filename) {
+    FILE *fp;
+    long size;
+
+    fp = fopen(filename, "rb");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
+        return -1;
+    }
+    if (fseek(fp, 0, SEEK_END) != 0 || (size = ftell(fp)) < 0 ||
+        fseek(fp, 0, SEEK_SET) != 0) {
+        fprintf(stderr, "Error: Cannot size file '%s'\n", filename);
+        fclose(fp);
+        return -1;
+    }
+
+    image->name = filename;
+    image->size = (uint32_t)size;
+    image->data = (uint8_t *)malloc(size ? (size_t)size : 1);
+    if (!image->data ||
+        fread(image->data, 1, (size_t)size, fp) != (size_t)size) {
+        fprintf(stderr, "Error: Failed to read file '%s'\n", filename);
+        fclose(fp);
+        return -1;
+    }
+
+    fclose(fp);
+    return 0;
+}
+
+/**
+ * @brief Boot an image up to its first BREAK and make it a fork base
+ *
+ * @param batch Batch configuration
+ * @param image Image to boot
+ * @param base Fork base to initialize
+ * @return 0 on success, -1 on failure
+ */
+static int boot_image(const batch_t *batch, const batch_image_t *image,
+                      c32_fork_base_t *base) {
+    c32_vm_t vm;
+    uint8_t *memory = (uint8_t *)calloc(batch->memory_size ? batch->memory_size : 1, 1);
+    c32_exit_reason_t reason;
+    int status = 0;
+
+    if (!memory) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return -1;
+    }
+    c32_vm_init(&vm, memory, batch->memory_size);
+    c32_memcpy(vm.memory + batch->load_addr, image->data, image->size);
+    vm.pc = batch->load_addr;
+    vm.running = 1;
+
+    reason = c32_vm_run_for(&vm, batch->max_steps, NULL);
+    if (reason != C32_EXIT_BREAK) {
+        fprintf(stderr, "Error: '%s' did not reach BREAK while booting (exit=%d)\n",
+                image->name, (int)reason);
+        status = -1;
+    } else {
+        /* Jobs resume just past the BREAK, as a debugger would, without
+         * its interrupt: the first EI in a job would otherwise take it */
+        c32_clear_interrupt(&vm, 5);
+        vm.running = 1;
+        if (c32_fork_base_init(base, &vm) != 0) {
+            fprintf(stderr, "Error: Cannot create fork base for '%s'\n", image->name);
+            status = -1;
+        }
+    }
+
+    free(memory);
+    return status;
+}
+
+/**
+ * @brief Take the next chunk of jobs
+ *
+ * @param batch Batch state
+ * @param first Receives the first job index of the chunk
+ * @return Number of jobs claimed (0 when the batch is exhausted)
+ */
+static uint32_t claim_jobs(batch_t *batch, uint32_t *first) {
+    uint32_t count;
+
+    pthread_mutex_lock(&batch->lock);
+    *first = batch->next_job;
+    count = batch->num_jobs - batch->next_job;
+    if (count > BATCH_CHUNK) {
+        count = BATCH_CHUNK;
+    }
+    batch->next_job += count;
+    pthread_mutex_unlock(&batch->lock);
+
+    return count;
+}
+
+/**
+ * @brief Run one job in a worker's arena
+ *
+ * @param worker Worker arena
+ * @param job Job index
+ */
+static void run_job(batch_worker_t *worker, uint32_t job) {
+    batch_t *batch = worker->batch;
+    const batch_image_t *image = &batch->images[job / batch->inputs];
+    batch_result_t *result = &batch->results[job];
+    uint32_t image_index = job / batch->inputs;
+    c32_vm_t vm;
+
+    if (batch->bases) {
+        const c32_fork_base_t *base = &batch->bases[image_index];
+        int forked;
+
+        /* Reuse the worker's clone when it already comes from this image */
+        if (worker->clone_image == image_index + 1) {
+            forked = c32_fork_reset(base, &worker->clone);
+        } else {
+            if (worker->clone_image) {
+                c32_fork_release(&batch->bases[worker->clone_image - 1], &worker->clone);
+            }
+            c32_vm_init(&worker->clone, NULL, 0);
+            c32_vm_set_icache(&worker->clone, worker->icache, BATCH_ICACHE_ENTRIES);
+            forked = c32_fork_clone(base, &worker->clone);
+        }
+        if (forked != 0) {
+            worker->clone_image = 0;
+            result->reason = C32_EXIT_FAULT;
+            result->steps = 0;
+            result->result = 0;
+            return;
+        }
+        worker->clone_image = image_index + 1;
+
+        worker->clone.regs[4] = job % batch->inputs;
+        worker->clone.regs[5] = batch->inputs;
+        result->reason = c32_vm_run_for(&worker->clone, batch->max_steps, &result->steps);
+        result->result = worker->clone.regs[2];
+        return;
+    }
+
+    /* Fresh guest: clear memory left over from the previous job */
+    c32_memset(worker->memory, 0, batch->memory_size);
+    c32_vm_init(&vm, worker->memory, batch->memory_size);
+    c32_vm_set_icache(&vm, worker->icache, BATCH_ICACHE_ENTRIES);
+    c32_memcpy(vm.memory + batch->load_addr, image->data, image->size);
+
+    vm.regs[4] = job % batch->inputs;
+    vm.regs[5] = batch->inputs;
+    vm.pc = batch->load_addr;
+    vm.running = 1;
+
+    result->reason = c32_vm_run_for(&vm, batch->max_steps, &result->steps);
+    result->result = vm.regs[2];
+}
+
+/**
+ * @brief Worker thread: run claimed jobs until none are left
+ *
+ * @param arg Worker arena
+ * @return NULL
+ */
+static void *worker_main(void *arg) {
+    batch_worker_t *worker = (batch_worker_t *)arg;
+    uint32_t first, count, i;
+
+    while ((count = claim_jobs(worker->batch, &first)) != 0) {
+        for (i = 0; i < count; i++) {
+            run_job(worker, first + i);
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * @brief Parse an unsigned command line value (decimal or 0x hex)
+ *
+ * @param text Argument text
+ * @param value Receives the parsed value
+ * @return 0 on success, -1 on failure
+ */
+static int parse_value(const char *text, uint32_t *value) {
+    char *end;
+    unsigned long v = strtoul(text, &end, 0);
+
+    if (*text == '\0' || *end != '\0') {
+        return -1;
+    }
+    *value = (uint32_t)v;
+    return 0;
+}
+
+/**
+ * @brief Print usage information
+ *
+ * @param program_name Name of the program
+ */
+static void print_usage(const char *program_name) {
+    printf("CRISP-32 Parallel Batch Runner\n");
+    printf("Usage: %s [options] <binary_file>...\n\n", program_name);
+    printf("Options:\n");
+    printf("  -j threads     Worker threads (default: online CPUs)\n");
+    printf("  -n inputs      Input sets per binary; job i gets R4 = i, R5 = inputs (default: 1)\n");
+    printf("  -m bytes       Guest memory per job (default: %d)\n", BATCH_MEMORY_SIZE);
+    printf("  -a address     Load address (default: 0x%x)\n", BATCH_LOAD_ADDR);
+    printf("  -s steps       Instruction budget per job (default: %d)\n", BATCH_MAX_STEPS);
+    printf("  -b             Boot each binary to its first BREAK once; fork every job from it\n");
+    printf("  -v             Print the result of every job\n\n");
+    printf("Examples:\n");
+    printf("  %s a.bin b.bin c.bin\n", program_name);
+    printf("  %s -j 8 -n 10000 kernel.bin\n", program_name);
+    printf("  %s -b -n 10000 -m 0x1000000 kernel.bin\n", program_name);
+}
+
+/**
+ * @brief Main entry point
+ *
+ * @param argc Argument count
+ * @param argv Argument vector
+ * @return 0 if every job halted normally, 1 otherwise
+ */
+int main(int argc, char **argv) {
+    static batch_worker_t workers[BATCH_MAX_THREADS];
+    batch_t batch;
+    uint32_t threads = 0, i;
+    uint32_t counts[C32_EXIT_ILLEGAL + 1];
+    double total_steps = 0.0;
+    struct timespec start, end;
+    double seconds;
+    int verbose = 0;
+    int boot = 0;
+    int argi;
+    int status = 0;
+
+    batch.inputs = 1;
+    batch.memory_size = BATCH_MEMORY_SIZE;
+    batch.load_addr = BATCH_LOAD_ADDR;
+    batch.max_steps = BATCH_MAX_STEPS;
+    batch.bases = NULL;
+
+    /* Parse options */
+    for (argi = 1; argi < argc && argv[argi][0] == '-'; argi++) {
+        const char *opt = argv[argi];
+        uint32_t *target = NULL;
+
+        if (opt[1] == 'v' && opt[2] == '\0') {
+            verbose = 1;
+            continue;
+        }
+        if (opt[1] == 'b' && opt[2] == '\0') {
+            boot = 1;
+            continue;
+        }
+        switch (opt[1]) {
+            case 'j': target = &threads; break;
+            case 'n': target = &batch.inputs; break;
+            case 'm': target = &batch.memory_size; break;
+            case 'a': target = &batch.load_addr; break;
+            case 's': target = &batch.max_steps; break;
+            default: break;
+        }
+        if (!target || opt[2] != '\0' || argi + 1 >= argc ||
+            parse_value(argv[argi + 1], target) != 0) {
+            print_usage(argv[0]);
+            return 1;
+        }
+        argi++;
+    }
+    if (argi >= argc || batch.inputs == 0 || batch.max_steps == 0) {
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    if (threads == 0) {
+        long online = sysconf(_SC_NPROCESSORS_ONLN);
+        threads = online > 0 ? (uint32_t)online : 1;
+    }
+    if (threads > BATCH_MAX_THREADS) {
+        threads = BATCH_MAX_THREADS;
+    }
+
+    /* Load every image once */
+    batch.num_images = (uint32_t)(argc - argi);
+    batch.images = (batch_image_t *)calloc(batch.num_images, sizeof(batch_image_t));
+    if (!batch.images) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+    for (i = 0; i < batch.num_images; i++) {
+        if (load_image(&batch.images[i], argv[argi + i]) != 0) {
+            return 1;
+        }
+        if (batch.load_addr > batch.memory_size ||
+            batch.images[i].size > batch.memory_size - batch.load_addr) {
+            fprintf(stderr, "Error: '%s' does not fit in guest memory\n",
+                    batch.images[i].name);
+            return 1;
+        }
+    }
+
+    if ((double)batch.num_images * (double)batch.inputs > 4294967295.0) {
+        fprintf(stderr, "Error: Too many jobs\n");
+        return 1;
+    }
+    batch.num_jobs = batch.num_images * batch.inputs;
+    batch.next_job = 0;
+    batch.results = (batch_result_t *)calloc(batch.num_jobs, sizeof(batch_result_t));
+    if (!batch.results) {
+        fprintf(stderr, "Error: Out of memory\n");
+        return 1;
+    }
+    if (threads > batch.num_jobs) {
+        threads = batch.num_jobs;
+    }
+    pthread_mutex_init(&batch.lock, NULL);
+
+    /* Boot once per image; jobs fork from the booted state */
+    if (boot) {
+        batch.bases = (c32_fork_base_t *)calloc(batch.num_images, sizeof(c32_fork_base_t));
+        if (!batch.bases) {
+            fprintf(stderr, "Error: Out of memory\n");
+            return 1;
+        }
+        for (i = 0; i < batch.num_images; i++) {
+            if (boot_image(&batch, &batch.images[i], &batch.bases[i]) != 0) {
+                return 1;
+            }
+        }
+    }
+
+    /* Per-thread arenas */
+    for (i = 0; i < threads; i++) {
+        workers[i].batch = &batch;
+        workers[i].clone_image = 0;
+        workers[i].memory = (uint8_t *)malloc(batch.memory_size ? batch.memory_size : 1);
+        workers[i].icache = (c32_icache_entry_t *)malloc(
+            BATCH_ICACHE_ENTRIES * sizeof(c32_icache_entry_t));
+        if (!workers[i].memory || !workers[i].icache) {
+            fprintf(stderr, "Error: Out of memory\n");
+            return 1;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    for (i = 0; i < threads; i++) {
+        if (pthread_create(&workers[i].thread, NULL, worker_main, &workers[i]) != 0) {
+            fprintf(stderr, "Error: Cannot start worker thread\n");
+            return 1;
+        }
+    }
+    for (i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    seconds = (double)(end.tv_sec - start.tv_sec) +
+              (double)(end.tv_nsec - start.tv_nsec) / 1e9;
+    if (seconds <= 0.0) {
+        seconds = 1e-9;
+    }
+
+    /* Collect results */
+    for (i = 0; i <= C32_EXIT_ILLEGAL; i++) {
+        counts[i] = 0;
+    }
+    for (i = 0; i < batch.num_jobs; i++) {
+        const batch_result_t *r = &batch.results[i];
+
+        counts[r->reason]++;
+        total_steps += r->steps;
+        if (r->reason != C32_EXIT_SYSCALL && r->reason != C32_EXIT_BREAK) {
+            status = 1;
+        }
+        if (verbose) {
+            printf("%s[%lu]: exit=%d steps=%lu R2=0x%08lx\n",
+                   batch.images[i / batch.inputs].name,
+                   (unsigned long)(i % batch.inputs), (int)r->reason,
+                   (unsigned long)r->steps, (unsigned long)r->result);
+        }
+    }
+
+    printf("Jobs:       %lu (%lu binaries x %lu inputs) on %lu threads\n",
+           (unsigned long)batch.num_jobs, (unsigned long)batch.num_images,
+           (unsigned long)batch.inputs, (unsigned long)threads);
+    printf("Exits:      %lu halted, %lu budget, %lu fault, %lu illegal\n",
+           (unsigned long)(counts[C32_EXIT_SYSCALL] + counts[C32_EXIT_BREAK]),
+           (unsigned long)counts[C32_EXIT_BUDGET],
+           (unsigned long)counts[C32_EXIT_FAULT],
+           (unsigned long)counts[C32_EXIT_ILLEGAL]);
+    printf("Time:       %.3f s\n", seconds);
+    printf("Throughput: %.0f programs/sec, %.1f MIPS\n",
+           (double)batch.num_jobs / seconds, total_steps / seconds / 1e6);
+
+    if (batch.bases) {
+        for (i = 0; i < threads; i++) {
+            if (workers[i].clone_image) {
+                c32_fork_release(&batch.bases[workers[i].clone_image - 1], &workers[i].clone);
+            }
+        }
+        for (i = 0; i < batch.num_images; i++) {
+            c32_fork_base_destroy(&batch.bases[i]);
+        }
+    }
+
+    pthread_mutex_destroy(&batch.lock);
+    return status;
+}
+
+/** @} */ /* end of vm_batch */
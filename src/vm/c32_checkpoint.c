@@ -0,0 +1,304 @@
+/**
+ * @file c32_checkpoint.c
+ * @brief CRISP-32 Incremental Checkpoints
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_checkpoint.h"
+#include "c32_string.h"
+
+/**
+ * @addtogroup checkpoint
+ * @{
+ */
+
+/* State record word indices: R0-R31 */
+#define STATE_REGS 0
+
+/* PC and machine state */
+#define STATE_PC 32
+#define STATE_RUNNING 33
+#define STATE_KERNEL_MODE 34
+#define STATE_PAGING 35
+#define STATE_PTBR 36
+#define STATE_NUM_PAGES 37
+
+/* Interrupt state (pending is 8 words) */
+#define STATE_INT_ENABLED 38
+#define STATE_INT_PENDING 39
+#define STATE_INT_SAVED_PC 47
+#define STATE_INT_SAVED_REGS 48
+
+/* Timer */
+#define STATE_TIMER_COUNT 49
+#define STATE_TIMER_PERIOD 50
+#define STATE_TIMER_IRQ 51
+
+/* Shadow register banks: 32 registers and the return PC per bank */
+#define STATE_SHADOW_COUNT 52
+#define STATE_SHADOW_DEPTH 53
+#define STATE_SHADOW_SPILLED 54
+#define STATE_SHADOW_BANKS 55
+#define SHADOW_WORDS 33
+
+/**
+ * @brief Bytes of guest memory in a page record
+ */
+static uint32_t page_bytes(const c32_vm_t *vm, uint32_t page) {
+    uint32_t start = page << C32_DIRTY_PAGE_SHIFT;
+    uint32_t left = vm->memory_size - start;
+
+    return left < C32_DIRTY_PAGE_SIZE ? left : (uint32_t)C32_DIRTY_PAGE_SIZE;
+}
+
+/**
+ * @brief Encode the architectural state record
+ */
+static void save_state(const c32_vm_t *vm, uint8_t *rec) {
+    uint32_t i, b;
+
+    for (i = 0; i < 32; i++) {
+        c32_write_word(rec + 4 * (STATE_REGS + i), vm->regs[i]);
+    }
+    c32_write_word(rec + 4 * STATE_PC, vm->pc);
+    c32_write_word(rec + 4 * STATE_RUNNING, (uint32_t)vm->running);
+    c32_write_word(rec + 4 * STATE_KERNEL_MODE, vm->kernel_mode);
+    c32_write_word(rec + 4 * STATE_PAGING, vm->paging_enabled);
+    c32_write_word(rec + 4 * STATE_PTBR, vm->page_table_base);
+    c32_write_word(rec + 4 * STATE_NUM_PAGES, vm->num_pages);
+    c32_write_word(rec + 4 * STATE_INT_ENABLED, vm->interrupts.enabled);
+    for (i = 0; i < 8; i++) {
+        c32_write_word(rec + 4 * (STATE_INT_PENDING + i), vm->interrupts.pending[i]);
+    }
+    c32_write_word(rec + 4 * STATE_INT_SAVED_PC, vm->interrupts.saved_pc);
+    c32_write_word(rec + 4 * STATE_INT_SAVED_REGS, vm->interrupts.saved_regs_addr);
+    c32_write_word(rec + 4 * STATE_TIMER_COUNT, vm->timer.count);
+    c32_write_word(rec + 4 * STATE_TIMER_PERIOD, vm->timer.period);
+    c32_write_word(rec + 4 * STATE_TIMER_IRQ, vm->timer.irq);
+    c32_write_word(rec + 4 * STATE_SHADOW_COUNT, vm->interrupts.shadow_count);
+    c32_write_word(rec + 4 * STATE_SHADOW_DEPTH, vm->interrupts.shadow_depth);
+    c32_write_word(rec + 4 * STATE_SHADOW_SPILLED, vm->interrupts.shadow_spilled);
+    for (b = 0; b < C32_SHADOW_BANKS; b++) {
+        uint8_t *bank = rec + 4 * (STATE_SHADOW_BANKS + b * SHADOW_WORDS);
+
+        for (i = 0; i < 32; i++) {
+            c32_write_word(bank + 4 * i, vm->interrupts.shadow[b].regs[i]);
+        }
+        c32_write_word(bank + 4 * 32, vm->interrupts.shadow[b].pc);
+    }
+}
+
+/**
+ * @brief Apply a decoded architectural state record
+ */
+static void load_state(c32_vm_t *vm, const uint8_t *rec) {
+    uint32_t i, b;
+
+    for (i = 0; i < 32; i++) {
+        vm->regs[i] = c32_read_word(rec + 4 * (STATE_REGS + i));
+    }
+    vm->regs[0] = 0;
+    vm->pc = c32_read_word(rec + 4 * STATE_PC);
+    vm->running = c32_read_word(rec + 4 * STATE_RUNNING) != 0;
+    vm->kernel_mode = c32_read_word(rec + 4 * STATE_KERNEL_MODE) != 0;
+    vm->paging_enabled = c32_read_word(rec + 4 * STATE_PAGING) != 0;
+    vm->page_table_base = c32_read_word(rec + 4 * STATE_PTBR);
+    vm->num_pages = c32_read_word(rec + 4 * STATE_NUM_PAGES);
+    vm->interrupts.enabled = c32_read_word(rec + 4 * STATE_INT_ENABLED) != 0;
+    vm->interrupts.pending_summary = 0;
+    for (i = 0; i < 8; i++) {
+        vm->interrupts.pending[i] = c32_read_word(rec + 4 * (STATE_INT_PENDING + i));
+        if (vm->interrupts.pending[i]) {
+            vm->interrupts.pending_summary |= (uint32_t)1 << i;
+        }
+    }
+    vm->interrupts.saved_pc = c32_read_word(rec + 4 * STATE_INT_SAVED_PC);
+    vm->interrupts.saved_regs_addr = c32_read_word(rec + 4 * STATE_INT_SAVED_REGS);
+    vm->timer.count = c32_read_word(rec + 4 * STATE_TIMER_COUNT);
+    vm->timer.period = c32_read_word(rec + 4 * STATE_TIMER_PERIOD);
+    vm->timer.irq = (uint8_t)c32_read_word(rec + 4 * STATE_TIMER_IRQ);
+    vm->interrupts.shadow_count = c32_read_word(rec + 4 * STATE_SHADOW_COUNT);
+    vm->interrupts.shadow_depth = c32_read_word(rec + 4 * STATE_SHADOW_DEPTH);
+    vm->interrupts.shadow_spilled = c32_read_word(rec + 4 * STATE_SHADOW_SPILLED);
+    for (b = 0; b < C32_SHADOW_BANKS; b++) {
+        const uint8_t *bank = rec + 4 * (STATE_SHADOW_BANKS + b * SHADOW_WORDS);
+
+        for (i = 0; i < 32; i++) {
+            vm->interrupts.shadow[b].regs[i] = c32_read_word(bank + 4 * i);
+        }
+        vm->interrupts.shadow[b].pc = c32_read_word(bank + 4 * 32);
+    }
+
+    /* Translations may describe a different page table */
+    c32_vm_tlb_flush(vm);
+}
+
+/**
+ * @brief Write one page record
+ */
+static int save_page(const c32_vm_t *vm, uint32_t page, c32_checkpoint_write_t write,
+                     void *ctx) {
+    uint8_t num[4];
+
+    c32_write_word(num, page);
+    if (write(ctx, num, 4) != 0) {
+        return -1;
+    }
+    return write(ctx, vm->memory + (page << C32_DIRTY_PAGE_SHIFT), page_bytes(vm, page));
+}
+
+/**
+ * @brief Write a checkpoint and clear the dirty map
+ *
+ * @param vm Pointer to VM structure
+ * @param full 1 for a full checkpoint, 0 for the dirty pages only
+ * @param write Output callback
+ * @param ctx Context pointer passed to write
+ * @param pages If non-NULL, receives the number of pages written
+ * @return 0 on success, -1 on output error or missing dirty map
+ */
+int c32_checkpoint_save(c32_vm_t *vm, int full, c32_checkpoint_write_t write, void *ctx,
+                        uint32_t *pages) {
+    uint8_t header[C32_CHECKPOINT_HEADER_SIZE];
+    uint8_t state[C32_CHECKPOINT_STATE_SIZE];
+    uint32_t num_pages = C32_DIRTY_PAGES(vm->memory_size);
+    uint32_t words = C32_DIRTY_MAP_WORDS(vm->memory_size);
+    uint32_t written = 0, page, w;
+    int status = -1;
+
+    if (pages) {
+        *pages = 0;
+    }
+    if (!full && !vm->dirty_map) {
+        return -1;
+    }
+
+    c32_memcpy(header, C32_CHECKPOINT_MAGIC, 8);
+    c32_write_word(header + 8, C32_CHECKPOINT_VERSION);
+    c32_write_word(header + 12, vm->memory_size);
+    c32_write_word(header + 16, full ? C32_CHECKPOINT_FULL : 0);
+    save_state(vm, state);
+    if (write(ctx, header, sizeof(header)) != 0 || write(ctx, state, sizeof(state)) != 0) {
+        goto out;
+    }
+
+    if (full) {
+        if (vm->dirty_map) {
+            c32_vm_dirty_collect(vm, NULL);
+        }
+        for (page = 0; page < num_pages; page++) {
+            if (save_page(vm, page, write, ctx) != 0) {
+                goto out;
+            }
+            written++;
+        }
+    } else {
+        /* Each word is cleared as it is taken; only set bits cost a copy */
+        for (w = 0; w < words; w++) {
+            uint32_t bits = vm->dirty_map[w];
+
+            vm->dirty_map[w] = 0;
+            for (; bits; bits &= bits - 1) {
+                uint32_t bit = 0;
+
+                while (!(bits & ((uint32_t)1 << bit))) {
+                    bit++;
+                }
+                if (save_page(vm, (w << 5) + bit, write, ctx) != 0) {
+                    goto out;
+                }
+                written++;
+            }
+        }
+    }
+
+    c32_write_word(header, C32_CHECKPOINT_END);
+    if (write(ctx, header, 4) == 0) {
+        status = 0;
+    }
+
+out:
+    if (status != 0 && vm->dirty_map && vm->memory_size) {
+        c32_vm_dirty_mark(vm, 0, vm->memory_size);
+    }
+    if (pages) {
+        *pages = written;
+    }
+    return status;
+}
+
+/**
+ * @brief Apply a checkpoint to a VM
+ *
+ * @param vm Pointer to VM structure
+ * @param read Input callback
+ * @param ctx Context pointer passed to read
+ * @param pages If non-NULL, receives the number of pages loaded
+ * @return 0 on success, -1 on bad or truncated input
+ */
+int c32_checkpoint_load(c32_vm_t *vm, c32_checkpoint_read_t read, void *ctx,
+                        uint32_t *pages) {
+    uint8_t header[C32_CHECKPOINT_HEADER_SIZE];
+    uint8_t state[C32_CHECKPOINT_STATE_SIZE];
+    uint32_t num_pages = C32_DIRTY_PAGES(vm->memory_size);
+    uint32_t loaded = 0;
+
+    if (pages) {
+        *pages = 0;
+    }
+    if (read(ctx, header, sizeof(header)) != 0 ||
+        c32_memcmp(header, C32_CHECKPOINT_MAGIC, 8) != 0 ||
+        c32_read_word(header + 8) != C32_CHECKPOINT_VERSION ||
+        c32_read_word(header + 12) != vm->memory_size ||
+        read(ctx, state, sizeof(state)) != 0 ||
+        c32_read_word(state + 4 * STATE_SHADOW_COUNT) > C32_SHADOW_BANKS ||
+        c32_read_word(state + 4 * STATE_SHADOW_DEPTH) >
+        c32_read_word(state + 4 * STATE_SHADOW_COUNT)) {
+        return -1;
+    }
+
+    for (;;) {
+        uint8_t num[4];
+        uint32_t page, size;
+
+        if (read(ctx, num, 4) != 0) {
+            return -1;
+        }
+        page = c32_read_word(num);
+        if (page == C32_CHECKPOINT_END) {
+            break;
+        }
+        if (page >= num_pages) {
+            return -1;
+        }
+        size = page_bytes(vm, page);
+        if (read(ctx, vm->memory + (page << C32_DIRTY_PAGE_SHIFT), size) != 0) {
+            return -1;
+        }
+        c32_vm_host_write(vm, page << C32_DIRTY_PAGE_SHIFT, size);
+        loaded++;
+        if (pages) {
+            *pages = loaded;
+        }
+    }
+
+    load_state(vm, state);
+    return 0;
+}
+
+/** @} */ /* end of checkpoint */
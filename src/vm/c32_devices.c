@@ -0,0 +1,279 @@
+/**
+ * @file c32_devices.c
+ * @brief CRISP-32 Host Console and Block Devices (POSIX hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_devices.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @addtogroup devices
+ * @{
+ */
+
+/**
+ * @brief Initialize a console
+ *
+ * @param con Console state
+ * @param in_fd Host descriptor for input
+ * @param out_fd Host descriptor for output
+ */
+void c32_console_init(c32_console_t *con, int in_fd, int out_fd) {
+    con->in_fd = in_fd;
+    con->out_fd = out_fd;
+    con->used = 0;
+}
+
+/**
+ * @brief Write buffered console output to the host
+ *
+ * Output the host refuses is dropped, as a real UART would.
+ *
+ * @param con Console state
+ */
+void c32_console_flush(c32_console_t *con) {
+    uint32_t done = 0;
+
+    while (done < con->used) {
+        ssize_t n = write(con->out_fd, con->out + done, con->used - done);
+
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        done += (uint32_t)n;
+    }
+    con->used = 0;
+}
+
+/**
+ * @brief Console register read
+ */
+static uint32_t console_read(c32_vm_t *vm, void *ctx, uint32_t offset, uint32_t width) {
+    c32_console_t *con = (c32_console_t *)ctx;
+    struct pollfd pfd;
+    unsigned char byte;
+    ssize_t n;
+
+    (void)vm;
+    (void)width;
+
+    switch (offset) {
+        case C32_CONSOLE_DATA:
+            /* A prompt must be visible before the guest waits for input */
+            c32_console_flush(con);
+            do {
+                n = read(con->in_fd, &byte, 1);
+            } while (n < 0 && errno == EINTR);
+            return n == 1 ? byte : C32_CONSOLE_EOF;
+        case C32_CONSOLE_STATUS:
+            pfd.fd = con->in_fd;
+            pfd.events = POLLIN;
+            pfd.revents = 0;
+            return poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLIN | POLLHUP)) ? 1 : 0;
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief Console register write
+ */
+static void console_write(c32_vm_t *vm, void *ctx, uint32_t offset, uint32_t width,
+                          uint32_t value) {
+    c32_console_t *con = (c32_console_t *)ctx;
+
+    (void)vm;
+    (void)width;
+
+    if (offset != C32_CONSOLE_DATA) {
+        return;
+    }
+    con->out[con->used++] = (uint8_t)value;
+    if ((uint8_t)value == '\n' || con->used == C32_CONSOLE_BUFFER) {
+        c32_console_flush(con);
+    }
+}
+
+/**
+ * @brief Describe a console as an MMIO device
+ *
+ * @param dev Device entry to fill in
+ * @param base Physical base address
+ * @param con Console state
+ */
+void c32_console_device(c32_device_t *dev, uint32_t base, c32_console_t *con) {
+    dev->base = base;
+    dev->size = C32_CONSOLE_SIZE;
+    dev->read = console_read;
+    dev->write = console_write;
+    dev->ctx = con;
+}
+
+/**
+ * @brief Open a disk image
+ *
+ * @param blk Block device state
+ * @param filename Disk image
+ * @param writable 1 to allow C32_BLOCKDEV_CMD_WRITE
+ * @return 0 on success, -1 on host error
+ */
+int c32_blockdev_open(c32_blockdev_t *blk, const char *filename, int writable) {
+    struct stat st;
+    off_t sectors;
+
+    blk->fd = open(filename, writable ? O_RDWR : O_RDONLY);
+    if (blk->fd < 0) {
+        return -1;
+    }
+    if (fstat(blk->fd, &st) != 0) {
+        close(blk->fd);
+        blk->fd = -1;
+        return -1;
+    }
+
+    sectors = st.st_size / C32_BLOCKDEV_SECTOR_SIZE;
+    blk->capacity = sectors > 0xFFFFFFFF ? 0xFFFFFFFF : (uint32_t)sectors;
+    blk->writable = writable;
+    blk->sector = 0;
+    blk->buffer = 0;
+    blk->count = 0;
+    blk->status = C32_BLOCKDEV_OK;
+    return 0;
+}
+
+/**
+ * @brief Close a disk image
+ *
+ * @param blk Block device state
+ */
+void c32_blockdev_close(c32_blockdev_t *blk) {
+    if (blk->fd >= 0) {
+        close(blk->fd);
+        blk->fd = -1;
+    }
+}
+
+/**
+ * @brief Run a transfer between the disk and guest memory
+ *
+ * The whole range is checked against the disk and RAM first, so a
+ * failed command moves nothing unless the host itself fails part way.
+ *
+ * @return C32_BLOCKDEV_OK or C32_BLOCKDEV_ERROR
+ */
+static uint32_t blockdev_transfer(c32_vm_t *vm, c32_blockdev_t *blk, uint32_t command) {
+    uint32_t bytes, done = 0;
+    off_t pos;
+
+    if ((command != C32_BLOCKDEV_CMD_READ && command != C32_BLOCKDEV_CMD_WRITE) ||
+        (command == C32_BLOCKDEV_CMD_WRITE && !blk->writable)) {
+        return C32_BLOCKDEV_ERROR;
+    }
+    if (blk->sector > blk->capacity || blk->count > blk->capacity - blk->sector ||
+        blk->buffer > vm->memory_size ||
+        blk->count > (vm->memory_size - blk->buffer) / C32_BLOCKDEV_SECTOR_SIZE) {
+        return C32_BLOCKDEV_ERROR;
+    }
+
+    bytes = blk->count * C32_BLOCKDEV_SECTOR_SIZE;
+    pos = (off_t)blk->sector * C32_BLOCKDEV_SECTOR_SIZE;
+    while (done < bytes) {
+        ssize_t n;
+
+        if (command == C32_BLOCKDEV_CMD_READ) {
+            n = pread(blk->fd, vm->memory + blk->buffer + done, bytes - done, pos + done);
+        } else {
+            n = pwrite(blk->fd, vm->memory + blk->buffer + done, bytes - done, pos + done);
+        }
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            break;
+        }
+        done += (uint32_t)n;
+    }
+
+    if (command == C32_BLOCKDEV_CMD_READ) {
+        c32_vm_host_write(vm, blk->buffer, done);
+    }
+    return done == bytes ? C32_BLOCKDEV_OK : C32_BLOCKDEV_ERROR;
+}
+
+/**
+ * @brief Block device register read
+ */
+static uint32_t blockdev_read(c32_vm_t *vm, void *ctx, uint32_t offset, uint32_t width) {
+    c32_blockdev_t *blk = (c32_blockdev_t *)ctx;
+
+    (void)vm;
+    (void)width;
+
+    switch (offset) {
+        case C32_BLOCKDEV_SECTOR: return blk->sector;
+        case C32_BLOCKDEV_BUFFER: return blk->buffer;
+        case C32_BLOCKDEV_COUNT: return blk->count;
+        case C32_BLOCKDEV_STATUS: return blk->status;
+        case C32_BLOCKDEV_CAPACITY: return blk->capacity;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Block device register write; a COMMAND write is the doorbell
+ */
+static void blockdev_write(c32_vm_t *vm, void *ctx, uint32_t offset, uint32_t width,
+                           uint32_t value) {
+    c32_blockdev_t *blk = (c32_blockdev_t *)ctx;
+
+    (void)width;
+
+    switch (offset) {
+        case C32_BLOCKDEV_SECTOR: blk->sector = value; break;
+        case C32_BLOCKDEV_BUFFER: blk->buffer = value; break;
+        case C32_BLOCKDEV_COUNT: blk->count = value; break;
+        case C32_BLOCKDEV_COMMAND: blk->status = blockdev_transfer(vm, blk, value); break;
+        default: break;
+    }
+}
+
+/**
+ * @brief Describe a block device as an MMIO device
+ *
+ * @param dev Device entry to fill in
+ * @param base Physical base address
+ * @param blk Block device state
+ */
+void c32_blockdev_device(c32_device_t *dev, uint32_t base, c32_blockdev_t *blk) {
+    dev->base = base;
+    dev->size = C32_BLOCKDEV_SIZE;
+    dev->read = blockdev_read;
+    dev->write = blockdev_write;
+    dev->ctx = blk;
+}
+
+/** @} */ /* end of devices */
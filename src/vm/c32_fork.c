@@ -0,0 +1,145 @@
+/**
+ * @file c32_fork.c
+ * @brief CRISP-32 Copy-on-Write VM Fork (POSIX hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_fork.h"
+
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @addtogroup fork
+ * @{
+ */
+
+/**
+ * @brief Snapshot a VM into a fork base
+ *
+ * The image is written through a shared mapping of an unlinked
+ * temporary file, which is then made read-only.
+ *
+ * @param base Fork base to initialize
+ * @param vm VM to capture
+ * @return 0 on success, -1 on host error
+ */
+int c32_fork_base_init(c32_fork_base_t *base, const c32_vm_t *vm) {
+    char path[] = "/tmp/c32forkXXXXXX";
+    long page = sysconf(_SC_PAGESIZE);
+    void *image;
+
+    if (page <= 0) {
+        page = 4096;
+    }
+    base->map_size = ((unsigned long)vm->memory_size + (unsigned long)page - 1) &
+                     ~((unsigned long)page - 1);
+    if (base->map_size == 0) {
+        base->map_size = (unsigned long)page;
+    }
+
+    base->fd = mkstemp(path);
+    if (base->fd < 0) {
+        return -1;
+    }
+    unlink(path);
+    if (ftruncate(base->fd, (off_t)base->map_size) != 0) {
+        close(base->fd);
+        return -1;
+    }
+
+    image = mmap(NULL, base->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, base->fd, 0);
+    if (image == MAP_FAILED) {
+        close(base->fd);
+        return -1;
+    }
+    c32_vm_snapshot(vm, &base->snap, (uint8_t *)image, (uint32_t)vm->memory_size);
+
+    /* Clones must only ever see the image as it was captured */
+    mprotect(image, base->map_size, PROT_READ);
+    return 0;
+}
+
+/**
+ * @brief Release a fork base
+ *
+ * @param base Fork base
+ */
+void c32_fork_base_destroy(c32_fork_base_t *base) {
+    munmap(base->snap.image, base->map_size);
+    close(base->fd);
+    base->snap.image = NULL;
+    base->fd = -1;
+}
+
+/**
+ * @brief Create a copy-on-write clone
+ *
+ * @param base Fork base
+ * @param vm VM to turn into a clone
+ * @return 0 on success, -1 on host error
+ */
+int c32_fork_clone(const c32_fork_base_t *base, c32_vm_t *vm) {
+    void *memory = mmap(NULL, base->map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+                        base->fd, 0);
+
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    c32_vm_restore_state(vm, &base->snap, (uint8_t *)memory);
+    return 0;
+}
+
+/**
+ * @brief Return a clone to the base state, dropping its private pages
+ *
+ * Maps the file again at the same address; the kernel throws away the
+ * pages the clone had copied.
+ *
+ * @param base Fork base the clone was created from
+ * @param vm Clone
+ * @return 0 on success, -1 on host error
+ */
+int c32_fork_reset(const c32_fork_base_t *base, c32_vm_t *vm) {
+    void *memory = mmap(vm->memory, base->map_size, PROT_READ | PROT_WRITE,
+                        MAP_PRIVATE | MAP_FIXED, base->fd, 0);
+
+    if (memory == MAP_FAILED) {
+        return -1;
+    }
+    c32_vm_restore_state(vm, &base->snap, (uint8_t *)memory);
+    return 0;
+}
+
+/**
+ * @brief Unmap a clone's memory
+ *
+ * @param base Fork base the clone was created from
+ * @param vm Clone (left halted with no memory)
+ */
+void c32_fork_release(const c32_fork_base_t *base, c32_vm_t *vm) {
+    if (vm->memory) {
+        munmap(vm->memory, base->map_size);
+    }
+    vm->memory = NULL;
+    vm->memory_size = 0;
+    vm->running = 0;
+}
+
+/** @} */ /* end of fork */
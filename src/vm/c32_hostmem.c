@@ -0,0 +1,161 @@
+/**
+ * @file c32_hostmem.c
+ * @brief CRISP-32 Host Guest-Memory Allocation (POSIX hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_hostmem.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* Not every host names the lazy-commit flags */
+#ifndef MAP_NORESERVE
+#define MAP_NORESERVE 0
+#endif
+#if !defined(MAP_ANONYMOUS) && defined(MAP_ANON)
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+/**
+ * @addtogroup hostmem
+ * @{
+ */
+
+/**
+ * @brief Host page size
+ *
+ * @return Page size in bytes
+ */
+static unsigned long host_page_size(void) {
+    long page = sysconf(_SC_PAGESIZE);
+
+    return page > 0 ? (unsigned long)page : 4096;
+}
+
+/**
+ * @brief Reserve zero-filled guest memory
+ *
+ * Anonymous private mappings are committed a page at a time on first
+ * touch; MAP_NORESERVE also keeps the reservation out of the host's
+ * swap accounting.
+ *
+ * @param size Guest memory size in bytes (1 to C32_HOSTMEM_MAX_SIZE)
+ * @return Base of the reservation, or NULL on host error
+ */
+uint8_t *c32_hostmem_reserve(uint32_t size) {
+    void *memory;
+
+    if (size == 0 || size > C32_HOSTMEM_MAX_SIZE) {
+        return NULL;
+    }
+
+    memory = mmap(NULL, size, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    return memory == MAP_FAILED ? NULL : (uint8_t *)memory;
+}
+
+/**
+ * @brief Release memory from c32_hostmem_reserve()
+ *
+ * @param memory Base of the reservation
+ * @param size Size passed to c32_hostmem_reserve()
+ */
+void c32_hostmem_release(uint8_t *memory, uint32_t size) {
+    if (memory) {
+        munmap(memory, size);
+    }
+}
+
+/**
+ * @brief Read a file into memory
+ *
+ * @param fd Open file, positioned at the start
+ * @param dest Destination
+ * @param size Bytes to read
+ * @return 0 on success, -1 on error
+ */
+static int read_image(int fd, uint8_t *dest, uint32_t size) {
+    while (size > 0) {
+        ssize_t got = read(fd, dest, size);
+
+        if (got <= 0) {
+            return -1;
+        }
+        dest += got;
+        size -= (uint32_t)got;
+    }
+    return 0;
+}
+
+/**
+ * @brief Load a program image file into reserved guest memory
+ *
+ * The private file mapping replaces the anonymous pages it covers; the
+ * zero-filled tail of its last page matches what a read would leave.
+ *
+ * @param memory Base of the reservation
+ * @param memory_size Guest memory size
+ * @param load_addr Guest physical address of the first image byte
+ * @param filename Image file
+ * @param loaded Receives the number of image bytes placed in memory
+ * @return 1 if mapped, 0 if read, -1 on host error or bad load address
+ */
+int c32_hostmem_load_image(uint8_t *memory, uint32_t memory_size, uint32_t load_addr,
+                           const char *filename, uint32_t *loaded) {
+    struct stat st;
+    uint32_t size;
+    int fd;
+    int mapped = 0;
+
+    *loaded = 0;
+    if (load_addr >= memory_size) {
+        return -1;
+    }
+
+    fd = open(filename, O_RDONLY);
+    if (fd < 0) {
+        return -1;
+    }
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    size = memory_size - load_addr;
+    if ((unsigned long)st.st_size < size) {
+        size = (uint32_t)st.st_size;
+    }
+
+    if (size > 0 && load_addr % host_page_size() == 0 &&
+        mmap(memory + load_addr, size, PROT_READ | PROT_WRITE,
+             MAP_PRIVATE | MAP_FIXED, fd, 0) != MAP_FAILED) {
+        mapped = 1;
+    } else if (read_image(fd, memory + load_addr, size) != 0) {
+        close(fd);
+        return -1;
+    }
+
+    close(fd);
+    *loaded = size;
+    return mapped;
+}
+
+/** @} */ /* end of hostmem */
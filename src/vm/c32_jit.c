@@ -0,0 +1,1826 @@
+/**
+ * @file c32_jit.c
+ * @brief CRISP-32 Dynamic Binary Translator (x86-64 and AArch64 hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_jit.h"
+#include "c32_opcodes.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#if defined(__x86_64__) || defined(__aarch64__)
+/** @brief Defined when this host has a code generator */
+#define JIT_CODEGEN
+#endif
+
+#ifdef JIT_CODEGEN
+
+#include <sys/mman.h>
+
+/**
+ * @defgroup jit_codegen Code Generation
+ * @brief Contract between the block manager and the host code generators
+ *
+ * Every block starts with a budget check that leaves through a stub if
+ * fewer instructions remain than the block holds, so blocks are atomic
+ * with respect to the budget and may chain into each other freely.
+ * Translated instructions never change interrupt, privilege, or paging
+ * state, so the dispatcher's checks before entering the first block stay
+ * valid for the whole chain.
+ *
+ * Each generator provides JIT_BLOCK_RESERVE, emit_stubs(),
+ * emit_block_entry(), emit_insn(), emit_terminator(), emit_chain_exit(),
+ * patch_chain(), reset_chain() and sync_code().
+ * @{
+ */
+
+/** @brief Exit code: indirect jump or unchained exit, resume at vm->pc */
+#define JIT_EXIT_NONE   0xFFFFFFFF
+
+/** @brief Exit code: budget too small for the block at vm->pc */
+#define JIT_EXIT_BUDGET 0xFFFFFFFE
+
+/** @brief Exit code: store hit a watched granule, address in exit info */
+#define JIT_EXIT_SMC    0xFFFFFFFD
+
+/** @brief Exit code: load or store at vm->pc missed RAM, interpret it */
+#define JIT_EXIT_MMIO   0xFFFFFFFC
+
+/**
+ * @brief Information passed back from translated code
+ */
+typedef struct {
+    /** Remaining budget on exit */
+    uint32_t remaining;
+
+    /** Physical address of the store that caused JIT_EXIT_SMC */
+    uint32_t smc_addr;
+} jit_exit_info_t;
+
+/**
+ * @brief Signature of the generated entry trampoline
+ */
+typedef uint32_t (*jit_entry_fn)(c32_vm_t *vm, const uint8_t *code, uint8_t *memory,
+                                 uint8_t *watch, jit_exit_info_t *info);
+
+/**
+ * @brief Output cursor for code emission
+ */
+typedef struct {
+    uint8_t *p;
+} emit_t;
+
+/**
+ * @brief Classify an instruction for translation
+ *
+ * @return 0 = interpret, 1 = translate, 2 = translate and end block
+ */
+static int jit_classify(uint8_t opcode, uint8_t rs, uint8_t rt, uint8_t rd) {
+    if (rs >= 32 || rt >= 32 || rd >= 32) {
+        return 0;
+    }
+
+    switch (opcode) {
+        case OP_NOP:
+        case OP_ADD: case OP_ADDU: case OP_SUB: case OP_SUBU:
+        case OP_ADDI: case OP_ADDIU:
+        case OP_AND: case OP_OR: case OP_XOR: case OP_NOR:
+        case OP_ANDI: case OP_ORI: case OP_XORI: case OP_LUI:
+        case OP_SLL: case OP_SRL: case OP_SRA:
+        case OP_SLLV: case OP_SRLV: case OP_SRAV:
+        case OP_SLT: case OP_SLTU: case OP_SLTI: case OP_SLTIU:
+        case OP_MUL:
+        case OP_DIV: case OP_DIVU: case OP_REM: case OP_REMU:
+        case OP_LW: case OP_LH: case OP_LHU: case OP_LB: case OP_LBU:
+        case OP_SW: case OP_SH: case OP_SB:
+            return 1;
+        case OP_BEQ: case OP_BNE: case OP_BLEZ: case OP_BGTZ:
+        case OP_BLTZ: case OP_BGEZ:
+        case OP_J: case OP_JAL: case OP_JR: case OP_JALR:
+            return 2;
+        default:
+            /* MULH/MULHU, system, interrupt, and MMU instructions */
+            return 0;
+    }
+}
+
+/** @} */ /* end of jit_codegen */
+
+#endif /* JIT_CODEGEN */
+
+#if defined(__x86_64__)
+
+/**
+ * @defgroup jit_x86 x86-64 Code Generator
+ * @brief Translation of guest blocks to x86-64 machine code
+ *
+ * Register assignment inside translated code:
+ * - rbx: c32_vm_t pointer (guest registers live in vm->regs)
+ * - r12: guest memory base
+ * - r14d: remaining instruction budget
+ * - r15: watch map base
+ * - r13: dirty page bitmap (vm->dirty_map, loaded on entry)
+ * - rbp: exit information (remaining budget, SMC store address)
+ * - eax, ecx, edx: scratch
+ * @{
+ */
+
+/** @brief Worst-case host bytes for one block, checked before translating */
+#define JIT_BLOCK_RESERVE (C32_JIT_MAX_BLOCK_INSNS * 160 + 256)
+
+/** @brief Host scratch registers */
+#define EAX 0
+#define ECX 1
+#define EDX 2
+
+static void e8(emit_t *e, uint32_t byte) {
+    *e->p++ = (uint8_t)byte;
+}
+
+static void e32(emit_t *e, uint32_t value) {
+    e8(e, value);
+    e8(e, value >> 8);
+    e8(e, value >> 16);
+    e8(e, value >> 24);
+}
+
+/**
+ * @brief Emit a rel32 displacement to an absolute host address
+ */
+static void emit_rel32(emit_t *e, const uint8_t *target) {
+    e32(e, (uint32_t)(target - (e->p + 4)));
+}
+
+/**
+ * @brief Point a previously emitted rel32 at an absolute host address
+ */
+static void patch_rel32(uint8_t *site, const uint8_t *target) {
+    uint32_t rel = (uint32_t)(target - (site + 4));
+    site[0] = (uint8_t)rel;
+    site[1] = (uint8_t)(rel >> 8);
+    site[2] = (uint8_t)(rel >> 16);
+    site[3] = (uint8_t)(rel >> 24);
+}
+
+/**
+ * @brief Point a chain exit's jump at an absolute host address
+ */
+static void patch_chain(uint8_t *site, const uint8_t *target) {
+    patch_rel32(site, target);
+}
+
+/**
+ * @brief Reset a chain exit's jump to its unchained path
+ */
+static void reset_chain(uint8_t *site) {
+    patch_rel32(site, site + 4);
+}
+
+/**
+ * @brief Make freshly written code visible to instruction fetch
+ *
+ * Nothing to do: x86 keeps instruction fetch coherent with stores.
+ */
+static void sync_code(uint8_t *start, uint8_t *end) {
+    (void)start;
+    (void)end;
+}
+
+/**
+ * @brief Point a previously emitted rel8 at the current position
+ */
+static void patch_rel8(emit_t *e, uint8_t *site) {
+    *site = (uint8_t)(e->p - (site + 1));
+}
+
+/**
+ * @brief Emit a [rbx + guest register] memory operand for opcode byte op
+ */
+static void emit_reg_operand(emit_t *e, uint32_t op, uint32_t host, uint32_t guest) {
+    uint32_t disp = (uint32_t)offsetof(c32_vm_t, regs) + guest * 4;
+
+    e8(e, op);
+    if (disp < 128) {
+        e8(e, 0x43 | (host << 3));
+        e8(e, disp);
+    } else {
+        e8(e, 0x83 | (host << 3));
+        e32(e, disp);
+    }
+}
+
+/** @brief mov host, regs[guest] */
+static void emit_load_reg(emit_t *e, uint32_t host, uint32_t guest) {
+    emit_reg_operand(e, 0x8B, host, guest);
+}
+
+/** @brief mov regs[guest], host */
+static void emit_store_reg(emit_t *e, uint32_t guest, uint32_t host) {
+    emit_reg_operand(e, 0x89, host, guest);
+}
+
+/** @brief mov dword regs[guest], imm32 */
+static void emit_store_imm(emit_t *e, uint32_t guest, uint32_t imm) {
+    emit_reg_operand(e, 0xC7, 0, guest);
+    e32(e, imm);
+}
+
+/** @brief mov host, imm32 */
+static void emit_mov_imm(emit_t *e, uint32_t host, uint32_t imm) {
+    e8(e, 0xB8 + host);
+    e32(e, imm);
+}
+
+/** @brief movzx eax, al after a setcc */
+static void emit_setcc_eax(emit_t *e, uint32_t cc) {
+    e8(e, 0x0F);
+    e8(e, 0x90 | cc);
+    e8(e, 0xC0);
+    e8(e, 0x0F);
+    e8(e, 0xB6);
+    e8(e, 0xC0);
+}
+
+/**
+ * @brief Emit a jump to the shared exit stub with eax = pc, edx = code
+ */
+static void emit_exit(c32_jit_t *jit, emit_t *e, uint32_t pc, uint32_t code) {
+    emit_mov_imm(e, EAX, pc);
+    emit_mov_imm(e, EDX, code);
+    e8(e, 0xE9);
+    emit_rel32(e, jit->exit_stub);
+}
+
+/**
+ * @brief Emit a chainable exit to a constant guest PC
+ *
+ * Layout: `jmp rel32` (initially to the next instruction), then the
+ * unchained exit. Chaining rewrites the rel32 to the target block.
+ */
+static void emit_chain_exit(c32_jit_t *jit, emit_t *e, uint32_t target) {
+    uint32_t slot;
+
+    if (jit->num_slots >= C32_JIT_MAX_SLOTS) {
+        emit_exit(jit, e, target, JIT_EXIT_NONE);
+        return;
+    }
+
+    slot = jit->num_slots++;
+    e8(e, 0xE9);
+    jit->slots[slot].site = e->p;
+    jit->slots[slot].target = target;
+    e32(e, 0);
+    emit_exit(jit, e, target, slot);
+}
+
+/**
+ * @brief Emit eax = regs[rs] + imm
+ */
+static void emit_address(emit_t *e, uint32_t rs, uint32_t imm) {
+    emit_load_reg(e, EAX, rs);
+    if (imm != 0) {
+        e8(e, 0x05);            /* add eax, imm32 */
+        e32(e, imm);
+    }
+}
+
+/**
+ * @brief Emit an exit that hands the memory access at pc to the interpreter
+ *
+ * The access and the refund instructions after it have not run, so all
+ * of them go back to the budget.
+ */
+static void emit_mmio_exit(c32_jit_t *jit, emit_t *e, uint32_t pc, uint32_t refund) {
+    e8(e, 0x41);                /* add r14d, refund + 1 */
+    e8(e, 0x81);
+    e8(e, 0xC6);
+    e32(e, refund + 1);
+    emit_exit(jit, e, pc, JIT_EXIT_MMIO);
+}
+
+/**
+ * @brief Emit a bounds check that leaves the block if eax + size > memory_size
+ *
+ * Accesses outside RAM may target a device, so they are interpreted.
+ */
+static void emit_bounds_check(c32_jit_t *jit, emit_t *e, uint32_t memory_size,
+                              uint32_t size, uint32_t pc, uint32_t refund) {
+    uint8_t *in_range;
+
+    e8(e, 0x3D);                /* cmp eax, memory_size - size */
+    e32(e, memory_size - size);
+    e8(e, 0x76);                /* jbe in_range */
+    in_range = e->p;
+    e8(e, 0);
+    emit_mmio_exit(jit, e, pc, refund);
+    patch_rel8(e, in_range);
+}
+
+/**
+ * @brief Emit the watch map test for one granule index in edx
+ *
+ * @return Address of the rel32 to patch to the SMC exit
+ */
+static uint8_t *emit_watch_test(emit_t *e) {
+    uint8_t *site;
+
+    e8(e, 0xC1);                /* shr edx, shift */
+    e8(e, 0xEA);
+    e8(e, C32_JIT_WATCH_SHIFT);
+    e8(e, 0x41);                /* cmp byte [r15 + rdx], 0 */
+    e8(e, 0x80);
+    e8(e, 0x3C);
+    e8(e, 0x17);
+    e8(e, 0x00);
+    e8(e, 0x0F);                /* jne smc */
+    e8(e, 0x85);
+    site = e->p;
+    e32(e, 0);
+    return site;
+}
+
+/**
+ * @brief Emit the dirty bit update for the page of eax + offset
+ */
+static void emit_dirty_mark(emit_t *e, uint32_t offset) {
+    if (offset == 0) {
+        e8(e, 0x89);            /* mov edx, eax */
+        e8(e, 0xC2);
+    } else {
+        e8(e, 0x8D);            /* lea edx, [rax + offset] */
+        e8(e, 0x50);
+        e8(e, offset);
+    }
+    e8(e, 0xC1);                /* shr edx, C32_DIRTY_PAGE_SHIFT */
+    e8(e, 0xEA);
+    e8(e, C32_DIRTY_PAGE_SHIFT);
+    e8(e, 0x41);                /* bts dword [r13], edx */
+    e8(e, 0x0F);
+    e8(e, 0xAB);
+    e8(e, 0x55);
+    e8(e, 0x00);
+}
+
+/**
+ * @brief Emit a division or remainder
+ *
+ * Matches the interpreter: division by zero yields 0. The signed
+ * INT_MIN / -1 case, which traps on x86, wraps instead.
+ */
+static void emit_divide(emit_t *e, uint8_t opcode, uint32_t rd, uint32_t rs, uint32_t rt) {
+    uint32_t result = (opcode == OP_DIV || opcode == OP_DIVU) ? EAX : EDX;
+    uint8_t *to_zero, *to_normal = NULL, *done1, *done2 = NULL;
+
+    emit_load_reg(e, EAX, rs);
+    emit_load_reg(e, ECX, rt);
+    e8(e, 0x85);                /* test ecx, ecx */
+    e8(e, 0xC9);
+    e8(e, 0x74);                /* jz zero */
+    to_zero = e->p;
+    e8(e, 0);
+
+    if (opcode == OP_DIV || opcode == OP_REM) {
+        e8(e, 0x83);            /* cmp ecx, -1 */
+        e8(e, 0xF9);
+        e8(e, 0xFF);
+        e8(e, 0x75);            /* jne normal */
+        to_normal = e->p;
+        e8(e, 0);
+        if (opcode == OP_DIV) {
+            e8(e, 0xF7);        /* neg eax */
+            e8(e, 0xD8);
+        } else {
+            e8(e, 0x31);        /* xor edx, edx */
+            e8(e, 0xD2);
+        }
+        e8(e, 0xEB);            /* jmp done */
+        done2 = e->p;
+        e8(e, 0);
+        patch_rel8(e, to_normal);
+        e8(e, 0x99);            /* cdq */
+        e8(e, 0xF7);            /* idiv ecx */
+        e8(e, 0xF9);
+    } else {
+        e8(e, 0x31);            /* xor edx, edx */
+        e8(e, 0xD2);
+        e8(e, 0xF7);            /* div ecx */
+        e8(e, 0xF1);
+    }
+    e8(e, 0xEB);                /* jmp done */
+    done1 = e->p;
+    e8(e, 0);
+
+    patch_rel8(e, to_zero);
+    e8(e, 0x31);                /* xor result, result */
+    e8(e, 0xC0 | (result << 3) | result);
+
+    patch_rel8(e, done1);
+    if (done2) {
+        patch_rel8(e, done2);
+    }
+    emit_store_reg(e, rd, result);
+}
+
+/**
+ * @brief Emit a non-terminating instruction
+ *
+ * @param jit Pointer to JIT state
+ * @param e Output cursor
+ * @param pc Guest address of the instruction
+ * @param inst Instruction bytes
+ * @param refund Instructions after this one in the block (returned to
+ *               the budget if a store leaves the block early)
+ */
+static void emit_insn(c32_jit_t *jit, emit_t *e, uint32_t pc, const uint8_t *inst,
+                      uint32_t refund) {
+    uint8_t opcode = inst[0];
+    uint32_t rs = inst[1], rt = inst[2], rd = inst[3];
+    uint32_t imm = (uint32_t)inst[4] | ((uint32_t)inst[5] << 8) |
+                   ((uint32_t)inst[6] << 16) | ((uint32_t)inst[7] << 24);
+    uint32_t memory_size = jit->vm->memory_size;
+    uint32_t size;
+
+    switch (opcode) {
+        /* Register-register ALU: eax = regs[rs] op regs[rt] */
+        case OP_ADD: case OP_ADDU: case OP_SUB: case OP_SUBU:
+        case OP_AND: case OP_OR: case OP_XOR: case OP_NOR:
+        case OP_SLT: case OP_SLTU: case OP_MUL: {
+            if (rd == 0) {
+                return;
+            }
+            emit_load_reg(e, EAX, rs);
+            emit_load_reg(e, ECX, rt);
+            switch (opcode) {
+                case OP_ADD: case OP_ADDU: e8(e, 0x01); e8(e, 0xC8); break;
+                case OP_SUB: case OP_SUBU: e8(e, 0x29); e8(e, 0xC8); break;
+                case OP_AND: e8(e, 0x21); e8(e, 0xC8); break;
+                case OP_OR: e8(e, 0x09); e8(e, 0xC8); break;
+                case OP_XOR: e8(e, 0x31); e8(e, 0xC8); break;
+                case OP_NOR:
+                    e8(e, 0x09); e8(e, 0xC8);   /* or eax, ecx */
+                    e8(e, 0xF7); e8(e, 0xD0);   /* not eax */
+                    break;
+                case OP_SLT:
+                    e8(e, 0x39); e8(e, 0xC8);   /* cmp eax, ecx */
+                    emit_setcc_eax(e, 0xC);      /* setl */
+                    break;
+                case OP_SLTU:
+                    e8(e, 0x39); e8(e, 0xC8);
+                    emit_setcc_eax(e, 0x2);      /* setb */
+                    break;
+                default: /* OP_MUL */
+                    e8(e, 0x0F); e8(e, 0xAF); e8(e, 0xC1); /* imul eax, ecx */
+                    break;
+            }
+            emit_store_reg(e, rd, EAX);
+            return;
+        }
+
+        /* Register-immediate ALU: eax = regs[rs] op imm */
+        case OP_ADDI: case OP_ADDIU: case OP_ANDI: case OP_ORI: case OP_XORI:
+        case OP_SLTI: case OP_SLTIU: {
+            if (rt == 0) {
+                return;
+            }
+            emit_load_reg(e, EAX, rs);
+            switch (opcode) {
+                case OP_ADDI: case OP_ADDIU: e8(e, 0x05); e32(e, imm); break;
+                case OP_ANDI: e8(e, 0x25); e32(e, imm); break;
+                case OP_ORI: e8(e, 0x0D); e32(e, imm); break;
+                case OP_XORI: e8(e, 0x35); e32(e, imm); break;
+                case OP_SLTI:
+                    e8(e, 0x3D); e32(e, imm);   /* cmp eax, imm32 */
+                    emit_setcc_eax(e, 0xC);
+                    break;
+                default: /* OP_SLTIU */
+                    e8(e, 0x3D); e32(e, imm);
+                    emit_setcc_eax(e, 0x2);
+                    break;
+            }
+            emit_store_reg(e, rt, EAX);
+            return;
+        }
+
+        case OP_LUI:
+            if (rt != 0) {
+                emit_store_imm(e, rt, imm << 16);
+            }
+            return;
+
+        /* Shifts: x86 masks the count to 5 bits like the interpreter */
+        case OP_SLL: case OP_SRL: case OP_SRA:
+        case OP_SLLV: case OP_SRLV: case OP_SRAV: {
+            uint32_t ext;
+
+            if (rd == 0) {
+                return;
+            }
+            ext = (opcode == OP_SLL || opcode == OP_SLLV) ? 0xE0 :
+                  (opcode == OP_SRL || opcode == OP_SRLV) ? 0xE8 : 0xF8;
+            emit_load_reg(e, EAX, rt);
+            if (opcode == OP_SLL || opcode == OP_SRL || opcode == OP_SRA) {
+                if (imm & 0x1F) {
+                    e8(e, 0xC1);
+                    e8(e, ext);
+                    e8(e, imm & 0x1F);
+                }
+            } else {
+                emit_load_reg(e, ECX, rs);
+                e8(e, 0xD3);
+                e8(e, ext);
+            }
+            emit_store_reg(e, rd, EAX);
+            return;
+        }
+
+        case OP_DIV: case OP_DIVU: case OP_REM: case OP_REMU:
+            if (rd != 0) {
+                emit_divide(e, opcode, rd, rs, rt);
+            }
+            return;
+
+        /* Loads: addresses outside RAM are left to the interpreter */
+        case OP_LW: case OP_LH: case OP_LHU: case OP_LB: case OP_LBU: {
+            size = (opcode == OP_LW) ? 4 : (opcode == OP_LB || opcode == OP_LBU) ? 1 : 2;
+            if (memory_size < size) {
+                emit_mmio_exit(jit, e, pc, refund);
+                return;
+            }
+            emit_address(e, rs, imm);
+            emit_bounds_check(jit, e, memory_size, size, pc, refund);
+            if (rt == 0) {
+                return;
+            }
+            e8(e, 0x41);
+            switch (opcode) {
+                case OP_LW: e8(e, 0x8B); break;                 /* mov */
+                case OP_LH: e8(e, 0x0F); e8(e, 0xBF); break;    /* movsx word */
+                case OP_LHU: e8(e, 0x0F); e8(e, 0xB7); break;   /* movzx word */
+                case OP_LB: e8(e, 0x0F); e8(e, 0xBE); break;    /* movsx byte */
+                default: e8(e, 0x0F); e8(e, 0xB6); break;       /* movzx byte */
+            }
+            e8(e, 0x04);                /* eax, [r12 + rax] */
+            e8(e, 0x04);
+            emit_store_reg(e, rt, EAX);
+            return;
+        }
+
+        /* Stores: leave the block if a translated granule was written */
+        case OP_SW: case OP_SH: case OP_SB: {
+            uint8_t *smc_first, *smc_last = NULL, *done;
+
+            size = (opcode == OP_SW) ? 4 : (opcode == OP_SH) ? 2 : 1;
+            if (memory_size < size) {
+                emit_mmio_exit(jit, e, pc, refund);
+                return;
+            }
+            emit_address(e, rs, imm);
+            emit_bounds_check(jit, e, memory_size, size, pc, refund);
+            emit_load_reg(e, ECX, rt);
+            if (opcode == OP_SH) {
+                e8(e, 0x66);
+            }
+            e8(e, 0x41);
+            e8(e, (opcode == OP_SB) ? 0x88 : 0x89);
+            e8(e, 0x0C);                /* [r12 + rax], ecx/cx/cl */
+            e8(e, 0x04);
+
+            if (jit->dirty) {
+                emit_dirty_mark(e, 0);
+                if (size > 1) {
+                    emit_dirty_mark(e, size - 1);
+                }
+            }
+
+            e8(e, 0x89);                /* mov edx, eax */
+            e8(e, 0xC2);
+            smc_first = emit_watch_test(e);
+            if (size > 1) {
+                e8(e, 0x8D);            /* lea edx, [rax + size - 1] */
+                e8(e, 0x50);
+                e8(e, size - 1);
+                smc_last = emit_watch_test(e);
+            }
+            e8(e, 0xE9);                /* jmp done */
+            done = e->p;
+            e32(e, 0);
+
+            patch_rel32(smc_first, e->p);
+            if (smc_last) {
+                patch_rel32(smc_last, e->p);
+            }
+            if (refund) {
+                e8(e, 0x41);            /* add r14d, refund */
+                e8(e, 0x81);
+                e8(e, 0xC6);
+                e32(e, refund);
+            }
+            e8(e, 0x89);                /* mov ecx, eax */
+            e8(e, 0xC1);
+            emit_exit(jit, e, pc + 8, JIT_EXIT_SMC);
+
+            patch_rel32(done, e->p);
+            return;
+        }
+
+        default: /* OP_NOP */
+            return;
+    }
+}
+
+/**
+ * @brief Emit a branch or jump that ends a block
+ */
+static void emit_terminator(c32_jit_t *jit, emit_t *e, uint32_t pc, const uint8_t *inst) {
+    uint8_t opcode = inst[0];
+    uint32_t rs = inst[1], rt = inst[2], rd = inst[3];
+    uint32_t imm = (uint32_t)inst[4] | ((uint32_t)inst[5] << 8) |
+                   ((uint32_t)inst[6] << 16) | ((uint32_t)inst[7] << 24);
+    uint32_t next = pc + 8;
+    uint8_t *not_taken;
+    uint32_t cc;
+
+    switch (opcode) {
+        case OP_J:
+            emit_chain_exit(jit, e, imm);
+            return;
+        case OP_JAL:
+            emit_store_imm(e, 31, next);
+            emit_chain_exit(jit, e, imm);
+            return;
+        case OP_JR:
+            emit_load_reg(e, EAX, rs);
+            emit_mov_imm(e, EDX, JIT_EXIT_NONE);
+            e8(e, 0xE9);
+            emit_rel32(e, jit->exit_stub);
+            return;
+        case OP_JALR:
+            /* The interpreter writes the link before reading rs */
+            if (rd == rs) {
+                if (rd != 0) {
+                    emit_store_imm(e, rd, next);
+                }
+                emit_chain_exit(jit, e, next);
+                return;
+            }
+            emit_load_reg(e, EAX, rs);
+            if (rd != 0) {
+                emit_store_imm(e, rd, next);
+            }
+            emit_mov_imm(e, EDX, JIT_EXIT_NONE);
+            e8(e, 0xE9);
+            emit_rel32(e, jit->exit_stub);
+            return;
+        default:
+            break;
+    }
+
+    /* Conditional branches: jump over the taken exit when not taken */
+    emit_load_reg(e, EAX, rs);
+    if (opcode == OP_BEQ || opcode == OP_BNE) {
+        emit_load_reg(e, ECX, rt);
+        e8(e, 0x39);                /* cmp eax, ecx */
+        e8(e, 0xC8);
+        cc = (opcode == OP_BEQ) ? 0x5 : 0x4;   /* jne / je */
+    } else {
+        e8(e, 0x85);                /* test eax, eax */
+        e8(e, 0xC0);
+        cc = (opcode == OP_BLEZ) ? 0xF :        /* jg */
+             (opcode == OP_BGTZ) ? 0xE :        /* jle */
+             (opcode == OP_BLTZ) ? 0xD : 0xC;   /* jge / jl */
+    }
+    e8(e, 0x0F);
+    e8(e, 0x80 | cc);
+    not_taken = e->p;
+    e32(e, 0);
+    emit_chain_exit(jit, e, next + imm);
+    patch_rel32(not_taken, e->p);
+    emit_chain_exit(jit, e, next);
+}
+
+/**
+ * @brief Emit a block's budget stub and entry check
+ *
+ * @return Entry point of the block
+ */
+static uint8_t *emit_block_entry(c32_jit_t *jit, emit_t *e, uint32_t pc, uint32_t count) {
+    uint8_t *budget_exit = e->p, *entry;
+
+    emit_exit(jit, e, pc, JIT_EXIT_BUDGET);
+    entry = e->p;
+    e8(e, 0x41);                /* cmp r14d, count */
+    e8(e, 0x81);
+    e8(e, 0xFE);
+    e32(e, count);
+    e8(e, 0x72);                /* jb budget_exit */
+    e8(e, (uint32_t)(budget_exit - (e->p + 1)));
+    e8(e, 0x41);                /* sub r14d, count */
+    e8(e, 0x81);
+    e8(e, 0xEE);
+    e32(e, count);
+    return entry;
+}
+
+/**
+ * @brief Emit the shared entry trampoline and exit stub
+ */
+static void emit_stubs(c32_jit_t *jit) {
+    emit_t e;
+
+    e.p = jit->code;
+
+    /* Entry: (rdi=vm, rsi=code, rdx=memory, rcx=watch, r8=info) */
+    e8(&e, 0x53);                           /* push rbx */
+    e8(&e, 0x55);                           /* push rbp */
+    e8(&e, 0x41); e8(&e, 0x54);             /* push r12 */
+    e8(&e, 0x41); e8(&e, 0x55);             /* push r13 */
+    e8(&e, 0x41); e8(&e, 0x56);             /* push r14 */
+    e8(&e, 0x41); e8(&e, 0x57);             /* push r15 */
+    e8(&e, 0x48); e8(&e, 0x89); e8(&e, 0xFB); /* mov rbx, rdi */
+    e8(&e, 0x49); e8(&e, 0x89); e8(&e, 0xD4); /* mov r12, rdx */
+    e8(&e, 0x49); e8(&e, 0x89); e8(&e, 0xCF); /* mov r15, rcx */
+    e8(&e, 0x4C); e8(&e, 0x89); e8(&e, 0xC5); /* mov rbp, r8 */
+    e8(&e, 0x4C); e8(&e, 0x8B); e8(&e, 0xAB); /* mov r13, [rbx + dirty_map] */
+    e32(&e, (uint32_t)offsetof(c32_vm_t, dirty_map));
+    e8(&e, 0x44); e8(&e, 0x8B); e8(&e, 0x75); e8(&e, 0x00); /* mov r14d, [rbp] */
+    e8(&e, 0xFF); e8(&e, 0xE6);             /* jmp rsi */
+
+    /* Exit: eax = guest pc, edx = exit code, ecx = SMC address */
+    jit->exit_stub = e.p;
+    e8(&e, 0x89); e8(&e, 0x83);             /* mov [rbx + pc], eax */
+    e32(&e, (uint32_t)offsetof(c32_vm_t, pc));
+    e8(&e, 0x44); e8(&e, 0x89); e8(&e, 0x75); e8(&e, 0x00); /* mov [rbp], r14d */
+    e8(&e, 0x89); e8(&e, 0x4D); e8(&e, 0x04); /* mov [rbp + 4], ecx */
+    e8(&e, 0x89); e8(&e, 0xD0);             /* mov eax, edx */
+    e8(&e, 0x41); e8(&e, 0x5F);             /* pop r15 */
+    e8(&e, 0x41); e8(&e, 0x5E);             /* pop r14 */
+    e8(&e, 0x41); e8(&e, 0x5D);             /* pop r13 */
+    e8(&e, 0x41); e8(&e, 0x5C);             /* pop r12 */
+    e8(&e, 0x5D);                           /* pop rbp */
+    e8(&e, 0x5B);                           /* pop rbx */
+    e8(&e, 0xC3);                           /* ret */
+
+    jit->code_base = (uint32_t)(e.p - jit->code);
+    /* Keep blocks 16-byte aligned */
+    jit->code_base = (jit->code_base + 15) & ~(uint32_t)15;
+}
+
+/** @} */ /* end of jit_x86 */
+
+#elif defined(__aarch64__)
+
+/**
+ * @defgroup jit_arm64 AArch64 Code Generator
+ * @brief Translation of guest blocks to AArch64 machine code
+ *
+ * Register assignment inside translated code:
+ * - x19: c32_vm_t pointer (guest registers live in vm->regs)
+ * - x20: guest memory base
+ * - w21: remaining instruction budget
+ * - x22: watch map base
+ * - x23: dirty page bitmap (vm->dirty_map, loaded on entry)
+ * - x24: exit information (remaining budget, SMC store address)
+ * - w0, w1, w2: guest PC, exit code and SMC address on the way out
+ * - w9 to w14: scratch
+ *
+ * Instructions are written as little-endian words. Code is made visible
+ * to instruction fetch with __builtin___clear_cache() after every block
+ * and every patch.
+ * @{
+ */
+
+/** @brief Worst-case host bytes for one block, checked before translating */
+#define JIT_BLOCK_RESERVE (C32_JIT_MAX_BLOCK_INSNS * 256 + 256)
+
+/** @brief Host registers holding translated-code state */
+#define XVM     19
+#define XMEM    20
+#define WBUDGET 21
+#define XWATCH  22
+#define XDIRTY  23
+#define XINFO   24
+
+/** @brief Host scratch registers */
+#define W9  9
+#define W10 10
+#define W11 11
+#define W12 12
+#define W13 13
+#define W14 14
+
+/** @brief Zero register (stack pointer in address operands) */
+#define WZR 31
+
+/** @brief Condition codes */
+#define COND_EQ 0x0
+#define COND_NE 0x1
+#define COND_HS 0x2
+#define COND_LO 0x3
+#define COND_LS 0x9
+#define COND_GE 0xA
+#define COND_LT 0xB
+#define COND_GT 0xC
+#define COND_LE 0xD
+
+/* State reached through x19 must fit the scaled 12-bit load/store offsets */
+typedef char jit_vm_offsets_fit[offsetof(c32_vm_t, regs) + 31 * 4 < 16384 &&
+                                offsetof(c32_vm_t, pc) < 16384 &&
+                                offsetof(c32_vm_t, dirty_map) < 32768 ? 1 : -1];
+
+/**
+ * @brief Make freshly written code visible to instruction fetch
+ */
+static void sync_code(uint8_t *start, uint8_t *end) {
+    __builtin___clear_cache((char *)start, (char *)end);
+}
+
+/** @brief Emit one instruction word */
+static void emit(emit_t *e, uint32_t insn) {
+    e->p[0] = (uint8_t)insn;
+    e->p[1] = (uint8_t)(insn >> 8);
+    e->p[2] = (uint8_t)(insn >> 16);
+    e->p[3] = (uint8_t)(insn >> 24);
+    e->p += 4;
+}
+
+/** @brief Read back an emitted instruction word */
+static uint32_t read_insn(const uint8_t *site) {
+    return (uint32_t)site[0] | ((uint32_t)site[1] << 8) |
+           ((uint32_t)site[2] << 16) | ((uint32_t)site[3] << 24);
+}
+
+/** @brief Word offset from site to target */
+static uint32_t branch_offset(const uint8_t *site, const uint8_t *target) {
+    return (uint32_t)((target - site) / 4);
+}
+
+/**
+ * @brief Point the B instruction at site to an absolute host address
+ */
+static void patch_b26(uint8_t *site, const uint8_t *target) {
+    uint32_t insn = 0x14000000 | (branch_offset(site, target) & 0x3FFFFFF);
+    site[0] = (uint8_t)insn;
+    site[1] = (uint8_t)(insn >> 8);
+    site[2] = (uint8_t)(insn >> 16);
+    site[3] = (uint8_t)(insn >> 24);
+}
+
+/**
+ * @brief Point the B.cond or CBNZ at site to an absolute host address
+ */
+static void patch_b19(uint8_t *site, const uint8_t *target) {
+    uint32_t insn = (read_insn(site) & 0xFF00001F) |
+                    ((branch_offset(site, target) & 0x7FFFF) << 5);
+    site[0] = (uint8_t)insn;
+    site[1] = (uint8_t)(insn >> 8);
+    site[2] = (uint8_t)(insn >> 16);
+    site[3] = (uint8_t)(insn >> 24);
+}
+
+/**
+ * @brief Point a chain exit's jump at an absolute host address
+ */
+static void patch_chain(uint8_t *site, const uint8_t *target) {
+    patch_b26(site, target);
+    sync_code(site, site + 4);
+}
+
+/**
+ * @brief Reset a chain exit's jump to its unchained path
+ */
+static void reset_chain(uint8_t *site) {
+    patch_chain(site, site + 4);
+}
+
+/** @brief b target */
+static void emit_b(emit_t *e, const uint8_t *target) {
+    emit(e, 0x14000000 | (branch_offset(e->p, target) & 0x3FFFFFF));
+}
+
+/** @brief mov wd, imm32 (one or two instructions) */
+static void emit_mov_imm(emit_t *e, uint32_t rd, uint32_t imm) {
+    if ((imm >> 16) == 0) {
+        emit(e, 0x52800000 | (imm << 5) | rd);                      /* movz */
+    } else if ((imm & 0xFFFF) == 0) {
+        emit(e, 0x52A00000 | ((imm >> 16) << 5) | rd);              /* movz lsl 16 */
+    } else if ((~imm >> 16) == 0) {
+        emit(e, 0x12800000 | ((~imm & 0xFFFF) << 5) | rd);          /* movn */
+    } else {
+        emit(e, 0x52800000 | ((imm & 0xFFFF) << 5) | rd);           /* movz */
+        emit(e, 0x72A00000 | ((imm >> 16) << 5) | rd);              /* movk lsl 16 */
+    }
+}
+
+/** @brief ldr wt, regs[guest] */
+static void emit_load_reg(emit_t *e, uint32_t rt, uint32_t guest) {
+    uint32_t disp = (uint32_t)offsetof(c32_vm_t, regs) + guest * 4;
+
+    emit(e, 0xB9400000 | ((disp / 4) << 10) | (XVM << 5) | rt);
+}
+
+/** @brief str wt, regs[guest] */
+static void emit_store_reg(emit_t *e, uint32_t guest, uint32_t rt) {
+    uint32_t disp = (uint32_t)offsetof(c32_vm_t, regs) + guest * 4;
+
+    emit(e, 0xB9000000 | ((disp / 4) << 10) | (XVM << 5) | rt);
+}
+
+/** @brief regs[guest] = imm (through w9) */
+static void emit_store_imm(emit_t *e, uint32_t guest, uint32_t imm) {
+    if (imm == 0) {
+        emit_store_reg(e, guest, WZR);
+        return;
+    }
+    emit_mov_imm(e, W9, imm);
+    emit_store_reg(e, guest, W9);
+}
+
+/** @brief add wd, wn, imm (imm < 4096) */
+static void emit_add_imm(emit_t *e, uint32_t rd, uint32_t rn, uint32_t imm) {
+    emit(e, 0x11000000 | (imm << 10) | (rn << 5) | rd);
+}
+
+/** @brief lsr wd, wn, shift */
+static void emit_lsr_imm(emit_t *e, uint32_t rd, uint32_t rn, uint32_t shift) {
+    emit(e, 0x53007C00 | (shift << 16) | (rn << 5) | rd);
+}
+
+/**
+ * @brief Emit a jump to the shared exit stub with w0 = pc, w1 = code
+ */
+static void emit_exit(c32_jit_t *jit, emit_t *e, uint32_t pc, uint32_t code) {
+    emit_mov_imm(e, 0, pc);
+    emit_mov_imm(e, 1, code);
+    emit_b(e, jit->exit_stub);
+}
+
+/**
+ * @brief Emit a chainable exit to a constant guest PC
+ *
+ * Layout: `b` (initially to the next instruction), then the unchained
+ * exit. Chaining rewrites the branch to the target block.
+ */
+static void emit_chain_exit(c32_jit_t *jit, emit_t *e, uint32_t target) {
+    uint32_t slot;
+
+    if (jit->num_slots >= C32_JIT_MAX_SLOTS) {
+        emit_exit(jit, e, target, JIT_EXIT_NONE);
+        return;
+    }
+
+    slot = jit->num_slots++;
+    jit->slots[slot].site = e->p;
+    jit->slots[slot].target = target;
+    emit(e, 0x14000001);
+    emit_exit(jit, e, target, slot);
+}
+
+/**
+ * @brief Emit w9 = regs[rs] + imm
+ */
+static void emit_address(emit_t *e, uint32_t rs, uint32_t imm) {
+    emit_load_reg(e, W9, rs);
+    if (imm == 0) {
+        return;
+    }
+    if (imm < 4096) {
+        emit_add_imm(e, W9, W9, imm);
+    } else if (0 - imm < 4096) {
+        emit(e, 0x51000000 | ((0 - imm) << 10) | (W9 << 5) | W9);  /* sub */
+    } else {
+        emit_mov_imm(e, W10, imm);
+        emit(e, 0x0B000000 | (W10 << 16) | (W9 << 5) | W9);        /* add */
+    }
+}
+
+/**
+ * @brief Emit an exit that hands the memory access at pc to the interpreter
+ *
+ * The access and the refund instructions after it have not run, so all
+ * of them go back to the budget.
+ */
+static void emit_mmio_exit(c32_jit_t *jit, emit_t *e, uint32_t pc, uint32_t refund) {
+    emit_add_imm(e, WBUDGET, WBUDGET, refund + 1);
+    emit_exit(jit, e, pc, JIT_EXIT_MMIO);
+}
+
+/**
+ * @brief Emit a bounds check that leaves the block if w9 + size > memory_size
+ *
+ * Accesses outside RAM may target a device, so they are interpreted.
+ */
+static void emit_bounds_check(c32_jit_t *jit, emit_t *e, uint32_t memory_size,
+                              uint32_t size, uint32_t pc, uint32_t refund) {
+    uint8_t *in_range;
+
+    emit_mov_imm(e, W10, memory_size - size);
+    emit(e, 0x6B000000 | (W10 << 16) | (W9 << 5) | WZR);  /* cmp w9, w10 */
+    in_range = e->p;
+    emit(e, 0x54000000 | COND_LS);                          /* b.ls in_range */
+    emit_mmio_exit(jit, e, pc, refund);
+    patch_b19(in_range, e->p);
+}
+
+/**
+ * @brief Emit the watch map test for the store address in register src
+ *
+ * @return Address of the CBNZ to patch to the SMC exit
+ */
+static uint8_t *emit_watch_test(emit_t *e, uint32_t src) {
+    uint8_t *site;
+
+    emit_lsr_imm(e, W11, src, C32_JIT_WATCH_SHIFT);
+    emit(e, 0x38604800 | (W11 << 16) | (XWATCH << 5) | W12);   /* ldrb w12, [x22, w11, uxtw] */
+    site = e->p;
+    emit(e, 0x35000000 | W12);                                  /* cbnz w12, smc */
+    return site;
+}
+
+/**
+ * @brief Emit the dirty bit update for the page of w9 + offset
+ */
+static void emit_dirty_mark(emit_t *e, uint32_t offset) {
+    if (offset == 0) {
+        emit_lsr_imm(e, W11, W9, C32_DIRTY_PAGE_SHIFT);
+    } else {
+        emit_add_imm(e, W11, W9, offset);
+        emit_lsr_imm(e, W11, W11, C32_DIRTY_PAGE_SHIFT);
+    }
+    emit_lsr_imm(e, W12, W11, 5);
+    emit(e, 0xB8605800 | (W12 << 16) | (XDIRTY << 5) | W13);   /* ldr w13, [x23, w12, uxtw #2] */
+    emit(e, 0x52800020 | W14);                                  /* mov w14, #1 */
+    emit(e, 0x1AC02000 | (W11 << 16) | (W14 << 5) | W14);      /* lsl w14, w14, w11 */
+    emit(e, 0x2A000000 | (W14 << 16) | (W13 << 5) | W13);      /* orr w13, w13, w14 */
+    emit(e, 0xB8205800 | (W12 << 16) | (XDIRTY << 5) | W13);   /* str w13, [x23, w12, uxtw #2] */
+}
+
+/**
+ * @brief Emit a division or remainder
+ *
+ * Matches the interpreter: SDIV and UDIV already yield 0 for a zero
+ * divisor and wrap INT_MIN / -1. The remainder is formed with MSUB and
+ * forced to 0 for a zero divisor.
+ */
+static void emit_divide(emit_t *e, uint8_t opcode, uint32_t rd, uint32_t rs, uint32_t rt) {
+    uint32_t div = (opcode == OP_DIV || opcode == OP_REM) ? 0x1AC00C00 : 0x1AC00800;
+
+    emit_load_reg(e, W9, rs);
+    emit_load_reg(e, W10, rt);
+    if (opcode == OP_DIV || opcode == OP_DIVU) {
+        emit(e, div | (W10 << 16) | (W9 << 5) | W9);                   /* w9 = w9 / w10 */
+    } else {
+        emit(e, div | (W10 << 16) | (W9 << 5) | W11);                  /* w11 = w9 / w10 */
+        emit(e, 0x1B008000 | (W10 << 16) | (W9 << 10) | (W11 << 5) | W11); /* msub */
+        emit(e, 0x7100001F | (W10 << 5));                              /* cmp w10, #0 */
+        emit(e, 0x1A800000 | (WZR << 16) | (COND_NE << 12) | (W11 << 5) | W9); /* csel */
+    }
+    emit_store_reg(e, rd, W9);
+}
+
+/** @brief cset w9, cond after a compare */
+static void emit_cset(emit_t *e, uint32_t cond) {
+    emit(e, 0x1A9F07E0 | ((cond ^ 1) << 12) | W9);
+}
+
+/**
+ * @brief Emit a non-terminating instruction
+ *
+ * @param jit Pointer to JIT state
+ * @param e Output cursor
+ * @param pc Guest address of the instruction
+ * @param inst Instruction bytes
+ * @param refund Instructions after this one in the block (returned to
+ *               the budget if a store leaves the block early)
+ */
+static void emit_insn(c32_jit_t *jit, emit_t *e, uint32_t pc, const uint8_t *inst,
+                      uint32_t refund) {
+    uint8_t opcode = inst[0];
+    uint32_t rs = inst[1], rt = inst[2], rd = inst[3];
+    uint32_t imm = (uint32_t)inst[4] | ((uint32_t)inst[5] << 8) |
+                   ((uint32_t)inst[6] << 16) | ((uint32_t)inst[7] << 24);
+    uint32_t memory_size = jit->vm->memory_size;
+    uint32_t size;
+
+    switch (opcode) {
+        /* ALU: w9 = regs[rs] op w10, with w10 = regs[rt] or the immediate */
+        case OP_ADD: case OP_ADDU: case OP_SUB: case OP_SUBU:
+        case OP_AND: case OP_OR: case OP_XOR: case OP_NOR:
+        case OP_SLT: case OP_SLTU: case OP_MUL:
+        case OP_ADDI: case OP_ADDIU: case OP_ANDI: case OP_ORI: case OP_XORI:
+        case OP_SLTI: case OP_SLTIU: {
+            int immediate = opcode == OP_ADDI || opcode == OP_ADDIU || opcode == OP_ANDI ||
+                            opcode == OP_ORI || opcode == OP_XORI || opcode == OP_SLTI ||
+                            opcode == OP_SLTIU;
+            uint32_t dest = immediate ? rt : rd;
+            uint32_t ops = (W10 << 16) | (W9 << 5) | W9;
+
+            if (dest == 0) {
+                return;
+            }
+            emit_load_reg(e, W9, rs);
+            if (immediate) {
+                emit_mov_imm(e, W10, imm);
+            } else {
+                emit_load_reg(e, W10, rt);
+            }
+            switch (opcode) {
+                case OP_ADD: case OP_ADDU: case OP_ADDI: case OP_ADDIU:
+                    emit(e, 0x0B000000 | ops);
+                    break;
+                case OP_SUB: case OP_SUBU:
+                    emit(e, 0x4B000000 | ops);
+                    break;
+                case OP_AND: case OP_ANDI:
+                    emit(e, 0x0A000000 | ops);
+                    break;
+                case OP_OR: case OP_ORI:
+                    emit(e, 0x2A000000 | ops);
+                    break;
+                case OP_XOR: case OP_XORI:
+                    emit(e, 0x4A000000 | ops);
+                    break;
+                case OP_NOR:
+                    emit(e, 0x2A000000 | ops);                          /* orr */
+                    emit(e, 0x2A200000 | (W9 << 16) | (WZR << 5) | W9); /* mvn */
+                    break;
+                case OP_SLT: case OP_SLTI:
+                    emit(e, 0x6B000000 | (W10 << 16) | (W9 << 5) | WZR);    /* cmp */
+                    emit_cset(e, COND_LT);
+                    break;
+                case OP_SLTU: case OP_SLTIU:
+                    emit(e, 0x6B000000 | (W10 << 16) | (W9 << 5) | WZR);
+                    emit_cset(e, COND_LO);
+                    break;
+                default: /* OP_MUL */
+                    emit(e, 0x1B007C00 | ops);                          /* mul */
+                    break;
+            }
+            emit_store_reg(e, dest, W9);
+            return;
+        }
+
+        case OP_LUI:
+            if (rt != 0) {
+                emit_store_imm(e, rt, imm << 16);
+            }
+            return;
+
+        /* Shifts: AArch64 masks the register count to 5 bits like the interpreter */
+        case OP_SLL: case OP_SRL: case OP_SRA:
+        case OP_SLLV: case OP_SRLV: case OP_SRAV: {
+            uint32_t shift = imm & 0x1F;
+
+            if (rd == 0) {
+                return;
+            }
+            emit_load_reg(e, W9, rt);
+            if (opcode == OP_SLLV || opcode == OP_SRLV || opcode == OP_SRAV) {
+                emit_load_reg(e, W10, rs);
+                emit(e, (opcode == OP_SLLV ? 0x1AC02000 :              /* lslv */
+                         opcode == OP_SRLV ? 0x1AC02400 : 0x1AC02800) | /* lsrv / asrv */
+                        (W10 << 16) | (W9 << 5) | W9);
+            } else if (shift != 0) {
+                if (opcode == OP_SLL) {
+                    emit(e, 0x53000000 | ((32 - shift) << 16) |         /* ubfm (lsl) */
+                            ((31 - shift) << 10) | (W9 << 5) | W9);
+                } else {
+                    emit(e, (opcode == OP_SRL ? 0x53007C00 : 0x13007C00) | /* lsr / asr */
+                            (shift << 16) | (W9 << 5) | W9);
+                }
+            }
+            emit_store_reg(e, rd, W9);
+            return;
+        }
+
+        case OP_DIV: case OP_DIVU: case OP_REM: case OP_REMU:
+            if (rd != 0) {
+                emit_divide(e, opcode, rd, rs, rt);
+            }
+            return;
+
+        /* Loads: addresses outside RAM are left to the interpreter */
+        case OP_LW: case OP_LH: case OP_LHU: case OP_LB: case OP_LBU: {
+            size = (opcode == OP_LW) ? 4 : (opcode == OP_LB || opcode == OP_LBU) ? 1 : 2;
+            if (memory_size < size) {
+                emit_mmio_exit(jit, e, pc, refund);
+                return;
+            }
+            emit_address(e, rs, imm);
+            emit_bounds_check(jit, e, memory_size, size, pc, refund);
+            if (rt == 0) {
+                return;
+            }
+            switch (opcode) {
+                case OP_LW: emit(e, 0xB8604800 | (W9 << 16) | (XMEM << 5) | W9); break;  /* ldr */
+                case OP_LH: emit(e, 0x78E04800 | (W9 << 16) | (XMEM << 5) | W9); break;  /* ldrsh */
+                case OP_LHU: emit(e, 0x78604800 | (W9 << 16) | (XMEM << 5) | W9); break; /* ldrh */
+                case OP_LB: emit(e, 0x38E04800 | (W9 << 16) | (XMEM << 5) | W9); break;  /* ldrsb */
+                default: emit(e, 0x38604800 | (W9 << 16) | (XMEM << 5) | W9); break;     /* ldrb */
+            }
+            emit_store_reg(e, rt, W9);
+            return;
+        }
+
+        /* Stores: leave the block if a translated granule was written */
+        case OP_SW: case OP_SH: case OP_SB: {
+            uint8_t *smc_first, *smc_last = NULL, *done;
+
+            size = (opcode == OP_SW) ? 4 : (opcode == OP_SH) ? 2 : 1;
+            if (memory_size < size) {
+                emit_mmio_exit(jit, e, pc, refund);
+                return;
+            }
+            emit_address(e, rs, imm);
+            emit_bounds_check(jit, e, memory_size, size, pc, refund);
+            emit_load_reg(e, W10, rt);
+            emit(e, (opcode == OP_SW ? 0xB8204800 :                 /* str */
+                     opcode == OP_SH ? 0x78204800 : 0x38204800) |   /* strh / strb */
+                    (W9 << 16) | (XMEM << 5) | W10);
+
+            if (jit->dirty) {
+                emit_dirty_mark(e, 0);
+                if (size > 1) {
+                    emit_dirty_mark(e, size - 1);
+                }
+            }
+
+            smc_first = emit_watch_test(e, W9);
+            if (size > 1) {
+                emit_add_imm(e, W11, W9, size - 1);
+                smc_last = emit_watch_test(e, W11);
+            }
+            done = e->p;
+            emit(e, 0x14000000);                                    /* b done */
+
+            patch_b19(smc_first, e->p);
+            if (smc_last) {
+                patch_b19(smc_last, e->p);
+            }
+            if (refund) {
+                emit_add_imm(e, WBUDGET, WBUDGET, refund);
+            }
+            emit(e, 0x2A000000 | (W9 << 16) | (WZR << 5) | 2);         /* mov w2, w9 */
+            emit_exit(jit, e, pc + 8, JIT_EXIT_SMC);
+
+            patch_b26(done, e->p);
+            return;
+        }
+
+        default: /* OP_NOP */
+            return;
+    }
+}
+
+/**
+ * @brief Emit a branch or jump that ends a block
+ */
+static void emit_terminator(c32_jit_t *jit, emit_t *e, uint32_t pc, const uint8_t *inst) {
+    uint8_t opcode = inst[0];
+    uint32_t rs = inst[1], rt = inst[2], rd = inst[3];
+    uint32_t imm = (uint32_t)inst[4] | ((uint32_t)inst[5] << 8) |
+                   ((uint32_t)inst[6] << 16) | ((uint32_t)inst[7] << 24);
+    uint32_t next = pc + 8;
+    uint8_t *not_taken;
+    uint32_t cond;
+
+    switch (opcode) {
+        case OP_J:
+            emit_chain_exit(jit, e, imm);
+            return;
+        case OP_JAL:
+            emit_store_imm(e, 31, next);
+            emit_chain_exit(jit, e, imm);
+            return;
+        case OP_JR:
+            emit_load_reg(e, 0, rs);
+            emit_mov_imm(e, 1, JIT_EXIT_NONE);
+            emit_b(e, jit->exit_stub);
+            return;
+        case OP_JALR:
+            /* The interpreter writes the link before reading rs */
+            if (rd == rs) {
+                if (rd != 0) {
+                    emit_store_imm(e, rd, next);
+                }
+                emit_chain_exit(jit, e, next);
+                return;
+            }
+            emit_load_reg(e, 0, rs);
+            if (rd != 0) {
+                emit_store_imm(e, rd, next);
+            }
+            emit_mov_imm(e, 1, JIT_EXIT_NONE);
+            emit_b(e, jit->exit_stub);
+            return;
+        default:
+            break;
+    }
+
+    /* Conditional branches: jump over the taken exit when not taken */
+    emit_load_reg(e, W9, rs);
+    if (opcode == OP_BEQ || opcode == OP_BNE) {
+        emit_load_reg(e, W10, rt);
+        emit(e, 0x6B000000 | (W10 << 16) | (W9 << 5) | WZR);   /* cmp w9, w10 */
+        cond = (opcode == OP_BEQ) ? COND_NE : COND_EQ;
+    } else {
+        emit(e, 0x7100001F | (W9 << 5));                      /* cmp w9, #0 */
+        cond = (opcode == OP_BLEZ) ? COND_GT :
+               (opcode == OP_BGTZ) ? COND_LE :
+               (opcode == OP_BLTZ) ? COND_GE : COND_LT;
+    }
+    not_taken = e->p;
+    emit(e, 0x54000000 | cond);
+    emit_chain_exit(jit, e, next + imm);
+    patch_b19(not_taken, e->p);
+    emit_chain_exit(jit, e, next);
+}
+
+/**
+ * @brief Emit a block's budget stub and entry check
+ *
+ * @return Entry point of the block
+ */
+static uint8_t *emit_block_entry(c32_jit_t *jit, emit_t *e, uint32_t pc, uint32_t count) {
+    uint8_t *budget_exit = e->p, *entry;
+
+    emit_exit(jit, e, pc, JIT_EXIT_BUDGET);
+    entry = e->p;
+    emit(e, 0x7100001F | (count << 10) | (WBUDGET << 5));           /* cmp w21, count */
+    emit(e, 0x54000000 | ((branch_offset(e->p, budget_exit) & 0x7FFFF) << 5) |
+            COND_LO);                                               /* b.lo budget_exit */
+    emit(e, 0x51000000 | (count << 10) | (WBUDGET << 5) | WBUDGET); /* sub w21, count */
+    return entry;
+}
+
+/**
+ * @brief Emit the shared entry trampoline and exit stub
+ */
+static void emit_stubs(c32_jit_t *jit) {
+    emit_t e;
+
+    e.p = jit->code;
+
+    /* Entry: (x0=vm, x1=code, x2=memory, x3=watch, x4=info) */
+    emit(&e, 0xA9BC7BFD);                   /* stp x29, x30, [sp, #-64]! */
+    emit(&e, 0x910003FD);                   /* mov x29, sp */
+    emit(&e, 0xA90153F3);                   /* stp x19, x20, [sp, #16] */
+    emit(&e, 0xA9025BF5);                   /* stp x21, x22, [sp, #32] */
+    emit(&e, 0xA90363F7);                   /* stp x23, x24, [sp, #48] */
+    emit(&e, 0xAA0003F3);                   /* mov x19, x0 */
+    emit(&e, 0xAA0203F4);                   /* mov x20, x2 */
+    emit(&e, 0xAA0303F6);                   /* mov x22, x3 */
+    emit(&e, 0xAA0403F8);                   /* mov x24, x4 */
+    emit(&e, 0xF9400000 | (((uint32_t)offsetof(c32_vm_t, dirty_map) / 8) << 10) |
+             (XVM << 5) | XDIRTY);          /* ldr x23, [x19, dirty_map] */
+    emit(&e, 0xB9400000 | (XINFO << 5) | WBUDGET); /* ldr w21, [x24] */
+    emit(&e, 0xD61F0020);                   /* br x1 */
+
+    /* Exit: w0 = guest pc, w1 = exit code, w2 = SMC address */
+    jit->exit_stub = e.p;
+    emit(&e, 0xB9000000 | (((uint32_t)offsetof(c32_vm_t, pc) / 4) << 10) |
+             (XVM << 5) | 0);               /* str w0, [x19, pc] */
+    emit(&e, 0xB9000000 | (XINFO << 5) | WBUDGET); /* str w21, [x24] */
+    emit(&e, 0xB9000400 | (XINFO << 5) | 2); /* str w2, [x24, #4] */
+    emit(&e, 0x2A0103E0);                   /* mov w0, w1 */
+    emit(&e, 0xA94363F7);                   /* ldp x23, x24, [sp, #48] */
+    emit(&e, 0xA9425BF5);                   /* ldp x21, x22, [sp, #32] */
+    emit(&e, 0xA94153F3);                   /* ldp x19, x20, [sp, #16] */
+    emit(&e, 0xA8C47BFD);                   /* ldp x29, x30, [sp], #64 */
+    emit(&e, 0xD65F03C0);                   /* ret */
+
+    sync_code(jit->code, e.p);
+    jit->code_base = (uint32_t)(e.p - jit->code);
+    /* Keep blocks 16-byte aligned */
+    jit->code_base = (jit->code_base + 15) & ~(uint32_t)15;
+}
+
+/** @} */ /* end of jit_arm64 */
+
+#endif /* __x86_64__ */
+
+#ifdef JIT_CODEGEN
+
+/**
+ * @defgroup jit_blocks Block Management
+ * @brief Translation, lookup, chaining, and invalidation of blocks
+ * @{
+ */
+
+/**
+ * @brief Mark the watch granules covered by a block
+ */
+static void watch_block(c32_jit_t *jit, const c32_jit_block_t *block) {
+    uint32_t g;
+
+    for (g = block->pc >> C32_JIT_WATCH_SHIFT;
+         g <= (block->end - 1) >> C32_JIT_WATCH_SHIFT && g < jit->watch_size; g++) {
+        jit->watch[g] = 1;
+    }
+}
+
+/**
+ * @brief Discard all translations
+ *
+ * @param jit Pointer to JIT state
+ */
+void c32_jit_flush(c32_jit_t *jit) {
+    jit->code_used = jit->code_base;
+    jit->num_blocks = 0;
+    jit->num_slots = 0;
+    memset(jit->map, 0, sizeof(jit->map));
+    memset(jit->watch, 0, jit->watch_size);
+    jit->vm->watch_hit = 0;
+    jit->stat_flushes++;
+}
+
+/**
+ * @brief Discard translations overlapping a physical range
+ *
+ * Blocks stay in the code buffer until the next flush but become
+ * unreachable: their lookup entries are cleared and every chain exit
+ * leading to them is reset to its unchained path.
+ *
+ * @param jit Pointer to JIT state
+ * @param phys_addr Physical start address of modified range
+ * @param size Size of modified range in bytes
+ */
+void c32_jit_invalidate(c32_jit_t *jit, uint32_t phys_addr, uint32_t size) {
+    uint32_t end = phys_addr + size;
+    uint32_t i, killed = 0;
+
+    if (size == 0) {
+        return;
+    }
+    if (end < phys_addr) {
+        c32_jit_flush(jit);
+        return;
+    }
+
+    for (i = 0; i < jit->num_blocks; i++) {
+        c32_jit_block_t *block = &jit->blocks[i];
+        uint32_t *slot = &jit->map[(block->pc >> 3) & (C32_JIT_MAP_ENTRIES - 1)];
+
+        if (block->end == 0 || block->pc >= end || block->end <= phys_addr) {
+            continue;
+        }
+        if (*slot == i + 1) {
+            *slot = 0;
+        }
+        block->end = 0; /* Dead */
+        killed++;
+    }
+    if (!killed) {
+        return;
+    }
+
+    /* Unchain every jump whose target is no longer mapped to a live block */
+    for (i = 0; i < jit->num_slots; i++) {
+        c32_jit_slot_t *slot = &jit->slots[i];
+        uint32_t idx = jit->map[(slot->target >> 3) & (C32_JIT_MAP_ENTRIES - 1)];
+
+        if (idx == 0 || jit->blocks[idx - 1].pc != slot->target) {
+            reset_chain(slot->site);
+        }
+    }
+
+    /* Rebuild the watch map from the surviving blocks */
+    memset(jit->watch, 0, jit->watch_size);
+    for (i = 0; i < jit->num_blocks; i++) {
+        if (jit->blocks[i].end != 0) {
+            watch_block(jit, &jit->blocks[i]);
+        }
+    }
+}
+
+/**
+ * @brief Translate the block starting at a physical PC
+ *
+ * @return Block descriptor; code is NULL if the first instruction must
+ *         be interpreted
+ */
+static c32_jit_block_t *jit_translate(c32_jit_t *jit, uint32_t pc) {
+    c32_vm_t *vm = jit->vm;
+    c32_jit_block_t *block;
+    uint32_t count = 0, end = pc, n;
+    int kind = 0;
+    emit_t e;
+
+    if (jit->num_blocks >= C32_JIT_MAX_BLOCKS ||
+        jit->code_used + JIT_BLOCK_RESERVE > C32_JIT_CODE_SIZE) {
+        c32_jit_flush(jit);
+    }
+
+    /* Find the extent: stop after a terminator or before an interpreted op */
+    while (count < C32_JIT_MAX_BLOCK_INSNS && end + 8 <= vm->memory_size && end + 8 > end) {
+        const uint8_t *inst = vm->memory + end;
+        kind = jit_classify(inst[0], inst[1], inst[2], inst[3]);
+        if (vm->profile && vm->profile->calls &&
+            (inst[0] == OP_JAL || inst[0] == OP_JALR)) {
+            kind = 0; /* Interpreted so the call is counted */
+        }
+        if (kind == 0) {
+            break;
+        }
+        count++;
+        end += 8;
+        if (kind == 2) {
+            break;
+        }
+    }
+
+    block = &jit->blocks[jit->num_blocks++];
+    block->pc = pc;
+    block->end = count ? end : pc + 8;
+    block->code = NULL;
+    jit->map[(pc >> 3) & (C32_JIT_MAP_ENTRIES - 1)] = jit->num_blocks;
+    if (count == 0) {
+        return block;
+    }
+
+    e.p = jit->code + jit->code_used;
+
+    /* Budget stub, then the entry point that branches back to it */
+    block->code = emit_block_entry(jit, &e, pc, count);
+
+    for (n = 0; n < count; n++) {
+        uint32_t addr = pc + n * 8;
+        const uint8_t *inst = vm->memory + addr;
+
+        if (n == count - 1 && kind == 2) {
+            emit_terminator(jit, &e, addr, inst);
+        } else {
+            emit_insn(jit, &e, addr, inst, count - n - 1);
+        }
+    }
+    if (kind != 2) {
+        emit_chain_exit(jit, &e, end);
+    }
+
+    sync_code(jit->code + jit->code_used, e.p);
+    jit->code_used = ((uint32_t)(e.p - jit->code) + 15) & ~(uint32_t)15;
+    watch_block(jit, block);
+    jit->stat_blocks++;
+    return block;
+}
+
+/**
+ * @brief Find or create the block for a physical PC
+ */
+static c32_jit_block_t *jit_lookup(c32_jit_t *jit, uint32_t pc) {
+    uint32_t idx = jit->map[(pc >> 3) & (C32_JIT_MAP_ENTRIES - 1)];
+
+    if (idx != 0 && jit->blocks[idx - 1].pc == pc) {
+        return &jit->blocks[idx - 1];
+    }
+    return jit_translate(jit, pc);
+}
+
+/** @} */ /* end of jit_blocks */
+
+/**
+ * @addtogroup jit
+ * @{
+ */
+
+/**
+ * @brief Attach a JIT to a VM
+ *
+ * @param jit Pointer to JIT state
+ * @param vm Pointer to initialized VM
+ * @return 0 on success, -1 on failure
+ */
+int c32_jit_init(c32_jit_t *jit, c32_vm_t *vm) {
+    void *code, *watch;
+
+    memset(jit, 0, sizeof(*jit));
+    jit->vm = vm;
+    jit->watch_size = (uint32_t)(((unsigned long)vm->memory_size +
+                                  (1UL << C32_JIT_WATCH_SHIFT) - 1) >> C32_JIT_WATCH_SHIFT);
+
+    code = mmap(NULL, C32_JIT_CODE_SIZE, PROT_READ | PROT_WRITE | PROT_EXEC,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (code == MAP_FAILED) {
+        return -1;
+    }
+    watch = mmap(NULL, jit->watch_size ? jit->watch_size : 1, PROT_READ | PROT_WRITE,
+                 MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (watch == MAP_FAILED) {
+        munmap(code, C32_JIT_CODE_SIZE);
+        return -1;
+    }
+
+    jit->code = (uint8_t *)code;
+    jit->watch = (uint8_t *)watch;
+    emit_stubs(jit);
+    jit->code_used = jit->code_base;
+
+    c32_vm_set_icache(vm, NULL, 0);
+    c32_vm_set_write_watch(vm, jit->watch, jit->watch_size, C32_JIT_WATCH_SHIFT);
+    return 0;
+}
+
+/**
+ * @brief Release the JIT's host resources and detach it from the VM
+ *
+ * @param jit Pointer to JIT state
+ */
+void c32_jit_destroy(c32_jit_t *jit) {
+    if (!jit->code) {
+        return;
+    }
+    c32_vm_set_write_watch(jit->vm, NULL, 0, 0);
+    munmap(jit->code, C32_JIT_CODE_SIZE);
+    munmap(jit->watch, jit->watch_size ? jit->watch_size : 1);
+    jit->code = NULL;
+    jit->watch = NULL;
+}
+
+/**
+ * @brief Run VM for at most budget instructions using translated code
+ *
+ * Each iteration either runs translated code (which may chain through
+ * many blocks) or hands a small slice to the interpreter:
+ * - one instruction when an interrupt is pending and enabled, when the
+ *   instruction at PC is not translated, or when translated code left at
+ *   a load or store outside RAM (which may reach a device)
+ * - up to 256 instructions in paged user mode, which is not translated
+ * - the budget remainder when it is smaller than the next block
+ *
+ * Translated code is given at most the instructions left before the
+ * timer expires and the timer is charged for what it retired.
+ *
+ * @param jit Pointer to JIT state
+ * @param budget Maximum number of instructions to execute
+ * @param executed If non-NULL, receives the number of instructions retired
+ * @return Why execution stopped
+ */
+c32_exit_reason_t c32_jit_run_for(c32_jit_t *jit, uint32_t budget, uint32_t *executed) {
+    c32_vm_t *vm = jit->vm;
+    c32_exit_reason_t reason = C32_EXIT_BUDGET;
+    jit_exit_info_t info;
+    jit_entry_fn entry;
+    uint32_t remaining = budget;
+    uint32_t chain = JIT_EXIT_NONE;
+    uint32_t interpreted = 0;
+    void *code_ptr = jit->code;
+
+    /* Object to function pointer conversion without a cast ISO C rejects */
+    memcpy(&entry, &code_ptr, sizeof(entry));
+
+    if (!vm->running) {
+        if (executed) {
+            *executed = 0;
+        }
+        return C32_EXIT_HALTED;
+    }
+
+    /* Translated code does not write trace records */
+    if (vm->trace) {
+        return c32_vm_run_for(vm, budget, executed);
+    }
+
+    /* Stores are translated with or without dirty marking */
+    if ((vm->dirty_map != NULL) != jit->dirty) {
+        c32_jit_flush(jit);
+        jit->dirty = vm->dirty_map != NULL;
+        chain = JIT_EXIT_NONE;
+    }
+
+    while (remaining > 0) {
+        c32_jit_block_t *block;
+        uint32_t slice = 0, quota, code;
+
+        /* Interpreter stores into translated code */
+        if (vm->watch_hit) {
+            c32_jit_flush(jit);
+            chain = JIT_EXIT_NONE;
+        }
+
+        if (vm->interrupts.pending_summary && vm->interrupts.enabled) {
+            slice = 1;
+        } else if (!vm->kernel_mode && vm->paging_enabled) {
+            slice = remaining < 256 ? remaining : 256;
+        } else if ((vm->pc & 7) != 0 || vm->pc > vm->memory_size - 8 ||
+                   vm->memory_size < 8) {
+            /* The interpreter's fetch reports misaligned and out-of-RAM PCs */
+            slice = 1;
+        } else {
+            block = jit_lookup(jit, vm->pc);
+            if (!block->code) {
+                slice = 1;
+            } else {
+                if (chain < jit->num_slots && jit->slots[chain].target == block->pc) {
+                    patch_chain(jit->slots[chain].site, block->code);
+                    jit->stat_chains++;
+                }
+                /* Stop translated code at the timer expiry */
+                quota = remaining;
+                if (vm->timer.count != 0 && vm->timer.count < quota) {
+                    quota = vm->timer.count;
+                }
+                info.remaining = quota;
+                code = entry(vm, block->code, vm->memory, jit->watch, &info);
+                remaining -= quota - info.remaining;
+                c32_vm_timer_elapse(vm, quota - info.remaining);
+                chain = code;
+
+                /* Translated stores do not track page table writes */
+                if (vm->paging_enabled) {
+                    c32_vm_tlb_flush(vm);
+                }
+
+                if (code == JIT_EXIT_SMC) {
+                    c32_jit_invalidate(jit, info.smc_addr, 4);
+                    chain = JIT_EXIT_NONE;
+                } else if (code == JIT_EXIT_BUDGET) {
+                    slice = info.remaining;
+                } else if (code == JIT_EXIT_MMIO) {
+                    slice = 1;
+                }
+            }
+        }
+
+        if (slice) {
+            uint32_t count = 0;
+
+            chain = JIT_EXIT_NONE;
+            reason = c32_vm_run_for(vm, slice, &count);
+            remaining -= count;
+            interpreted += count;
+            if (reason != C32_EXIT_BUDGET) {
+                break;
+            }
+        }
+    }
+
+#ifdef C32_ENABLE_STATS
+    /* The interpreter counted its own share; translated code only retires */
+    {
+        uint32_t translated = budget - remaining - interpreted;
+
+        vm->stats.instructions += translated;
+        if (vm->stats.instructions < translated) {
+            vm->stats.instructions_hi++;
+        }
+    }
+#else
+    (void)interpreted;
+#endif
+
+    if (executed) {
+        *executed = budget - remaining;
+    }
+    return reason;
+}
+
+/** @} */ /* end of jit */
+
+#else /* !JIT_CODEGEN */
+
+/*
+ * No code generator for this host. c32_jit_init() fails so callers use
+ * the interpreter.
+ */
+
+int c32_jit_init(c32_jit_t *jit, c32_vm_t *vm) {
+    memset(jit, 0, sizeof(*jit));
+    jit->vm = vm;
+    return -1;
+}
+
+void c32_jit_destroy(c32_jit_t *jit) {
+    (void)jit;
+}
+
+c32_exit_reason_t c32_jit_run_for(c32_jit_t *jit, uint32_t budget, uint32_t *executed) {
+    return c32_vm_run_for(jit->vm, budget, executed);
+}
+
+void c32_jit_invalidate(c32_jit_t *jit, uint32_t phys_addr, uint32_t size) {
+    (void)jit;
+    (void)phys_addr;
+    (void)size;
+}
+
+void c32_jit_flush(c32_jit_t *jit) {
+    (void)jit;
+}
+
+#endif /* JIT_CODEGEN */
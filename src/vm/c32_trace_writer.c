@@ -0,0 +1,259 @@
+/**
+ * @file c32_trace_writer.c
+ * @brief CRISP-32 Streaming Trace Writer (POSIX hosts)
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_trace_writer.h"
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/**
+ * @addtogroup trace_writer
+ * @{
+ */
+
+/**
+ * @brief Writer state
+ *
+ * The VM thread fills buffers[current]; while queued is non-zero the
+ * writer thread owns buffers[current ^ 1] and is writing queued bytes
+ * from it.
+ */
+struct c32_trace_writer {
+    FILE *fp;                   /**< Output file */
+    pthread_t thread;           /**< Writer thread */
+    pthread_mutex_t lock;       /**< Protects queued, stop and error */
+    pthread_cond_t cond;        /**< Signals queued and stop changes */
+    uint8_t *buffers[2];        /**< Chunk buffers */
+    uint32_t chunk_bytes;       /**< Size of each chunk buffer */
+    uint32_t fill;              /**< Bytes used in buffers[current] */
+    int current;                /**< Buffer the VM thread is filling */
+    uint32_t queued;            /**< Bytes handed to the writer thread */
+    int stop;                   /**< Set when the writer thread should exit */
+    int error;                  /**< Set when a write failed */
+    unsigned long records;      /**< Records handed to the writer thread */
+};
+
+/**
+ * @brief Writer thread: write each queued chunk until told to stop
+ *
+ * @param arg Writer
+ * @return NULL
+ */
+static void *writer_main(void *arg) {
+    c32_trace_writer_t *writer = (c32_trace_writer_t *)arg;
+
+    pthread_mutex_lock(&writer->lock);
+    for (;;) {
+        const uint8_t *chunk;
+        uint32_t bytes;
+        int failed;
+
+        while (!writer->queued && !writer->stop) {
+            pthread_cond_wait(&writer->cond, &writer->lock);
+        }
+        if (!writer->queued) {
+            break;
+        }
+        chunk = writer->buffers[writer->current ^ 1];
+        bytes = writer->queued;
+        pthread_mutex_unlock(&writer->lock);
+
+        failed = fwrite(chunk, 1, bytes, writer->fp) != bytes;
+
+        pthread_mutex_lock(&writer->lock);
+        if (failed) {
+            writer->error = 1;
+        }
+        writer->queued = 0;
+        pthread_cond_broadcast(&writer->cond);
+    }
+    pthread_mutex_unlock(&writer->lock);
+    return NULL;
+}
+
+/**
+ * @brief Hand the current buffer to the writer thread
+ *
+ * Waits for the previous chunk to finish first.
+ *
+ * @param writer Writer
+ * @return 0 on success, -1 if a write has failed
+ */
+static int submit_chunk(c32_trace_writer_t *writer) {
+    int error;
+
+    pthread_mutex_lock(&writer->lock);
+    while (writer->queued) {
+        pthread_cond_wait(&writer->cond, &writer->lock);
+    }
+    if (writer->fill) {
+        writer->queued = writer->fill;
+        writer->current ^= 1;
+        writer->fill = 0;
+        pthread_cond_broadcast(&writer->cond);
+    }
+    error = writer->error;
+    pthread_mutex_unlock(&writer->lock);
+    return error ? -1 : 0;
+}
+
+/**
+ * @brief Create a trace file and start its writer thread
+ *
+ * @param filename Output path
+ * @param chunk_records Records per chunk buffer (0 selects the default)
+ * @return Writer, or NULL on host error
+ */
+c32_trace_writer_t *c32_trace_writer_open(const char *filename, uint32_t chunk_records) {
+    c32_trace_writer_t *writer;
+    uint8_t header[C32_TRACE_HEADER_SIZE];
+    int i;
+
+    if (chunk_records == 0) {
+        chunk_records = C32_TRACE_DEFAULT_CHUNK;
+    }
+
+    writer = (c32_trace_writer_t *)calloc(1, sizeof(*writer));
+    if (!writer) {
+        return NULL;
+    }
+    writer->chunk_bytes = chunk_records * C32_TRACE_RECORD_SIZE;
+    writer->buffers[0] = (uint8_t *)malloc(writer->chunk_bytes);
+    writer->buffers[1] = (uint8_t *)malloc(writer->chunk_bytes);
+    writer->fp = fopen(filename, "wb");
+    if (!writer->buffers[0] || !writer->buffers[1] || !writer->fp) {
+        goto fail;
+    }
+
+    for (i = 0; i < 8; i++) {
+        header[i] = (uint8_t)C32_TRACE_MAGIC[i];
+    }
+    c32_write_word(header + 8, C32_TRACE_VERSION);
+    c32_write_word(header + 12, C32_TRACE_RECORD_SIZE);
+    if (fwrite(header, 1, sizeof(header), writer->fp) != sizeof(header)) {
+        goto fail;
+    }
+
+    pthread_mutex_init(&writer->lock, NULL);
+    pthread_cond_init(&writer->cond, NULL);
+    if (pthread_create(&writer->thread, NULL, writer_main, writer) != 0) {
+        pthread_cond_destroy(&writer->cond);
+        pthread_mutex_destroy(&writer->lock);
+        goto fail;
+    }
+    return writer;
+
+fail:
+    if (writer->fp) {
+        fclose(writer->fp);
+    }
+    free(writer->buffers[0]);
+    free(writer->buffers[1]);
+    free(writer);
+    return NULL;
+}
+
+/**
+ * @brief Move every pending record from a ring into the writer
+ *
+ * Records are encoded little-endian into the current chunk buffer; each
+ * chunk that fills up is handed to the writer thread. A failed write is
+ * reported by the next call that hands over a chunk.
+ *
+ * @param writer Writer
+ * @param trace Ring to drain
+ * @return 0 on success, -1 if a write has failed
+ */
+int c32_trace_writer_drain(c32_trace_writer_t *writer, c32_trace_t *trace) {
+    const c32_trace_record_t *chunk;
+    uint32_t count;
+
+    while ((count = c32_trace_peek(trace, &chunk)) != 0) {
+        uint32_t room = (writer->chunk_bytes - writer->fill) / C32_TRACE_RECORD_SIZE;
+        uint8_t *out = writer->buffers[writer->current] + writer->fill;
+        uint32_t i;
+
+        if (count > room) {
+            count = room;
+        }
+        for (i = 0; i < count; i++, out += C32_TRACE_RECORD_SIZE) {
+            c32_write_word(out, chunk[i].pc);
+            out[4] = chunk[i].opcode;
+            out[5] = chunk[i].rs;
+            out[6] = chunk[i].rt;
+            out[7] = chunk[i].rd;
+            c32_write_word(out + 8, chunk[i].imm);
+            c32_write_word(out + 12, chunk[i].addr);
+        }
+        c32_trace_consume(trace, count);
+        writer->fill += count * C32_TRACE_RECORD_SIZE;
+        writer->records += count;
+
+        if (writer->fill == writer->chunk_bytes && submit_chunk(writer) != 0) {
+            return -1;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief Drain a ring one last time, finish the file and free the writer
+ *
+ * @param writer Writer
+ * @param trace Ring to drain, or NULL
+ * @param records If non-NULL, receives the number of records written
+ * @return 0 on success, -1 if any write failed
+ */
+int c32_trace_writer_close(c32_trace_writer_t *writer, c32_trace_t *trace,
+                           unsigned long *records) {
+    int status = 0;
+
+    if (trace && c32_trace_writer_drain(writer, trace) != 0) {
+        status = -1;
+    }
+    if (submit_chunk(writer) != 0) {
+        status = -1;
+    }
+
+    pthread_mutex_lock(&writer->lock);
+    writer->stop = 1;
+    pthread_cond_broadcast(&writer->cond);
+    pthread_mutex_unlock(&writer->lock);
+    pthread_join(writer->thread, NULL);
+
+    if (fclose(writer->fp) != 0 || writer->error) {
+        status = -1;
+    }
+    if (records) {
+        *records = writer->records;
+    }
+
+    pthread_cond_destroy(&writer->cond);
+    pthread_mutex_destroy(&writer->lock);
+    free(writer->buffers[0]);
+    free(writer->buffers[1]);
+    free(writer);
+    return status;
+}
+
+/** @} */ /* end of trace_writer */
@@ -23,53 +23,6 @@
 #include "c32_opcodes.h"
 #include "c32_string.h"
 
-/**
- * @defgroup vm_endian Endianness Conversion
- * @brief Little-endian conversion for big-endian hosts
- *
- * CRISP-32 uses little-endian encoding for all multi-byte values.
- * These functions provide automatic byte-swapping on big-endian hosts.
- * @{
- */
-
-/* Endianness detection and conversion */
-#ifdef C32_HOST_BIG_ENDIAN
-#define NEED_ENDIAN_SWAP 1
-
-/**
- * @brief Swap bytes in 32-bit value
- *
- * Converts between little-endian and big-endian representation.
- *
- * @param val Value to swap
- * @return Byte-swapped value
- */
-static uint32_t swap32(uint32_t val) {
-    return ((val & 0xFF000000) >> 24) |
-           ((val & 0x00FF0000) >> 8) |
-           ((val & 0x0000FF00) << 8) |
-           ((val & 0x000000FF) << 24);
-}
-
-/**
- * @brief Swap bytes in 16-bit value
- *
- * Converts between little-endian and big-endian representation.
- *
- * @param val Value to swap
- * @return Byte-swapped value
- */
-static uint16_t swap16(uint16_t val) {
-    return ((val & 0xFF00) >> 8) |
-           ((val & 0x00FF) << 8);
-}
-
-#else
-#define NEED_ENDIAN_SWAP 0
-#endif
-
-/** @} */ /* end of vm_endian */
-
 /**
  * @addtogroup vm_memory
  * @{
@@ -85,13 +38,10 @@ static uint16_t swap16(uint16_t val) {
  * @return 32-bit value in host byte order
  */
 uint32_t c32_read_word(const uint8_t *addr) {
-    uint32_t val;
-    c32_memcpy(&val, addr, 4);
-#if NEED_ENDIAN_SWAP
-    return swap32(val);
-#else
-    return val;
-#endif
+    return (uint32_t)addr[0] |
+           ((uint32_t)addr[1] << 8) |
+           ((uint32_t)addr[2] << 16) |
+           ((uint32_t)addr[3] << 24);
 }
 
 /**
@@ -104,13 +54,7 @@ uint32_t c32_read_word(const uint8_t *addr) {
  * @return 16-bit value in host byte order
  */
 uint16_t c32_read_half(const uint8_t *addr) {
-    uint16_t val;
-    c32_memcpy(&val, addr, 2);
-#if NEED_ENDIAN_SWAP
-    return swap16(val);
-#else
-    return val;
-#endif
+    return (uint16_t)(addr[0] | (addr[1] << 8));
 }
 
 /**
@@ -135,12 +79,10 @@ uint8_t c32_read_byte(const uint8_t *addr) {
  * @param value 32-bit value in host byte order
  */
 void c32_write_word(uint8_t *addr, uint32_t value) {
-#if NEED_ENDIAN_SWAP
-    uint32_t val = swap32(value);
-    c32_memcpy(addr, &val, 4);
-#else
-    c32_memcpy(addr, &value, 4);
-#endif
+    addr[0] = (uint8_t)value;
+    addr[1] = (uint8_t)(value >> 8);
+    addr[2] = (uint8_t)(value >> 16);
+    addr[3] = (uint8_t)(value >> 24);
 }
 
 /**
@@ -153,12 +95,8 @@ void c32_write_word(uint8_t *addr, uint32_t value) {
  * @param value 16-bit value in host byte order
  */
 void c32_write_half(uint8_t *addr, uint16_t value) {
-#if NEED_ENDIAN_SWAP
-    uint16_t val = swap16(value);
-    c32_memcpy(addr, &val, 2);
-#else
-    c32_memcpy(addr, &value, 2);
-#endif
+    addr[0] = (uint8_t)value;
+    addr[1] = (uint8_t)(value >> 8);
 }
 
 /**
@@ -210,20 +148,70 @@ void c32_vm_init(c32_vm_t *vm, uint8_t *memory, uint32_t memory_size) {
     vm->page_table_base = 0;
     vm->num_pages = 0;
 
+    /* No decoded instruction cache until the host attaches one */
+    vm->icache = NULL;
+    vm->icache_mask = 0;
+    for (i = 0; i < C32_FUSE_COUNT; i++) {
+        vm->fusion_hits[i] = 0;
+    }
+
+    for (i = 0; i < C32_TLB_ENTRIES; i++) {
+        vm->itlb[i].source = 0;
+        vm->dtlb[i].source = 0;
+    }
+    for (i = 0; i < C32_STLB_ENTRIES; i++) {
+        vm->stlb[i].source = 0;
+    }
+    c32_vm_tlb_flush(vm);
+
+    /* No write watch until the host attaches one */
+    vm->watch_map = NULL;
+    vm->watch_size = 0;
+    vm->watch_shift = 0;
+    vm->watch_hit = 0;
+
+    /* No dirty tracking until the host attaches a map */
+    vm->dirty_map = NULL;
+
+    /* No profile or trace until the host attaches one */
+    vm->profile = NULL;
+    vm->trace = NULL;
+
+    /* SYSCALL halts until the host attaches a handler */
+    vm->syscall_handler = NULL;
+    vm->syscall_ctx = NULL;
+
+    /* Nothing above RAM until the host attaches devices */
+    vm->devices = NULL;
+    vm->num_devices = 0;
+
     /* Clear interrupt state */
     vm->interrupts.enabled = 0;
-    for (i = 0; i < 32; i++) {
+    for (i = 0; i < 8; i++) {
         vm->interrupts.pending[i] = 0;
     }
+    vm->interrupts.pending_summary = 0;
     vm->interrupts.saved_pc = 0;
     vm->interrupts.saved_regs_addr = 0;
+
+    /* Register frames go to guest memory until the host enables banks */
+    vm->interrupts.shadow_count = 0;
+    vm->interrupts.shadow_depth = 0;
+    vm->interrupts.shadow_spilled = 0;
+    c32_memset(vm->interrupts.shadow, 0, sizeof(vm->interrupts.shadow));
+
+    /* Timer stopped until kernel code or the host programs it */
+    c32_vm_set_timer(vm, 0, 0);
+
+    c32_vm_reset_stats(vm);
 }
 
 /**
  * @brief Reset virtual machine to initial state
  *
  * Clears all registers, sets PC to 0, enters kernel mode, disables paging,
- * and stops execution. Does not clear interrupt state or modify memory.
+ * and stops execution. Does not clear interrupt state or modify memory,
+ * except that no shadow bank is in use afterwards.
  *
  * @param vm Pointer to VM structure
  */
@@ -238,433 +226,2176 @@ void c32_vm_reset(c32_vm_t *vm) {
     vm->running = 0;
     vm->kernel_mode = 1;
     vm->paging_enabled = 0;
+    c32_vm_tlb_flush(vm);
+    c32_vm_set_timer(vm, 0, 0);
+
+    /* No handler is running any more; the bank count stays */
+    vm->interrupts.shadow_depth = 0;
+    vm->interrupts.shadow_spilled = 0;
 }
 
 /** @} */ /* end of vm_lifecycle */
 
 /**
- * @addtogroup vm_interrupts
+ * @addtogroup vm_icache
  * @{
  */
 
 /**
- * @brief Raise software interrupt
+ * @brief Attach a decoded instruction cache
  *
- * Sets the pending bit for the specified interrupt number in the interrupt
- * pending bitmap. The interrupt will be dispatched before the next instruction
- * if interrupts are globally enabled.
+ * Rounds the entry count down to a power of two so that lookups can use
+ * a simple mask of the physical PC, then flushes every entry.
  *
  * @param vm Pointer to VM structure
- * @param int_num Interrupt number (0-255)
+ * @param entries Caller-supplied entry buffer (NULL, or fewer than two
+ *                entries, disables the cache)
+ * @param num_entries Number of entries in buffer
  */
-void c32_raise_interrupt(c32_vm_t *vm, uint8_t int_num) {
-    uint8_t byte_idx = int_num / 8;
-    uint8_t bit_idx = int_num % 8;
+void c32_vm_set_icache(c32_vm_t *vm, c32_icache_entry_t *entries, uint32_t num_entries) {
+    uint32_t count = 1;
+
+    if (!entries || num_entries < 2) {
+        vm->icache = NULL;
+        vm->icache_mask = 0;
+        return;
+    }
 
-    if (byte_idx < 32) {
-        vm->interrupts.pending[byte_idx] |= (1 << bit_idx);
+    /* Largest power of two not exceeding num_entries */
+    while (count <= num_entries / 2) {
+        count *= 2;
     }
+
+    vm->icache = entries;
+    vm->icache_mask = count - 1;
+    c32_vm_icache_flush(vm);
 }
 
 /**
- * @brief Set interrupt handler address
+ * @brief Tag marking the cache entry at index as empty
  *
- * Writes the handler address to the Interrupt Vector Table (IVT) in guest
- * memory. The IVT is located at physical address 0x00000000, with each entry
- * occupying 8 bytes (handler address at offset int_num * 8).
+ * The fetch fast path takes any entry whose tag equals the PC, so an empty
+ * tag must be a value no PC indexing that entry can have. That holds for
+ * C32_ICACHE_INVALID everywhere except in the last entry, the one a PC of
+ * 0xFFFFFFFF maps to; it is given C32_ICACHE_INVALID - 8, which maps to
+ * the entry before it. Both are misaligned, so neither matches a valid
+ * entry's PC.
+ *
+ * @param vm Pointer to VM structure (cache of at least two entries)
+ * @param index Entry index
+ * @return Empty tag for the entry
+ */
+static uint32_t icache_empty_tag(const c32_vm_t *vm, uint32_t index) {
+    return index == vm->icache_mask ? C32_ICACHE_INVALID - 8 : C32_ICACHE_INVALID;
+}
+
+/**
+ * @brief Flush the entire decoded instruction cache
  *
  * @param vm Pointer to VM structure
- * @param int_num Interrupt number (0-255)
- * @param handler_addr Physical address of interrupt handler routine
  */
-void c32_set_interrupt_handler(c32_vm_t *vm, uint8_t int_num, uint32_t handler_addr) {
-    uint32_t ivt_offset;
+void c32_vm_icache_flush(c32_vm_t *vm) {
+    uint32_t i;
 
-    /* Calculate byte offset in guest memory: int_num * 8 */
-    /* Note: int_num is uint8_t, so no need to check >= 256 */
-    ivt_offset = (uint32_t)int_num * 8;
+    if (!vm->icache) {
+        return;
+    }
 
-    /* Write handler address to guest memory (little-endian) */
-    if (ivt_offset + 4 <= vm->memory_size) {
-        c32_write_word(vm->memory + ivt_offset, handler_addr);
+    for (i = 0; i <= vm->icache_mask; i++) {
+        vm->icache[i].tag = icache_empty_tag(vm, i);
     }
 }
 
-/** @} */ /* end of vm_interrupts */
+/**
+ * @brief Invalidate cached instructions overlapping a physical range
+ *
+ * Every 8-byte instruction slot touched by the range, plus the slot
+ * before it (which may be fused with the first one), is checked against
+ * its cache entry. Ranges covering more slots than the cache holds are
+ * handled with a full flush instead.
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical start address of modified range
+ * @param size Size of modified range in bytes
+ */
+void c32_vm_icache_invalidate(c32_vm_t *vm, uint32_t phys_addr, uint32_t size) {
+    uint32_t slot, last;
+
+    if (!vm->icache || size == 0) {
+        return;
+    }
+
+    slot = phys_addr & ~(uint32_t)0x7;
+    last = (phys_addr + size - 1) & ~(uint32_t)0x7;
+    if (slot >= 8) {
+        slot -= 8;
+    }
+
+    /* Large or wrapping range - cheaper to drop everything */
+    if (last < slot || ((last - slot) >> 3) >= vm->icache_mask) {
+        c32_vm_icache_flush(vm);
+        return;
+    }
+
+    for (;;) {
+        uint32_t index = (slot >> 3) & vm->icache_mask;
+        if (vm->icache[index].tag == slot) {
+            vm->icache[index].tag = icache_empty_tag(vm, index);
+        }
+        if (slot == last) {
+            break;
+        }
+        slot += 8;
+    }
+}
+
+/** @} */ /* end of vm_icache */
 
 /**
- * @defgroup vm_helpers Internal Helper Functions
- * @brief Private helper functions for VM implementation
+ * @addtogroup vm_tlb
  * @{
  */
 
 /**
- * @brief Check for pending interrupts and dispatch if enabled
- *
- * Scans the interrupt pending bitmap for the highest priority pending interrupt.
- * If interrupts are enabled and a pending interrupt is found, performs the
- * following dispatch sequence:
- * 1. Clears the pending bit
- * 2. Saves current PC to saved_pc
- * 3. Switches to kernel mode
- * 4. Saves all registers (R0-R31) to stack
- * 5. Disables interrupts
- * 6. Loads interrupt number into R4
- * 7. Reads handler address from IVT and jumps to it
+ * @brief Flush the instruction and data TLBs
  *
  * @param vm Pointer to VM structure
- * @return 1 if interrupt dispatched, 0 if no interrupts pending, -1 on error
  */
-static int check_interrupts(c32_vm_t *vm) {
-    uint8_t int_num;
-    uint8_t byte_idx, bit_idx;
-    uint32_t ivt_offset, handler_addr;
+void c32_vm_tlb_flush(c32_vm_t *vm) {
     uint32_t i;
 
-    /* Only process interrupts if enabled */
-    if (!vm->interrupts.enabled) {
-        return 0;
+    for (i = 0; i < C32_TLB_ENTRIES; i++) {
+        vm->itlb[i].vpn = C32_TLB_INVALID;
+        vm->dtlb[i].vpn = C32_TLB_INVALID;
+    }
+    for (i = 0; i < C32_STLB_ENTRIES; i++) {
+        vm->stlb[i].vpn = C32_TLB_INVALID;
     }
 
-    /* Scan pending interrupt bits (priority order: 0-255) */
-    for (int_num = 0; int_num < 255; int_num++) {
-        byte_idx = int_num / 8;
-        bit_idx = int_num % 8;
-
-        if (vm->interrupts.pending[byte_idx] & (1 << bit_idx)) {
-            /* Found pending interrupt - dispatch it */
-
-            /* Clear the pending bit */
-            vm->interrupts.pending[byte_idx] &= ~(1 << bit_idx);
+    /* Nothing cached: tlb_store() has no two-level entries to search */
+    vm->tlb_source_low = 0xFFFFFFFF;
+    vm->tlb_source_high = 0;
+}
 
-            /* Save current PC */
-            vm->interrupts.saved_pc = vm->pc;
+/** @} */ /* end of vm_tlb */
 
-            /* Switch to kernel mode */
-            vm->kernel_mode = 1;
+/**
+ * @addtogroup vm_watch
+ * @{
+ */
 
-            /* Save all registers to stack (R29 is stack pointer) */
-            /* Stack grows downward, allocate 128 bytes (32 regs × 4 bytes) */
-            vm->regs[29] -= 128;
-            vm->interrupts.saved_regs_addr = vm->regs[29];
+/**
+ * @brief Attach a write watch map
+ *
+ * @param vm Pointer to VM structure
+ * @param map Caller-supplied map (NULL disables watching)
+ * @param size Number of bytes in map
+ * @param shift log2 of the granule size in bytes
+ */
+void c32_vm_set_write_watch(c32_vm_t *vm, uint8_t *map, uint32_t size, uint8_t shift) {
+    vm->watch_map = map;
+    vm->watch_size = map ? size : 0;
+    vm->watch_shift = shift;
+    vm->watch_hit = 0;
+}
 
-            /* Save R0-R31 to guest memory stack */
-            if (vm->interrupts.saved_regs_addr + 128 <= vm->memory_size) {
-                for (i = 0; i < 32; i++) {
-                    c32_write_word(vm->memory + vm->interrupts.saved_regs_addr + (i * 4),
-                                   vm->regs[i]);
-                }
-            }
+/** @} */ /* end of vm_watch */
 
-            /* Disable interrupts */
-            vm->interrupts.enabled = 0;
+/**
+ * @addtogroup vm_snapshot
+ * @{
+ */
 
-            /* Put interrupt number in R4 (a0) */
-            vm->regs[4] = int_num;
+/**
+ * @brief Capture VM state and guest memory
+ *
+ * @param vm Pointer to VM structure
+ * @param snap Snapshot to fill
+ * @param image Buffer receiving a copy of guest memory
+ * @param image_size Size of image buffer in bytes
+ * @return 0 on success, -1 if image is smaller than guest memory
+ */
+int c32_vm_snapshot(const c32_vm_t *vm, c32_snapshot_t *snap,
+                    uint8_t *image, uint32_t image_size) {
+    if (image_size < vm->memory_size) {
+        return -1;
+    }
 
-            /* Read handler address from IVT */
-            ivt_offset = (uint32_t)int_num * 8;
-            if (ivt_offset + 4 <= vm->memory_size) {
-                handler_addr = c32_read_word(vm->memory + ivt_offset);
-                vm->pc = handler_addr;
-            } else {
-                /* No valid handler - halt */
-                vm->running = 0;
-                return -1;
-            }
+    c32_memcpy(image, vm->memory, vm->memory_size);
+    c32_memcpy(&snap->state, vm, sizeof(c32_vm_t));
+    snap->state.memory = image;
+    snap->image = image;
+    return 0;
+}
 
-            return 1; /* Interrupt dispatched */
-        }
+/**
+ * @brief Restore VM state and copy the snapshot image into guest memory
+ *
+ * @param vm Pointer to initialized VM structure
+ * @param snap Snapshot to restore
+ * @param memory Guest memory buffer (at least state.memory_size bytes)
+ */
+void c32_vm_restore(c32_vm_t *vm, const c32_snapshot_t *snap, uint8_t *memory) {
+    if (memory != snap->image) {
+        c32_memcpy(memory, snap->image, snap->state.memory_size);
     }
-
-    return 0; /* No interrupts pending */
+    c32_vm_restore_state(vm, snap, memory);
 }
 
 /**
- * @brief Translate virtual address to physical address
+ * @brief Restore VM state over memory that already holds the image
  *
- * Performs virtual to physical address translation using the page table.
- * Kernel mode bypasses translation. User mode requires valid page table entries
- * with appropriate permissions.
+ * Host attachments of vm survive; the decoded instruction cache is
+ * flushed since it may describe different code.
  *
- * Page Table Entry (PTE) format (32 bits):
- * - Bits [31:12]: Physical page number
- * - Bit 3: U (User accessible)
- * - Bit 2: X (Executable)
- * - Bit 1: W (Writable)
- * - Bit 0: V (Valid)
+ * @param vm Pointer to initialized VM structure
+ * @param snap Snapshot to restore
+ * @param memory Guest memory whose contents equal snap->image
+ */
+void c32_vm_restore_state(c32_vm_t *vm, const c32_snapshot_t *snap, uint8_t *memory) {
+    c32_icache_entry_t *icache = vm->icache;
+    uint32_t icache_mask = vm->icache_mask;
+    uint8_t *watch_map = vm->watch_map;
+    uint32_t watch_size = vm->watch_size;
+    uint8_t watch_shift = vm->watch_shift;
+    uint32_t *dirty_map = vm->dirty_map;
+    c32_profile_t *profile = vm->profile;
+    c32_trace_t *trace = vm->trace;
+    c32_syscall_handler_t syscall_handler = vm->syscall_handler;
+    void *syscall_ctx = vm->syscall_ctx;
+    const c32_device_t *devices = vm->devices;
+    uint32_t num_devices = vm->num_devices;
+
+    c32_memcpy(vm, &snap->state, sizeof(c32_vm_t));
+    vm->memory = memory;
+    vm->icache = icache;
+    vm->icache_mask = icache_mask;
+    vm->watch_map = watch_map;
+    vm->watch_size = watch_size;
+    vm->watch_shift = watch_shift;
+    vm->watch_hit = 0;
+    vm->dirty_map = dirty_map;
+    vm->profile = profile;
+    vm->trace = trace;
+    vm->syscall_handler = syscall_handler;
+    vm->syscall_ctx = syscall_ctx;
+    vm->devices = devices;
+    vm->num_devices = num_devices;
+    c32_vm_icache_flush(vm);
+
+    /* All of memory may have changed */
+    if (dirty_map && vm->memory_size) {
+        c32_vm_dirty_mark(vm, 0, vm->memory_size);
+    }
+}
+
+/** @} */ /* end of vm_snapshot */
+
+/**
+ * @addtogroup vm_stats
+ * @{
+ */
+
+/**
+ * @brief Copy the VM's counters
  *
- * Raises interrupt 8 (page fault) on:
- * - Invalid page number
- * - Invalid page table address
- * - Valid bit not set
- * - User bit not set in user mode
- * - Write to non-writable page
- * - Execute from non-executable page
+ * @param vm Pointer to VM structure
+ * @param stats Receives the counters (zeroed if counters are compiled out)
+ * @return 0 on success, -1 if the core was built without C32_ENABLE_STATS
+ */
+int c32_vm_get_stats(const c32_vm_t *vm, c32_stats_t *stats) {
+#ifdef C32_ENABLE_STATS
+    c32_memcpy(stats, &vm->stats, sizeof(c32_stats_t));
+    return 0;
+#else
+    (void)vm;
+    c32_memset(stats, 0, sizeof(c32_stats_t));
+    return -1;
+#endif
+}
+
+/**
+ * @brief Clear the VM's counters
  *
  * @param vm Pointer to VM structure
- * @param vaddr Virtual address to translate
- * @param is_write 1 if this is a write access, 0 for read
- * @param is_exec 1 if this is an instruction fetch, 0 for data access
- * @return Physical address, or 0xFFFFFFFF on page fault
  */
-static uint32_t translate_address(c32_vm_t *vm, uint32_t vaddr, int is_write, int is_exec) {
-    uint32_t page_num, page_offset, pte_addr, pte, phys_page, phys_addr;
-    uint8_t valid, user, writable, executable;
+void c32_vm_reset_stats(c32_vm_t *vm) {
+#ifdef C32_ENABLE_STATS
+    c32_memset(&vm->stats, 0, sizeof(c32_stats_t));
+#else
+    (void)vm;
+#endif
+}
 
-    /* Kernel mode bypasses paging */
-    if (vm->kernel_mode) {
-        return vaddr;
+/** @} */ /* end of vm_stats */
+
+/**
+ * @addtogroup vm_profile
+ * @{
+ */
+
+/**
+ * @brief Initialize a profile over caller-supplied histograms
+ *
+ * @param prof Profile to initialize
+ * @param samples Sample counters (num_buckets entries)
+ * @param calls Call counters (num_buckets entries), or NULL
+ * @param num_buckets Number of buckets
+ * @param base PC of the start of bucket 0
+ * @param shift log2 of the bucket size in bytes
+ */
+void c32_profile_init(c32_profile_t *prof, uint32_t *samples, uint32_t *calls,
+                      uint32_t num_buckets, uint32_t base, uint8_t shift) {
+    prof->samples = samples;
+    prof->calls = calls;
+    prof->num_buckets = num_buckets;
+    prof->base = base;
+    prof->shift = shift;
+    prof->total = 0;
+    prof->dropped = 0;
+
+    c32_memset(samples, 0, num_buckets * sizeof(uint32_t));
+    if (calls) {
+        c32_memset(calls, 0, num_buckets * sizeof(uint32_t));
     }
+}
 
-    /* Paging disabled - direct mapping */
-    if (!vm->paging_enabled) {
-        return vaddr;
+/**
+ * @brief Record one PC sample
+ *
+ * @param prof Profile
+ * @param pc Sampled program counter
+ */
+void c32_profile_sample(c32_profile_t *prof, uint32_t pc) {
+    uint32_t bucket = (pc - prof->base) >> prof->shift;
+
+    if (pc >= prof->base && bucket < prof->num_buckets) {
+        prof->samples[bucket]++;
+        prof->total++;
+    } else {
+        prof->dropped++;
     }
+}
 
-    /* Extract page number and offset */
-    page_num = vaddr >> 12;          /* Bits [31:12] */
-    page_offset = vaddr & 0x0FFF;    /* Bits [11:0] */
+/**
+ * @brief Attach a profile to receive call counts (NULL detaches)
+ *
+ * @param vm Pointer to VM structure
+ * @param prof Profile, or NULL
+ */
+void c32_vm_set_profile(c32_vm_t *vm, c32_profile_t *prof) {
+    vm->profile = prof;
+}
 
-    /* Check page number bounds */
-    if (page_num >= vm->num_pages) {
-        /* Page fault: out of bounds */
-        c32_raise_interrupt(vm, 8);
-        return 0xFFFFFFFF; /* Invalid address marker */
-    }
+/** @} */ /* end of vm_profile */
 
-    /* Read PTE from page table */
-    pte_addr = vm->page_table_base + (page_num * 4);
-    if (pte_addr + 4 > vm->memory_size) {
-        /* Page fault: invalid page table */
-        c32_raise_interrupt(vm, 8);
-        return 0xFFFFFFFF;
+/**
+ * @addtogroup vm_trace
+ * @{
+ */
+
+/**
+ * @brief Initialize a trace ring over a caller-supplied record buffer
+ *
+ * @param trace Ring to initialize
+ * @param records Record storage
+ * @param num_records Number of records (must be a power of two)
+ * @return 0 on success, -1 if num_records is not a power of two
+ */
+int c32_trace_init(c32_trace_t *trace, c32_trace_record_t *records, uint32_t num_records) {
+    if (num_records == 0 || (num_records & (num_records - 1)) != 0) {
+        return -1;
     }
 
-    pte = c32_read_word(vm->memory + pte_addr);
+    trace->records = records;
+    trace->mask = num_records - 1;
+    trace->head = 0;
+    trace->tail = 0;
+    trace->lost = 0;
+    return 0;
+}
 
-    /* Extract PTE fields */
-    phys_page = pte & 0xFFFFF000;    /* Bits [31:12] */
-    user = (pte >> 3) & 1;           /* Bit 3 */
-    executable = (pte >> 2) & 1;     /* Bit 2 */
-    writable = (pte >> 1) & 1;       /* Bit 1 */
-    valid = pte & 1;                 /* Bit 0 */
+/**
+ * @brief Get the oldest undrained records
+ *
+ * @param trace Ring
+ * @param chunk Receives a pointer to the first undrained record
+ * @return Number of contiguous records at *chunk (0 if the ring is empty)
+ */
+uint32_t c32_trace_peek(const c32_trace_t *trace, const c32_trace_record_t **chunk) {
+    uint32_t start = trace->tail & trace->mask;
+    uint32_t pending = trace->head - trace->tail;
+    uint32_t to_end = trace->mask + 1 - start;
 
-    /* Check valid bit */
-    if (!valid) {
-        /* Page fault: invalid page */
-        c32_raise_interrupt(vm, 8);
-        return 0xFFFFFFFF;
-    }
+    *chunk = &trace->records[start];
+    return pending < to_end ? pending : to_end;
+}
+
+/**
+ * @brief Mark records returned by c32_trace_peek() as drained
+ *
+ * @param trace Ring
+ * @param count Number of records to drop from the tail
+ */
+void c32_trace_consume(c32_trace_t *trace, uint32_t count) {
+    trace->tail += count;
+}
+
+/**
+ * @brief Attach a trace ring (NULL detaches)
+ *
+ * @param vm Pointer to VM structure
+ * @param trace Ring, or NULL
+ */
+void c32_vm_set_trace(c32_vm_t *vm, c32_trace_t *trace) {
+    vm->trace = trace;
+}
+
+/** @} */ /* end of vm_trace */
+
+/**
+ * @addtogroup vm_syscall
+ * @{
+ */
+
+/**
+ * @brief Attach a host syscall handler (NULL restores halting)
+ *
+ * @param vm Pointer to VM structure
+ * @param handler Handler, or NULL
+ * @param ctx Context pointer passed to every call
+ */
+void c32_vm_set_syscall_handler(c32_vm_t *vm, c32_syscall_handler_t handler, void *ctx) {
+    vm->syscall_handler = handler;
+    vm->syscall_ctx = ctx;
+}
+
+/** @} */ /* end of vm_syscall */
+
+/**
+ * @addtogroup vm_interrupts
+ * @{
+ */
+
+/**
+ * @brief Raise software interrupt
+ *
+ * Sets the pending bit for the specified interrupt number in the interrupt
+ * pending bitmap and marks its word in the summary. The interrupt will be
+ * dispatched before the next instruction if interrupts are globally enabled.
+ *
+ * @param vm Pointer to VM structure
+ * @param int_num Interrupt number (0-255)
+ */
+void c32_raise_interrupt(c32_vm_t *vm, uint8_t int_num) {
+    uint32_t word_idx = int_num >> 5;
+    uint32_t bit_idx = int_num & 31;
+
+    vm->interrupts.pending[word_idx] |= (uint32_t)1 << bit_idx;
+    vm->interrupts.pending_summary |= (uint32_t)1 << word_idx;
+}
+
+/**
+ * @brief Clear a pending interrupt
+ *
+ * Clears the pending bit, and the summary bit if its word empties.
+ *
+ * @param vm Pointer to VM structure
+ * @param int_num Interrupt number (0-255)
+ */
+void c32_clear_interrupt(c32_vm_t *vm, uint8_t int_num) {
+    uint32_t word_idx = int_num >> 5;
+    uint32_t bit_idx = int_num & 31;
+
+    vm->interrupts.pending[word_idx] &= ~((uint32_t)1 << bit_idx);
+    if (vm->interrupts.pending[word_idx] == 0) {
+        vm->interrupts.pending_summary &= ~((uint32_t)1 << word_idx);
+    }
+}
+
+/**
+ * @brief Set interrupt handler address
+ *
+ * Writes the handler address to the Interrupt Vector Table (IVT) in guest
+ * memory. The IVT is located at physical address 0x00000000, with each entry
+ * occupying 8 bytes (handler address at offset int_num * 8).
+ *
+ * @param vm Pointer to VM structure
+ * @param int_num Interrupt number (0-255)
+ * @param handler_addr Physical address of interrupt handler routine
+ */
+void c32_set_interrupt_handler(c32_vm_t *vm, uint8_t int_num, uint32_t handler_addr) {
+    uint32_t ivt_offset;
+
+    /* Calculate byte offset in guest memory: int_num * 8 */
+    /* Note: int_num is uint8_t, so no need to check >= 256 */
+    ivt_offset = (uint32_t)int_num * 8;
+
+    /* Write handler address to guest memory (little-endian) */
+    if (ivt_offset + 4 <= vm->memory_size) {
+        c32_write_word(vm->memory + ivt_offset, handler_addr);
+        c32_vm_host_write(vm, ivt_offset, 4);
+    }
+}
+
+/**
+ * @brief Enter interrupts through shadow register banks
+ *
+ * @param vm Pointer to VM structure
+ * @param count Banks to use (0 restores the memory frame for every entry)
+ * @return 0 on success, -1 if count exceeds C32_SHADOW_BANKS or a banked
+ *         handler is running
+ */
+int c32_vm_set_shadow_banks(c32_vm_t *vm, uint32_t count) {
+    if (count > C32_SHADOW_BANKS || vm->interrupts.shadow_depth > 0) {
+        return -1;
+    }
+    vm->interrupts.shadow_count = count;
+    vm->interrupts.shadow_spilled = 0;
+    return 0;
+}
+
+/** @} */ /* end of vm_interrupts */
+
+/**
+ * @defgroup vm_helpers Internal Helper Functions
+ * @brief Private helper functions for VM implementation
+ * @{
+ */
+
+/**
+ * @brief First dispatch handler index used for fused pairs
+ *
+ * Handler C32_HANDLER_FUSED + k runs fusion kind k (c32_fusion_t). The
+ * range is unused by the instruction set, so decode_instruction() sends
+ * guest opcodes in it to C32_HANDLER_ILLEGAL.
+ */
+#define C32_HANDLER_FUSED 0x80
+
+/** @brief Unassigned handler index that dispatches to the illegal handler */
+#define C32_HANDLER_ILLEGAL (C32_HANDLER_FUSED + C32_FUSE_COUNT)
+
+/** @brief Fused pair dispatch handler indices */
+#define FUSED_LUI_ORI   (C32_HANDLER_FUSED + C32_FUSE_LUI_ORI)
+#define FUSED_SLT_BEQ   (C32_HANDLER_FUSED + C32_FUSE_SLT_BEQ)
+#define FUSED_SLT_BNE   (C32_HANDLER_FUSED + C32_FUSE_SLT_BNE)
+#define FUSED_SLTU_BEQ  (C32_HANDLER_FUSED + C32_FUSE_SLTU_BEQ)
+#define FUSED_SLTU_BNE  (C32_HANDLER_FUSED + C32_FUSE_SLTU_BNE)
+#define FUSED_ADDI_BEQ  (C32_HANDLER_FUSED + C32_FUSE_ADDI_BEQ)
+#define FUSED_ADDI_BNE  (C32_HANDLER_FUSED + C32_FUSE_ADDI_BNE)
+
+/**
+ * @brief Bump an execution counter (no code unless C32_ENABLE_STATS)
+ */
+#ifdef C32_ENABLE_STATS
+#define VM_COUNT(counter) ((void)(vm->stats.counter++))
+#else
+#define VM_COUNT(counter) ((void)0)
+#endif
+
+/**
+ * @brief True if width bytes at phys lie in RAM
+ *
+ * Written so it cannot wrap near the top of the address space; also false
+ * for the 0xFFFFFFFF translation fault marker.
+ */
+#define RAM_FITS(vm, phys, width) \
+    ((vm)->memory_size >= (width) && (phys) <= (vm)->memory_size - (width))
+
+/**
+ * @brief Count a call to target in the attached profile
+ *
+ * @param prof Attached profile
+ * @param target Call target PC
+ */
+static void profile_call(c32_profile_t *prof, uint32_t target) {
+    uint32_t bucket = (target - prof->base) >> prof->shift;
+
+    if (!prof->calls) {
+        return;
+    }
+    if (target >= prof->base && bucket < prof->num_buckets) {
+        prof->calls[bucket]++;
+    } else {
+        prof->dropped++;
+    }
+}
+
+/**
+ * @brief Append a trace record for an instruction about to execute
+ *
+ * Loads and stores read their base register before writing anything, so
+ * the effective address can be computed here from the current registers.
+ *
+ * @param vm Pointer to VM structure
+ * @param pc Virtual address of the instruction
+ * @param inst Decoded instruction
+ */
+static void trace_instruction(c32_vm_t *vm, uint32_t pc, const c32_icache_entry_t *inst) {
+    c32_trace_t *trace = vm->trace;
+    c32_trace_record_t *rec = &trace->records[trace->head & trace->mask];
+
+    rec->pc = pc;
+    rec->opcode = inst->opcode;
+    rec->rs = inst->rs;
+    rec->rt = inst->rt;
+    rec->rd = inst->rd;
+    rec->imm = inst->imm;
+    switch (inst->opcode) {
+        case OP_LW: case OP_LH: case OP_LHU: case OP_LB: case OP_LBU:
+        case OP_SW: case OP_SH: case OP_SB:
+            rec->addr = vm->regs[inst->rs & 0x1F] + inst->imm;
+            break;
+        default:
+            rec->addr = 0;
+            break;
+    }
+
+    /* Overwrite the oldest record when full */
+    if (++trace->head - trace->tail > trace->mask + 1) {
+        trace->tail++;
+        trace->lost++;
+    }
+}
+
+/**
+ * @brief Flag a guest store that touches a watched granule
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical address of the store
+ * @param size Store size in bytes (non-zero)
+ */
+static void watch_store(c32_vm_t *vm, uint32_t phys_addr, uint32_t size) {
+    uint32_t first = phys_addr >> vm->watch_shift;
+    uint32_t last = (phys_addr + size - 1) >> vm->watch_shift;
+
+    for (; first <= last && first < vm->watch_size; first++) {
+        if (vm->watch_map[first]) {
+            vm->watch_hit = 1;
+            return;
+        }
+    }
+}
+
+/**
+ * @brief Set the dirty bits of the pages a write into RAM touches
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical address of the write (inside RAM)
+ * @param size Write size in bytes (non-zero)
+ */
+static void dirty_store(c32_vm_t *vm, uint32_t phys_addr, uint32_t size) {
+    uint32_t first = phys_addr >> C32_DIRTY_PAGE_SHIFT;
+    uint32_t last = (phys_addr + size - 1) >> C32_DIRTY_PAGE_SHIFT;
+
+    for (; first <= last; first++) {
+        vm->dirty_map[first >> 5] |= (uint32_t)1 << (first & 31);
+    }
+}
+
+/**
+ * @brief Index of the lowest set bit
+ *
+ * @param value Non-zero value
+ * @return Bit number (0-31) of the least significant set bit
+ */
+static uint32_t lowest_set_bit(uint32_t value) {
+#ifdef __GNUC__
+    return (uint32_t)__builtin_ctz(value);
+#else
+    /* De Bruijn multiply on the isolated lowest bit */
+    static const uint8_t table[32] = {
+        0, 1, 28, 2, 29, 14, 24, 3, 30, 22, 20, 15, 25, 17, 4, 8,
+        31, 27, 13, 23, 21, 19, 16, 7, 26, 12, 18, 6, 11, 5, 10, 9
+    };
+    return table[((value & (0U - value)) * 0x077CB531U) >> 27];
+#endif
+}
+
+/**
+ * @brief Whether a 128-byte register frame at addr lies in guest memory
+ */
+static int frame_in_memory(const c32_vm_t *vm, uint32_t addr) {
+    return vm->memory_size >= 128 && addr <= vm->memory_size - 128;
+}
+
+/**
+ * @brief Push R0-R31 as a 128-byte frame below R29
+ *
+ * R29 is lowered first, so the saved R29 is the frame address. A frame
+ * that would wrap or leave guest memory is not written.
+ */
+static void save_frame(c32_vm_t *vm) {
+    uint32_t i;
+
+    vm->regs[29] -= 128;
+    vm->interrupts.saved_regs_addr = vm->regs[29];
+    if (!frame_in_memory(vm, vm->interrupts.saved_regs_addr)) {
+        return;
+    }
+
+    for (i = 0; i < 32; i++) {
+        c32_write_word(vm->memory + vm->interrupts.saved_regs_addr + (i * 4), vm->regs[i]);
+    }
+    c32_vm_icache_invalidate(vm, vm->interrupts.saved_regs_addr, 128);
+    if (vm->watch_map) {
+        watch_store(vm, vm->interrupts.saved_regs_addr, 128);
+    }
+    if (vm->dirty_map) {
+        dirty_store(vm, vm->interrupts.saved_regs_addr, 128);
+    }
+}
+
+/**
+ * @brief Whether interrupt entry can switch to a shadow bank
+ *
+ * Needs a free bank, no memory frame above the banked ones (so that IRET
+ * unwinds memory frames first), and no C32_IVT_SPILL in the vector.
+ */
+static int use_shadow_bank(const c32_vm_t *vm, uint32_t int_num) {
+    uint32_t ivt_offset = int_num * 8;
+
+    if (vm->interrupts.shadow_depth >= vm->interrupts.shadow_count ||
+        vm->interrupts.shadow_spilled > 0) {
+        return 0;
+    }
+    return ivt_offset + 8 > vm->memory_size ||
+           !(c32_read_word(vm->memory + ivt_offset + 4) & C32_IVT_SPILL);
+}
+
+/**
+ * @brief Restore R0-R31 and saved_pc for IRET
+ *
+ * Unwinds the innermost context: a memory frame if one is above the
+ * banks, else the innermost bank, else the frame at saved_regs_addr. The
+ * caller has already taken the return PC from saved_pc.
+ */
+static void restore_context(c32_vm_t *vm) {
+    uint32_t i;
+
+    if (vm->interrupts.shadow_spilled == 0 && vm->interrupts.shadow_depth > 0) {
+        const c32_shadow_bank_t *bank = &vm->interrupts.shadow[--vm->interrupts.shadow_depth];
+
+        for (i = 0; i < 32; i++) {
+            vm->regs[i] = bank->regs[i];
+        }
+    } else {
+        if (vm->interrupts.shadow_spilled > 0) {
+            vm->interrupts.shadow_spilled--;
+        }
+        if (frame_in_memory(vm, vm->interrupts.saved_regs_addr)) {
+            for (i = 0; i < 32; i++) {
+                vm->regs[i] = c32_read_word(vm->memory + vm->interrupts.saved_regs_addr + (i * 4));
+            }
+        }
+    }
+
+    /* GETPC in an outer banked handler sees its own saved PC again */
+    if (vm->interrupts.shadow_spilled == 0 && vm->interrupts.shadow_depth > 0) {
+        vm->interrupts.saved_pc = vm->interrupts.shadow[vm->interrupts.shadow_depth - 1].pc;
+    }
+}
+
+/**
+ * @brief Check for pending interrupts and dispatch if enabled
+ *
+ * Finds the highest priority (lowest numbered) pending interrupt with two
+ * find-first-set steps: one on the summary word, one on the selected
+ * bitmap word. If interrupts are enabled and an interrupt is pending,
+ * performs the following dispatch sequence:
+ * 1. Clears the pending bit
+ * 2. Saves current PC to saved_pc
+ * 3. Switches to kernel mode
+ * 4. Saves all registers (R0-R31) to a free shadow bank, or else to
+ *    the stack (skipped if the frame would not be in guest memory)
+ * 5. Disables interrupts
+ * 6. Loads interrupt number into R4
+ * 7. Reads handler address from IVT and jumps to it
+ *
+ * @param vm Pointer to VM structure
+ * @return 1 if interrupt dispatched, 0 if no interrupts pending, -1 on error
+ */
+static int check_interrupts(c32_vm_t *vm) {
+    uint32_t int_num;
+    uint32_t word_idx, bit_idx;
+    uint32_t ivt_offset, handler_addr;
+
+    /* Only process interrupts if enabled and something is pending */
+    if (!vm->interrupts.enabled || !vm->interrupts.pending_summary) {
+        return 0;
+    }
+
+    /* Lowest pending interrupt number (priority order: 0-255) */
+    word_idx = lowest_set_bit(vm->interrupts.pending_summary);
+    bit_idx = lowest_set_bit(vm->interrupts.pending[word_idx]);
+    int_num = (word_idx << 5) | bit_idx;
+
+    c32_clear_interrupt(vm, (uint8_t)int_num);
+
+    /* Save current PC */
+    vm->interrupts.saved_pc = vm->pc;
+
+    /* Switch to kernel mode */
+    vm->kernel_mode = 1;
+
+    if (use_shadow_bank(vm, int_num)) {
+        /* Switch banks: no guest memory traffic, R29 unchanged */
+        c32_shadow_bank_t *bank = &vm->interrupts.shadow[vm->interrupts.shadow_depth++];
+        uint32_t i;
+
+        for (i = 0; i < 32; i++) {
+            bank->regs[i] = vm->regs[i];
+        }
+        bank->pc = vm->pc;
+    } else {
+        if (vm->interrupts.shadow_count) {
+            vm->interrupts.shadow_spilled++;
+        }
+        VM_COUNT(spills);
+        save_frame(vm);
+    }
+
+    /* Disable interrupts */
+    vm->interrupts.enabled = 0;
+
+    /* Put interrupt number in R4 (a0) */
+    vm->regs[4] = int_num;
+    VM_COUNT(interrupts);
+
+    /* Read handler address from IVT */
+    ivt_offset = (uint32_t)int_num * 8;
+    if (ivt_offset + 4 <= vm->memory_size) {
+        handler_addr = c32_read_word(vm->memory + ivt_offset);
+        vm->pc = handler_addr;
+    } else {
+        /* No valid handler - halt */
+        vm->running = 0;
+        return -1;
+    }
+
+    return 1; /* Interrupt dispatched */
+}
+
+/**
+ * @brief Note that a TLB entry was read from a two-level table at addr
+ *
+ * tlb_store() only searches the TLBs for stores inside this range.
+ *
+ * @param vm Pointer to VM structure
+ * @param addr Physical address of the directory or page table entry
+ */
+static void tlb_track_source(c32_vm_t *vm, uint32_t addr) {
+    if (addr < vm->tlb_source_low) {
+        vm->tlb_source_low = addr;
+    }
+    if (addr + 4 > vm->tlb_source_high) {
+        vm->tlb_source_high = addr + 4;
+    }
+}
+
+/**
+ * @brief Find the PTE for vaddr in a two-level page table
+ *
+ * The directory at PTBR holds num_pages entries, one per 4 MB of virtual
+ * space (vaddr >> 22). A directory entry with the S bit set is a leaf
+ * mapping a 4 MB superpage: bits [31:22] are the physical frame and the
+ * U/X/W/V bits apply as in a PTE. Otherwise a valid entry's bits [31:12]
+ * locate a 4 KB table of 1024 PTEs indexed by vaddr bits [21:12].
+ *
+ * Superpage entries are kept in the superpage TLB, so a small TLB miss
+ * inside a mapped superpage is refilled without reading guest memory.
+ * A superpage is returned as the equivalent 4 KB PTE.
+ *
+ * Raises the page fault itself when the walk fails.
+ *
+ * @param vm Pointer to VM structure
+ * @param vaddr Virtual address to translate
+ * @param pte Receives the PTE (valid and permission bits unchecked)
+ * @return Physical address the PTE came from, or 0xFFFFFFFF on page fault
+ */
+static uint32_t walk_directory(c32_vm_t *vm, uint32_t vaddr, uint32_t *pte) {
+    uint32_t dir_index = vaddr >> 22;
+    c32_tlb_entry_t *stlb = &vm->stlb[dir_index & (C32_STLB_ENTRIES - 1)];
+    uint32_t pde_addr, pde, pte_addr;
+
+    if (stlb->vpn == dir_index) {
+        *pte = (stlb->pte & 0xFFC0000F) | (vaddr & 0x003FF000);
+        return stlb->source;
+    }
+
+    if (dir_index >= vm->num_pages) {
+        VM_COUNT(page_faults[C32_PF_BOUNDS]);
+        c32_raise_interrupt(vm, 8);
+        return 0xFFFFFFFF;
+    }
+
+    pde_addr = (vm->page_table_base & ~(uint32_t)C32_PTBR_TWO_LEVEL) + dir_index * 4;
+    if (!RAM_FITS(vm, pde_addr, 4)) {
+        VM_COUNT(page_faults[C32_PF_TABLE]);
+        c32_raise_interrupt(vm, 8);
+        return 0xFFFFFFFF;
+    }
+    pde = c32_read_word(vm->memory + pde_addr);
+    tlb_track_source(vm, pde_addr);
+
+    if (pde & C32_PDE_SUPER) {
+        /* Only entries that can satisfy some access are worth caching */
+        if ((pde & 0x9) == 0x9) {
+            stlb->vpn = dir_index;
+            stlb->pte = pde;
+            stlb->source = pde_addr;
+        }
+        *pte = (pde & 0xFFC0000F) | (vaddr & 0x003FF000);
+        return pde_addr;
+    }
+
+    if (!(pde & 1)) {
+        VM_COUNT(page_faults[C32_PF_INVALID]);
+        c32_raise_interrupt(vm, 8);
+        return 0xFFFFFFFF;
+    }
+
+    pte_addr = (pde & 0xFFFFF000) + ((vaddr >> 10) & 0x0FFC);
+    if (!RAM_FITS(vm, pte_addr, 4)) {
+        VM_COUNT(page_faults[C32_PF_TABLE]);
+        c32_raise_interrupt(vm, 8);
+        return 0xFFFFFFFF;
+    }
+    *pte = c32_read_word(vm->memory + pte_addr);
+    tlb_track_source(vm, pte_addr);
+    return pte_addr;
+}
+
+/**
+ * @brief Translate virtual address to physical address
+ *
+ * Performs virtual to physical address translation using the page table.
+ * Kernel mode bypasses translation. User mode requires valid page table entries
+ * with appropriate permissions.
+ *
+ * Page Table Entry (PTE) format (32 bits):
+ * - Bits [31:12]: Physical page number
+ * - Bit 3: U (User accessible)
+ * - Bit 2: X (Executable)
+ * - Bit 1: W (Writable)
+ * - Bit 0: V (Valid)
+ *
+ * Raises interrupt 8 (page fault) on:
+ * - Invalid page number
+ * - Invalid page table address
+ * - Valid bit not set
+ * - User bit not set in user mode
+ * - Write to non-writable page
+ * - Execute from non-executable page
+ *
+ * @param vm Pointer to VM structure
+ * @param vaddr Virtual address to translate
+ * @param is_write 1 if this is a write access, 0 for read
+ * @param is_exec 1 if this is an instruction fetch, 0 for data access
+ * @return Physical address, or 0xFFFFFFFF on page fault
+ */
+static uint32_t translate_address(c32_vm_t *vm, uint32_t vaddr, int is_write, int is_exec) {
+    uint32_t page_num, page_offset, pte_addr, pte, phys_page, phys_addr;
+    uint8_t valid, user, writable, executable;
+    c32_tlb_entry_t *tlb;
+    uint32_t need;
+
+    /* Kernel mode bypasses paging */
+    if (vm->kernel_mode) {
+        return vaddr;
+    }
+
+    /* Paging disabled - direct mapping */
+    if (!vm->paging_enabled) {
+        return vaddr;
+    }
+
+    /* Extract page number and offset */
+    page_num = vaddr >> 12;          /* Bits [31:12] */
+    page_offset = vaddr & 0x0FFF;    /* Bits [11:0] */
+
+    /* TLB hit with sufficient permissions skips the walk */
+    tlb = is_exec ? &vm->itlb[page_num & (C32_TLB_ENTRIES - 1)]
+                  : &vm->dtlb[page_num & (C32_TLB_ENTRIES - 1)];
+    need = is_exec ? 0x4 : (is_write ? 0x2 : 0); /* X or W bit */
+    if (tlb->vpn == page_num && (tlb->pte & need) == need) {
+        return (tlb->pte & 0xFFFFF000) | page_offset;
+    }
+
+    VM_COUNT(translations);
+
+    if (vm->page_table_base & C32_PTBR_TWO_LEVEL) {
+        pte_addr = walk_directory(vm, vaddr, &pte);
+        if (pte_addr == 0xFFFFFFFF) {
+            return 0xFFFFFFFF;
+        }
+    } else {
+        /* Check page number bounds */
+        if (page_num >= vm->num_pages) {
+            /* Page fault: out of bounds */
+            VM_COUNT(page_faults[C32_PF_BOUNDS]);
+            c32_raise_interrupt(vm, 8);
+            return 0xFFFFFFFF; /* Invalid address marker */
+        }
+
+        /* Read PTE from page table */
+        pte_addr = vm->page_table_base + (page_num * 4);
+        if (!RAM_FITS(vm, pte_addr, 4)) {
+            /* Page fault: invalid page table */
+            VM_COUNT(page_faults[C32_PF_TABLE]);
+            c32_raise_interrupt(vm, 8);
+            return 0xFFFFFFFF;
+        }
+
+        pte = c32_read_word(vm->memory + pte_addr);
+    }
+
+    /* Extract PTE fields */
+    phys_page = pte & 0xFFFFF000;    /* Bits [31:12] */
+    user = (pte >> 3) & 1;           /* Bit 3 */
+    executable = (pte >> 2) & 1;     /* Bit 2 */
+    writable = (pte >> 1) & 1;       /* Bit 1 */
+    valid = pte & 1;                 /* Bit 0 */
+
+    /* Check valid bit */
+    if (!valid) {
+        /* Page fault: invalid page */
+        VM_COUNT(page_faults[C32_PF_INVALID]);
+        c32_raise_interrupt(vm, 8);
+        return 0xFFFFFFFF;
+    }
+
+    /* Check user accessible (user mode requires U bit) */
+    if (!user) {
+        /* Page fault: not user accessible */
+        VM_COUNT(page_faults[C32_PF_USER]);
+        c32_raise_interrupt(vm, 8);
+        return 0xFFFFFFFF;
+    }
+
+    /* Remember the entry; permissions are re-checked on every hit */
+    tlb->vpn = page_num;
+    tlb->pte = pte;
+    tlb->source = pte_addr;
+
+    /* Check permissions */
+    if (is_write && !writable) {
+        /* Page fault: write to read-only page */
+        VM_COUNT(page_faults[C32_PF_WRITE]);
+        c32_raise_interrupt(vm, 8);
+        return 0xFFFFFFFF;
+    }
+
+    if (is_exec && !executable) {
+        /* Page fault: execute on non-executable page */
+        VM_COUNT(page_faults[C32_PF_EXEC]);
+        c32_raise_interrupt(vm, 8);
+        return 0xFFFFFFFF;
+    }
+
+    /* Construct physical address */
+    phys_addr = phys_page | page_offset;
+    return phys_addr;
+}
+
+/**
+ * @brief Split an 8-byte instruction into its fields
+ *
+ * @param inst Pointer to instruction bytes in guest memory
+ * @param entry Decoded instruction to fill (tag is left untouched)
+ */
+static void decode_instruction(const uint8_t *inst, c32_icache_entry_t *entry) {
+    entry->opcode = inst[0];
+    /* Only the low 5 bits of a register field select a register */
+    entry->rs = inst[1] & 0x1F;
+    entry->rt = inst[2] & 0x1F;
+    entry->rd = inst[3] & 0x1F;
+    entry->imm = c32_read_word(inst + 4);
+    entry->handler = entry->opcode;
+
+    /* Side-effect-free writes to R0 would be discarded anyway */
+    switch (entry->opcode) {
+        case OP_ADD: case OP_ADDU: case OP_SUB: case OP_SUBU:
+        case OP_AND: case OP_OR: case OP_XOR: case OP_NOR:
+        case OP_SLL: case OP_SRL: case OP_SRA:
+        case OP_SLLV: case OP_SRLV: case OP_SRAV:
+        case OP_SLT: case OP_SLTU:
+        case OP_MUL: case OP_MULH: case OP_MULHU:
+        case OP_DIV: case OP_DIVU: case OP_REM: case OP_REMU:
+            if (entry->rd == 0) {
+                entry->handler = OP_NOP;
+            }
+            break;
+        case OP_ADDI: case OP_ADDIU:
+        case OP_ANDI: case OP_ORI: case OP_XORI: case OP_LUI:
+        case OP_SLTI: case OP_SLTIU:
+            if (entry->rt == 0) {
+                entry->handler = OP_NOP;
+            }
+            break;
+        default:
+            /* A guest opcode must not select a fused pair handler */
+            if (entry->opcode >= C32_HANDLER_FUSED &&
+                entry->opcode < C32_HANDLER_FUSED + C32_FUSE_COUNT) {
+                entry->handler = C32_HANDLER_ILLEGAL;
+            }
+            break;
+    }
+}
+
+/**
+ * @brief Fuse a freshly cached instruction with its successor
+ *
+ * Recognizes the pairs listed in c32_fusion_t. On a match the entry's
+ * handler is replaced by the fused handler and the successor is cached
+ * in the next entry, where the fused handler reads it from. Pairs that
+ * cross a page boundary are not fused because the successor may be
+ * mapped elsewhere.
+ *
+ * @param vm Pointer to VM structure
+ * @param entry Cache entry just filled (tag set)
+ */
+static void fuse_instruction(c32_vm_t *vm, c32_icache_entry_t *entry) {
+    uint32_t next_pc = entry->tag + 8;
+    c32_icache_entry_t second, *slot;
+    uint8_t dest;
+    int kind = -1;
+
+    if (vm->icache_mask == 0 || (next_pc & 0x0FFF) == 0 || !RAM_FITS(vm, next_pc, 8)) {
+        return;
+    }
+    decode_instruction(vm->memory + next_pc, &second);
+
+    switch (entry->handler) {
+        case OP_LUI:
+            if (second.handler == OP_ORI && second.rs == entry->rt) {
+                kind = C32_FUSE_LUI_ORI;
+            }
+            break;
+        case OP_SLT:
+        case OP_SLTU:
+        case OP_ADDI:
+        case OP_ADDIU:
+            dest = (entry->handler == OP_SLT || entry->handler == OP_SLTU) ?
+                   entry->rd : entry->rt;
+            if ((second.handler != OP_BEQ && second.handler != OP_BNE) ||
+                (second.rs != dest && second.rt != dest)) {
+                break;
+            }
+            if (entry->handler == OP_SLT) {
+                kind = second.handler == OP_BEQ ? C32_FUSE_SLT_BEQ : C32_FUSE_SLT_BNE;
+            } else if (entry->handler == OP_SLTU) {
+                kind = second.handler == OP_BEQ ? C32_FUSE_SLTU_BEQ : C32_FUSE_SLTU_BNE;
+            } else {
+                kind = second.handler == OP_BEQ ? C32_FUSE_ADDI_BEQ : C32_FUSE_ADDI_BNE;
+            }
+            break;
+        default:
+            break;
+    }
+    if (kind < 0) {
+        return;
+    }
+
+    entry->handler = (uint8_t)(C32_HANDLER_FUSED + kind);
+    slot = &vm->icache[(next_pc >> 3) & vm->icache_mask];
+    if (slot->tag != next_pc) {
+        *slot = second;
+        slot->tag = next_pc;
+    }
+}
+
+/**
+ * @brief Drop cached instructions overwritten by a guest store
+ *
+ * A store of at most 4 bytes touches one or two instruction slots, so
+ * only those entries need to be checked, together with the slot before
+ * them in case it was fused with the first. Larger writes go through
+ * c32_vm_icache_invalidate().
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical address of the store
+ * @param size Store size in bytes
+ */
+static void icache_store(c32_vm_t *vm, uint32_t phys_addr, uint32_t size) {
+    uint32_t first, last, index;
+
+    if (size > 4) {
+        c32_vm_icache_invalidate(vm, phys_addr, size);
+        return;
+    }
+
+    first = phys_addr & ~(uint32_t)0x7;
+    index = (first >> 3) & vm->icache_mask;
+    if (vm->icache[index].tag == first) {
+        vm->icache[index].tag = icache_empty_tag(vm, index);
+    }
+    index = ((first - 8) >> 3) & vm->icache_mask;
+    if (vm->icache[index].tag == first - 8) {
+        vm->icache[index].tag = icache_empty_tag(vm, index);
+    }
+
+    last = (phys_addr + size - 1) & ~(uint32_t)0x7;
+    if (last != first) {
+        index = (last >> 3) & vm->icache_mask;
+        if (vm->icache[index].tag == last) {
+            vm->icache[index].tag = icache_empty_tag(vm, index);
+        }
+    }
+}
+
+/**
+ * @brief Drop TLB entries whose page table entry a guest store overwrote
+ *
+ * Only called while paging is enabled; enabling paging flushes the TLBs,
+ * so stale entries cannot survive from a period with paging off. A store
+ * of at most 4 bytes touches one or two PTEs. With a two-level table the
+ * entries are matched by the address they were read from instead.
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical address of the store
+ * @param size Store size in bytes
+ */
+static void tlb_store(c32_vm_t *vm, uint32_t phys_addr, uint32_t size) {
+    uint32_t first, last, vpn, base, i;
+    int directory;
+
+    if (vm->page_table_base & C32_PTBR_TWO_LEVEL) {
+        /* Entries may come from any table; search only for stores into one */
+        if (phys_addr >= vm->tlb_source_high || phys_addr + size <= vm->tlb_source_low) {
+            return;
+        }
+
+        /* A directory store also drops the 4 KB entries found through it */
+        base = vm->page_table_base & ~(uint32_t)C32_PTBR_TWO_LEVEL;
+        directory = phys_addr + size > base &&
+                    (phys_addr < base || phys_addr - base < vm->num_pages * 4);
+        first = phys_addr < base ? 0 : (phys_addr - base) >> 2;
+        last = (phys_addr + size - 1 - base) >> 2;
+        for (i = 0; i < C32_TLB_ENTRIES; i++) {
+            if (vm->itlb[i].source - phys_addr < size ||
+                (directory && (vm->itlb[i].vpn >> 10) - first <= last - first)) {
+                vm->itlb[i].vpn = C32_TLB_INVALID;
+            }
+            if (vm->dtlb[i].source - phys_addr < size ||
+                (directory && (vm->dtlb[i].vpn >> 10) - first <= last - first)) {
+                vm->dtlb[i].vpn = C32_TLB_INVALID;
+            }
+        }
+        for (i = 0; i < C32_STLB_ENTRIES; i++) {
+            if (vm->stlb[i].source - phys_addr < size) {
+                vm->stlb[i].vpn = C32_TLB_INVALID;
+            }
+        }
+        return;
+    }
+
+    if (phys_addr < vm->page_table_base) {
+        return;
+    }
+
+    first = (phys_addr - vm->page_table_base) >> 2;
+    last = (phys_addr + size - 1 - vm->page_table_base) >> 2;
+    for (vpn = first; vpn <= last && vpn < vm->num_pages; vpn++) {
+        c32_tlb_entry_t *entry = &vm->itlb[vpn & (C32_TLB_ENTRIES - 1)];
+        if (entry->vpn == vpn) {
+            entry->vpn = C32_TLB_INVALID;
+        }
+        entry = &vm->dtlb[vpn & (C32_TLB_ENTRIES - 1)];
+        if (entry->vpn == vpn) {
+            entry->vpn = C32_TLB_INVALID;
+        }
+    }
+}
+
+/**
+ * @brief Apply the side effects of a write into RAM
+ *
+ * Drops the decoded instructions and TLB entries the write overwrote,
+ * flags watched granules, and marks the pages dirty.
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical address of the write (inside RAM)
+ * @param size Write size in bytes (non-zero)
+ */
+static void ram_written(c32_vm_t *vm, uint32_t phys_addr, uint32_t size) {
+    if (vm->icache) {
+        icache_store(vm, phys_addr, size);
+    }
+    if (vm->paging_enabled) {
+        tlb_store(vm, phys_addr, size);
+    }
+    if (vm->watch_map) {
+        watch_store(vm, phys_addr, size);
+    }
+    if (vm->dirty_map) {
+        dirty_store(vm, phys_addr, size);
+    }
+}
+
+/**
+ * @brief Find the device whose window holds a whole access
+ *
+ * @param vm Pointer to VM structure (devices attached)
+ * @param phys_addr Physical address of the access
+ * @param width Access width in bytes
+ * @return Device, or NULL if no device covers the access
+ */
+static const c32_device_t *find_device(const c32_vm_t *vm, uint32_t phys_addr, uint32_t width) {
+    uint32_t i;
+
+    for (i = 0; i < vm->num_devices; i++) {
+        const c32_device_t *dev = &vm->devices[i];
+        uint32_t offset = phys_addr - dev->base;
+
+        if (offset < dev->size && width <= dev->size - offset) {
+            return dev;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Load from a device after an access missed RAM
+ *
+ * @param vm Pointer to VM structure (devices attached)
+ * @param phys_addr Translated address, or 0xFFFFFFFF after a page fault
+ * @param width Access width in bytes
+ * @param value Receives the loaded value if a device was hit
+ * @return 1 if a device serviced the load, 0 otherwise
+ */
+static int mmio_load(c32_vm_t *vm, uint32_t phys_addr, uint32_t width, uint32_t *value) {
+    const c32_device_t *dev;
+
+    if (phys_addr == 0xFFFFFFFF) {
+        return 0;
+    }
+    dev = find_device(vm, phys_addr, width);
+    if (!dev) {
+        return 0;
+    }
+    *value = dev->read ? dev->read(vm, dev->ctx, phys_addr - dev->base, width) : 0;
+    return 1;
+}
+
+/**
+ * @brief Store to a device after an access missed RAM
+ *
+ * @param vm Pointer to VM structure (devices attached)
+ * @param phys_addr Translated address, or 0xFFFFFFFF after a page fault
+ * @param width Access width in bytes
+ * @param value Value to store (low width bytes)
+ */
+static void mmio_store(c32_vm_t *vm, uint32_t phys_addr, uint32_t width, uint32_t value) {
+    const c32_device_t *dev;
+
+    if (phys_addr == 0xFFFFFFFF) {
+        return;
+    }
+    dev = find_device(vm, phys_addr, width);
+    if (dev && dev->write) {
+        dev->write(vm, dev->ctx, phys_addr - dev->base, width, value);
+    }
+}
+
+/**
+ * @brief Read one byte of a bulk operation that left RAM
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Translated address
+ * @return The byte from RAM or a device, or 0 if nothing is mapped there
+ */
+static uint32_t bulk_load_byte(c32_vm_t *vm, uint32_t phys_addr) {
+    uint32_t value = 0;
+
+    if (phys_addr < vm->memory_size) {
+        return vm->memory[phys_addr];
+    }
+    mmio_load(vm, phys_addr, 1, &value);
+    return value & 0xFF;
+}
+
+/**
+ * @brief Write one byte of a bulk operation that left RAM
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Translated address
+ * @param value Byte to store (low 8 bits)
+ */
+static void bulk_store_byte(c32_vm_t *vm, uint32_t phys_addr, uint32_t value) {
+    if (phys_addr < vm->memory_size) {
+        vm->memory[phys_addr] = (uint8_t)value;
+        c32_vm_host_write(vm, phys_addr, 1);
+    } else {
+        mmio_store(vm, phys_addr, 1, value);
+    }
+}
+
+/**
+ * @brief Run one step of MEMCPY, MEMSET or MEMCMP
+ *
+ * A step stops at the next 4 KB boundary of either address, so each side
+ * is translated once and the bytes can be moved with the host block
+ * routines. A step that would touch anything outside RAM moves a single
+ * byte through the devices instead. The registers are advanced past the
+ * bytes done, which lets the instruction be executed again to continue:
+ * between steps interrupts are taken, and a page fault leaves the
+ * registers at the faulting byte so that IRET resumes the operation.
+ * With interrupts disabled a page fault ends the instruction instead,
+ * as a single load or store would.
+ *
+ * @param vm Pointer to VM structure
+ * @param op OP_MEMCPY, OP_MEMSET or OP_MEMCMP
+ * @param rd Destination (MEMCMP: first buffer) address register
+ * @param rs Source address (MEMSET: fill value, MEMCMP: second buffer) register
+ * @param rt Remaining length register
+ * @return 1 if the instruction is complete, 0 if it must be executed again
+ */
+static int bulk_step(c32_vm_t *vm, uint8_t op, uint8_t rd, uint8_t rs, uint8_t rt) {
+    uint32_t len = vm->regs[rt];
+    uint32_t dst = vm->regs[rd];
+    uint32_t src = vm->regs[rs];
+    uint32_t n = 0x1000 - (dst & 0x0FFF);
+    uint32_t phys_dst, phys_src = 0, i;
+
+    if (len == 0) {
+        return 1;
+    }
+    if (op != OP_MEMSET && 0x1000 - (src & 0x0FFF) < n) {
+        n = 0x1000 - (src & 0x0FFF);
+    }
+    if (n > len) {
+        n = len;
+    }
+
+    if (op != OP_MEMSET) {
+        phys_src = translate_address(vm, src, 0, 0);
+        if (phys_src == 0xFFFFFFFF) {
+            return !vm->interrupts.enabled;
+        }
+    }
+    phys_dst = translate_address(vm, dst, op != OP_MEMCMP, 0);
+    if (phys_dst == 0xFFFFFFFF) {
+        return !vm->interrupts.enabled;
+    }
+
+    if (phys_dst >= vm->memory_size || n > vm->memory_size - phys_dst ||
+        (op != OP_MEMSET && (phys_src >= vm->memory_size || n > vm->memory_size - phys_src))) {
+        n = 1;
+        if (op == OP_MEMCMP) {
+            if (bulk_load_byte(vm, phys_dst) != bulk_load_byte(vm, phys_src)) {
+                return 1;
+            }
+        } else {
+            bulk_store_byte(vm, phys_dst, op == OP_MEMSET ? src : bulk_load_byte(vm, phys_src));
+        }
+    } else if (op == OP_MEMCPY) {
+        c32_memcpy(vm->memory + phys_dst, vm->memory + phys_src, n);
+        c32_vm_host_write(vm, phys_dst, n);
+    } else if (op == OP_MEMSET) {
+        c32_memset(vm->memory + phys_dst, (int)(src & 0xFF), n);
+        c32_vm_host_write(vm, phys_dst, n);
+    } else if (c32_memcmp(vm->memory + phys_dst, vm->memory + phys_src, n) != 0) {
+        /* Leave both addresses at the first differing byte */
+        for (i = 0; vm->memory[phys_dst + i] == vm->memory[phys_src + i]; i++) {
+        }
+        vm->regs[rd] = dst + i;
+        vm->regs[rs] = src + i;
+        vm->regs[rt] = len - i;
+        return 1;
+    }
+
+    vm->regs[rd] = dst + n;
+    if (op != OP_MEMSET) {
+        vm->regs[rs] = src + n;
+    }
+    vm->regs[rt] = len - n;
+    return n == len;
+}
+
+/** @} */ /* end of vm_helpers */
+
+/**
+ * @addtogroup vm_devices
+ * @{
+ */
+
+/**
+ * @brief Attach a device table (NULL or count 0 detaches)
+ *
+ * @param vm Pointer to VM structure
+ * @param devices Device table, or NULL
+ * @param count Number of entries in devices
+ * @return 0 on success, -1 if a device is empty, wraps or overlaps RAM
+ */
+int c32_vm_set_devices(c32_vm_t *vm, const c32_device_t *devices, uint32_t count) {
+    uint32_t i;
+
+    if (!devices || count == 0) {
+        vm->devices = NULL;
+        vm->num_devices = 0;
+        return 0;
+    }
+
+    for (i = 0; i < count; i++) {
+        const c32_device_t *dev = &devices[i];
+
+        if (dev->size == 0 || dev->base < vm->memory_size ||
+            dev->size > 0xFFFFFFFFUL - dev->base) {
+            return -1;
+        }
+    }
+
+    vm->devices = devices;
+    vm->num_devices = count;
+    return 0;
+}
+
+/**
+ * @brief Account for a host write into guest memory
+ *
+ * @param vm Pointer to VM structure
+ * @param phys_addr Physical start address of the written range
+ * @param size Size of the written range in bytes
+ */
+void c32_vm_host_write(c32_vm_t *vm, uint32_t phys_addr, uint32_t size) {
+    if (size == 0) {
+        return;
+    }
+    ram_written(vm, phys_addr, size);
+}
+
+/** @} */ /* end of vm_devices */
+
+/**
+ * @addtogroup vm_dirty
+ * @{
+ */
+
+/**
+ * @brief Attach a dirty page bitmap (NULL detaches)
+ *
+ * @param vm Pointer to VM structure
+ * @param map Caller-supplied bitmap, or NULL
+ * @param num_words Number of words in map
+ * @return 0 on success, -1 if map is too small for guest memory
+ */
+int c32_vm_set_dirty_map(c32_vm_t *vm, uint32_t *map, uint32_t num_words) {
+    uint32_t i, words = C32_DIRTY_MAP_WORDS(vm->memory_size);
+
+    if (!map) {
+        vm->dirty_map = NULL;
+        return 0;
+    }
+    if (num_words < words) {
+        return -1;
+    }
+
+    for (i = 0; i < words; i++) {
+        map[i] = 0;
+    }
+    vm->dirty_map = map;
+    return 0;
+}
+
+/**
+ * @brief Copy the dirty bitmap out and clear it
+ *
+ * @param vm Pointer to VM structure (with a dirty map attached)
+ * @param out Receives the bitmap, or NULL
+ * @return Number of dirty pages
+ */
+uint32_t c32_vm_dirty_collect(c32_vm_t *vm, uint32_t *out) {
+    uint32_t i, words = C32_DIRTY_MAP_WORDS(vm->memory_size);
+    uint32_t pages = 0;
+
+    for (i = 0; i < words; i++) {
+        uint32_t bits = vm->dirty_map[i];
+
+        if (out) {
+            out[i] = bits;
+        }
+        vm->dirty_map[i] = 0;
+        for (; bits; bits &= bits - 1) {
+            pages++;
+        }
+    }
+    return pages;
+}
+
+/**
+ * @brief Mark the pages covering a physical range as dirty
+ *
+ * @param vm Pointer to VM structure (with a dirty map attached)
+ * @param phys_addr Physical start address
+ * @param size Size of the range in bytes
+ */
+void c32_vm_dirty_mark(c32_vm_t *vm, uint32_t phys_addr, uint32_t size) {
+    if (size == 0 || phys_addr >= vm->memory_size) {
+        return;
+    }
+    if (size > vm->memory_size - phys_addr) {
+        size = vm->memory_size - phys_addr;
+    }
+    dirty_store(vm, phys_addr, size);
+}
+
+/** @} */ /* end of vm_dirty */
+
+/**
+ * @addtogroup vm_timer
+ * @{
+ */
+
+/**
+ * @brief Program the timer
+ *
+ * @param vm Pointer to VM structure
+ * @param period Instructions between interrupts (0 stops the timer)
+ * @param irq Interrupt raised on expiry
+ */
+void c32_vm_set_timer(c32_vm_t *vm, uint32_t period, uint8_t irq) {
+    vm->timer.count = period;
+    vm->timer.period = period;
+    vm->timer.irq = irq;
+}
+
+/**
+ * @brief Charge the timer for retired instructions
+ *
+ * Callers never run past the expiry point, so count exceeding the
+ * remaining count still expires the timer only once.
+ *
+ * @param vm Pointer to VM structure
+ * @param count Instructions retired
+ */
+void c32_vm_timer_elapse(c32_vm_t *vm, uint32_t count) {
+    if (vm->timer.count == 0) {
+        return;
+    }
+    if (count < vm->timer.count) {
+        vm->timer.count -= count;
+        return;
+    }
+    c32_raise_interrupt(vm, vm->timer.irq);
+    vm->timer.count = vm->timer.period;
+}
+
+/** @} */ /* end of vm_timer */
+
+/**
+ * @defgroup vm_engine Execution Engine
+ * @brief Instruction fetch and dispatch loop
+ *
+ * Instruction bodies are written once and expanded into one of two
+ * engines selected at build time:
+ * - Default: a portable C89 `switch` inside a loop.
+ * - C32_THREADED_DISPATCH: token-threaded dispatch through a 256-entry
+ *   table of label addresses (GCC/Clang computed goto). Every handler
+ *   ends with its own copy of the fetch and indirect jump, so the host
+ *   branch predictor sees one dispatch site per guest instruction.
+ * @{
+ */
+
+#ifdef C32_THREADED_DISPATCH
+#if !defined(__GNUC__)
+#error "C32_THREADED_DISPATCH requires GCC-compatible computed goto"
+#endif
+#endif
+
+/**
+ * @brief Fetch the instruction at the current PC
+ *
+ * Validates PC alignment, translates the PC, checks bounds, and returns
+ * the decoded instruction from the cache (filling it on a miss) or from
+ * the caller's scratch entry when no cache is attached.
+ *
+ * @param vm Pointer to VM structure
+ * @param scratch Decode buffer used when the cache is disabled
+ * @return Decoded instruction, or NULL on a fetch fault
+ */
+static const c32_icache_entry_t *fetch_instruction(c32_vm_t *vm,
+                                                   c32_icache_entry_t *scratch) {
+    uint32_t phys_pc;
+    c32_icache_entry_t *entry;
+
+    /* Check PC alignment (8-byte boundary) */
+    if ((vm->pc & 0x7) != 0) {
+        /* Misaligned PC - raise exception */
+        c32_raise_interrupt(vm, 2); /* MEM_FAULT */
+        return NULL;
+    }
+
+    /* Translate PC (virtual to physical) */
+    phys_pc = translate_address(vm, vm->pc, 0, 1);
+    if (phys_pc == 0xFFFFFFFF) {
+        /* Page fault during instruction fetch */
+        return NULL;
+    }
+
+    /* Check PC bounds */
+    if (!RAM_FITS(vm, phys_pc, 8)) {
+        /* PC out of bounds */
+        vm->running = 0;
+        return NULL;
+    }
+
+    /* Reuse a cached decode when possible */
+    if (vm->icache) {
+        entry = &vm->icache[(phys_pc >> 3) & vm->icache_mask];
+        if (entry->tag != phys_pc) {
+            VM_COUNT(decodes);
+            decode_instruction(vm->memory + phys_pc, entry);
+            entry->tag = phys_pc;
+            fuse_instruction(vm, entry);
+        }
+        return entry;
+    }
+
+    VM_COUNT(decodes);
+    decode_instruction(vm->memory + phys_pc, scratch);
+    return scratch;
+}
+
+/**
+ * @brief Run a guest table of syscall requests through the host handler
+ *
+ * Each request is translated as a write, so it must be writable in paged
+ * user mode; the table's alignment keeps every request inside one page.
+ * The result word is stored with the same cache, TLB and watch updates
+ * as a guest SW.
+ *
+ * @param vm Pointer to VM structure
+ * @return C32_SYSCALL_HALT if the handler halted, C32_SYSCALL_DONE otherwise
+ */
+static c32_syscall_status_t host_syscall_batch(c32_vm_t *vm) {
+    c32_syscall_t call;
+    c32_syscall_status_t status = C32_SYSCALL_DONE;
+    uint32_t table = vm->regs[5];
+    uint32_t count = vm->regs[6];
+    uint32_t done = 0;
+    int i;
+
+    if ((table & (C32_SYSCALL_REQUEST_SIZE - 1)) == 0) {
+        for (; done < count; done++) {
+            uint32_t vaddr = table + done * C32_SYSCALL_REQUEST_SIZE;
+            uint32_t phys = translate_address(vm, vaddr, 1, 0);
+            const uint8_t *req;
+
+            if (phys == 0xFFFFFFFF || phys > vm->memory_size - C32_SYSCALL_REQUEST_SIZE ||
+                vm->memory_size < C32_SYSCALL_REQUEST_SIZE) {
+                break;
+            }
+            req = vm->memory + phys;
+            call.number = c32_read_word(req);
+            for (i = 0; i < C32_SYSCALL_ARGS; i++) {
+                call.args[i] = c32_read_word(req + 4 + 4 * i);
+            }
+            call.result = 0;
 
-    /* Check user accessible (user mode requires U bit) */
-    if (!user) {
-        /* Page fault: not user accessible */
-        c32_raise_interrupt(vm, 8);
-        return 0xFFFFFFFF;
+            if (vm->syscall_handler(vm, &call, vm->syscall_ctx) != C32_SYSCALL_DONE) {
+                status = C32_SYSCALL_HALT;
+                break;
+            }
+
+            phys += C32_SYSCALL_REQUEST_SIZE - 4;
+            c32_write_word(vm->memory + phys, call.result);
+            ram_written(vm, phys, 4);
+        }
     }
 
-    /* Check permissions */
-    if (is_write && !writable) {
-        /* Page fault: write to read-only page */
-        c32_raise_interrupt(vm, 8);
-        return 0xFFFFFFFF;
+    vm->regs[2] = done;
+    return status;
+}
+
+/**
+ * @brief Service a SYSCALL through the attached host handler
+ *
+ * @param vm Pointer to VM structure (syscall_handler set)
+ * @return C32_SYSCALL_HALT if the SYSCALL should halt the VM
+ */
+static c32_syscall_status_t host_syscall(c32_vm_t *vm) {
+    c32_syscall_t call;
+    int i;
+
+    if (vm->regs[4] == C32_SYSCALL_BATCH) {
+        return host_syscall_batch(vm);
     }
 
-    if (is_exec && !executable) {
-        /* Page fault: execute on non-executable page */
-        c32_raise_interrupt(vm, 8);
-        return 0xFFFFFFFF;
+    call.number = vm->regs[4];
+    for (i = 0; i < C32_SYSCALL_ARGS; i++) {
+        call.args[i] = vm->regs[5 + i];
     }
+    call.result = 0;
 
-    /* Construct physical address */
-    phys_addr = phys_page | page_offset;
-    return phys_addr;
+    if (vm->syscall_handler(vm, &call, vm->syscall_ctx) != C32_SYSCALL_DONE) {
+        return C32_SYSCALL_HALT;
+    }
+    vm->regs[2] = call.result;
+    return C32_SYSCALL_DONE;
 }
 
-/** @} */ /* end of vm_helpers */
+/**
+ * @brief Check interrupts, fetch next instruction, and advance PC
+ *
+ * Interrupt dispatch is only attempted when the pending summary is
+ * non-zero and interrupts are enabled. A cache hit is resolved inline:
+ * the PC is used directly when no translation is in effect, or translated
+ * through a matching instruction TLB entry in paged user mode. A matching
+ * tag implies the PC is aligned and in bounds, since no PC can match the
+ * tag of an empty entry (see icache_empty_tag()). Everything else goes
+ * through fetch_instruction(). Jumps to `fault` if interrupt dispatch or
+ * the fetch fails.
+ */
+#define VM_FETCH()                                                      \
+    do {                                                                \
+        if (vm->interrupts.pending_summary &&                           \
+            vm->interrupts.enabled &&                                   \
+            check_interrupts(vm) < 0) {                                 \
+            goto fault; /* Interrupt dispatch failed */                 \
+        }                                                               \
+        decoded = NULL;                                                 \
+        if (icache) {                                                   \
+            uint32_t phys_pc = vm->pc;                                  \
+            int hit = 1;                                                \
+            if (!vm->kernel_mode && vm->paging_enabled) {               \
+                const c32_tlb_entry_t *itlb =                           \
+                    &vm->itlb[(phys_pc >> 12) & (C32_TLB_ENTRIES - 1)]; \
+                hit = itlb->vpn == (phys_pc >> 12) && (itlb->pte & 0x4);\
+                phys_pc = (itlb->pte & 0xFFFFF000) | (phys_pc & 0x0FFF);\
+            }                                                           \
+            if (hit && icache[(phys_pc >> 3) & icache_mask].tag ==      \
+                    phys_pc) {                                          \
+                decoded = &icache[(phys_pc >> 3) & icache_mask];        \
+            }                                                           \
+        }                                                               \
+        if (!decoded) {                                                 \
+            decoded = fetch_instruction(vm, &scratch);                  \
+            if (!decoded) {                                             \
+                goto fault;                                             \
+            }                                                           \
+        }                                                               \
+        VM_COUNT(opcodes[decoded->opcode]);                             \
+        if (vm->trace) {                                                \
+            trace_instruction(vm, vm->pc, decoded);                     \
+        }                                                               \
+        rs = decoded->rs;                                               \
+        rt = decoded->rt;                                               \
+        rd = decoded->rd;                                               \
+        imm = decoded->imm;                                             \
+        /* Advance PC (overridden by branches/jumps) */                 \
+        vm->pc += 8;                                                    \
+    } while (0)
 
 /**
- * @addtogroup vm_lifecycle
- * @{
+ * @brief Complete an instruction: enforce R0 = 0 and check the budget
  */
+#define VM_RETIRE()                                     \
+    do {                                                \
+        vm->regs[0] = 0;                                \
+        executed++;                                     \
+        if (executed >= budget) {                       \
+            reason = C32_EXIT_BUDGET;                   \
+            goto done;                                  \
+        }                                               \
+    } while (0)
 
 /**
- * @brief Execute single instruction
+ * @brief Complete an instruction that stopped the VM and leave the loop
  *
- * Performs one complete instruction cycle:
+ * Handlers that clear the running flag end with VM_HALT instead of
+ * VM_NEXT, so the common path never has to re-check the flag.
+ */
+#define VM_HALT(why)                                    \
+    do {                                                \
+        vm->regs[0] = 0;                                \
+        executed++;                                     \
+        reason = (why);                                 \
+        goto done;                                      \
+    } while (0)
+
+/**
+ * @brief Take a conditional branch if cond holds, counting the outcome
+ */
+#define VM_BRANCH(cond, offset)                         \
+    do {                                                \
+        if (cond) {                                     \
+            vm->pc += (offset);                         \
+            VM_COUNT(branches_taken);                   \
+        } else {                                        \
+            VM_COUNT(branches_not_taken);               \
+        }                                               \
+    } while (0)
+
+/**
+ * @brief Execute the second half of a fused pair
+ *
+ * Fused handlers only come from cache fills, so decoded->tag is the
+ * physical PC of the first instruction. The second is taken from the
+ * next cache entry if that still holds it and the budget allows two
+ * instructions; otherwise only the first retires and the second is
+ * fetched normally. No interrupt check is needed in between: none of the
+ * fused instructions can raise one.
+ */
+#define VM_FUSED(kind, body)                                            \
+    do {                                                                \
+        const c32_icache_entry_t *second =                              \
+            &icache[((decoded->tag + 8) >> 3) & icache_mask];           \
+        if (second->tag == decoded->tag + 8 && budget - executed >= 2) {\
+            if (vm->trace) {                                            \
+                trace_instruction(vm, vm->pc, second);                  \
+            }                                                           \
+            vm->pc += 8;                                                \
+            body;                                                       \
+            executed++;                                                 \
+            vm->fusion_hits[kind]++;                                    \
+            VM_COUNT(opcodes[second->opcode]);                          \
+        }                                                               \
+    } while (0)
+
+#ifdef C32_THREADED_DISPATCH
+#define VM_DISPATCH()                                   \
+    do {                                                \
+        VM_FETCH();                                     \
+        goto *dispatch_table[decoded->handler];         \
+    } while (0)
+#define VM_BEGIN        VM_DISPATCH();
+#define VM_END
+#define VM_OP(op)       op_##op:
+#define VM_ILLEGAL      op_illegal:
+#define VM_NEXT         do { VM_RETIRE(); VM_DISPATCH(); } while (0)
+#else
+#define VM_BEGIN        for (;;) { VM_FETCH(); switch (decoded->handler) {
+#define VM_END          } VM_RETIRE(); }
+#define VM_OP(op)       case op:
+#define VM_ILLEGAL      default:
+#define VM_NEXT         break
+#endif
+
+/**
+ * @brief Execute up to budget instructions
+ *
+ * Runs the fetch/decode/execute cycle in a single loop until the budget
+ * is used up, an instruction stops the VM, or a fetch fault occurs. The
+ * running flag is not consulted on entry, matching the historical
+ * behaviour of c32_vm_step(); c32_vm_run_for() checks it for its callers.
+ * A running timer splits the budget into slices that end exactly at its
+ * expiry, so the per-instruction budget check is the only test paid.
+ *
+ * Each instruction cycle:
  * 1. Checks for pending interrupts and dispatches if enabled
  * 2. Validates PC alignment (8-byte boundary)
  * 3. Translates virtual PC to physical address
- * 4. Fetches 8-byte instruction from memory
+ * 4. Fetches 8-byte instruction from memory (or the decoded instruction cache)
  * 5. Decodes instruction fields (opcode, rs, rt, rd, imm)
  * 6. Advances PC by 8 bytes
  * 7. Executes instruction based on opcode
  * 8. Enforces R0 = 0
  *
- * Instruction encoding (8 bytes, little-endian):
- * - Byte 0: opcode
- * - Byte 1: rs (source register 1)
- * - Byte 2: rt (source register 2 or target for immediates)
- * - Byte 3: rd (destination register)
- * - Bytes 4-7: imm (32-bit immediate value)
- *
- * Supported instruction categories:
- * - Arithmetic (ADD, SUB, MUL, DIV, etc.)
- * - Logical (AND, OR, XOR, NOR, shifts)
- * - Comparison (SLT, SLTU)
- * - Memory (LW, LH, LB, SW, SH, SB with variants)
- * - Branches (BEQ, BNE, BLEZ, BGTZ, BLTZ, BGEZ)
- * - Jumps (J, JAL, JR, JALR)
- * - System (SYSCALL, BREAK)
- * - Interrupts (EI, DI, IRET, RAISE, GETPC)
- * - Privilege/MMU (ENABLE_PAGING, DISABLE_PAGING, SET_PTBR, ENTER_USER, GETMODE)
- *
  * @param vm Pointer to VM structure
- * @return 0 on success, -1 on error (halts execution)
+ * @param budget Maximum number of instructions to execute (at least 1)
+ * @param executed_out Receives the number of instructions retired
+ * @return Why execution stopped (never C32_EXIT_HALTED)
  */
-int c32_vm_step(c32_vm_t *vm) {
-    uint8_t opcode, rs, rt, rd;
+static c32_exit_reason_t vm_execute(c32_vm_t *vm, uint32_t budget,
+                                    uint32_t *executed_out) {
+    uint8_t rs, rt, rd;
     uint32_t imm;
-    uint32_t phys_pc;
-    const uint8_t *inst;
-
-    /* Check for pending interrupts */
-    if (check_interrupts(vm) < 0) {
-        return -1; /* Interrupt dispatch failed */
-    }
-
-    /* Check PC alignment (8-byte boundary) */
-    if ((vm->pc & 0x7) != 0) {
-        /* Misaligned PC - raise exception */
-        c32_raise_interrupt(vm, 2); /* MEM_FAULT */
-        return -1;
-    }
-
-    /* Translate PC (virtual to physical) */
-    phys_pc = translate_address(vm, vm->pc, 0, 1);
-    if (phys_pc == 0xFFFFFFFF) {
-        /* Page fault during instruction fetch */
-        return -1;
-    }
+    uint32_t executed = 0;
+    /* Caller's budget; budget itself may be cut short at the timer expiry */
+    uint32_t limit = budget;
+    /* Value of executed the timer has been charged up to */
+    uint32_t timer_mark = 0;
+    c32_exit_reason_t reason;
+    c32_icache_entry_t scratch;
+    const c32_icache_entry_t *decoded;
+    /* The host cannot re-attach the cache mid-run, so keep it in locals */
+    const c32_icache_entry_t *icache = vm->icache;
+    uint32_t icache_mask = vm->icache_mask;
+#ifdef C32_THREADED_DISPATCH
+    static const void *const dispatch_table[256] = {
+        [0 ... 255] = &&op_illegal,
+        [OP_NOP] = &&op_OP_NOP,
+        [OP_ADD] = &&op_OP_ADD,
+        [OP_ADDU] = &&op_OP_ADDU,
+        [OP_SUB] = &&op_OP_SUB,
+        [OP_SUBU] = &&op_OP_SUBU,
+        [OP_ADDI] = &&op_OP_ADDI,
+        [OP_ADDIU] = &&op_OP_ADDIU,
+        [OP_AND] = &&op_OP_AND,
+        [OP_OR] = &&op_OP_OR,
+        [OP_XOR] = &&op_OP_XOR,
+        [OP_NOR] = &&op_OP_NOR,
+        [OP_ANDI] = &&op_OP_ANDI,
+        [OP_ORI] = &&op_OP_ORI,
+        [OP_XORI] = &&op_OP_XORI,
+        [OP_LUI] = &&op_OP_LUI,
+        [OP_SLL] = &&op_OP_SLL,
+        [OP_SRL] = &&op_OP_SRL,
+        [OP_SRA] = &&op_OP_SRA,
+        [OP_SLLV] = &&op_OP_SLLV,
+        [OP_SRLV] = &&op_OP_SRLV,
+        [OP_SRAV] = &&op_OP_SRAV,
+        [OP_SLT] = &&op_OP_SLT,
+        [OP_SLTU] = &&op_OP_SLTU,
+        [OP_SLTI] = &&op_OP_SLTI,
+        [OP_SLTIU] = &&op_OP_SLTIU,
+        [OP_MUL] = &&op_OP_MUL,
+        [OP_MULH] = &&op_OP_MULH,
+        [OP_MULHU] = &&op_OP_MULHU,
+        [OP_DIV] = &&op_OP_DIV,
+        [OP_DIVU] = &&op_OP_DIVU,
+        [OP_REM] = &&op_OP_REM,
+        [OP_REMU] = &&op_OP_REMU,
+        [OP_LW] = &&op_OP_LW,
+        [OP_LH] = &&op_OP_LH,
+        [OP_LHU] = &&op_OP_LHU,
+        [OP_LB] = &&op_OP_LB,
+        [OP_LBU] = &&op_OP_LBU,
+        [OP_SW] = &&op_OP_SW,
+        [OP_SH] = &&op_OP_SH,
+        [OP_SB] = &&op_OP_SB,
+        [OP_MEMCPY] = &&op_OP_MEMCPY,
+        [OP_MEMSET] = &&op_OP_MEMSET,
+        [OP_MEMCMP] = &&op_OP_MEMCMP,
+        [OP_BEQ] = &&op_OP_BEQ,
+        [OP_BNE] = &&op_OP_BNE,
+        [OP_BLEZ] = &&op_OP_BLEZ,
+        [OP_BGTZ] = &&op_OP_BGTZ,
+        [OP_BLTZ] = &&op_OP_BLTZ,
+        [OP_BGEZ] = &&op_OP_BGEZ,
+        [OP_J] = &&op_OP_J,
+        [OP_JAL] = &&op_OP_JAL,
+        [OP_JR] = &&op_OP_JR,
+        [OP_JALR] = &&op_OP_JALR,
+        [OP_SYSCALL] = &&op_OP_SYSCALL,
+        [OP_BREAK] = &&op_OP_BREAK,
+        [OP_EI] = &&op_OP_EI,
+        [OP_DI] = &&op_OP_DI,
+        [OP_IRET] = &&op_OP_IRET,
+        [OP_RAISE] = &&op_OP_RAISE,
+        [OP_GETPC] = &&op_OP_GETPC,
+        [OP_ENABLE_PAGING] = &&op_OP_ENABLE_PAGING,
+        [OP_DISABLE_PAGING] = &&op_OP_DISABLE_PAGING,
+        [OP_SET_PTBR] = &&op_OP_SET_PTBR,
+        [OP_SET_TIMER] = &&op_OP_SET_TIMER,
+        [OP_ENTER_USER] = &&op_OP_ENTER_USER,
+        [OP_GETMODE] = &&op_OP_GETMODE,
+        [FUSED_LUI_ORI] = &&op_FUSED_LUI_ORI,
+        [FUSED_SLT_BEQ] = &&op_FUSED_SLT_BEQ,
+        [FUSED_SLT_BNE] = &&op_FUSED_SLT_BNE,
+        [FUSED_SLTU_BEQ] = &&op_FUSED_SLTU_BEQ,
+        [FUSED_SLTU_BNE] = &&op_FUSED_SLTU_BNE,
+        [FUSED_ADDI_BEQ] = &&op_FUSED_ADDI_BEQ,
+        [FUSED_ADDI_BNE] = &&op_FUSED_ADDI_BNE,
+    };
+#endif
 
-    /* Check PC bounds */
-    if (phys_pc + 8 > vm->memory_size) {
-        /* PC out of bounds */
-        vm->running = 0;
-        return -1;
+resume:
+    if (vm->timer.count != 0 && vm->timer.count < limit - executed) {
+        budget = executed + vm->timer.count;
+    } else {
+        budget = limit;
     }
 
-    /* Fetch instruction (8 bytes) */
-    inst = vm->memory + phys_pc;
-    opcode = inst[0];
-    rs = inst[1];
-    rt = inst[2];
-    rd = inst[3];
-    imm = c32_read_word(inst + 4);
-
-    /* Advance PC (will be overridden by branches/jumps) */
-    vm->pc += 8;
-
-    /* Decode and execute instruction */
-    switch (opcode) {
+    VM_BEGIN
         /* NOP - No Operation */
-        case OP_NOP:
-            break;
+        VM_OP(OP_NOP)
+            VM_NEXT;
 
         /* Arithmetic - Register-Register */
-        case OP_ADD:
+        VM_OP(OP_ADD)
             vm->regs[rd] = (int32_t)vm->regs[rs] + (int32_t)vm->regs[rt];
-            break;
-        case OP_ADDU:
+            VM_NEXT;
+        VM_OP(OP_ADDU)
             vm->regs[rd] = vm->regs[rs] + vm->regs[rt];
-            break;
-        case OP_SUB:
+            VM_NEXT;
+        VM_OP(OP_SUB)
             vm->regs[rd] = (int32_t)vm->regs[rs] - (int32_t)vm->regs[rt];
-            break;
-        case OP_SUBU:
+            VM_NEXT;
+        VM_OP(OP_SUBU)
             vm->regs[rd] = vm->regs[rs] - vm->regs[rt];
-            break;
+            VM_NEXT;
 
         /* Arithmetic - Register-Immediate */
-        case OP_ADDI:
+        VM_OP(OP_ADDI)
             vm->regs[rt] = (int32_t)vm->regs[rs] + (int32_t)imm;
-            break;
-        case OP_ADDIU:
+            VM_NEXT;
+        VM_OP(OP_ADDIU)
             vm->regs[rt] = vm->regs[rs] + imm;
-            break;
+            VM_NEXT;
 
         /* Logical - Register-Register */
-        case OP_AND:
+        VM_OP(OP_AND)
             vm->regs[rd] = vm->regs[rs] & vm->regs[rt];
-            break;
-        case OP_OR:
+            VM_NEXT;
+        VM_OP(OP_OR)
             vm->regs[rd] = vm->regs[rs] | vm->regs[rt];
-            break;
-        case OP_XOR:
+            VM_NEXT;
+        VM_OP(OP_XOR)
             vm->regs[rd] = vm->regs[rs] ^ vm->regs[rt];
-            break;
-        case OP_NOR:
+            VM_NEXT;
+        VM_OP(OP_NOR)
             vm->regs[rd] = ~(vm->regs[rs] | vm->regs[rt]);
-            break;
+            VM_NEXT;
 
         /* Logical - Register-Immediate */
-        case OP_ANDI:
+        VM_OP(OP_ANDI)
             vm->regs[rt] = vm->regs[rs] & imm;
-            break;
-        case OP_ORI:
+            VM_NEXT;
+        VM_OP(OP_ORI)
             vm->regs[rt] = vm->regs[rs] | imm;
-            break;
-        case OP_XORI:
+            VM_NEXT;
+        VM_OP(OP_XORI)
             vm->regs[rt] = vm->regs[rs] ^ imm;
-            break;
-        case OP_LUI:
+            VM_NEXT;
+        VM_OP(OP_LUI)
             vm->regs[rt] = imm << 16;
-            break;
+            VM_NEXT;
 
         /* Shift - Immediate Amount */
-        case OP_SLL:
+        VM_OP(OP_SLL)
             vm->regs[rd] = vm->regs[rt] << (imm & 0x1F);
-            break;
-        case OP_SRL:
+            VM_NEXT;
+        VM_OP(OP_SRL)
             vm->regs[rd] = vm->regs[rt] >> (imm & 0x1F);
-            break;
-        case OP_SRA:
+            VM_NEXT;
+        VM_OP(OP_SRA)
             vm->regs[rd] = (int32_t)vm->regs[rt] >> (imm & 0x1F);
-            break;
+            VM_NEXT;
 
         /* Shift - Variable Amount */
-        case OP_SLLV:
+        VM_OP(OP_SLLV)
             vm->regs[rd] = vm->regs[rt] << (vm->regs[rs] & 0x1F);
-            break;
-        case OP_SRLV:
+            VM_NEXT;
+        VM_OP(OP_SRLV)
             vm->regs[rd] = vm->regs[rt] >> (vm->regs[rs] & 0x1F);
-            break;
-        case OP_SRAV:
+            VM_NEXT;
+        VM_OP(OP_SRAV)
             vm->regs[rd] = (int32_t)vm->regs[rt] >> (vm->regs[rs] & 0x1F);
-            break;
+            VM_NEXT;
 
         /* Comparison - Register-Register */
-        case OP_SLT:
+        VM_OP(OP_SLT)
             vm->regs[rd] = ((int32_t)vm->regs[rs] < (int32_t)vm->regs[rt]) ? 1 : 0;
-            break;
-        case OP_SLTU:
+            VM_NEXT;
+        VM_OP(OP_SLTU)
             vm->regs[rd] = (vm->regs[rs] < vm->regs[rt]) ? 1 : 0;
-            break;
+            VM_NEXT;
 
         /* Comparison - Register-Immediate */
-        case OP_SLTI:
+        VM_OP(OP_SLTI)
             vm->regs[rt] = ((int32_t)vm->regs[rs] < (int32_t)imm) ? 1 : 0;
-            break;
-        case OP_SLTIU:
+            VM_NEXT;
+        VM_OP(OP_SLTIU)
             vm->regs[rt] = (vm->regs[rs] < imm) ? 1 : 0;
-            break;
+            VM_NEXT;
 
         /* Multiply and Divide */
-        case OP_MUL:
+        VM_OP(OP_MUL)
             vm->regs[rd] = vm->regs[rs] * vm->regs[rt];
-            break;
-        case OP_MULH: {
+            VM_NEXT;
+        VM_OP(OP_MULH) {
             /* 64-bit signed multiplication using 32-bit operations (C89 compatible) */
             uint32_t a = vm->regs[rs];
             uint32_t b = vm->regs[rt];
@@ -676,17 +2407,20 @@ int c32_vm_step(c32_vm_t *vm) {
             uint32_t p1 = a_lo * b_hi;
             uint32_t p2 = a_hi * b_lo;
             uint32_t p3 = a_hi * b_hi;
-            uint32_t mid = p1 + p2 + (p0 >> 16);
-            uint32_t result_hi = p3 + (mid >> 16);
+            uint32_t mid = p1 + (p0 >> 16);  /* Cannot overflow */
+            uint32_t result_hi;
+
+            mid += p2;
+            result_hi = p3 + (mid >> 16) + (mid < p2 ? 0x10000 : 0);
 
             /* Adjust for signs: if negative, subtract the other operand from high word */
             if ((int32_t)a < 0) result_hi -= b;
             if ((int32_t)b < 0) result_hi -= a;
 
             vm->regs[rd] = result_hi;
-            break;
+            VM_NEXT;
         }
-        case OP_MULHU: {
+        VM_OP(OP_MULHU) {
             /* 64-bit unsigned multiplication using 32-bit operations (C89 compatible) */
             uint32_t a = vm->regs[rs];
             uint32_t b = vm->regs[rt];
@@ -698,260 +2432,430 @@ int c32_vm_step(c32_vm_t *vm) {
             uint32_t p1 = a_lo * b_hi;
             uint32_t p2 = a_hi * b_lo;
             uint32_t p3 = a_hi * b_hi;
-            uint32_t mid = p1 + p2 + (p0 >> 16);
-            vm->regs[rd] = p3 + (mid >> 16);
-            break;
+            uint32_t mid = p1 + (p0 >> 16);  /* Cannot overflow */
+
+            mid += p2;
+            vm->regs[rd] = p3 + (mid >> 16) + (mid < p2 ? 0x10000 : 0);
+            VM_NEXT;
         }
-        case OP_DIV:
-            if (vm->regs[rt] != 0) {
-                vm->regs[rd] = (int32_t)vm->regs[rs] / (int32_t)vm->regs[rt];
-            } else {
+        VM_OP(OP_DIV)
+            if (vm->regs[rt] == 0) {
                 vm->regs[rd] = 0; /* Divide by zero returns 0 */
+            } else if (vm->regs[rt] == 0xFFFFFFFF) {
+                vm->regs[rd] = 0 - vm->regs[rs]; /* INT_MIN / -1 wraps */
+            } else {
+                vm->regs[rd] = (int32_t)vm->regs[rs] / (int32_t)vm->regs[rt];
             }
-            break;
-        case OP_DIVU:
+            VM_NEXT;
+        VM_OP(OP_DIVU)
             if (vm->regs[rt] != 0) {
                 vm->regs[rd] = vm->regs[rs] / vm->regs[rt];
             } else {
                 vm->regs[rd] = 0;
             }
-            break;
-        case OP_REM:
-            if (vm->regs[rt] != 0) {
-                vm->regs[rd] = (int32_t)vm->regs[rs] % (int32_t)vm->regs[rt];
+            VM_NEXT;
+        VM_OP(OP_REM)
+            if (vm->regs[rt] == 0 || vm->regs[rt] == 0xFFFFFFFF) {
+                vm->regs[rd] = 0; /* Also avoids the INT_MIN % -1 trap */
             } else {
-                vm->regs[rd] = 0;
+                vm->regs[rd] = (int32_t)vm->regs[rs] % (int32_t)vm->regs[rt];
             }
-            break;
-        case OP_REMU:
+            VM_NEXT;
+        VM_OP(OP_REMU)
             if (vm->regs[rt] != 0) {
                 vm->regs[rd] = vm->regs[rs] % vm->regs[rt];
             } else {
                 vm->regs[rd] = 0;
             }
-            break;
+            VM_NEXT;
 
         /* Load Operations */
-        case OP_LW: {
+        VM_OP(OP_LW) {
             uint32_t addr = vm->regs[rs] + imm;
             uint32_t phys_addr = translate_address(vm, addr, 0, 0);
-            if (phys_addr != 0xFFFFFFFF && phys_addr + 4 <= vm->memory_size) {
+            VM_COUNT(loads);
+            if (RAM_FITS(vm, phys_addr, 4)) {
                 vm->regs[rt] = c32_read_word(vm->memory + phys_addr);
+            } else if (vm->devices) {
+                uint32_t value;
+                if (mmio_load(vm, phys_addr, 4, &value)) {
+                    vm->regs[rt] = value;
+                }
             }
-            break;
+            VM_NEXT;
         }
-        case OP_LH: {
+        VM_OP(OP_LH) {
             uint32_t addr = vm->regs[rs] + imm;
             uint32_t phys_addr = translate_address(vm, addr, 0, 0);
-            if (phys_addr != 0xFFFFFFFF && phys_addr + 2 <= vm->memory_size) {
+            VM_COUNT(loads);
+            if (RAM_FITS(vm, phys_addr, 2)) {
                 int16_t val = (int16_t)c32_read_half(vm->memory + phys_addr);
                 vm->regs[rt] = (int32_t)val; /* Sign extend */
+            } else if (vm->devices) {
+                uint32_t value;
+                if (mmio_load(vm, phys_addr, 2, &value)) {
+                    vm->regs[rt] = (int32_t)(int16_t)value; /* Sign extend */
+                }
             }
-            break;
+            VM_NEXT;
         }
-        case OP_LHU: {
+        VM_OP(OP_LHU) {
             uint32_t addr = vm->regs[rs] + imm;
             uint32_t phys_addr = translate_address(vm, addr, 0, 0);
-            if (phys_addr != 0xFFFFFFFF && phys_addr + 2 <= vm->memory_size) {
+            VM_COUNT(loads);
+            if (RAM_FITS(vm, phys_addr, 2)) {
                 vm->regs[rt] = c32_read_half(vm->memory + phys_addr);
+            } else if (vm->devices) {
+                uint32_t value;
+                if (mmio_load(vm, phys_addr, 2, &value)) {
+                    vm->regs[rt] = value & 0xFFFF;
+                }
             }
-            break;
+            VM_NEXT;
         }
-        case OP_LB: {
+        VM_OP(OP_LB) {
             uint32_t addr = vm->regs[rs] + imm;
             uint32_t phys_addr = translate_address(vm, addr, 0, 0);
-            if (phys_addr != 0xFFFFFFFF && phys_addr + 1 <= vm->memory_size) {
+            VM_COUNT(loads);
+            if (RAM_FITS(vm, phys_addr, 1)) {
                 int8_t val = (int8_t)c32_read_byte(vm->memory + phys_addr);
                 vm->regs[rt] = (int32_t)val; /* Sign extend */
+            } else if (vm->devices) {
+                uint32_t value;
+                if (mmio_load(vm, phys_addr, 1, &value)) {
+                    vm->regs[rt] = (int32_t)(int8_t)value; /* Sign extend */
+                }
             }
-            break;
+            VM_NEXT;
         }
-        case OP_LBU: {
+        VM_OP(OP_LBU) {
             uint32_t addr = vm->regs[rs] + imm;
             uint32_t phys_addr = translate_address(vm, addr, 0, 0);
-            if (phys_addr != 0xFFFFFFFF && phys_addr + 1 <= vm->memory_size) {
+            VM_COUNT(loads);
+            if (RAM_FITS(vm, phys_addr, 1)) {
                 vm->regs[rt] = c32_read_byte(vm->memory + phys_addr);
+            } else if (vm->devices) {
+                uint32_t value;
+                if (mmio_load(vm, phys_addr, 1, &value)) {
+                    vm->regs[rt] = value & 0xFF;
+                }
             }
-            break;
+            VM_NEXT;
         }
 
         /* Store Operations */
-        case OP_SW: {
+        VM_OP(OP_SW) {
             uint32_t addr = vm->regs[rs] + imm;
             uint32_t phys_addr = translate_address(vm, addr, 1, 0);
-            if (phys_addr != 0xFFFFFFFF && phys_addr + 4 <= vm->memory_size) {
+            VM_COUNT(stores);
+            if (RAM_FITS(vm, phys_addr, 4)) {
                 c32_write_word(vm->memory + phys_addr, vm->regs[rt]);
+                ram_written(vm, phys_addr, 4);
+            } else if (vm->devices) {
+                mmio_store(vm, phys_addr, 4, vm->regs[rt]);
             }
-            break;
+            VM_NEXT;
         }
-        case OP_SH: {
+        VM_OP(OP_SH) {
             uint32_t addr = vm->regs[rs] + imm;
             uint32_t phys_addr = translate_address(vm, addr, 1, 0);
-            if (phys_addr != 0xFFFFFFFF && phys_addr + 2 <= vm->memory_size) {
+            VM_COUNT(stores);
+            if (RAM_FITS(vm, phys_addr, 2)) {
                 c32_write_half(vm->memory + phys_addr, (uint16_t)vm->regs[rt]);
+                ram_written(vm, phys_addr, 2);
+            } else if (vm->devices) {
+                mmio_store(vm, phys_addr, 2, vm->regs[rt] & 0xFFFF);
             }
-            break;
+            VM_NEXT;
         }
-        case OP_SB: {
+        VM_OP(OP_SB) {
             uint32_t addr = vm->regs[rs] + imm;
             uint32_t phys_addr = translate_address(vm, addr, 1, 0);
-            if (phys_addr != 0xFFFFFFFF && phys_addr + 1 <= vm->memory_size) {
+            VM_COUNT(stores);
+            if (RAM_FITS(vm, phys_addr, 1)) {
                 c32_write_byte(vm->memory + phys_addr, (uint8_t)vm->regs[rt]);
+                ram_written(vm, phys_addr, 1);
+            } else if (vm->devices) {
+                mmio_store(vm, phys_addr, 1, vm->regs[rt] & 0xFF);
             }
-            break;
+            VM_NEXT;
         }
+        VM_OP(OP_MEMCPY)
+        VM_OP(OP_MEMSET)
+        VM_OP(OP_MEMCMP)
+            /* One page per execution: re-run until the length reaches 0 */
+            if (!bulk_step(vm, decoded->opcode, rd, rs, rt)) {
+                vm->pc -= 8;
+            }
+            VM_NEXT;
 
         /* Branch Operations */
-        case OP_BEQ:
-            if (vm->regs[rs] == vm->regs[rt]) {
-                vm->pc = vm->pc + imm; /* PC already advanced to next instruction */
-            }
-            break;
-        case OP_BNE:
-            if (vm->regs[rs] != vm->regs[rt]) {
-                vm->pc = vm->pc + imm;
-            }
-            break;
-        case OP_BLEZ:
-            if ((int32_t)vm->regs[rs] <= 0) {
-                vm->pc = vm->pc + imm;
-            }
-            break;
-        case OP_BGTZ:
-            if ((int32_t)vm->regs[rs] > 0) {
-                vm->pc = vm->pc + imm;
-            }
-            break;
-        case OP_BLTZ:
-            if ((int32_t)vm->regs[rs] < 0) {
-                vm->pc = vm->pc + imm;
-            }
-            break;
-        case OP_BGEZ:
-            if ((int32_t)vm->regs[rs] >= 0) {
-                vm->pc = vm->pc + imm;
-            }
-            break;
+        VM_OP(OP_BEQ)
+            VM_BRANCH(vm->regs[rs] == vm->regs[rt], imm); /* PC already advanced to next instruction */
+            VM_NEXT;
+        VM_OP(OP_BNE)
+            VM_BRANCH(vm->regs[rs] != vm->regs[rt], imm);
+            VM_NEXT;
+        VM_OP(OP_BLEZ)
+            VM_BRANCH((int32_t)vm->regs[rs] <= 0, imm);
+            VM_NEXT;
+        VM_OP(OP_BGTZ)
+            VM_BRANCH((int32_t)vm->regs[rs] > 0, imm);
+            VM_NEXT;
+        VM_OP(OP_BLTZ)
+            VM_BRANCH((int32_t)vm->regs[rs] < 0, imm);
+            VM_NEXT;
+        VM_OP(OP_BGEZ)
+            VM_BRANCH((int32_t)vm->regs[rs] >= 0, imm);
+            VM_NEXT;
 
         /* Jump Operations */
-        case OP_J:
+        VM_OP(OP_J)
             vm->pc = imm;
-            break;
-        case OP_JAL:
+            VM_NEXT;
+        VM_OP(OP_JAL)
             vm->regs[31] = vm->pc; /* PC already advanced by 8 */
             vm->pc = imm;
-            break;
-        case OP_JR:
+            if (vm->profile) {
+                profile_call(vm->profile, vm->pc);
+            }
+            VM_NEXT;
+        VM_OP(OP_JR)
             vm->pc = vm->regs[rs];
-            break;
-        case OP_JALR:
+            VM_NEXT;
+        VM_OP(OP_JALR)
             vm->regs[rd] = vm->pc; /* PC already advanced by 8 */
             vm->pc = vm->regs[rs];
-            break;
+            if (vm->profile) {
+                profile_call(vm->profile, vm->pc);
+            }
+            VM_NEXT;
 
         /* System Operations */
-        case OP_SYSCALL:
+        VM_OP(OP_SYSCALL)
+            if (vm->syscall_handler && host_syscall(vm) == C32_SYSCALL_DONE) {
+                VM_NEXT; /* Serviced inline by the host */
+            }
             c32_raise_interrupt(vm, 4); /* SYSCALL interrupt */
             vm->running = 0; /* Stop execution */
-            break;
-        case OP_BREAK:
+            VM_HALT(C32_EXIT_SYSCALL);
+        VM_OP(OP_BREAK)
             c32_raise_interrupt(vm, 5); /* BREAK interrupt */
             vm->running = 0;
-            break;
+            VM_HALT(C32_EXIT_BREAK);
 
         /* Interrupt Control Operations */
-        case OP_EI:
+        VM_OP(OP_EI)
             if (!vm->kernel_mode) {
                 c32_raise_interrupt(vm, 7); /* PRIVILEGE_VIOLATION */
             } else {
                 vm->interrupts.enabled = 1;
             }
-            break;
-        case OP_DI:
+            VM_NEXT;
+        VM_OP(OP_DI)
             if (!vm->kernel_mode) {
                 c32_raise_interrupt(vm, 7);
             } else {
                 vm->interrupts.enabled = 0;
             }
-            break;
-        case OP_IRET:
+            VM_NEXT;
+        VM_OP(OP_IRET)
             if (!vm->kernel_mode) {
                 c32_raise_interrupt(vm, 7);
             } else {
-                uint32_t i;
                 /* Restore PC */
                 vm->pc = vm->interrupts.saved_pc;
-                /* Restore all registers from stack */
-                if (vm->interrupts.saved_regs_addr + 128 <= vm->memory_size) {
-                    for (i = 0; i < 32; i++) {
-                        vm->regs[i] = c32_read_word(vm->memory +
-                                                    vm->interrupts.saved_regs_addr + (i * 4));
-                    }
-                }
+                /* Restore all registers from the bank or stack */
+                restore_context(vm);
                 /* Enable interrupts */
                 vm->interrupts.enabled = 1;
+                VM_COUNT(irets);
                 /* Note: In a real implementation, we might restore privilege level here */
             }
-            break;
-        case OP_RAISE:
+            VM_NEXT;
+        VM_OP(OP_RAISE)
             c32_raise_interrupt(vm, (uint8_t)imm);
-            break;
-        case OP_GETPC:
+            VM_NEXT;
+        VM_OP(OP_GETPC)
             vm->regs[rd] = vm->interrupts.saved_pc;
-            break;
+            VM_NEXT;
 
         /* Privilege and MMU Control */
-        case OP_ENABLE_PAGING:
+        VM_OP(OP_ENABLE_PAGING)
             if (!vm->kernel_mode) {
                 c32_raise_interrupt(vm, 7);
             } else {
                 vm->paging_enabled = 1;
+                c32_vm_tlb_flush(vm);
             }
-            break;
-        case OP_DISABLE_PAGING:
+            VM_NEXT;
+        VM_OP(OP_DISABLE_PAGING)
             if (!vm->kernel_mode) {
                 c32_raise_interrupt(vm, 7);
             } else {
                 vm->paging_enabled = 0;
+                c32_vm_tlb_flush(vm);
             }
-            break;
-        case OP_SET_PTBR:
+            VM_NEXT;
+        VM_OP(OP_SET_PTBR)
             if (!vm->kernel_mode) {
                 c32_raise_interrupt(vm, 7);
             } else {
                 vm->page_table_base = vm->regs[rd];
                 vm->num_pages = vm->regs[rt];
+                c32_vm_tlb_flush(vm);
             }
-            break;
-        case OP_ENTER_USER:
+            VM_NEXT;
+        VM_OP(OP_SET_TIMER)
+            if (!vm->kernel_mode) {
+                c32_raise_interrupt(vm, 7);
+            } else {
+                c32_vm_set_timer(vm, vm->regs[rs & 0x1F], (uint8_t)imm);
+                /* The new count starts after this instruction; end the
+                 * slice here so the budget is clamped to it */
+                timer_mark = executed + 1;
+                budget = executed + 1;
+            }
+            VM_NEXT;
+        VM_OP(OP_ENTER_USER)
             if (!vm->kernel_mode) {
                 c32_raise_interrupt(vm, 7);
             } else {
                 vm->kernel_mode = 0;
+                c32_vm_tlb_flush(vm);
             }
-            break;
-        case OP_GETMODE:
+            VM_NEXT;
+        VM_OP(OP_GETMODE)
             vm->regs[rd] = vm->kernel_mode;
-            break;
+            VM_NEXT;
+
+        /* Fused pairs: first instruction, then the second if still cached */
+        VM_OP(FUSED_LUI_ORI)
+            vm->regs[rt] = imm << 16;
+            VM_FUSED(C32_FUSE_LUI_ORI,
+                     vm->regs[second->rt] = vm->regs[second->rs] | second->imm);
+            VM_NEXT;
+        VM_OP(FUSED_SLT_BEQ)
+            vm->regs[rd] = ((int32_t)vm->regs[rs] < (int32_t)vm->regs[rt]) ? 1 : 0;
+            VM_FUSED(C32_FUSE_SLT_BEQ,
+                     VM_BRANCH(vm->regs[second->rs] == vm->regs[second->rt],
+                               second->imm));
+            VM_NEXT;
+        VM_OP(FUSED_SLT_BNE)
+            vm->regs[rd] = ((int32_t)vm->regs[rs] < (int32_t)vm->regs[rt]) ? 1 : 0;
+            VM_FUSED(C32_FUSE_SLT_BNE,
+                     VM_BRANCH(vm->regs[second->rs] != vm->regs[second->rt],
+                               second->imm));
+            VM_NEXT;
+        VM_OP(FUSED_SLTU_BEQ)
+            vm->regs[rd] = (vm->regs[rs] < vm->regs[rt]) ? 1 : 0;
+            VM_FUSED(C32_FUSE_SLTU_BEQ,
+                     VM_BRANCH(vm->regs[second->rs] == vm->regs[second->rt],
+                               second->imm));
+            VM_NEXT;
+        VM_OP(FUSED_SLTU_BNE)
+            vm->regs[rd] = (vm->regs[rs] < vm->regs[rt]) ? 1 : 0;
+            VM_FUSED(C32_FUSE_SLTU_BNE,
+                     VM_BRANCH(vm->regs[second->rs] != vm->regs[second->rt],
+                               second->imm));
+            VM_NEXT;
+        VM_OP(FUSED_ADDI_BEQ)
+            vm->regs[rt] = vm->regs[rs] + imm;
+            VM_FUSED(C32_FUSE_ADDI_BEQ,
+                     VM_BRANCH(vm->regs[second->rs] == vm->regs[second->rt],
+                               second->imm));
+            VM_NEXT;
+        VM_OP(FUSED_ADDI_BNE)
+            vm->regs[rt] = vm->regs[rs] + imm;
+            VM_FUSED(C32_FUSE_ADDI_BNE,
+                     VM_BRANCH(vm->regs[second->rs] != vm->regs[second->rt],
+                               second->imm));
+            VM_NEXT;
 
         /* Unknown opcode */
-        default:
+        VM_ILLEGAL
             c32_raise_interrupt(vm, 1); /* ILLEGAL_OP */
             vm->running = 0;
-            break;
+            VM_HALT(C32_EXIT_ILLEGAL);
+    VM_END
+
+fault:
+    reason = C32_EXIT_FAULT;
+
+done:
+    /* Charge the timer once per slice; a slice cut short at the expiry
+     * point (or by SET_TIMER) carries on with the rest of the budget */
+    c32_vm_timer_elapse(vm, executed - timer_mark);
+    timer_mark = executed;
+    if (reason == C32_EXIT_BUDGET && executed < limit) {
+        goto resume;
     }
 
-    /* Enforce R0 = 0 */
-    vm->regs[0] = 0;
+#ifdef C32_ENABLE_STATS
+    vm->stats.instructions += executed;
+    if (vm->stats.instructions < executed) {
+        vm->stats.instructions_hi++;
+    }
+#endif
+    *executed_out = executed;
+    return reason;
+}
+
+/** @} */ /* end of vm_engine */
+
+/**
+ * @addtogroup vm_lifecycle
+ * @{
+ */
+
+/**
+ * @brief Execute single instruction
+ *
+ * Performs one complete instruction cycle:
+ * 1. Checks for pending interrupts and dispatches if enabled
+ * 2. Validates PC alignment (8-byte boundary)
+ * 3. Translates virtual PC to physical address
+ * 4. Fetches 8-byte instruction from memory (or the decoded instruction cache)
+ * 5. Decodes instruction fields (opcode, rs, rt, rd, imm)
+ * 6. Advances PC by 8 bytes
+ * 7. Executes instruction based on opcode
+ * 8. Enforces R0 = 0
+ *
+ * Instruction encoding (8 bytes, little-endian):
+ * - Byte 0: opcode
+ * - Byte 1: rs (source register 1)
+ * - Byte 2: rt (source register 2 or target for immediates)
+ * - Byte 3: rd (destination register)
+ * - Bytes 4-7: imm (32-bit immediate value)
+ *
+ * Supported instruction categories:
+ * - Arithmetic (ADD, SUB, MUL, DIV, etc.)
+ * - Logical (AND, OR, XOR, NOR, shifts)
+ * - Comparison (SLT, SLTU)
+ * - Memory (LW, LH, LB, SW, SH, SB with variants)
+ * - Branches (BEQ, BNE, BLEZ, BGTZ, BLTZ, BGEZ)
+ * - Jumps (J, JAL, JR, JALR)
+ * - System (SYSCALL, BREAK)
+ * - Interrupts (EI, DI, IRET, RAISE, GETPC)
+ * - Privilege/MMU (ENABLE_PAGING, DISABLE_PAGING, SET_PTBR, SET_TIMER, ENTER_USER, GETMODE)
+ *
+ * @param vm Pointer to VM structure
+ * @return 0 on success, -1 on error (halts execution)
+ */
+int c32_vm_step(c32_vm_t *vm) {
+    uint32_t executed;
 
+    if (vm_execute(vm, 1, &executed) == C32_EXIT_FAULT) {
+        return -1;
+    }
     return 0;
 }
 
 /**
  * @brief Run VM until halted
  *
- * Executes instructions in a continuous loop by repeatedly calling
- * c32_vm_step() until the VM halts (running flag becomes 0).
+ * Executes instructions in a continuous loop inside the execution engine
+ * until the VM halts (running flag becomes 0).
  * The VM can be halted by:
  * - SYSCALL or BREAK instructions
  * - Fatal errors (invalid PC, page faults without handlers)
@@ -960,13 +2864,47 @@ int c32_vm_step(c32_vm_t *vm) {
  * @param vm Pointer to VM structure
  */
 void c32_vm_run(c32_vm_t *vm) {
+    uint32_t executed;
+
     vm->running = 1;
 
     while (vm->running) {
-        if (c32_vm_step(vm) != 0) {
+        if (vm_execute(vm, 0xFFFFFFFF, &executed) == C32_EXIT_FAULT) {
             break;
         }
     }
 }
 
+/**
+ * @brief Run VM for at most budget instructions
+ *
+ * Executes inside a single engine loop without returning to the host
+ * between instructions. Unlike c32_vm_run(), the running flag is not
+ * set: a halted VM returns C32_EXIT_HALTED immediately, so a host that
+ * services a SYSCALL must set running back to 1 before resuming.
+ *
+ * @param vm Pointer to VM structure
+ * @param budget Maximum number of instructions to execute
+ * @param executed If non-NULL, receives the number of instructions retired
+ * @return Why execution stopped
+ */
+c32_exit_reason_t c32_vm_run_for(c32_vm_t *vm, uint32_t budget,
+                                 uint32_t *executed) {
+    uint32_t count = 0;
+    c32_exit_reason_t reason;
+
+    if (!vm->running) {
+        reason = C32_EXIT_HALTED;
+    } else if (budget == 0) {
+        reason = C32_EXIT_BUDGET;
+    } else {
+        reason = vm_execute(vm, budget, &count);
+    }
+
+    if (executed) {
+        *executed = count;
+    }
+    return reason;
+}
+
 /** @} */ /* end of vm_lifecycle */
@@ -0,0 +1,262 @@
+/**
+ * @file c32_vring.c
+ * @brief CRISP-32 Shared-Memory Request Rings
+ * @author Manny Peterson <manny@manny.ca>
+ * @date 2025
+ * @copyright Copyright (C) 2025 Manny Peterson
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "c32_vring.h"
+
+/**
+ * @addtogroup vring
+ * @{
+ */
+
+/**
+ * @brief Check that [addr, addr + size) lies in guest RAM
+ */
+static int in_ram(const c32_vm_t *vm, uint32_t addr, uint32_t size) {
+    return addr <= vm->memory_size && size <= vm->memory_size - addr;
+}
+
+/**
+ * @brief Initialize an unconfigured ring
+ *
+ * @param ring Ring state
+ * @param irq Interrupt raised on completion
+ * @param service Doorbell callback
+ * @param ctx Context pointer passed to service
+ */
+void c32_vring_init(c32_vring_t *ring, uint8_t irq, c32_vring_service_t service, void *ctx) {
+    ring->num = 0;
+    ring->desc = 0;
+    ring->avail = 0;
+    ring->used = 0;
+    ring->ready = 0;
+    ring->last_avail = 0;
+    ring->used_idx = 0;
+    ring->irq = irq;
+    ring->service = service;
+    ring->ctx = ctx;
+}
+
+/**
+ * @brief Check a ring layout against guest memory and start the ring
+ *
+ * @param ring Ring state
+ * @param vm VM whose memory holds the ring
+ * @param num Ring size (power of two, 1 to C32_VRING_MAX_SIZE)
+ * @param desc Descriptor table address (16-byte aligned)
+ * @param avail Available ring address (2-byte aligned)
+ * @param used Used ring address (4-byte aligned)
+ * @return 0 on success, -1 if the layout is invalid or outside RAM
+ */
+int c32_vring_setup(c32_vring_t *ring, const c32_vm_t *vm, uint32_t num,
+                    uint32_t desc, uint32_t avail, uint32_t used) {
+    ring->ready = 0;
+    if (num == 0 || num > C32_VRING_MAX_SIZE || (num & (num - 1)) != 0 ||
+        (desc & 15) != 0 || (avail & 1) != 0 || (used & 3) != 0 ||
+        !in_ram(vm, desc, 16 * num) || !in_ram(vm, avail, 4 + 2 * num) ||
+        !in_ram(vm, used, 4 + 8 * num)) {
+        return -1;
+    }
+
+    ring->num = num;
+    ring->desc = desc;
+    ring->avail = avail;
+    ring->used = used;
+    ring->last_avail = 0;
+    ring->used_idx = 0;
+    ring->ready = 1;
+    return 0;
+}
+
+/**
+ * @brief Pop the next available chain
+ *
+ * A chain can hold at most num descriptors, which bounds the walk even
+ * if the guest links descriptors into a loop.
+ *
+ * @param ring Ring state (ready)
+ * @param vm VM whose memory holds the ring
+ * @param head Receives the chain's head descriptor, for c32_vring_push()
+ * @param bufs Receives the chain's buffers in order
+ * @param max_bufs Capacity of bufs
+ * @param num_bufs Receives the number of buffers in the chain
+ * @return 1 if a chain was popped, 0 if none is available, -1 if malformed
+ */
+int c32_vring_pop(c32_vring_t *ring, c32_vm_t *vm, uint16_t *head, c32_vring_buf_t *bufs,
+                  uint32_t max_bufs, uint32_t *num_bufs) {
+    uint16_t avail_idx;
+    uint32_t index, n = 0;
+
+    if (!ring->ready) {
+        return 0;
+    }
+
+    avail_idx = c32_read_half(vm->memory + ring->avail + 2);
+    if (avail_idx == ring->last_avail) {
+        return 0;
+    }
+    if ((uint16_t)(avail_idx - ring->last_avail) > ring->num) {
+        ring->ready = 0;
+        return -1;
+    }
+
+    index = c32_read_half(vm->memory + ring->avail + 4 +
+                          2 * (ring->last_avail & (ring->num - 1)));
+    ring->last_avail++;
+    *head = (uint16_t)index;
+
+    for (;;) {
+        const uint8_t *desc;
+        uint32_t addr, len, flags;
+
+        if (index >= ring->num || n >= ring->num || n >= max_bufs) {
+            ring->ready = 0;
+            return -1;
+        }
+        desc = vm->memory + ring->desc + 16 * index;
+        addr = c32_read_word(desc);
+        len = c32_read_word(desc + 8);
+        flags = c32_read_half(desc + 12);
+        if (c32_read_word(desc + 4) != 0 || !in_ram(vm, addr, len) ||
+            (flags & ~(uint32_t)(C32_VRING_DESC_F_NEXT | C32_VRING_DESC_F_WRITE)) != 0) {
+            ring->ready = 0;
+            return -1;
+        }
+
+        bufs[n].data = vm->memory + addr;
+        bufs[n].addr = addr;
+        bufs[n].len = len;
+        bufs[n].writable = (flags & C32_VRING_DESC_F_WRITE) != 0;
+        n++;
+
+        if (!(flags & C32_VRING_DESC_F_NEXT)) {
+            break;
+        }
+        index = c32_read_half(desc + 14);
+    }
+
+    *num_bufs = n;
+    return 1;
+}
+
+/**
+ * @brief Complete a chain by posting it to the used ring
+ *
+ * @param ring Ring state (ready)
+ * @param vm VM whose memory holds the ring
+ * @param head Head descriptor returned by c32_vring_pop()
+ * @param written Bytes the host wrote into the chain's writable buffers
+ */
+void c32_vring_push(c32_vring_t *ring, c32_vm_t *vm, uint16_t head, uint32_t written) {
+    uint32_t elem = ring->used + 4 + 8 * (ring->used_idx & (ring->num - 1));
+
+    c32_write_word(vm->memory + elem, head);
+    c32_write_word(vm->memory + elem + 4, written);
+    c32_vm_host_write(vm, elem, 8);
+
+    /* The index is published after the element it covers */
+    ring->used_idx++;
+    c32_write_half(vm->memory + ring->used + 2, ring->used_idx);
+    c32_vm_host_write(vm, ring->used + 2, 2);
+}
+
+/**
+ * @brief Raise the ring's interrupt unless the guest suppressed it
+ *
+ * @param ring Ring state (ready)
+ * @param vm VM whose memory holds the ring
+ */
+void c32_vring_notify(c32_vring_t *ring, c32_vm_t *vm) {
+    if (!(c32_read_half(vm->memory + ring->avail) & C32_VRING_AVAIL_F_NO_INTERRUPT)) {
+        c32_raise_interrupt(vm, ring->irq);
+    }
+}
+
+/**
+ * @brief Doorbell register read
+ */
+static uint32_t vring_read(c32_vm_t *vm, void *ctx, uint32_t offset, uint32_t width) {
+    c32_vring_t *ring = (c32_vring_t *)ctx;
+
+    (void)vm;
+    (void)width;
+
+    switch (offset) {
+        case C32_VRING_NUM: return ring->num;
+        case C32_VRING_DESC: return ring->desc;
+        case C32_VRING_AVAIL: return ring->avail;
+        case C32_VRING_USED: return ring->used;
+        case C32_VRING_READY: return (uint32_t)ring->ready;
+        default: return 0;
+    }
+}
+
+/**
+ * @brief Doorbell register write; the layout is fixed while the ring runs
+ */
+static void vring_write(c32_vm_t *vm, void *ctx, uint32_t offset, uint32_t width,
+                        uint32_t value) {
+    c32_vring_t *ring = (c32_vring_t *)ctx;
+
+    (void)width;
+
+    if (offset == C32_VRING_NOTIFY) {
+        if (ring->ready && ring->service) {
+            ring->service(vm, ring, ring->ctx);
+        }
+        return;
+    }
+    if (offset == C32_VRING_READY) {
+        if (value) {
+            c32_vring_setup(ring, vm, ring->num, ring->desc, ring->avail, ring->used);
+        } else {
+            ring->ready = 0;
+        }
+        return;
+    }
+    if (ring->ready) {
+        return;
+    }
+
+    switch (offset) {
+        case C32_VRING_NUM: ring->num = value; break;
+        case C32_VRING_DESC: ring->desc = value; break;
+        case C32_VRING_AVAIL: ring->avail = value; break;
+        case C32_VRING_USED: ring->used = value; break;
+        default: break;
+    }
+}
+
+/**
+ * @brief Describe a ring's doorbell and configuration registers as an MMIO device
+ *
+ * @param dev Device entry to fill in
+ * @param base Physical base address
+ * @param ring Ring state
+ */
+void c32_vring_device(c32_device_t *dev, uint32_t base, c32_vring_t *ring) {
+    dev->base = base;
+    dev->size = C32_VRING_SIZE;
+    dev->read = vring_read;
+    dev->write = vring_write;
+    dev->ctx = ring;
+}
+
+/** @} */ /* end of vring */
@@ -21,9 +21,16 @@
 
 #include "c32_vm.h"
 #include "c32_string.h"
+#include "c32_hostmem.h"
+#include "c32_trace_writer.h"
+#include "c32_devices.h"
+#ifdef C32_USE_JIT
+#include "c32_jit.h"
+#endif
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 /**
  * @defgroup vm_runner VM Runner
@@ -31,8 +38,8 @@
  * @{
  */
 
-/** @brief VM memory size (64KB) */
-#define VM_MEMORY_SIZE 65536
+/** @brief Default VM memory size (64KB) */
+#define DEFAULT_MEMORY_SIZE 65536
 
 /** @brief Default program load address */
 #define DEFAULT_LOAD_ADDR 0x1000
@@ -40,8 +47,52 @@
 /** @brief Maximum execution steps before timeout */
 #define MAX_EXECUTION_STEPS 1000000
 
-/** @brief VM memory buffer */
-static uint8_t vm_memory[VM_MEMORY_SIZE];
+/** @brief Decoded instruction cache size (entries) */
+#define VM_ICACHE_ENTRIES 4096
+
+/** @brief Default instructions between profile samples */
+#define DEFAULT_PROFILE_INTERVAL 1000
+
+/** @brief Trace ring size in records (1MB) */
+#define VM_TRACE_RECORDS 65536
+
+/** @brief Longest run between trace drains (half the ring) */
+#define VM_TRACE_SLICE (VM_TRACE_RECORDS / 2)
+
+/** @brief Decoded instruction cache buffer */
+static c32_icache_entry_t vm_icache[VM_ICACHE_ENTRIES];
+
+/** @brief PC profile */
+static c32_profile_t vm_profile;
+
+/** @brief Trace ring storage */
+static c32_trace_record_t vm_trace_records[VM_TRACE_RECORDS];
+
+/** @brief Trace ring */
+static c32_trace_t vm_trace;
+
+/** @brief Trace file writer (NULL when not tracing) */
+static c32_trace_writer_t *vm_trace_writer;
+
+/** @brief Set when a trace write fails */
+static int vm_trace_failed;
+
+/** @brief Console on stdin/stdout */
+static c32_console_t vm_console;
+
+/** @brief Block device backed by a disk image */
+static c32_blockdev_t vm_disk;
+
+/** @brief MMIO device table */
+static c32_device_t vm_devices[2];
+
+#ifdef C32_USE_JIT
+/** @brief Dynamic binary translator state */
+static c32_jit_t vm_jit;
+
+/** @brief Set when the VM runs through the translator */
+static int vm_jit_active;
+#endif
 
 /**
  * @brief Load a binary file into VM memory
@@ -49,46 +100,68 @@ static uint8_t vm_memory[VM_MEMORY_SIZE];
  * @param vm Pointer to VM instance
  * @param filename Path to binary file
  * @param load_addr Address to load program
+ * @param size Receives the number of bytes loaded
  * @return 0 on success, -1 on failure
  */
-static int load_binary_file(c32_vm_t *vm, const char *filename, uint32_t load_addr) {
-    FILE *fp;
-    size_t bytes_read;
-    size_t available_space;
-
-    fp = fopen(filename, "rb");
-    if (!fp) {
-        fprintf(stderr, "Error: Cannot open file '%s'\n", filename);
-        return -1;
-    }
+static int load_binary_file(c32_vm_t *vm, const char *filename, uint32_t load_addr,
+                            uint32_t *size) {
+    int mapped;
 
-    /* Calculate available memory space */
     if (load_addr >= vm->memory_size) {
         fprintf(stderr, "Error: Load address 0x%08x exceeds memory size\n",
                 (unsigned int)load_addr);
-        fclose(fp);
         return -1;
     }
 
-    available_space = vm->memory_size - load_addr;
-
-    /* Read binary into memory */
-    bytes_read = fread(vm->memory + load_addr, 1, available_space, fp);
-
-    if (ferror(fp)) {
-        fprintf(stderr, "Error: Failed to read file '%s'\n", filename);
-        fclose(fp);
+    /* Large images are mapped and paged in on demand */
+    mapped = c32_hostmem_load_image(vm->memory, vm->memory_size, load_addr, filename, size);
+    if (mapped < 0) {
+        fprintf(stderr, "Error: Cannot load file '%s'\n", filename);
         return -1;
     }
 
-    fclose(fp);
+    /* Drop any decoded instructions the new image replaced */
+    c32_vm_icache_invalidate(vm, load_addr, *size);
 
-    printf("Loaded %lu bytes from '%s' at address 0x%08x\n",
-           (unsigned long)bytes_read, filename, (unsigned int)load_addr);
+    printf("%s %lu bytes from '%s' at address 0x%08x\n", mapped ? "Mapped" : "Loaded",
+           (unsigned long)*size, filename, (unsigned int)load_addr);
 
     return 0;
 }
 
+/**
+ * @brief Parse a memory size with an optional K, M or G suffix
+ *
+ * @param text Size text, e.g. "65536", "0x10000", "256M" or "1G"
+ * @param size Receives the size in bytes
+ * @return 0 on success, -1 if malformed or out of range
+ */
+static int parse_memory_size(const char *text, uint32_t *size) {
+    char *end;
+    unsigned long value = strtoul(text, &end, 0);
+    unsigned long scale = 1;
+
+    if (end == text) {
+        return -1;
+    }
+    if (*end == 'K' || *end == 'k') {
+        scale = 1024UL;
+        end++;
+    } else if (*end == 'M' || *end == 'm') {
+        scale = 1024UL * 1024UL;
+        end++;
+    } else if (*end == 'G' || *end == 'g') {
+        scale = 1024UL * 1024UL * 1024UL;
+        end++;
+    }
+    if (*end != '\0' || value == 0 || value > C32_HOSTMEM_MAX_SIZE / scale) {
+        return -1;
+    }
+
+    *size = (uint32_t)(value * scale);
+    return 0;
+}
+
 /**
  * @brief Print VM register state
  *
@@ -113,6 +186,173 @@ static void print_registers(const c32_vm_t *vm) {
     printf("================\n");
 }
 
+/**
+ * @brief Print execution counters
+ *
+ * @param vm Pointer to VM instance
+ */
+static void print_stats(const c32_vm_t *vm) {
+    static const char *const fault_names[C32_PF_COUNT] = {
+        "bounds", "table", "invalid", "user", "write", "exec"
+    };
+    c32_stats_t stats;
+    int i;
+
+    if (c32_vm_get_stats(vm, &stats) != 0) {
+        printf("\nStatistics not available (rebuild with 'make STATS=1')\n");
+        return;
+    }
+
+    printf("\nExecution Statistics:\n");
+    printf("================\n");
+    printf("Instructions:  %.0f\n",
+           (double)stats.instructions_hi * 4294967296.0 + (double)stats.instructions);
+    printf("Decodes:       %lu\n", (unsigned long)stats.decodes);
+    printf("Loads:         %lu\n", (unsigned long)stats.loads);
+    printf("Stores:        %lu\n", (unsigned long)stats.stores);
+    printf("Branches:      %lu taken, %lu not taken\n",
+           (unsigned long)stats.branches_taken, (unsigned long)stats.branches_not_taken);
+    printf("Translations:  %lu\n", (unsigned long)stats.translations);
+    printf("Page faults:  ");
+    for (i = 0; i < C32_PF_COUNT; i++) {
+        printf(" %s=%lu", fault_names[i], (unsigned long)stats.page_faults[i]);
+    }
+    printf("\n");
+    printf("Interrupts:    %lu dispatched, %lu IRET, %lu saved to memory\n",
+           (unsigned long)stats.interrupts, (unsigned long)stats.irets,
+           (unsigned long)stats.spills);
+    printf("Fused pairs:  ");
+    for (i = 0; i < C32_FUSE_COUNT; i++) {
+        printf(" %lu", (unsigned long)vm->fusion_hits[i]);
+    }
+    printf("\n");
+    printf("Opcodes:\n");
+    for (i = 0; i < 256; i++) {
+        if (stats.opcodes[i]) {
+            printf("  0x%02x: %lu\n", i, (unsigned long)stats.opcodes[i]);
+        }
+    }
+    printf("================\n");
+}
+
+/**
+ * @brief Run for at most budget instructions on the selected engine
+ *
+ * @param vm Pointer to VM instance
+ * @param budget Maximum number of instructions to execute
+ * @param executed Receives the number of instructions retired
+ * @return Why execution stopped
+ */
+static c32_exit_reason_t run_slice(c32_vm_t *vm, uint32_t budget, uint32_t *executed) {
+#ifdef C32_USE_JIT
+    if (vm_jit_active) {
+        return c32_jit_run_for(&vm_jit, budget, executed);
+    }
+#endif
+    return c32_vm_run_for(vm, budget, executed);
+}
+
+/**
+ * @brief Run in slices, sampling the profile and draining the trace between them
+ *
+ * With a profile attached the PC is sampled every interval instructions.
+ * With a trace writer open the ring is drained at least every
+ * VM_TRACE_SLICE instructions, so no record is overwritten.
+ *
+ * @param vm Pointer to VM instance
+ * @param interval Instructions between profile samples
+ * @param budget Maximum number of instructions to execute
+ * @param executed Receives the number of instructions retired
+ * @return Why execution stopped
+ */
+static c32_exit_reason_t run_sliced(c32_vm_t *vm, uint32_t interval,
+                                    uint32_t budget, uint32_t *executed) {
+    c32_exit_reason_t reason = C32_EXIT_BUDGET;
+    uint32_t total = 0;
+    uint32_t until_sample = interval;
+
+    while (total < budget) {
+        uint32_t count = 0;
+        uint32_t slice = budget - total;
+
+        if (vm->profile && slice > until_sample) {
+            slice = until_sample;
+        }
+        if (vm_trace_writer && slice > VM_TRACE_SLICE) {
+            slice = VM_TRACE_SLICE;
+        }
+
+        reason = run_slice(vm, slice, &count);
+        total += count;
+        if (vm_trace_writer && c32_trace_writer_drain(vm_trace_writer, &vm_trace) != 0) {
+            vm_trace_failed = 1;
+        }
+        if (reason != C32_EXIT_BUDGET) {
+            break;
+        }
+        until_sample -= count;
+        if (until_sample == 0) {
+            if (vm->profile) {
+                c32_profile_sample(vm->profile, vm->pc);
+            }
+            until_sample = interval;
+        }
+    }
+
+    *executed = total;
+    return reason;
+}
+
+/**
+ * @brief Write a profile for c32prof
+ *
+ * Text format: "interval N", "instructions N", "dropped N", then one
+ * "pc ADDRESS COUNT" line per sampled bucket and one "call ADDRESS COUNT"
+ * line per called bucket.
+ *
+ * @param filename Output path
+ * @param prof Profile to write
+ * @param interval Instructions between samples
+ * @param instructions Instructions retired during the run
+ * @return 0 on success, -1 on failure
+ */
+static int write_profile(const char *filename, const c32_profile_t *prof,
+                         uint32_t interval, uint32_t instructions) {
+    FILE *fp;
+    uint32_t i;
+
+    fp = fopen(filename, "w");
+    if (!fp) {
+        fprintf(stderr, "Error: Cannot create profile '%s'\n", filename);
+        return -1;
+    }
+
+    fprintf(fp, "# CRISP-32 profile\n");
+    fprintf(fp, "interval %lu\n", (unsigned long)interval);
+    fprintf(fp, "instructions %lu\n", (unsigned long)instructions);
+    fprintf(fp, "dropped %lu\n", (unsigned long)prof->dropped);
+    for (i = 0; i < prof->num_buckets; i++) {
+        if (prof->samples[i]) {
+            fprintf(fp, "pc 0x%08lx %lu\n",
+                    (unsigned long)(prof->base + (i << prof->shift)),
+                    (unsigned long)prof->samples[i]);
+        }
+    }
+    for (i = 0; i < prof->num_buckets; i++) {
+        if (prof->calls[i]) {
+            fprintf(fp, "call 0x%08lx %lu\n",
+                    (unsigned long)(prof->base + (i << prof->shift)),
+                    (unsigned long)prof->calls[i]);
+        }
+    }
+
+    if (fclose(fp) != 0) {
+        fprintf(stderr, "Error: Failed to write profile '%s'\n", filename);
+        return -1;
+    }
+    return 0;
+}
+
 /**
  * @brief Print usage information
  *
@@ -120,13 +360,30 @@ static void print_registers(const c32_vm_t *vm) {
  */
 static void print_usage(const char *program_name) {
     printf("CRISP-32 Virtual Machine\n");
-    printf("Usage: %s <binary_file> [load_address]\n\n", program_name);
+    printf("Usage: %s [options] <binary_file> [load_address]\n\n", program_name);
+    printf("Options:\n");
+    printf("  --memory size  Guest memory size, with optional K/M/G suffix (default: 64K,\n");
+    printf("                 max 2G); memory is committed only as the guest touches it\n");
+    printf("  --stats        Print execution counters after the run\n");
+    printf("  --profile file Write a PC sample and call count profile (see c32prof)\n");
+    printf("  --profile-interval n\n");
+    printf("                 Instructions between PC samples (default: %d)\n",
+           DEFAULT_PROFILE_INTERVAL);
+    printf("  --trace file   Write a binary trace of every instruction (see c32trace)\n");
+    printf("  --console      Map a console on stdin/stdout at 0x%08lx\n", C32_CONSOLE_BASE);
+    printf("  --disk file    Map a block device backed by file at 0x%08lx\n\n",
+           C32_BLOCKDEV_BASE);
     printf("Arguments:\n");
     printf("  binary_file    Path to CRISP-32 binary program\n");
     printf("  load_address   Memory address to load program (hex, default: 0x1000)\n\n");
     printf("Examples:\n");
     printf("  %s program.bin\n", program_name);
     printf("  %s program.bin 0x2000\n", program_name);
+    printf("  %s --memory 1G program.bin\n", program_name);
+    printf("  %s --stats program.bin\n", program_name);
+    printf("  %s --profile program.prof program.bin\n", program_name);
+    printf("  %s --trace program.trace program.bin\n", program_name);
+    printf("  %s --console --disk disk.img program.bin\n", program_name);
 }
 
 /**
@@ -141,35 +398,100 @@ static void print_usage(const char *program_name) {
 int main(int argc, char **argv) {
     c32_vm_t vm;
     uint32_t load_addr = DEFAULT_LOAD_ADDR;
-    int step_count = 0;
+    uint32_t memory_size = DEFAULT_MEMORY_SIZE;
+    uint32_t image_size = 0;
+    uint8_t *memory;
+    uint32_t step_count = 0;
+    c32_exit_reason_t reason;
     const char *filename;
+    int show_stats = 0;
+    const char *profile_file = NULL;
+    const char *trace_file = NULL;
+    const char *disk_file = NULL;
+    int use_console = 0;
+    uint32_t num_devices = 0;
+    uint32_t profile_interval = DEFAULT_PROFILE_INTERVAL;
+    int argi = 1;
+
+    /* Parse options */
+    while (argi < argc && strncmp(argv[argi], "--", 2) == 0) {
+        if (strcmp(argv[argi], "--memory") == 0 && argi + 1 < argc &&
+            parse_memory_size(argv[argi + 1], &memory_size) == 0) {
+            argi += 2;
+        } else if (strcmp(argv[argi], "--stats") == 0) {
+            show_stats = 1;
+            argi++;
+        } else if (strcmp(argv[argi], "--profile") == 0 && argi + 1 < argc) {
+            profile_file = argv[argi + 1];
+            argi += 2;
+        } else if (strcmp(argv[argi], "--trace") == 0 && argi + 1 < argc) {
+            trace_file = argv[argi + 1];
+            argi += 2;
+        } else if (strcmp(argv[argi], "--console") == 0) {
+            use_console = 1;
+            argi++;
+        } else if (strcmp(argv[argi], "--disk") == 0 && argi + 1 < argc) {
+            disk_file = argv[argi + 1];
+            argi += 2;
+        } else if (strcmp(argv[argi], "--profile-interval") == 0 && argi + 1 < argc &&
+                   (profile_interval = (uint32_t)strtoul(argv[argi + 1], NULL, 0)) != 0) {
+            argi += 2;
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
 
     /* Parse arguments */
-    if (argc < 2 || argc > 3) {
+    if (argc - argi < 1 || argc - argi > 2) {
         print_usage(argv[0]);
         return 1;
     }
 
-    filename = argv[1];
+    filename = argv[argi];
 
     /* Parse optional load address */
-    if (argc == 3) {
+    if (argc - argi == 2) {
         unsigned long addr;
-        if (sscanf(argv[2], "0x%lx", &addr) == 1 ||
-            sscanf(argv[2], "%lx", &addr) == 1) {
+        if (sscanf(argv[argi + 1], "0x%lx", &addr) == 1 ||
+            sscanf(argv[argi + 1], "%lx", &addr) == 1) {
             load_addr = (uint32_t)addr;
         } else {
-            fprintf(stderr, "Error: Invalid load address '%s'\n", argv[2]);
+            fprintf(stderr, "Error: Invalid load address '%s'\n", argv[argi + 1]);
             print_usage(argv[0]);
             return 1;
         }
     }
 
     /* Initialize VM */
-    c32_vm_init(&vm, vm_memory, VM_MEMORY_SIZE);
+    memory = c32_hostmem_reserve(memory_size);
+    if (!memory) {
+        fprintf(stderr, "Error: Cannot reserve %lu bytes of guest memory\n",
+                (unsigned long)memory_size);
+        return 1;
+    }
+    c32_vm_init(&vm, memory, memory_size);
+    c32_vm_set_icache(&vm, vm_icache, VM_ICACHE_ENTRIES);
 
     /* Load binary program */
-    if (load_binary_file(&vm, filename, load_addr) != 0) {
+    if (load_binary_file(&vm, filename, load_addr, &image_size) != 0) {
+        return 1;
+    }
+
+    /* Map devices above RAM */
+    if (use_console) {
+        c32_console_init(&vm_console, 0, 1);
+        c32_console_device(&vm_devices[num_devices++], C32_CONSOLE_BASE, &vm_console);
+    }
+    if (disk_file) {
+        if (c32_blockdev_open(&vm_disk, disk_file, 1) != 0) {
+            fprintf(stderr, "Error: Cannot open disk image '%s'\n", disk_file);
+            return 1;
+        }
+        c32_blockdev_device(&vm_devices[num_devices++], C32_BLOCKDEV_BASE, &vm_disk);
+    }
+    if (c32_vm_set_devices(&vm, vm_devices, num_devices) != 0) {
+        fprintf(stderr, "Error: Devices overlap guest memory\n");
         return 1;
     }
 
@@ -178,29 +500,92 @@ int main(int argc, char **argv) {
     vm.running = 1;
 
     printf("\nStarting execution at 0x%08x...\n", (unsigned int)load_addr);
+    fflush(stdout); /* The console writes stdout directly */
 
     /* Execute program */
-    while (vm.running && step_count < MAX_EXECUTION_STEPS) {
-        if (c32_vm_step(&vm) != 0) {
-            fprintf(stderr, "\nError: VM execution failed at PC=0x%08x\n",
-                    (unsigned int)vm.pc);
-            print_registers(&vm);
+    if (profile_file) {
+        /* One bucket per instruction of the loaded image */
+        uint32_t buckets = (image_size + 7) / 8 + 1;
+        uint32_t *samples = (uint32_t *)calloc(buckets, sizeof(uint32_t));
+        uint32_t *calls = (uint32_t *)calloc(buckets, sizeof(uint32_t));
+
+        if (!samples || !calls) {
+            fprintf(stderr, "Error: Cannot allocate profile\n");
             return 1;
         }
-        step_count++;
+        c32_profile_init(&vm_profile, samples, calls, buckets, load_addr, 3);
+        c32_vm_set_profile(&vm, &vm_profile);
+    }
+    if (trace_file) {
+        vm_trace_writer = c32_trace_writer_open(trace_file, 0);
+        if (!vm_trace_writer) {
+            fprintf(stderr, "Error: Cannot create trace '%s'\n", trace_file);
+            return 1;
+        }
+        c32_trace_init(&vm_trace, vm_trace_records, VM_TRACE_RECORDS);
+        c32_vm_set_trace(&vm, &vm_trace);
+    }
+#ifdef C32_USE_JIT
+    vm_jit_active = c32_jit_init(&vm_jit, &vm) == 0;
+    if (!vm_jit_active) {
+        fprintf(stderr, "Warning: JIT unavailable, using interpreter\n");
+    }
+#endif
+    if (profile_file || trace_file) {
+        reason = run_sliced(&vm, profile_interval, MAX_EXECUTION_STEPS, &step_count);
+    } else {
+        reason = run_slice(&vm, MAX_EXECUTION_STEPS, &step_count);
+    }
+#ifdef C32_USE_JIT
+    if (vm_jit_active) {
+        c32_jit_destroy(&vm_jit);
+    }
+#endif
+    if (use_console) {
+        c32_console_flush(&vm_console);
+    }
+    if (disk_file) {
+        c32_blockdev_close(&vm_disk);
+    }
+    if (trace_file) {
+        unsigned long records;
+
+        if (c32_trace_writer_close(vm_trace_writer, &vm_trace, &records) != 0 ||
+            vm_trace_failed) {
+            fprintf(stderr, "Error: Failed to write trace '%s'\n", trace_file);
+            return 1;
+        }
+        printf("Trace: %lu records written to '%s'\n", records, trace_file);
+    }
+    if (profile_file &&
+        write_profile(profile_file, &vm_profile, profile_interval, step_count) != 0) {
+        return 1;
+    }
+    if (reason == C32_EXIT_FAULT) {
+        fprintf(stderr, "\nError: VM execution failed at PC=0x%08x\n",
+                (unsigned int)vm.pc);
+        print_registers(&vm);
+        if (show_stats) {
+            print_stats(&vm);
+        }
+        return 1;
     }
 
     /* Check if program timed out */
-    if (vm.running) {
+    if (reason == C32_EXIT_BUDGET) {
         fprintf(stderr, "\nWarning: Program did not halt within %d steps\n",
                 MAX_EXECUTION_STEPS);
     } else {
-        printf("\nProgram halted after %d steps\n", step_count);
+        printf("\nProgram halted after %u steps\n", (unsigned int)step_count);
     }
 
     /* Print final register state */
     print_registers(&vm);
+    if (show_stats) {
+        print_stats(&vm);
+    }
 
+    c32_hostmem_release(memory, memory_size);
     return 0;
 }
 